@@ -0,0 +1,47 @@
+# This file is part of FreeRCT.
+# FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+# FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+#
+
+# CMake script for building an RCD file twice with different rcdgen options, and checking that both builds are byte-identical.
+#
+# RCDGEN             rcdgen program.
+# SOURCE_DIR         Directory of the FML files, rcdgen runs there.
+# PREPROCESSED_FILE  Preprocessed FML file to build.
+# OUTFILE            Name of the RCD file written by rcdgen.
+# WORK_DIR           Directory to keep both builds in.
+# OPTIONS_A          Comma-separated rcdgen options of the first build.
+# OPTIONS_B          Comma-separated rcdgen options of the second build.
+
+FOREACH(VAR RCDGEN SOURCE_DIR PREPROCESSED_FILE OUTFILE WORK_DIR OPTIONS_A OPTIONS_B)
+	IF(NOT DEFINED ${VAR})
+		message(FATAL_ERROR "Variable '${VAR}' must be provided")
+	ENDIF()
+ENDFOREACH()
+
+file(GLOB LANGFILES "${SOURCE_DIR}/lang/*.yml")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+# The build timestamp in the INFO block would differ otherwise.
+set(ENV{SOURCE_DATE_EPOCH} 0)
+
+FOREACH(BUILD A B)
+	string(REPLACE "," ";" OPTIONS "${OPTIONS_${BUILD}}")
+	execute_process(COMMAND "${RCDGEN}" ${OPTIONS} ${LANGFILES} "${PREPROCESSED_FILE}"
+	                WORKING_DIRECTORY "${SOURCE_DIR}"
+	                RESULT_VARIABLE RESULT
+	                OUTPUT_QUIET
+	)
+	IF(NOT RESULT EQUAL 0)
+		message(FATAL_ERROR "rcdgen ${OPTIONS_${BUILD}} failed on ${PREPROCESSED_FILE}")
+	ENDIF()
+	file(RENAME "${SOURCE_DIR}/${OUTFILE}" "${WORK_DIR}/${BUILD}_${OUTFILE}")
+ENDFOREACH()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files "${WORK_DIR}/A_${OUTFILE}" "${WORK_DIR}/B_${OUTFILE}"
+                RESULT_VARIABLE DIFFERENT
+)
+IF(NOT DIFFERENT EQUAL 0)
+	message(FATAL_ERROR "${OUTFILE} built with rcdgen ${OPTIONS_A} differs from ${OUTFILE} built with rcdgen ${OPTIONS_B}")
+ENDIF()
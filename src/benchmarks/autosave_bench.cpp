@@ -0,0 +1,222 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file autosave_bench.cpp Benchmark of the incremental autosave, and check of its round trip. */
+
+#include "../stdafx.h"
+#include <filesystem>
+#include "../map.h"
+#include "../gamecontrol.h"
+#include "../gameobserver.h"
+#include "../loadsave.h"
+#include "../people.h"
+#include "../ride_type.h"
+#include "../scenery.h"
+#include "../time_func.h"
+#include "game_bench.h"
+
+/** Command-line options of the program. */
+static const OptionData _options[] = {
+	GETOPT_NOVAL('h', "--help"),
+	GETOPT_VALUE('d', "--deltas"),
+	GETOPT_VALUE('t', "--ticks"),
+	GAME_BENCH_OPTIONS,
+	GETOPT_END()
+};
+
+/** Output online help. */
+static void PrintUsage()
+{
+	printf("Usage: autosave_bench [options]\n");
+	printf("Write an incremental savegame with a base and deltas while the park runs, load it, and compare the loaded game with the live game.\n");
+	printf("Options:\n");
+	printf("  -h, --help             Display this help text and exit.\n");
+	printf("  -d, --deltas N         Number of deltas to append (default 6).\n");
+	printf("  -t, --ticks N          Number of game ticks between two deltas (default 300).\n");
+	BenchmarkGame::PrintOptions();
+	printf("\n");
+	printf("A CSV line is printed for every save with the columns kind, index, ms, and bytes. Kind is 'full' for\n");
+	printf("a complete savegame, 'base' for a new incremental savegame, 'delta' for an appended delta, 'load'\n");
+	printf("for loading the incremental savegame, and 'truncated' for loading it with its last delta cut short;\n");
+	printf("bytes is the size of the file afterwards. The program fails if a complete save of the loaded game differs\n");
+	printf("from a complete save of the live game, or of the game at the previous save after loading the cut file.\n");
+}
+
+/**
+ * Save the current game to memory, without the timestamp of the file header.
+ * @return The saved game.
+ */
+static std::vector<uint8> SaveToMemory()
+{
+	std::vector<uint8> data;
+	Saver svr(&data);
+	SaveGame(svr);
+	std::fill(data.begin() + 8, data.begin() + 16, 0);  // Timestamp of the file header.
+	return data;
+}
+
+/** Remove the park from the game, as #GameControl does before loading a game. */
+static void ClearPark()
+{
+	_rides_manager.DeleteAllRideInstances();
+	_scenery.Clear();
+	_game_observer.Uninitialize();
+	_guests.Uninitialize();
+	_staff.Uninitialize();
+}
+
+/**
+ * Print a CSV line of a save.
+ * @param kind Kind of save.
+ * @param index Index of the delta, or \c 0.
+ * @param start Start time of the save.
+ * @param fname File written by the save.
+ */
+static void PrintSave(const char *kind, int index, const Realtime &start, const std::string &fname)
+{
+	const double ms = Delta(start);
+	printf("%s,%d,%.2f,%ju\n", kind, index, ms, static_cast<uintmax_t>(std::filesystem::file_size(fname)));
+	fflush(stdout);
+}
+
+/**
+ * Load a savegame file, and check that it gives the expected game.
+ * @param fname File to load.
+ * @param expected Expected game, as saved by #SaveToMemory.
+ * @param kind Kind of load, for the CSV line.
+ * @param index Index of the last delta, for the CSV line.
+ * @return Whether the file was loaded and gave the expected game.
+ */
+static bool CheckLoad(const std::string &fname, const std::vector<uint8> &expected, const char *kind, int index)
+{
+	ClearPark();
+	const Realtime start = Time();
+	if (!LoadGameFile(fname.c_str())) {
+		fprintf(stderr, "ERROR: Cannot load the savegame '%s'\n", fname.c_str());
+		return false;
+	}
+	PrintSave(kind, index, start, fname);
+
+	const std::vector<uint8> reloaded = SaveToMemory();
+	if (reloaded != expected) {
+		fprintf(stderr, "ERROR: The loaded game (%zu bytes) differs from the expected game (%zu bytes)\n", reloaded.size(), expected.size());
+		return false;
+	}
+	return true;
+}
+
+/**
+ * The main program of the autosave benchmark.
+ * @param argc Number of argument given to the program.
+ * @param argv Argument texts.
+ * @return Exit code.
+ */
+int main(int argc, char *argv[])
+{
+	GetOptData opt_data(argc - 1, argv + 1, _options);
+	BenchmarkGame game;
+	int deltas = 6;
+	int ticks = 300;
+
+	int opt_id;
+	do {
+		opt_id = opt_data.GetOpt();
+		bool failed = false;
+		if (game.HandleOption(opt_id, opt_data.opt, &failed)) {
+			if (failed) return 1;
+			continue;
+		}
+		switch (opt_id) {
+			case 'h':
+				PrintUsage();
+				return 0;
+
+			case 'd':
+				deltas = atoi(opt_data.opt);
+				if (deltas < 0) {
+					fprintf(stderr, "ERROR: The number of deltas cannot be negative\n");
+					return 1;
+				}
+				break;
+
+			case 't':
+				ticks = atoi(opt_data.opt);
+				if (ticks < 0) {
+					fprintf(stderr, "ERROR: The number of ticks cannot be negative\n");
+					return 1;
+				}
+				break;
+
+			case -1:
+				break;
+
+			default:
+				/* -2 or some other weird thing happened. */
+				fprintf(stderr, "ERROR while processing the command-line\n");
+				return 1;
+		}
+	} while (opt_id != -1);
+
+	_max_autosaves = 0;  // Do not overwrite the autosaves of the player.
+	if (!game.LoadData() || !game.LoadPark()) return 1;
+	_game_observer.won_lost = SCENARIO_WON;  // Ending the scenario opens a window, which needs the video system.
+
+	const std::filesystem::path tmp_dir = std::filesystem::temp_directory_path();
+	const std::string full_file = (tmp_dir / "freerct_benchmark_full.fct").string();
+	const std::string inc_file = (tmp_dir / "freerct_benchmark_autosave.fct").string();
+
+	printf("kind,index,ms,bytes\n");
+	Realtime start = Time();
+	bool saved = SaveGameFile(full_file.c_str());
+	if (saved) PrintSave("full", 0, start, full_file);
+	std::filesystem::remove(full_file);
+
+	start = Time();
+	saved = saved && SaveIncrementalGameFile(inc_file.c_str());
+	if (saved) PrintSave("base", 0, start, inc_file);
+
+	std::vector<uint8> live = SaveToMemory();  // Game at the last save.
+	std::vector<uint8> previous;               // Game at the save before, if the last save appended a delta.
+	for (int i = 1; saved && i <= deltas; i++) {
+		for (int t = 0; t < ticks; t++) OnNewTick(FRAME_DELAY);
+
+		/* Change the world, also at stacks that the game did not change by itself. */
+		const uint16 x = i % _world.GetXSize();
+		const uint16 y = _world.GetYSize() / 2;
+		VoxelStack *vs = _world.GetModifyStack(x, y);
+		if (!vs->voxels.empty()) {
+			vs->voxels[0]->SetGrowth(i % 8);
+			_world.MarkStackDirty(x, y);
+		}
+
+		start = Time();
+		if (AppendIncrementalGameFile(inc_file.c_str())) {
+			PrintSave("delta", i, start, inc_file);
+			previous = std::move(live);
+		} else {
+			/* The file got too long, the game writes a new base then. */
+			saved = SaveIncrementalGameFile(inc_file.c_str());
+			if (saved) PrintSave("base", i, start, inc_file);
+			previous.clear();
+		}
+		live = SaveToMemory();
+	}
+	if (!saved) {
+		fprintf(stderr, "ERROR: Cannot write the savegame '%s'\n", inc_file.c_str());
+		std::filesystem::remove(inc_file);
+		return 1;
+	}
+
+	bool ok = CheckLoad(inc_file, live, "load", deltas);
+	if (ok && !previous.empty()) {
+		/* A game that stopped while appending the last delta must give the game of the save before. */
+		std::filesystem::resize_file(inc_file, std::filesystem::file_size(inc_file) - 1);
+		ok = CheckLoad(inc_file, previous, "truncated", deltas - 1);
+	}
+	std::filesystem::remove(inc_file);
+	return ok ? 0 : 1;
+}
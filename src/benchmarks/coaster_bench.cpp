@@ -0,0 +1,252 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file coaster_bench.cpp Benchmark of the ratings of a long coaster, with trees planted next to its track. */
+
+#include "../stdafx.h"
+#include <memory>
+#include "../map.h"
+#include "../coaster.h"
+#include "../gamecontrol.h"
+#include "../gameobserver.h"
+#include "../random.h"
+#include "../scenery.h"
+#include "../ride_type.h"
+#include "../time_func.h"
+#include "game_bench.h"
+
+/** Command-line options of the program. */
+static const OptionData _options[] = {
+	GETOPT_NOVAL('h', "--help"),
+	GETOPT_VALUE('p', "--pieces"),
+	GETOPT_VALUE('t', "--trees"),
+	GAME_BENCH_OPTIONS,
+	GETOPT_END()
+};
+
+/** Output online help. */
+static void PrintUsage()
+{
+	printf("Usage: coaster_bench [options]\n");
+	printf("Build a random coaster in a park, and plant trees next to its track one by one.\n");
+	printf("Options:\n");
+	printf("  -h, --help             Display this help text and exit.\n");
+	printf("  -p, --pieces N         Number of track pieces of the coaster (default 400).\n");
+	printf("  -t, --trees N          Number of trees to plant (default 200).\n");
+	BenchmarkGame::PrintOptions();
+	printf("\n");
+	printf("A CSV line is printed after the coaster is built, and after every tree, with the columns trees, excitement,\n");
+	printf("intensity, nausea, cached_ms, and full_ms. Cached_ms is the time to compute the ratings again with the cached\n");
+	printf("bonus of the surroundings, full_ms the time after all voxel stacks are marked as changed. The program fails\n");
+	printf("if both computations give different ratings.\n");
+}
+
+/**
+ * Build a random track from a starting piece, backtracking when no piece fits.
+ * @param ci Coaster to build.
+ * @param start Starting piece at its position.
+ * @param count Number of track pieces to build.
+ * @param rnd Random number generator.
+ * @return Number of placed track pieces.
+ */
+static int BuildTrack(CoasterInstance *ci, const PositionedTrackPiece &start, int count, Random *rnd)
+{
+	const CoasterType *ct = ci->GetCoasterType();
+	std::vector<int> placed{ci->AddPositionedPiece(start)};  // Indices in ci->pieces, in track order.
+	ci->PlaceTrackPieceInWorld(ci->pieces[placed.back()]);
+
+	for (int steps = 0; static_cast<int>(placed.size()) < count && steps < 200 * count; steps++) {
+		const PositionedTrackPiece &last = ci->pieces[placed.back()];
+		const XYZPoint16 pos = last.GetEndXYZ();
+		std::vector<ConstTrackPiecePtr> options;
+		for (const ConstTrackPiecePtr &p : ct->pieces) {
+			if (p->entry_connect == last.piece->exit_connect && !p->IsStartingPiece()) options.push_back(p);
+		}
+
+		bool added = false;
+		for (int attempt = 0; attempt < 40 && !options.empty() && !added; attempt++) {
+			const ConstTrackPiecePtr &p = options[rnd->Uniform(options.size() - 1)];
+			/* Mostly stay a few levels above the ground. */
+			const int ground = IsVoxelstackInsideWorld(pos.x, pos.y) ? _world.GetBaseGroundHeight(pos.x, pos.y) : 0;
+			if (attempt < 30 && p->exit_dxyz.z > 0 && pos.z + p->exit_dxyz.z > ground + 10) continue;
+			if (attempt < 30 && p->exit_dxyz.z < 0 && pos.z + p->exit_dxyz.z < ground + 6) continue;
+
+			PositionedTrackPiece ptp(pos, p);
+			if (ptp.CanBePlaced() != STR_NULL) continue;
+			placed.push_back(ci->AddPositionedPiece(ptp));
+			ci->PlaceTrackPieceInWorld(ci->pieces[placed.back()]);
+			added = true;
+		}
+		if (added) continue;
+
+		/* Take back a few pieces, but never the starting piece. */
+		for (int k = 1 + rnd->Uniform(3); k > 0 && placed.size() > 1; k--) {
+			ci->RemovePositionedPiece(ci->pieces[placed.back()]);
+			placed.pop_back();
+		}
+	}
+	return placed.size();
+}
+
+/**
+ * Compute the ratings of the coaster with the cached surroundings, and again after marking the whole world changed.
+ * @param ci Coaster to rate.
+ * @param trees Number of planted trees.
+ * @return Whether both computations give the same ratings.
+ */
+static bool MeasureRatings(CoasterInstance *ci, int trees)
+{
+	Realtime start = Time();
+	ci->RecalculateRatings();
+	const double cached_ms = Delta(start);
+	const uint32 ratings[3] = {ci->excitement_rating, ci->intensity_rating, ci->nausea_rating};
+
+	_world.MarkAllStacksDirty();
+	start = Time();
+	ci->RecalculateRatings();
+	const double full_ms = Delta(start);
+
+	printf("%d,%u,%u,%u,%.4f,%.4f\n", trees, ratings[0], ratings[1], ratings[2], cached_ms, full_ms);
+	if (ratings[0] != ci->excitement_rating || ratings[1] != ci->intensity_rating || ratings[2] != ci->nausea_rating) {
+		fprintf(stderr, "ERROR: With %d trees, the cached ratings %u/%u/%u differ from the computed ratings %u/%u/%u\n", trees,
+				ratings[0], ratings[1], ratings[2], ci->excitement_rating, ci->intensity_rating, ci->nausea_rating);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * The main program of the coaster benchmark.
+ * @param argc Number of argument given to the program.
+ * @param argv Argument texts.
+ * @return Exit code.
+ */
+int main(int argc, char *argv[])
+{
+	GetOptData opt_data(argc - 1, argv + 1, _options);
+	BenchmarkGame game;
+	game.settings.x_size = 127;
+	game.settings.y_size = 127;
+	int piece_count = 400;
+	int tree_count = 200;
+
+	int opt_id;
+	do {
+		opt_id = opt_data.GetOpt();
+		bool failed = false;
+		if (game.HandleOption(opt_id, opt_data.opt, &failed)) {
+			if (failed) return 1;
+			continue;
+		}
+		switch (opt_id) {
+			case 'h':
+				PrintUsage();
+				return 0;
+
+			case 'p':
+				piece_count = atoi(opt_data.opt);
+				if (piece_count < 1) {
+					fprintf(stderr, "ERROR: The number of track pieces must be positive\n");
+					return 1;
+				}
+				break;
+
+			case 't':
+				tree_count = atoi(opt_data.opt);
+				if (tree_count < 0) {
+					fprintf(stderr, "ERROR: The number of trees cannot be negative\n");
+					return 1;
+				}
+				break;
+
+			case -1:
+				break;
+
+			default:
+				/* -2 or some other weird thing happened. */
+				fprintf(stderr, "ERROR while processing the command-line\n");
+				return 1;
+		}
+	} while (opt_id != -1);
+
+	_max_autosaves = 0;  // Do not overwrite the autosaves of the player.
+	if (!game.LoadData() || !game.LoadPark()) return 1;
+	_game_observer.won_lost = SCENARIO_WON;  // Ending the scenario opens a window, which needs the video system.
+
+	const CoasterType *ct = nullptr;
+	for (const auto &type : _rides_manager.ride_types) {
+		if (type->kind == RTK_COASTER) {
+			ct = static_cast<const CoasterType *>(type.get());
+			break;
+		}
+	}
+	ConstTrackPiecePtr start_piece;
+	if (ct != nullptr) {
+		for (const ConstTrackPiecePtr &p : ct->pieces) {
+			if (p->IsStartingPiece()) {
+				start_piece = p;
+				break;
+			}
+		}
+	}
+	const std::vector<const SceneryType *> trees = _scenery.GetAllTypes(SCC_TREES);
+	if (start_piece == nullptr || trees.empty()) {
+		fprintf(stderr, "ERROR: The game data has no coaster or no trees\n");
+		return 1;
+	}
+	const uint16 num = _rides_manager.GetFreeInstance(ct);
+	if (num == INVALID_RIDE_INSTANCE) {
+		fprintf(stderr, "ERROR: The park has no room for another ride\n");
+		return 1;
+	}
+	CoasterInstance *ci = static_cast<CoasterInstance *>(_rides_manager.CreateInstance(ct, num));
+
+	/* Find a free spot for the starting piece. */
+	Random rnd;
+	std::unique_ptr<PositionedTrackPiece> start;
+	for (int attempt = 0; attempt < 1000 && start == nullptr; attempt++) {
+		const uint16 x = rnd.Uniform(_world.GetXSize() - 1);
+		const uint16 y = rnd.Uniform(_world.GetYSize() - 1);
+		start.reset(new PositionedTrackPiece(XYZPoint16(x, y, _world.GetBaseGroundHeight(x, y) + 6), start_piece));
+		if (start->CanBePlaced() != STR_NULL) start.reset();
+	}
+	if (start == nullptr) {
+		fprintf(stderr, "ERROR: The park has no room for the coaster\n");
+		return 1;
+	}
+	const int placed = BuildTrack(ci, *start, piece_count, &rnd);
+	fprintf(stderr, "Built a coaster with %d track pieces\n", placed);
+
+	/* Statistics of a ride through the coaster, for the intensity and nausea ratings. */
+	for (uint32 point = 0; point < 100; point++) {
+		ci->SampleStatistics(point * COASTER_INTENSITY_STATISTICS_SAMPLING_PRECISION, true, 50 + point % 30, 3 + point % 5, 2 + point % 3);
+	}
+
+	printf("trees,excitement,intensity,nausea,cached_ms,full_ms\n");
+	if (!MeasureRatings(ci, 0)) return 1;
+
+	/* Plant trees next to the track, the surroundings of the coaster change with each of them. */
+	int planted = 0;
+	for (int attempt = 0; attempt < 10 * tree_count && planted < tree_count; attempt++) {
+		const PositionedTrackPiece &piece = ci->pieces[rnd.Uniform(ci->capacity - 1)];
+		if (piece.piece == nullptr) continue;
+		const int x = piece.base_voxel.x + rnd.Uniform(4) - 2;
+		const int y = piece.base_voxel.y + rnd.Uniform(4) - 2;
+		if (!IsVoxelstackInsideWorld(x, y)) continue;
+
+		std::unique_ptr<SceneryInstance> tree(new SceneryInstance(trees[rnd.Uniform(trees.size() - 1)]));
+		tree->vox_pos = XYZPoint16(x, y, _world.GetBaseGroundHeight(x, y));
+		if (tree->CanPlace() != STR_NULL) {
+			tree->vox_pos = XYZPoint16::invalid();  // The tree is not in the world, so deleting it must not remove it.
+			continue;
+		}
+		_scenery.AddItem(tree.release());
+		planted++;
+		if (!MeasureRatings(ci, planted)) return 1;
+	}
+	return 0;
+}
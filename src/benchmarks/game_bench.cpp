@@ -0,0 +1,121 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file game_bench.cpp Common setup of the benchmarks that run the code of the game. */
+
+#include "../stdafx.h"
+#include "../video.h"
+#include "../map.h"
+#include "../rcdfile.h"
+#include "../sprite_data.h"
+#include "../sprite_store.h"
+#include "../language.h"
+#include "../fileio.h"
+#include "../gamecontrol.h"
+#include "../loadsave.h"
+#include "../ride_type.h"
+#include "../rev.h"
+#include "game_bench.h"
+#include <filesystem>
+
+BenchmarkGame::BenchmarkGame() : data_loaded(false)
+{
+}
+
+BenchmarkGame::~BenchmarkGame()
+{
+	if (!this->data_loaded) return;
+
+	_game_control.Uninitialize();
+	UninitLanguage();
+	DestroyImageStorage();
+}
+
+/**
+ * Handle a command-line option of the game setup.
+ * @param opt_id Option returned by GetOptData::GetOpt.
+ * @param value Value of the option.
+ * @param failed [out] Set if the option was invalid. An error is printed then.
+ * @return Whether the option belongs to the game setup.
+ */
+bool BenchmarkGame::HandleOption(int opt_id, const char *value, bool *failed)
+{
+	switch (opt_id) {
+		case 'i':
+			OverrideInstallPrefix(value);
+			return true;
+		case 'u':
+			OverrideUserdataPrefix(value);
+			return true;
+		case 'l':
+			this->park_file = value;
+			return true;
+		case 'g':
+			if (!this->settings.Parse(value)) *failed = true;
+			return true;
+		default:
+			return false;
+	}
+}
+
+/** Output online help of the options of the game setup. */
+void BenchmarkGame::PrintOptions()
+{
+	printf("  -i, --installdir DIR   Use the specified installation directory.\n");
+	printf("  -u, --userdatadir DIR  Use the specified user data directory.\n");
+	printf("  -l, --load FILE        Run the benchmark in the park of the savegame.\n");
+	printf("  -g, --generator-settings SETTINGS\n");
+	printf("                         Settings of the generated park, if no savegame is loaded.\n");
+	printf("                         See 'freerct --help' for the format.\n");
+}
+
+/**
+ * Load the RCD files and the languages, as the game does at startup.
+ * @return Whether the graphics of the game are available.
+ */
+bool BenchmarkGame::LoadData()
+{
+	InitImageStorage();
+	_rcd_collection.ScanDirectories();
+	_sprite_manager.LoadRcdFiles();
+	_rides_manager.LoadDesigns();
+	InitLanguage();
+	this->data_loaded = true;
+
+	if (!_gui_sprites.HasSufficientGraphics()) {
+		fprintf(stderr, "Insufficient graphics loaded.\n");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Load the park of the benchmark, and play it.
+ * Without a savegame, a park is generated into a temporary file first.
+ * With the software renderer, the park is started as the game does, with its windows.
+ * @return Whether the park is loaded.
+ */
+bool BenchmarkGame::LoadPark()
+{
+	std::string fname = this->park_file;
+	if (fname.empty()) {
+		fname = (std::filesystem::temp_directory_path() / "freerct_benchmark_park.fct").string();
+		if (GeneratePark(fname, this->settings) != 0) return false;
+	}
+
+	bool loaded;
+	if (_video.IsSoftwareRendering()) {
+		_game_control.Initialize(fname, GM_PLAY);
+		loaded = _game_mode_mgr.InPlayMode();
+	} else {
+		loaded = LoadGameFile(fname.c_str());
+		if (loaded) _game_mode_mgr.SetGameMode(GM_PLAY);
+	}
+	if (this->park_file.empty()) std::filesystem::remove(fname);
+	if (!loaded) fprintf(stderr, "Cannot load the park '%s'\n", fname.c_str());
+	return loaded;
+}
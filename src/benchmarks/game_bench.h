@@ -0,0 +1,43 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file game_bench.h Common setup of the benchmarks that run the code of the game. */
+
+#ifndef GAME_BENCH_H
+#define GAME_BENCH_H
+
+#include "../getoptdata.h"
+#include "../park_generator.h"
+#include <string>
+
+/** Command-line options of #BenchmarkGame, to put in the option list of a benchmark. */
+#define GAME_BENCH_OPTIONS \
+	GETOPT_VALUE('i', "--installdir"), \
+	GETOPT_VALUE('u', "--userdatadir"), \
+	GETOPT_VALUE('l', "--load"), \
+	GETOPT_VALUE('g', "--generator-settings")
+
+/** The game data and the park of a benchmark. */
+class BenchmarkGame {
+public:
+	BenchmarkGame();
+	~BenchmarkGame();
+
+	bool HandleOption(int opt_id, const char *value, bool *failed);
+	static void PrintOptions();
+
+	bool LoadData();
+	bool LoadPark();
+
+	std::string park_file;               ///< Savegame to load, if empty a park is generated.
+	ParkGeneratorSettings settings;      ///< Settings of the generated park.
+
+private:
+	bool data_loaded;  ///< Whether #LoadData succeeded.
+};
+
+#endif
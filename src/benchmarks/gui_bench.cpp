@@ -0,0 +1,154 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file gui_bench.cpp Benchmark of drawing the windows of the game, with the software renderer. */
+
+#include "../stdafx.h"
+#include "../video.h"
+#include "../freerct.h"
+#include "../config_reader.h"
+#include "../map.h"
+#include "../window.h"
+#include "../language.h"
+#include "../fileio.h"
+#include "../gamecontrol.h"
+#include "../ride_type.h"
+#include "../time_func.h"
+#include "../rev.h"
+#include "game_bench.h"
+
+/** Command-line options of the program. */
+static const OptionData _options[] = {
+	GETOPT_NOVAL('h', "--help"),
+	GETOPT_VALUE('n', "--frames"),
+	GAME_BENCH_OPTIONS,
+	GETOPT_END()
+};
+
+/** Output online help. */
+static void PrintUsage()
+{
+	printf("Usage: gui_bench [options]\n");
+	printf("Open ten windows in a paused park, and count the widgets drawn per frame by the software renderer.\n");
+	printf("Options:\n");
+	printf("  -h, --help             Display this help text and exit.\n");
+	printf("  -n, --frames N         Number of frames to draw in each measurement (default 100).\n");
+	BenchmarkGame::PrintOptions();
+	printf("\n");
+	printf("The 'cached' measurement draws the windows as the game does, the 'full' measurement repaints every\n");
+	printf("window in every frame. Both print one CSV line with the columns measurement, frames, widgets,\n");
+	printf("widgets_per_frame, and ms_per_frame.\n");
+}
+
+/** Open the windows of the benchmark. */
+static void OpenWindows()
+{
+	ShowFinancesGui();
+	ShowInboxGui();
+	ShowMinimap();
+	ShowParkManagementGui(PARK_MANAGEMENT_TAB_GENERAL);
+	ShowSettingGui();
+	ShowStaffManagementGui();
+	ShowRideSelectGui();
+
+	/* Fill up with the management windows of the first rides. */
+	int rides = 3;
+	for (const auto &ri : _rides_manager.instances) {
+		if (rides == 0) break;
+		if (ShowRideManagementGui(ri.second->GetIndex())) rides--;
+	}
+}
+
+/**
+ * Draw frames, and print the number of drawn widgets.
+ * @param name Name of the measurement.
+ * @param frames Number of frames to draw.
+ * @param repaint_all Whether to mark all windows dirty before each frame.
+ */
+static void Measure(const char *name, int frames, bool repaint_all)
+{
+	uint64 widgets = 0;
+	const Realtime start = Time();
+	for (int i = 0; i < frames; i++) {
+		if (repaint_all) {
+			for (Window *w = _window_manager.top; w != nullptr; w = w->lower) w->MarkDirty();
+		}
+		_video.RenderFrames(1);
+		widgets += _window_manager.widget_draw_count;
+	}
+	const double ms = Delta(start);
+
+	printf("%s,%d,%llu,%.1f,%.3f\n", name, frames, static_cast<unsigned long long>(widgets),
+			static_cast<double>(widgets) / frames, ms / frames);
+	fflush(stdout);
+}
+
+/**
+ * The main program of the GUI benchmark.
+ * @param argc Number of argument given to the program.
+ * @param argv Argument texts.
+ * @return Exit code.
+ */
+int main(int argc, char *argv[])
+{
+	GetOptData opt_data(argc - 1, argv + 1, _options);
+	BenchmarkGame game;
+	int frames = 100;
+
+	int opt_id;
+	do {
+		opt_id = opt_data.GetOpt();
+		bool failed = false;
+		if (game.HandleOption(opt_id, opt_data.opt, &failed)) {
+			if (failed) return 1;
+			continue;
+		}
+		switch (opt_id) {
+			case 'h':
+				PrintUsage();
+				return 0;
+
+			case 'n':
+				frames = atoi(opt_data.opt);
+				if (frames < 1) {
+					fprintf(stderr, "ERROR: The number of frames must be positive\n");
+					return 1;
+				}
+				break;
+
+			case -1:
+				break;
+
+			default:
+				/* -2 or some other weird thing happened. */
+				fprintf(stderr, "ERROR while processing the command-line\n");
+				return 1;
+		}
+	} while (opt_id != -1);
+
+	if (!game.LoadData()) return 1;
+
+	ReadFontSettings(ConfigFile(freerct_userdata_prefix() + DIR_SEP + "freerct.cfg"));
+	_max_autosaves = 0;  // Do not overwrite the autosaves of the player.
+	_video.InitializeSoftware({&FONT_LATIN, &FONT_CJK}, 1920, 1080);
+
+	int result = 1;
+	if (game.LoadPark()) {
+		_game_control.speed = GSP_PAUSE;
+		OpenWindows();
+		_video.RenderFrames(1);  // Draw every window once.
+
+		printf("measurement,frames,widgets,widgets_per_frame,ms_per_frame\n");
+		Measure("cached", frames, false);
+		Measure("full", frames, true);
+		result = 0;
+	}
+
+	_game_control.Uninitialize();
+	_video.Shutdown();
+	return result;
+}
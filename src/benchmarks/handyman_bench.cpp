@@ -0,0 +1,176 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file handyman_bench.cpp Benchmark of handymen sweeping the paths of a park for years. */
+
+#include "../stdafx.h"
+#include "../map.h"
+#include "../dates.h"
+#include "../gamecontrol.h"
+#include "../gameobserver.h"
+#include "../people.h"
+#include "../person.h"
+#include "../random.h"
+#include "../scenery.h"
+#include "../ride_type.h"
+#include "../time_func.h"
+#include "game_bench.h"
+
+/** Command-line options of the program. */
+static const OptionData _options[] = {
+	GETOPT_NOVAL('h', "--help"),
+	GETOPT_VALUE('y', "--years"),
+	GETOPT_VALUE('m', "--handymen"),
+	GAME_BENCH_OPTIONS,
+	GETOPT_END()
+};
+
+/** Output online help. */
+static void PrintUsage()
+{
+	printf("Usage: handyman_bench [options]\n");
+	printf("Hire handymen at random paths, and let the park run for years.\n");
+	printf("Options:\n");
+	printf("  -h, --help             Display this help text and exit.\n");
+	printf("  -y, --years N          Number of years to simulate (default 10).\n");
+	printf("  -m, --handymen N       Number of handymen (default 100).\n");
+	BenchmarkGame::PrintOptions();
+	printf("\n");
+	printf("At the end of every simulated year, a CSV line is printed with the columns year, guests, litter,\n");
+	printf("dirty_paths, paths, handyman_ms, and total_ms. Litter counts the litter and vomit objects on the paths,\n");
+	printf("handyman_ms is the time spent in the staff code during the year, total_ms the time of all game ticks.\n");
+}
+
+/**
+ * Count the litter and vomit on the paths of the park.
+ * @param paths Voxels with a path.
+ * @param dirty_paths [out] Number of paths with litter or vomit.
+ * @return Number of litter and vomit objects.
+ */
+static uint CountLitter(const std::vector<XYZPoint16> &paths, uint *dirty_paths)
+{
+	uint litter = 0;
+	*dirty_paths = 0;
+	for (const XYZPoint16 &p : paths) {
+		const uint count = _scenery.CountLitterAndVomit(p);
+		litter += count;
+		if (count > 0) (*dirty_paths)++;
+	}
+	return litter;
+}
+
+/**
+ * The main program of the handyman benchmark.
+ * @param argc Number of argument given to the program.
+ * @param argv Argument texts.
+ * @return Exit code.
+ */
+int main(int argc, char *argv[])
+{
+	GetOptData opt_data(argc - 1, argv + 1, _options);
+	BenchmarkGame game;
+	game.settings.guests = 500;
+	game.settings.staff = 0;
+	int years = 10;
+	int handyman_count = 100;
+
+	int opt_id;
+	do {
+		opt_id = opt_data.GetOpt();
+		bool failed = false;
+		if (game.HandleOption(opt_id, opt_data.opt, &failed)) {
+			if (failed) return 1;
+			continue;
+		}
+		switch (opt_id) {
+			case 'h':
+				PrintUsage();
+				return 0;
+
+			case 'y':
+				years = atoi(opt_data.opt);
+				if (years < 1) {
+					fprintf(stderr, "ERROR: The number of years must be positive\n");
+					return 1;
+				}
+				break;
+
+			case 'm':
+				handyman_count = atoi(opt_data.opt);
+				if (handyman_count < 0) {
+					fprintf(stderr, "ERROR: The number of handymen cannot be negative\n");
+					return 1;
+				}
+				break;
+
+			case -1:
+				break;
+
+			default:
+				/* -2 or some other weird thing happened. */
+				fprintf(stderr, "ERROR while processing the command-line\n");
+				return 1;
+		}
+	} while (opt_id != -1);
+
+	_max_autosaves = 0;  // Do not overwrite the autosaves of the player.
+	if (!game.LoadData() || !game.LoadPark()) return 1;
+	_game_observer.won_lost = SCENARIO_WON;  // Ending the scenario opens a window, which needs the video system.
+
+	std::vector<XYZPoint16> paths;
+	for (uint16 x = 0; x < _world.GetXSize(); x++) {
+		for (uint16 y = 0; y < _world.GetYSize(); y++) {
+			const VoxelStack *vs = _world.GetStack(x, y);
+			for (int16 i = 0; i < vs->height; i++) {
+				if (HasValidPath(vs->voxels[i].get())) paths.emplace_back(x, y, vs->base + i);
+			}
+		}
+	}
+	if (paths.empty()) {
+		fprintf(stderr, "ERROR: The park has no paths\n");
+		return 1;
+	}
+
+	/* Hire the handymen, and put them at random paths. */
+	Random rnd;
+	for (int i = 0; i < handyman_count; i++) {
+		Handyman *m = _staff.HireHandyman();
+		const XYZPoint16 &p = paths[rnd.Uniform(paths.size() - 1)];
+		m->DeActivate(OAR_REMOVE);
+		m->Activate(Point16(p.x, p.y), PERSON_HANDYMAN);  // Start walking at the new position.
+	}
+
+	/* Run the ticks of the game as #OnNewTick does, to time the staff code separately. */
+	static const uint32 FRAME_DELAY = 30;  // Milliseconds per frame at normal speed.
+	printf("year,guests,litter,dirty_paths,paths,handyman_ms,total_ms\n");
+	for (int year = 1; year <= years; year++) {
+		double staff_ms = 0.0;
+		const Realtime year_start = Time();
+		const int start_year = _date.year;
+		while (_date.year == start_year) {
+			_guests.DoTick();
+			Realtime start = Time();
+			_staff.DoTick();
+			staff_ms += Delta(start);
+			DateOnTick();
+			_game_observer.DoTick();
+			_guests.OnAnimate(FRAME_DELAY);
+			start = Time();
+			_staff.OnAnimate(FRAME_DELAY);
+			staff_ms += Delta(start);
+			_rides_manager.OnAnimate(FRAME_DELAY);
+			_scenery.OnAnimate(FRAME_DELAY);
+		}
+		const double total_ms = Delta(year_start);
+
+		uint dirty_paths;
+		const uint litter = CountLitter(paths, &dirty_paths);
+		printf("%d,%u,%u,%u,%zu,%.1f,%.1f\n", year, _guests.CountGuestsInPark(), litter, dirty_paths, paths.size(), staff_ms, total_ms);
+		fflush(stdout);
+	}
+	return 0;
+}
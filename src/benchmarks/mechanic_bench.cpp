@@ -0,0 +1,263 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file mechanic_bench.cpp Benchmark of sending mechanics to broken rides. */
+
+#include "../stdafx.h"
+#include "../map.h"
+#include "../path_finding.h"
+#include "../people.h"
+#include "../person.h"
+#include "../random.h"
+#include "../ride_type.h"
+#include "../time_func.h"
+#include "game_bench.h"
+
+/** Command-line options of the program. */
+static const OptionData _options[] = {
+	GETOPT_NOVAL('h', "--help"),
+	GETOPT_VALUE('n', "--iterations"),
+	GETOPT_VALUE('m', "--mechanics"),
+	GETOPT_VALUE('b', "--breakdowns"),
+	GAME_BENCH_OPTIONS,
+	GETOPT_END()
+};
+
+/** Output online help. */
+static void PrintUsage()
+{
+	printf("Usage: mechanic_bench [options]\n");
+	printf("Hire mechanics at random paths, let rides break down at the same time, and measure sending a mechanic to each ride.\n");
+	printf("Options:\n");
+	printf("  -h, --help             Display this help text and exit.\n");
+	printf("  -n, --iterations N     Number of times to send the mechanics (default 10).\n");
+	printf("  -m, --mechanics N      Number of mechanics (default 200).\n");
+	printf("  -b, --breakdowns N     Number of broken rides, at most the number of rides with a path at their\n");
+	printf("                         mechanic entrance (default 100).\n");
+	BenchmarkGame::PrintOptions();
+	printf("\n");
+	printf("Every measurement prints one CSV line with the columns measurement, breakdowns, mechanics, iterations, and\n");
+	printf("ms_per_dispatch. 'cold' computes the walking distances to every ride, 'cached' reuses them, and\n");
+	printf("'per_mechanic_search' searches a path from every idle mechanic as the game did before.\n");
+	printf("The program fails if the game assigns a different mechanic to a ride than the path searches do.\n");
+}
+
+/**
+ * Get the voxel in front of the mechanic entrance of a ride.
+ * @param ride Ride to inspect.
+ * @return Voxel where a mechanic arrives at the ride.
+ */
+static XYZPoint16 GetMechanicDestination(const RideInstance *ride)
+{
+	EdgeCoordinate destination = ride->GetMechanicEntrance();
+	destination.coords.x += _tile_dxy[destination.edge].x;
+	destination.coords.y += _tile_dxy[destination.edge].y;
+	return destination.coords;
+}
+
+/**
+ * Find the walking distance from a mechanic to the mechanic entrance of a ride, with a path search.
+ * @param m Mechanic.
+ * @param ride Ride that needs a mechanic.
+ * @return Number of voxels walked, or PathDistanceField::UNREACHABLE if the ride cannot be reached.
+ */
+static uint32 SearchDistance(const Mechanic *m, const RideInstance *ride)
+{
+	PathSearcher ps(m->vox_pos);
+	XYZPoint16 p = GetMechanicDestination(ride);
+	ps.AddStart(p);
+	p.z--;
+	ps.AddStart(p);  // In case the path leading to the mechanic entrance is sloping upwards.
+
+	if (!ps.Search()) return PathDistanceField::UNREACHABLE;
+	uint32 d = 0;
+	for (const WalkedPosition *it = ps.dest_pos; it->prev_pos != nullptr; it = it->prev_pos) d++;
+	return d;
+}
+
+/**
+ * Send the nearest idle mechanic to every ride, by searching a path from every idle mechanic.
+ * @param mechanics All mechanics, in the order of the staff list.
+ * @param rides Rides that need a mechanic, in the order of their requests.
+ * @return For every ride, the assigned mechanic or \c nullptr.
+ */
+static std::vector<const Mechanic *> DispatchBySearching(const std::vector<Mechanic *> &mechanics, const std::vector<RideInstance *> &rides)
+{
+	std::vector<bool> busy(mechanics.size(), false);
+	std::vector<const Mechanic *> assigned;
+	for (const RideInstance *ride : rides) {
+		int best = -1;
+		uint32 distance = 0;
+		for (size_t i = 0; i < mechanics.size(); i++) {
+			if (busy[i]) continue;
+
+			const uint32 d = SearchDistance(mechanics[i], ride);
+			if (d == PathDistanceField::UNREACHABLE) continue;
+
+			if (best < 0 || d < distance) {
+				best = i;
+				distance = d;
+			}
+		}
+		if (best >= 0) busy[best] = true;
+		assigned.push_back(best >= 0 ? mechanics[best] : nullptr);
+	}
+	return assigned;
+}
+
+/**
+ * Let the game send the nearest idle mechanic to every ride, one request per tick.
+ * @param mechanics All mechanics.
+ * @param rides Rides that need a mechanic.
+ * @return For every ride, the assigned mechanic or \c nullptr.
+ */
+static std::vector<const Mechanic *> DispatchByGame(const std::vector<Mechanic *> &mechanics, const std::vector<RideInstance *> &rides)
+{
+	for (Mechanic *m : mechanics) m->ride = nullptr;
+	for (RideInstance *ride : rides) _staff.RequestMechanic(ride);
+
+	std::vector<const Mechanic *> assigned(rides.size(), nullptr);
+	for (size_t i = 0; i < rides.size(); i++) _staff.DoTick();
+	for (const Mechanic *m : mechanics) {
+		for (size_t i = 0; i < rides.size(); i++) {
+			if (m->ride == rides[i]) assigned[i] = m;
+		}
+	}
+	return assigned;
+}
+
+/**
+ * Time a way of sending mechanics, and print the result.
+ * @param name Name of the measurement.
+ * @param rides Number of rides that need a mechanic.
+ * @param mechanics Number of mechanics.
+ * @param iterations Number of runs to time.
+ * @param run Code to time.
+ */
+static void Measure(const char *name, size_t rides, size_t mechanics, int iterations, const std::function<void()> &run)
+{
+	double ms = 0.0;
+	for (int i = 0; i < iterations; i++) {
+		const Realtime start = Time();
+		run();
+		ms += Delta(start);
+	}
+	printf("%s,%zu,%zu,%d,%.3f\n", name, rides, mechanics, iterations, ms / iterations);
+	fflush(stdout);
+}
+
+/**
+ * The main program of the mechanic benchmark.
+ * @param argc Number of argument given to the program.
+ * @param argv Argument texts.
+ * @return Exit code.
+ */
+int main(int argc, char *argv[])
+{
+	GetOptData opt_data(argc - 1, argv + 1, _options);
+	BenchmarkGame game;
+	game.settings.x_size = 127;
+	game.settings.y_size = 127;
+	game.settings.shops = 40;
+	game.settings.gentle_rides = 35;
+	game.settings.thrill_rides = 35;
+	game.settings.guests = 0;
+	game.settings.staff = 0;
+	int iterations = 10;
+	int mechanic_count = 200;
+	int breakdowns = 100;
+
+	int opt_id;
+	do {
+		opt_id = opt_data.GetOpt();
+		bool failed = false;
+		if (game.HandleOption(opt_id, opt_data.opt, &failed)) {
+			if (failed) return 1;
+			continue;
+		}
+		switch (opt_id) {
+			case 'h':
+				PrintUsage();
+				return 0;
+
+			case 'n':
+			case 'm':
+			case 'b': {
+				const int value = atoi(opt_data.opt);
+				if (value < 1) {
+					fprintf(stderr, "ERROR: The value of an option must be positive\n");
+					return 1;
+				}
+				if (opt_id == 'n') iterations = value;
+				if (opt_id == 'm') mechanic_count = value;
+				if (opt_id == 'b') breakdowns = value;
+				break;
+			}
+
+			case -1:
+				break;
+
+			default:
+				/* -2 or some other weird thing happened. */
+				fprintf(stderr, "ERROR while processing the command-line\n");
+				return 1;
+		}
+	} while (opt_id != -1);
+
+	if (!game.LoadData() || !game.LoadPark()) return 1;
+
+	std::vector<XYZPoint16> paths;
+	for (uint16 x = 0; x < _world.GetXSize(); x++) {
+		for (uint16 y = 0; y < _world.GetYSize(); y++) {
+			const VoxelStack *vs = _world.GetStack(x, y);
+			for (int16 i = 0; i < vs->height; i++) {
+				if (HasValidPath(vs->voxels[i].get())) paths.emplace_back(x, y, vs->base + i);
+			}
+		}
+	}
+	/* A mechanic request of a ride without a path at its mechanic entrance would block all later requests. */
+	std::vector<RideInstance *> rides;
+	for (auto &ri : _rides_manager.instances) {
+		if (static_cast<int>(rides.size()) >= breakdowns) break;
+
+		XYZPoint16 p = GetMechanicDestination(ri.second.get());
+		const Voxel *v = _world.GetVoxel(p);
+		p.z--;
+		const Voxel *below = _world.GetVoxel(p);
+		if ((v != nullptr && HasValidPath(v)) || (below != nullptr && HasValidPath(below))) rides.push_back(ri.second.get());
+	}
+	if (paths.empty() || rides.empty()) {
+		fprintf(stderr, "ERROR: The park needs paths and rides\n");
+		return 1;
+	}
+
+	/* Hire the mechanics, and put them at random paths. */
+	Random rnd;
+	std::vector<Mechanic *> mechanics;
+	for (int i = 0; i < mechanic_count; i++) {
+		Mechanic *m = _staff.HireMechanic();
+		m->RemoveSelf(_world.GetCreateVoxel(m->vox_pos, false));
+		m->vox_pos = paths[rnd.Uniform(paths.size() - 1)];
+		m->AddSelf(_world.GetCreateVoxel(m->vox_pos, false));
+		mechanics.push_back(m);
+	}
+
+	const std::vector<const Mechanic *> expected = DispatchBySearching(mechanics, rides);
+	if (DispatchByGame(mechanics, rides) != expected) {
+		fprintf(stderr, "ERROR: The game assigned other mechanics than the path searches\n");
+		return 1;
+	}
+
+	printf("measurement,breakdowns,mechanics,iterations,ms_per_dispatch\n");
+	Measure("cold", rides.size(), mechanics.size(), iterations, [&mechanics, &rides]() {
+		for (const RideInstance *ride : rides) _staff.NotifyRideDeletion(ride);  // Drops the cached distances.
+		DispatchByGame(mechanics, rides);
+	});
+	Measure("cached", rides.size(), mechanics.size(), iterations, [&mechanics, &rides]() { DispatchByGame(mechanics, rides); });
+	Measure("per_mechanic_search", rides.size(), mechanics.size(), iterations, [&mechanics, &rides]() { DispatchBySearching(mechanics, rides); });
+	return 0;
+}
@@ -0,0 +1,287 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file queue_bench.cpp Comparison of the cached walks over queue paths with walking them, on random queue layouts. */
+
+#include "../stdafx.h"
+#include "../map.h"
+#include "../finances.h"
+#include "../path.h"
+#include "../path_build.h"
+#include "../random.h"
+#include "../time_func.h"
+#include "game_bench.h"
+
+/** Command-line options of the program. */
+static const OptionData _options[] = {
+	GETOPT_NOVAL('h', "--help"),
+	GETOPT_VALUE('n', "--layouts"),
+	GETOPT_VALUE('q', "--queues"),
+	GAME_BENCH_OPTIONS,
+	GETOPT_END()
+};
+
+/** Output online help. */
+static void PrintUsage()
+{
+	printf("Usage: queue_bench [options]\n");
+	printf("Build random queues next to the paths of a park, and compare the cached walks over the queues with walking them.\n");
+	printf("Options:\n");
+	printf("  -h, --help             Display this help text and exit.\n");
+	printf("  -n, --layouts N        Number of random queue layouts (default 20).\n");
+	printf("  -q, --queues N         Number of queues in a layout (default 40).\n");
+	BenchmarkGame::PrintOptions();
+	printf("\n");
+	printf("Every layout is checked twice, the second time after removing a voxel of some queues. A check walks from\n");
+	printf("every path voxel in every direction. The program fails if a cached walk differs from walking the queue,\n");
+	printf("otherwise it prints CSV lines with the columns measurement, walks, and ms.\n");
+}
+
+/** Time spent walking over queues. */
+struct Timings {
+	uint64 walks = 0;      ///< Number of walks of each kind.
+	double walk_ms = 0.0;  ///< Time of walking the queues voxel by voxel.
+	double cold_ms = 0.0;  ///< Time of the first cached walks after a change of the path network.
+	double warm_ms = 0.0;  ///< Time of the cached walks when nothing changed.
+};
+
+/**
+ * Collect the voxels with a path.
+ * @param paths [out] Voxels with a path.
+ */
+static void CollectPaths(std::vector<XYZPoint16> *paths)
+{
+	paths->clear();
+	for (uint16 x = 0; x < _world.GetXSize(); x++) {
+		for (uint16 y = 0; y < _world.GetYSize(); y++) {
+			const VoxelStack *vs = _world.GetStack(x, y);
+			for (int16 i = 0; i < vs->height; i++) {
+				if (HasValidPath(vs->voxels[i].get())) paths->emplace_back(x, y, vs->base + i);
+			}
+		}
+	}
+}
+
+/**
+ * Can a queue be extended to a voxel, without touching other paths?
+ * @param pos Voxel to extend the queue to.
+ * @param from Current end of the queue.
+ * @return Whether \a pos is free, and only \a from has a path next to it.
+ */
+static bool CanExtendQueue(const XYZPoint16 &pos, const XYZPoint16 &from)
+{
+	if (!IsVoxelstackInsideWorld(pos.x, pos.y)) return false;
+	const Voxel *v = _world.GetVoxel(pos);
+	if (v != nullptr && HasValidPath(v)) return false;
+
+	for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
+		const XYZPoint16 neighbour(pos.x + _tile_dxy[edge].x, pos.y + _tile_dxy[edge].y, pos.z);
+		if (neighbour == from || !IsVoxelstackInsideWorld(neighbour.x, neighbour.y)) continue;
+		const Voxel *n = _world.GetVoxel(neighbour);
+		if (n != nullptr && HasValidPath(n)) return false;
+	}
+	return true;
+}
+
+/**
+ * Build a queue that winds randomly away from a path. Queues never touch each other, so they do not form cycles.
+ * @param rnd Random number generator.
+ * @param start Path voxel to start the queue at.
+ * @param path_type Type of path to build.
+ * @param queue [out] Voxels of the built queue, from the start.
+ */
+static void BuildQueue(Random &rnd, const XYZPoint16 &start, PathType path_type, std::vector<XYZPoint16> *queue)
+{
+	queue->clear();
+	XYZPoint16 pos = start;
+	TileEdge edge = static_cast<TileEdge>(rnd.Uniform(EDGE_COUNT - 1));
+	for (int i = 0; i < EDGE_COUNT; i++) {  // Leave the path to the side.
+		if (CanExtendQueue(XYZPoint16(pos.x + _tile_dxy[edge].x, pos.y + _tile_dxy[edge].y, pos.z), pos)) break;
+		edge = static_cast<TileEdge>((edge + 1) % EDGE_COUNT);
+	}
+	for (int length = rnd.Uniform(29) + 1; length > 0; length--) {
+		if (rnd.Success1024(300)) edge = static_cast<TileEdge>((edge + (rnd.Success1024(512) ? 1 : 3)) % EDGE_COUNT);  // Turn.
+
+		const XYZPoint16 next(pos.x + _tile_dxy[edge].x, pos.y + _tile_dxy[edge].y, pos.z);
+		if (!CanExtendQueue(next, pos)) break;
+		if (!BuildFlatPath(next, path_type, PAS_QUEUE_PATH, false, false) || !HasValidPath(_world.GetVoxel(next))) break;
+		queue->push_back(next);
+		pos = next;
+	}
+}
+
+/**
+ * Walk from every path voxel in every direction, both cached and voxel by voxel, and compare the results.
+ * @param paths Voxels with a path.
+ * @param timings [inout] Time spent walking.
+ * @return Number of walks with different results.
+ */
+static int CompareWalks(const std::vector<XYZPoint16> &paths, Timings *timings)
+{
+	/** Result of a walk. */
+	struct WalkResult {
+		bool found;       ///< Return value of the walk.
+		XYZPoint16 pos;   ///< Last voxel, if found.
+		TileEdge edge;    ///< Exit edge, if found.
+	};
+	std::vector<WalkResult> walked;
+	std::vector<WalkResult> cached;
+	walked.reserve(paths.size() * EDGE_COUNT);
+	cached.reserve(paths.size() * EDGE_COUNT);
+
+	/** Walk from every path voxel in every direction. */
+	auto walk_all = [&paths](bool (*walk)(XYZPoint16 *, TileEdge *), std::vector<WalkResult> *results) {
+		results->clear();
+		for (const XYZPoint16 &p : paths) {
+			for (TileEdge e = EDGE_BEGIN; e < EDGE_COUNT; e++) {
+				WalkResult r = {false, p, e};
+				r.found = walk(&r.pos, &r.edge);
+				results->push_back(r);
+			}
+		}
+	};
+
+	Realtime start = Time();
+	walk_all(WalkQueuePath, &walked);
+	timings->walk_ms += Delta(start);
+
+	/** Walk over the queue segments. */
+	auto travel = [](XYZPoint16 *voxel_pos, TileEdge *entry) { return TravelQueuePath(voxel_pos, entry); };
+
+	start = Time();
+	walk_all(travel, &cached);
+	timings->cold_ms += Delta(start);
+
+	/** Count the walks with different results. */
+	auto count_mismatches = [&walked, &cached]() {
+		int mismatches = 0;
+		for (size_t i = 0; i < walked.size(); i++) {
+			const WalkResult &w = walked[i];
+			const WalkResult &c = cached[i];
+			if (w.found != c.found || (w.found && (w.pos != c.pos || w.edge != c.edge))) mismatches++;
+		}
+		return mismatches;
+	};
+	int mismatches = count_mismatches();
+
+	start = Time();
+	walk_all(travel, &cached);  // All walks are in the cache now.
+	timings->warm_ms += Delta(start);
+	mismatches += count_mismatches();
+
+	timings->walks += walked.size();
+	return mismatches;
+}
+
+/**
+ * The main program of the queue benchmark.
+ * @param argc Number of argument given to the program.
+ * @param argv Argument texts.
+ * @return Exit code.
+ */
+int main(int argc, char *argv[])
+{
+	GetOptData opt_data(argc - 1, argv + 1, _options);
+	BenchmarkGame game;
+	game.settings.roughness = 0;
+	game.settings.path_spacing = 16;  // Room for long queues.
+	game.settings.shops = 0;
+	game.settings.gentle_rides = 0;
+	game.settings.thrill_rides = 0;
+	game.settings.coasters = 0;
+	game.settings.guests = 0;
+	game.settings.staff = 0;
+	int layouts = 20;
+	int queue_count = 40;
+
+	int opt_id;
+	do {
+		opt_id = opt_data.GetOpt();
+		bool failed = false;
+		if (game.HandleOption(opt_id, opt_data.opt, &failed)) {
+			if (failed) return 1;
+			continue;
+		}
+		switch (opt_id) {
+			case 'h':
+				PrintUsage();
+				return 0;
+
+			case 'n':
+			case 'q': {
+				const int value = atoi(opt_data.opt);
+				if (value < 1) {
+					fprintf(stderr, "ERROR: The value of an option must be positive\n");
+					return 1;
+				}
+				if (opt_id == 'n') layouts = value;
+				if (opt_id == 'q') queue_count = value;
+				break;
+			}
+
+			case -1:
+				break;
+
+			default:
+				/* -2 or some other weird thing happened. */
+				fprintf(stderr, "ERROR while processing the command-line\n");
+				return 1;
+		}
+	} while (opt_id != -1);
+
+	if (!game.LoadData() || !game.LoadPark()) return 1;
+	_finances_manager.DoTransaction(Money(1000000000));  // Building in a park needs cash, even without paying.
+
+	std::vector<XYZPoint16> park_paths;
+	CollectPaths(&park_paths);
+	if (park_paths.empty()) {
+		fprintf(stderr, "ERROR: The park has no paths\n");
+		return 1;
+	}
+	const PathType path_type = GetPathType(_world.GetVoxel(park_paths[0])->GetInstanceData());
+
+	Random rnd;
+	Timings timings;
+	std::vector<XYZPoint16> paths;
+	uint64 queue_voxels = 0;
+	for (int layout = 0; layout < layouts; layout++) {
+		std::vector<std::vector<XYZPoint16>> queues(queue_count);
+		for (std::vector<XYZPoint16> &queue : queues) {
+			BuildQueue(rnd, park_paths[rnd.Uniform(park_paths.size() - 1)], path_type, &queue);
+			queue_voxels += queue.size();
+		}
+
+		CollectPaths(&paths);
+		int mismatches = CompareWalks(paths, &timings);
+
+		/* Cut some queues in two, the cached walks over them must change. */
+		for (std::vector<XYZPoint16> &queue : queues) {
+			if (queue.empty() || !rnd.Success1024(512)) continue;
+			const size_t index = rnd.Uniform(queue.size() - 1);
+			RemovePath(queue[index], false, false);
+			queue.erase(queue.begin() + index);
+		}
+
+		CollectPaths(&paths);
+		mismatches += CompareWalks(paths, &timings);
+		if (mismatches > 0) {
+			fprintf(stderr, "ERROR: %d cached walks over queues differ from walking the queues in layout %d\n", mismatches, layout + 1);
+			return 1;
+		}
+
+		for (const std::vector<XYZPoint16> &queue : queues) {
+			for (const XYZPoint16 &pos : queue) RemovePath(pos, false, false);
+		}
+	}
+
+	printf("measurement,walks,ms\n");
+	printf("walk,%llu,%.3f\n", static_cast<unsigned long long>(timings.walks), timings.walk_ms);
+	printf("cached_cold,%llu,%.3f\n", static_cast<unsigned long long>(timings.walks), timings.cold_ms);
+	printf("cached_warm,%llu,%.3f\n", static_cast<unsigned long long>(timings.walks), timings.warm_ms);
+	fprintf(stderr, "Compared the walks over %llu queue voxels in %d layouts.\n", static_cast<unsigned long long>(queue_voxels), layouts);
+	return 0;
+}
@@ -0,0 +1,756 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file sprite_bench.cpp Benchmark of decoding, recolouring, and scaling the sprites of RCD files. */
+
+#include "../stdafx.h"
+#include "../fileio.h"
+#include "../getoptdata.h"
+#include "../loadsave.h"
+#include "../palette.h"
+#include "../random.h"
+#include "../sprite_data.h"
+#include "../time_func.h"
+#include <cstdarg>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+/**
+ * Error handling for fatal non-user errors.
+ * @param str the string to print.
+ * @note \b Never returns.
+ */
+void error(const char *str, ...)
+{
+	va_list va;
+
+	va_start(va, str);
+	vfprintf(stderr, str, va);
+	va_end(va);
+
+	exit(1);
+}
+
+/*
+ * Recolourings can be loaded from and saved to savegames, which the benchmark never does.
+ * These stand-ins avoid linking the entire game for the savegame code.
+ */
+uint32 Loader::OpenPattern([[maybe_unused]] const char *name, [[maybe_unused]] bool may_fail, [[maybe_unused]] bool name_only) { NOT_REACHED(); }
+void Loader::ClosePattern() { NOT_REACHED(); }
+uint8 Loader::GetByte() { NOT_REACHED(); }
+uint32 Loader::GetLong() { NOT_REACHED(); }
+void Loader::VersionMismatch([[maybe_unused]] uint saved_version, [[maybe_unused]] uint current_version) { NOT_REACHED(); }
+void Saver::CheckNoOpenPattern() const { NOT_REACHED(); }
+void Saver::StartPattern([[maybe_unused]] const char *name, [[maybe_unused]] uint32 version) { NOT_REACHED(); }
+void Saver::EndPattern() { NOT_REACHED(); }
+void Saver::PutByte([[maybe_unused]] uint8 val) { NOT_REACHED(); }
+void Saver::PutLong([[maybe_unused]] uint32 val) { NOT_REACHED(); }
+
+/** Command-line options of the program. */
+static const OptionData _options[] = {
+	GETOPT_NOVAL('h', "--help"),
+	GETOPT_VALUE('n', "--iterations"),
+	GETOPT_VALUE('f', "--fuzz"),
+	GETOPT_END()
+};
+
+/** Output online help. */
+static void PrintUsage()
+{
+	printf("Usage: sprite_bench [--iterations N] [--fuzz M] RCD-FILE ...\n");
+	printf("Measure decoding, recolouring, and scaling of the sprites in the given RCD files.\n");
+	printf("\n");
+	printf("Every benchmark runs N times (default 10), and prints one CSV line with the columns\n");
+	printf("benchmark, images, pixels, iterations, seconds, ns_per_pixel, and checksum.\n");
+	printf("The checksum is a hash of the produced pixels, it should only change when the output of the code changes.\n");
+	printf("\n");
+	printf("With --fuzz, M randomly damaged copies of the sprites of each colour depth are decoded instead, both by the\n");
+	printf("decoders of the game and by a straightforward reference decoder. The program fails if they disagree about\n");
+	printf("accepting a sprite, or about its pixels. It prints CSV lines with the columns fuzz, sprites, and accepted.\n");
+}
+
+/** 64 bit FNV-1a hash of produced pixel data. */
+class Checksum {
+public:
+	Checksum() : hash(0xcbf29ce484222325ULL)
+	{
+	}
+
+	/**
+	 * Add data to the hash.
+	 * @param data First byte of the data.
+	 * @param length Number of bytes of the data.
+	 */
+	void Add(const uint8 *data, size_t length)
+	{
+		for (size_t i = 0; i < length; i++) {
+			this->hash ^= data[i];
+			this->hash *= 0x100000001b3ULL;
+		}
+	}
+
+	/**
+	 * Add an image to the hash.
+	 * @param img Image to add.
+	 */
+	void Add(const ImageData &img)
+	{
+		const size_t pixels = img.width * img.height;
+		this->Add(img.rgba.get(), 4 * pixels);
+		this->Add(img.recol.get(), (img.is_8bpp ? 1 : 2) * pixels);
+	}
+
+	uint64 hash;  ///< Current value of the hash.
+};
+
+/** The images of one colour depth from all RCD files. */
+struct ImageSet {
+	ImageSet() : pixels(0)
+	{
+	}
+
+	std::vector<std::unique_ptr<ImageData>> images;  ///< Decoded images.
+	uint64 pixels;                                   ///< Total number of pixels in #images.
+};
+
+/**
+ * Decode all images of one colour depth in the RCD files.
+ * @param files RCD files to read.
+ * @param is_8bpp Decode the 8bpp images, else decode the 32bpp images.
+ * @param store If not \c nullptr, the decoded images are added to it.
+ * @return Number of decoded images.
+ */
+static uint32 DecodeImages(const std::vector<std::string> &files, bool is_8bpp, ImageSet *store)
+{
+	const char *block_name = is_8bpp ? "8PXL" : "32PX";
+	ImageData scratch;
+	uint32 count = 0;
+	for (const std::string &fname : files) {
+		RcdFileReader rcd_file(fname);
+		if (!rcd_file.CheckFileHeader("RCDF", 2)) error("File '%s' is not an RCD file\n", fname.c_str());
+
+		while (rcd_file.ReadBlockHeader()) {
+			if (strcmp(rcd_file.name, block_name) != 0) {
+				rcd_file.SkipBytes(rcd_file.size);
+				continue;
+			}
+
+			ImageData *img = &scratch;
+			if (store != nullptr) {
+				store->images.emplace_back(new ImageData);
+				img = store->images.back().get();
+			}
+			img->is_8bpp = is_8bpp;
+			if (is_8bpp) {
+				img->Load8bpp(&rcd_file, rcd_file.size);
+			} else {
+				img->Load32bpp(&rcd_file, rcd_file.size);
+			}
+			if (store != nullptr) store->pixels += img->width * img->height;
+			count++;
+		}
+	}
+	return count;
+}
+
+/**
+ * Run a benchmark, and print its results.
+ * @param name Name of the benchmark.
+ * @param images Number of images handled by one run.
+ * @param pixels Number of pixels handled by one run.
+ * @param iterations Number of runs to time.
+ * @param checksum Checksum of the output of one run.
+ * @param run Code to benchmark.
+ */
+static void Measure(const std::string &name, size_t images, uint64 pixels, int iterations, uint64 checksum, const std::function<void()> &run)
+{
+	const Realtime start = Time();
+	for (int i = 0; i < iterations; i++) run();
+	const double seconds = Delta(start) / 1000.0;
+
+	const double ns_per_pixel = (pixels == 0) ? 0.0 : seconds * 1e9 / (static_cast<double>(pixels) * iterations);
+	printf("%s,%zu,%llu,%d,%.6f,%.3f,%016llx\n", name.c_str(), images, static_cast<unsigned long long>(pixels), iterations,
+			seconds, ns_per_pixel, static_cast<unsigned long long>(checksum));
+	fflush(stdout);
+}
+
+/**
+ * Benchmark decoding the images of one colour depth.
+ * @param files RCD files to read.
+ * @param is_8bpp Decode the 8bpp images, else decode the 32bpp images.
+ * @param iterations Number of runs to time.
+ * @param set [out] The decoded images.
+ */
+static void BenchmarkDecoding(const std::vector<std::string> &files, bool is_8bpp, int iterations, ImageSet *set)
+{
+	DecodeImages(files, is_8bpp, set);  // Also warms the file cache of the operating system.
+
+	Checksum checksum;
+	for (const auto &img : set->images) checksum.Add(*img);
+
+	Measure(is_8bpp ? "decode_8bpp" : "decode_32bpp", set->images.size(), set->pixels, iterations, checksum.hash,
+			[&files, is_8bpp]() { DecodeImages(files, is_8bpp, nullptr); });
+}
+
+/**
+ * Benchmark recolouring and gradient shifting a set of images.
+ * @param set Images to recolour.
+ * @param prefix Prefix of the benchmark names.
+ * @param iterations Number of runs to time.
+ */
+static void BenchmarkRecolouring(const ImageSet &set, const std::string &prefix, int iterations)
+{
+	Recolouring recoloured;
+	recoloured.Set(0, RecolourEntry(COL_RANGE_GREY, COL_RANGE_RED));
+	recoloured.Set(1, RecolourEntry(COL_RANGE_BLUE, COL_RANGE_YELLOW));
+	recoloured.Set(2, RecolourEntry(COL_RANGE_GREEN, COL_RANGE_PURPLE));
+	recoloured.Set(3, RecolourEntry(COL_RANGE_ORANGE_BROWN, COL_RANGE_SEA_GREEN));
+
+	struct {
+		const char *name;      ///< Name of the recolouring.
+		Recolouring recolour;  ///< Recolouring to apply.
+	} recolourings[] = {{"plain", Recolouring()}, {"recoloured", recoloured}};
+
+	static const struct {
+		const char *name;     ///< Name of the gradient shift.
+		GradientShift shift;  ///< Gradient shift to apply.
+	} shifts[] = {
+		{"normal", GS_NORMAL}, {"night", GS_NIGHT}, {"day", GS_DAY},
+		{"semi_transparent", GS_SEMI_TRANSPARENT}, {"wireframe", GS_WIREFRAME},
+	};
+
+	for (auto &rc : recolourings) {
+		for (const auto &sh : shifts) {
+			Checksum checksum;
+			for (const auto &img : set.images) {
+				std::unique_ptr<uint8[]> result = img->GetRecoloured(sh.shift, rc.recolour);
+				checksum.Add(result.get(), 4 * img->width * img->height);
+			}
+
+			Measure(prefix + rc.name + "_" + sh.name, set.images.size(), set.pixels, iterations, checksum.hash,
+					[&set, &rc, &sh]() {
+						for (const auto &img : set.images) img->GetRecoloured(sh.shift, rc.recolour);
+					});
+		}
+	}
+}
+
+/**
+ * Scale all images of a set, as drawing them at a different zoom level does.
+ * @param set Images to scale.
+ * @param numerator Numerator of the scaling factor.
+ * @param denominator Denominator of the scaling factor.
+ * @param checksum If not \c nullptr, the scaled images are added to it.
+ */
+static void ScaleImages(const ImageSet &set, int numerator, int denominator, Checksum *checksum)
+{
+	_image_variants = ImageVariants();  // Start with an empty cache, the benchmark should not measure cache hits only.
+	for (const auto &img : set.images) {
+		const int width = img->width * numerator / denominator;
+		if (width < 1 || img->height * numerator / denominator < 1) continue;
+
+		const ImageData *scaled = img->Scale(width);
+		if (checksum != nullptr) checksum->Add(*scaled);
+		_image_variants.Tick();  // The game drops stale cache entries every frame.
+	}
+}
+
+/**
+ * Benchmark scaling a set of images.
+ * @param set Images to scale.
+ * @param prefix Prefix of the benchmark names.
+ * @param iterations Number of runs to time.
+ */
+static void BenchmarkScaling(const ImageSet &set, const std::string &prefix, int iterations)
+{
+	static const struct {
+		const char *name;  ///< Name of the scaling.
+		int numerator;     ///< Numerator of the scaling factor.
+		int denominator;   ///< Denominator of the scaling factor.
+	} scalings[] = {{"down", 1, 2}, {"up", 2, 1}};
+
+	for (const auto &sc : scalings) {
+		Checksum checksum;
+		ScaleImages(set, sc.numerator, sc.denominator, &checksum);
+
+		Measure(prefix + sc.name, set.images.size(), set.pixels, iterations, checksum.hash,
+				[&set, &sc]() { ScaleImages(set, sc.numerator, sc.denominator, nullptr); });
+	}
+	_image_variants = ImageVariants();
+}
+
+/**
+ * Straightforward decoder of the sprite blocks of RCD files, as reference for the decoders of the game.
+ * It writes every pixel separately, and checks every access to the data and to the image.
+ * Damaged data that the decoders of the game must reject is rejected here as well, possibly at a later point.
+ */
+class ReferenceDecoder {
+public:
+	/**
+	 * Constructor.
+	 * @param data Data of the sprite block, without the block header.
+	 */
+	ReferenceDecoder(const std::vector<uint8> &data) : data(data), pos(0)
+	{
+	}
+
+	bool Decode8bpp();
+	bool Decode32bpp();
+
+	uint16 width;              ///< Width of the decoded image.
+	uint16 height;             ///< Height of the decoded image.
+	int16 xoffset;             ///< Horizontal offset of the decoded image.
+	int16 yoffset;             ///< Vertical offset of the decoded image.
+	std::vector<uint8> rgba;   ///< Decoded pixels.
+	std::vector<uint8> recol;  ///< Decoded recolour information.
+
+private:
+	/**
+	 * Read a byte of the data.
+	 * @param offset Offset of the byte.
+	 * @param val [out] The read byte.
+	 * @return Whether the byte exists.
+	 */
+	bool Get(size_t offset, uint8 *val) const
+	{
+		if (offset >= this->data.size()) return false;
+		*val = this->data[offset];
+		return true;
+	}
+
+	/**
+	 * Read a little-endian 16 bit value of the header.
+	 * @return The read value.
+	 * @pre The header has been checked to exist.
+	 */
+	uint16 GetWord()
+	{
+		uint16 val = this->data[this->pos] | (this->data[this->pos + 1] << 8);
+		this->pos += 2;
+		return val;
+	}
+
+	/**
+	 * Append a pixel to the image.
+	 * @param r Red colour component.
+	 * @param g Green colour component.
+	 * @param b Blue colour component.
+	 * @param a Opacity.
+	 * @param recolour Recolour bytes of the pixel (one byte for 8bpp images, else two).
+	 * @return Whether the pixel fits in the image.
+	 */
+	bool Put(uint8 r, uint8 g, uint8 b, uint8 a, std::initializer_list<uint8> recolour)
+	{
+		if (this->rgba.size() >= 4u * this->width * this->height) return false;
+		this->rgba.insert(this->rgba.end(), {r, g, b, a});
+		this->recol.insert(this->recol.end(), recolour);
+		return true;
+	}
+
+	bool ReadHeader(int max_width, int max_height);
+
+	const std::vector<uint8> &data;  ///< Data of the sprite block.
+	size_t pos;                      ///< Read position in #data.
+};
+
+/**
+ * Read the size and offsets of the image.
+ * @param max_width Largest allowed width.
+ * @param max_height Largest allowed height.
+ * @return Whether the header is valid.
+ */
+bool ReferenceDecoder::ReadHeader(int max_width, int max_height)
+{
+	if (this->data.size() < 8) return false;
+	this->width = this->GetWord();
+	this->height = this->GetWord();
+	this->xoffset = this->GetWord();
+	this->yoffset = this->GetWord();
+	return this->width > 0 && this->width <= max_width && this->height > 0 && this->height <= max_height;
+}
+
+/**
+ * Decode an 8bpp sprite.
+ * @return Whether the sprite is valid.
+ */
+bool ReferenceDecoder::Decode8bpp()
+{
+	if (!this->ReadHeader(300, 500)) return false;
+	if (this->data.size() - 8 > 100 * 1024) return false;
+
+	const size_t jmp_table = 4 * this->height;
+	if (this->data.size() - 8 <= jmp_table) return false;
+	const size_t base = 8 + jmp_table;  // Start of the line data.
+	const size_t length = this->data.size() - base;
+
+	for (uint y = 0; y < this->height; y++) {
+		uint32 dest = this->data[8 + 4 * y] | (this->data[9 + 4 * y] << 8) | (this->data[10 + 4 * y] << 16) | (this->data[11 + 4 * y] << 24);
+		uint32 xpos = 0;
+		if (dest != 0) {
+			dest -= jmp_table;
+			if (dest >= length) return false;
+
+			size_t offset = dest;
+			for (;;) {
+				if (offset + 2 >= length) return false;
+				const uint8 rel_pos = this->data[base + offset];
+				const uint8 count = this->data[base + offset + 1];
+				for (int i = 0; i < (rel_pos & 127); i++) {
+					if (!this->Put(0, 0, 0, 0, {0})) return false;
+				}
+				xpos += (rel_pos & 127) + count;
+				for (int i = 0; i < count; i++) {
+					uint8 pixel;
+					if (!this->Get(base + offset + 2 + i, &pixel)) return false;
+					const uint32 rgba = _palette[pixel];
+					if (!this->Put(GetR(rgba), GetG(rgba), GetB(rgba), GetA(rgba), {pixel})) return false;
+				}
+				offset += 2 + count;
+				if ((rel_pos & 128) == 0) {
+					if (xpos >= this->width || offset >= length) return false;
+				} else {
+					if (xpos > this->width || offset > length) return false;
+					break;
+				}
+			}
+		}
+		for (; xpos < this->width; xpos++) {
+			if (!this->Put(0, 0, 0, 0, {0})) return false;
+		}
+	}
+	return this->rgba.size() == 4u * this->width * this->height;
+}
+
+/**
+ * Decode a 32bpp sprite.
+ * @return Whether the sprite is valid.
+ */
+bool ReferenceDecoder::Decode32bpp()
+{
+	if (!this->ReadHeader(2000, 1200)) return false;
+	if (this->data.size() - 8 > 2000 * 1200) return false;
+
+	const size_t abs_end = this->data.size();
+	uint line_count = 0;
+	bool finished = false;
+	while (this->pos < abs_end && !finished) {
+		line_count++;
+
+		uint8 low, high;
+		if (!this->Get(this->pos, &low) || !this->Get(this->pos + 1, &high)) return false;
+		const uint16 line_length = low | (high << 8);
+		size_t end = abs_end;
+		if (line_length == 0) {
+			finished = true;
+		} else {
+			end = this->pos + line_length;
+			if (end > abs_end) return false;
+		}
+		this->pos += 2;
+
+		bool finished_line = false;
+		uint xpos = 0;
+		while (this->pos < end && !finished_line) {
+			const uint8 mode = this->data[this->pos++];
+			if (mode == 0) {
+				for (; xpos < this->width; xpos++) {
+					if (!this->Put(0, 0, 0, 0, {0, 0})) return false;
+				}
+				finished_line = true;
+				break;
+			}
+			xpos += mode & 0x3F;
+			uint8 alpha = 255;
+			uint8 layer = 0;
+			if ((mode >> 6) == 1 && !this->Get(this->pos++, &alpha)) return false;
+			if ((mode >> 6) == 3 && (!this->Get(this->pos++, &layer) || !this->Get(this->pos++, &alpha))) return false;
+			for (int i = mode & 0x3F; i > 0; i--) {
+				uint8 r = 0, g = 0, b = 0;
+				bool fits;
+				switch (mode >> 6) {
+					case 0:  // Fully opaque colour.
+					case 1:  // Semi-transparent colour.
+						if (!this->Get(this->pos, &r) || !this->Get(this->pos + 1, &g) || !this->Get(this->pos + 2, &b)) return false;
+						this->pos += 3;
+						fits = this->Put(r, g, b, alpha, {0, 0});
+						break;
+
+					case 2:  // Fully transparent.
+						fits = this->Put(0, 0, 0, 0, {0, 0});
+						break;
+
+					default: {  // Recolour layer.
+						uint8 intensity;
+						if (!this->Get(this->pos++, &intensity)) return false;
+						fits = this->Put(0, 0, 0, alpha, {layer, intensity});
+						break;
+					}
+				}
+				if (!fits) return false;
+			}
+		}
+		if (xpos > this->width || !finished_line || this->pos != end) return false;
+	}
+	return line_count == this->height && this->pos == abs_end && this->rgba.size() == 4u * this->width * this->height;
+}
+
+/** A sprite block of an RCD file. */
+struct SpriteBlock {
+	char name[5];               ///< Name of the block.
+	uint32 version;             ///< Version of the block.
+	std::vector<uint8> data;    ///< Data of the block, without the block header.
+};
+
+/**
+ * Read the sprite blocks of one colour depth from the RCD files.
+ * @param files RCD files to read.
+ * @param is_8bpp Read the 8bpp sprites, else read the 32bpp sprites.
+ * @param blocks [out] The read blocks.
+ */
+static void ReadSpriteBlocks(const std::vector<std::string> &files, bool is_8bpp, std::vector<SpriteBlock> *blocks)
+{
+	const char *block_name = is_8bpp ? "8PXL" : "32PX";
+	for (const std::string &fname : files) {
+		RcdFileReader rcd_file(fname);
+		if (!rcd_file.CheckFileHeader("RCDF", 2)) error("File '%s' is not an RCD file\n", fname.c_str());
+
+		while (rcd_file.ReadBlockHeader()) {
+			if (strcmp(rcd_file.name, block_name) != 0) {
+				rcd_file.SkipBytes(rcd_file.size);
+				continue;
+			}
+			blocks->emplace_back();
+			SpriteBlock &block = blocks->back();
+			memcpy(block.name, rcd_file.name, sizeof(block.name));
+			block.version = rcd_file.version;
+			block.data.resize(rcd_file.size);
+			rcd_file.GetBlob(block.data.data(), block.data.size());
+		}
+	}
+}
+
+/**
+ * Draw a random number.
+ * @param rnd Random number generator.
+ * @param upper Upper bound of the number.
+ * @return Number between \c 0 and \a upper (exclusive).
+ */
+static size_t RandomBelow(Random &rnd, size_t upper)
+{
+	const size_t val = (static_cast<size_t>(rnd.Uniform(0xFFFF)) << 16) | rnd.Uniform(0xFFFF);
+	return val % upper;
+}
+
+/**
+ * Damage a sprite block, by changing some bytes, and sometimes its length.
+ * @param rnd Random number generator.
+ * @param data [inout] Data of the block.
+ */
+static void DamageBlock(Random &rnd, std::vector<uint8> *data)
+{
+	for (int i = rnd.Uniform(3); i >= 0 && !data->empty(); i--) {
+		/* Damage the header and the start of the data more often, they decide how the remainder is read. */
+		const size_t upper = rnd.Success1024(256) ? std::min<size_t>(data->size(), 16) : data->size();
+		(*data)[RandomBelow(rnd, upper)] = rnd.Uniform(255);
+	}
+	if (rnd.Success1024(128)) data->resize(RandomBelow(rnd, data->size() + 1));
+	if (rnd.Success1024(64)) {
+		for (int i = rnd.Uniform(7); i >= 0; i--) data->push_back(rnd.Uniform(255));
+	}
+}
+
+/**
+ * Write sprite blocks to an RCD file.
+ * @param fname Name of the file.
+ * @param blocks Blocks to write.
+ * @param entries [out] Positions of the blocks in the file.
+ */
+static void WriteSpriteBlocks(const std::string &fname, const std::vector<SpriteBlock> &blocks, std::vector<RcdBlockEntry> *entries)
+{
+	FILE *fp = fopen(fname.c_str(), "wb");
+	if (fp == nullptr) error("Cannot write file '%s'\n", fname.c_str());
+
+	/** Write a little-endian 32 bit value. */
+	auto put_long = [fp](uint32 val) {
+		const uint8 bytes[4] = {static_cast<uint8>(val), static_cast<uint8>(val >> 8), static_cast<uint8>(val >> 16), static_cast<uint8>(val >> 24)};
+		fwrite(bytes, 1, 4, fp);
+	};
+
+	fwrite("RCDF", 1, 4, fp);
+	put_long(2);
+	uint32 offset = 8;
+	entries->clear();
+	for (const SpriteBlock &block : blocks) {
+		entries->emplace_back();
+		RcdBlockEntry &entry = entries->back();
+		memcpy(entry.name, block.name, sizeof(entry.name));
+		entry.version = block.version;
+		entry.offset = offset;
+		entry.size = block.data.size();
+
+		fwrite(block.name, 1, 4, fp);
+		put_long(block.version);
+		put_long(block.data.size());
+		if (!block.data.empty()) fwrite(block.data.data(), 1, block.data.size(), fp);
+		offset += 12 + block.data.size();
+	}
+	if (fclose(fp) != 0) error("Cannot write file '%s'\n", fname.c_str());
+}
+
+/**
+ * Decode damaged sprites of one colour depth with the decoders of the game and with the reference decoder, and compare the results.
+ * @param files RCD files with the sprites to damage.
+ * @param is_8bpp Fuzz the 8bpp decoder, else fuzz the 32bpp decoder.
+ * @param count Number of damaged sprites to decode.
+ * @return Number of sprites where the decoders disagree.
+ */
+static int FuzzDecoding(const std::vector<std::string> &files, bool is_8bpp, int count)
+{
+	std::vector<SpriteBlock> originals;
+	ReadSpriteBlocks(files, is_8bpp, &originals);
+	if (originals.empty()) return 0;
+
+	const std::string fname = (std::filesystem::temp_directory_path() / "sprite_bench_fuzz.rcd").string();
+	const char *depth = is_8bpp ? "8bpp" : "32bpp";
+	static const int BATCH_SIZE = 1000;  ///< Number of damaged sprites in a file.
+
+	Random rnd;
+	int mismatches = 0;
+	int accepted = 0;
+	std::vector<SpriteBlock> damaged;
+	std::vector<RcdBlockEntry> entries;
+	for (int done = 0; done < count; done += BATCH_SIZE) {
+		damaged.clear();
+		for (int i = 0; i < std::min(BATCH_SIZE, count - done); i++) {
+			damaged.push_back(originals[RandomBelow(rnd, originals.size())]);
+			DamageBlock(rnd, &damaged.back().data);
+		}
+		WriteSpriteBlocks(fname, damaged, &entries);
+
+		RcdFileReader rcd_file(fname);
+		if (!rcd_file.CheckFileHeader("RCDF", 2)) error("Cannot read file '%s'\n", fname.c_str());
+		for (size_t i = 0; i < damaged.size(); i++) {
+			if (!rcd_file.SeekBlock(entries[i])) error("Cannot read file '%s'\n", fname.c_str());
+			ImageData img;
+			img.is_8bpp = is_8bpp;
+			bool game_ok = true;
+			try {
+				if (is_8bpp) {
+					img.Load8bpp(&rcd_file, rcd_file.size);
+				} else {
+					img.Load32bpp(&rcd_file, rcd_file.size);
+				}
+			} catch (const LoadingError &) {
+				game_ok = false;
+			}
+
+			ReferenceDecoder ref(damaged[i].data);
+			const bool ref_ok = is_8bpp ? ref.Decode8bpp() : ref.Decode32bpp();
+			bool same = game_ok == ref_ok;
+			if (same && game_ok) {
+				const size_t pixels = img.width * img.height;
+				same = img.width == ref.width && img.height == ref.height && img.xoffset == ref.xoffset && img.yoffset == ref.yoffset &&
+						memcmp(img.rgba.get(), ref.rgba.data(), 4 * pixels) == 0 &&
+						memcmp(img.recol.get(), ref.recol.data(), (is_8bpp ? 1 : 2) * pixels) == 0;
+			}
+			if (!same) {
+				fprintf(stderr, "ERROR: Decoding damaged %s sprite %d differs (game %s, reference %s)\n", depth, done + static_cast<int>(i) + 1,
+						game_ok ? "accepts" : "rejects", ref_ok ? "accepts" : "rejects");
+				mismatches++;
+			}
+			if (game_ok) accepted++;
+		}
+	}
+	std::error_code error_code;
+	std::filesystem::remove(fname, error_code);
+
+	printf("%s,%d,%d\n", depth, count, accepted);
+	fflush(stdout);
+	return mismatches;
+}
+
+/**
+ * The main program of the sprite benchmark.
+ * @param argc Number of argument given to the program.
+ * @param argv Argument texts.
+ * @return Exit code.
+ */
+int main(int argc, char *argv[])
+{
+	GetOptData opt_data(argc - 1, argv + 1, _options);
+	int iterations = 10;
+	int fuzz_count = 0;
+
+	int opt_id;
+	do {
+		opt_id = opt_data.GetOpt();
+		switch (opt_id) {
+			case 'h':
+				PrintUsage();
+				return 0;
+
+			case 'n':
+				iterations = atoi(opt_data.opt);
+				if (iterations < 1) {
+					fprintf(stderr, "ERROR: The number of iterations must be positive\n");
+					return 1;
+				}
+				break;
+
+			case 'f':
+				fuzz_count = atoi(opt_data.opt);
+				if (fuzz_count < 1) {
+					fprintf(stderr, "ERROR: The number of damaged sprites must be positive\n");
+					return 1;
+				}
+				break;
+
+			case -1:
+				break;
+
+			default:
+				/* -2 or some other weird thing happened. */
+				fprintf(stderr, "ERROR while processing the command-line\n");
+				return 1;
+		}
+	} while (opt_id != -1);
+
+	if (opt_data.numleft < 1) {
+		PrintUsage();
+		return 1;
+	}
+	std::vector<std::string> files(opt_data.argv, opt_data.argv + opt_data.numleft);
+
+	if (fuzz_count > 0) {
+		printf("fuzz,sprites,accepted\n");
+		int mismatches = 0;
+		try {
+			for (bool is_8bpp : {true, false}) mismatches += FuzzDecoding(files, is_8bpp, fuzz_count);
+		} catch (const LoadingError &e) {
+			fprintf(stderr, "ERROR: %s\n", e.what());
+			return 1;
+		}
+		return mismatches > 0 ? 1 : 0;
+	}
+
+	printf("benchmark,images,pixels,iterations,seconds,ns_per_pixel,checksum\n");
+	try {
+		for (bool is_8bpp : {true, false}) {
+			ImageSet set;
+			BenchmarkDecoding(files, is_8bpp, iterations, &set);
+
+			const std::string depth = is_8bpp ? "8bpp_" : "32bpp_";
+			BenchmarkRecolouring(set, "recolour_" + depth, iterations);
+			BenchmarkScaling(set, "scale_" + depth, iterations);
+		}
+	} catch (const LoadingError &e) {
+		fprintf(stderr, "ERROR: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -8,14 +8,17 @@
 /** @file coaster.cpp Coaster type data. */
 
 #include <cmath>
+#include <unordered_map>
 #include "stdafx.h"
 #include "sprite_store.h"
 #include "coaster.h"
 #include "fileio.h"
+#include "finances.h"
 #include "memory.h"
 #include "map.h"
 #include "messages.h"
 #include "people.h"
+#include "replay.h"
 #include "sprite_data.h"
 #include "viewport.h"
 
@@ -886,7 +889,9 @@ CoasterInstance::CoasterInstance(const CoasterType *ct, const CarType *init_car_
 	temp_entrance_pos(XYZPoint16::invalid()),
 	temp_exit_pos(XYZPoint16::invalid()),
 	max_idle_duration(30000),
-	min_idle_duration(5000)
+	min_idle_duration(5000),
+	surroundings_stamp(0),
+	surroundings_bonus(0)
 {
 	for (uint i = 0; i < lengthof(this->trains); i++) {
 		CoasterTrain &train = this->trains[i];
@@ -1199,6 +1204,7 @@ void CoasterInstance::RemoveStationsFromWorld()
 						voxel->ClearInstances();
 					}
 				}
+				_world.MarkStackDirty(p.x, p.y);
 				AddRemovePathEdges(p, PATH_EMPTY, EDGE_ALL, PAS_UNUSED);
 			}
 		}
@@ -1221,6 +1227,7 @@ void CoasterInstance::InsertStationsIntoWorld()
 					voxel->SetInstance(index);
 					voxel->SetInstanceData(ENTRANCE_OR_EXIT);
 				}
+				_world.MarkStackDirty(p.x, p.y);
 				AddRemovePathEdges(p, PATH_EMPTY, GetEntranceDirections(p), entrance ? PAS_QUEUE_PATH : PAS_NORMAL_PATH);
 			}
 		}
@@ -1280,6 +1287,7 @@ int CoasterInstance::FindPredecessorPiece(const PositionedTrackPiece &placed)
 bool CoasterInstance::MakePositionedPiecesLooping(bool *modified)
 {
 	this->UpdateStations();
+	this->surroundings.clear();
 	if (modified != nullptr) *modified = false;
 
 	/* First step, move all non-null track pieces to the start of the array. */
@@ -1340,6 +1348,7 @@ int CoasterInstance::AddPositionedPiece(const PositionedTrackPiece &placed)
 		if (this->pieces[i].piece == nullptr) {
 			this->pieces[i] = placed;
 			this->pieces[i].return_cost = -this->pieces[i].piece->cost;
+			this->surroundings.clear();
 			if (placed.piece->IsStartingPiece()) this->UpdateStations();
 			return i;
 		}
@@ -1359,6 +1368,48 @@ void CoasterInstance::RemovePositionedPiece(PositionedTrackPiece &piece)
 	piece.piece = nullptr;
 }
 
+/**
+ * Build a track piece, or a saved track design starting at its position, and pay for it.
+ * @param placed Positioned track piece to build.
+ * @param design Index of the saved track design to build, or \c -1 to build only \a placed.
+ * @param direction Direction to build the track design in.
+ * @return Index of the last added positioned track piece.
+ * @pre placed.CanBePlaced() should hold, and the track design must fit.
+ */
+int CoasterInstance::BuildTrackPiece(const PositionedTrackPiece &placed, int16 design, TileEdge direction)
+{
+	const CoasterType *ct = this->GetCoasterType();
+	ReplayCommand cmd(RCT_BUILD_TRACK_PIECE);
+	cmd.instance = this->GetIndex();
+	cmd.pos = placed.base_voxel;
+	cmd.value = ct->GetPieceIndex(placed.piece);
+	cmd.data[0] = direction;
+	cmd.size.x = design;
+	_replay.Record(cmd);
+
+	int ptp_index = -1;
+	if (design < 0) {
+		ptp_index = this->AddPositionedPiece(placed);
+	} else {
+		const TrackedRideDesign &trd = ct->designs.at(design);
+
+		XYZPoint16 pos = placed.base_voxel;
+		for (const TrackedRideDesign::AbstractTrackPiece &abstract_piece : trd.pieces) {
+			int piece_id = ct->GetRotatedPieceIndex(ct->pieces.at(ct->GetPieceIndex(abstract_piece.piece_name)), direction);
+			assert(piece_id >= 0);
+			ConstTrackPiecePtr piece = ct->pieces.at(piece_id);
+			ptp_index = this->AddPositionedPiece(PositionedTrackPiece(pos, piece));
+			assert(ptp_index >= 0);  // The caller checked that placing this design is permitted.
+			pos += piece->exit_dxyz;
+		}
+	}
+	assert(ptp_index >= 0);
+
+	this->PlaceTrackPieceInWorld(placed);
+	_finances_manager.PayRideConstruct(placed.piece->cost);
+	return ptp_index;
+}
+
 /**
  * Get the number of this ride.
  * @return The (unique) number of this ride.
@@ -1390,12 +1441,14 @@ void CoasterInstance::PlaceTrackPieceInWorld(const PositionedTrackPiece &placed)
 {
 	assert(placed.CanBePlaced() == STR_NULL);
 	SmallRideInstance ride_number = this->GetRideNumber();
+	this->surroundings.clear();
 
 	for (const auto& tvx : placed.piece->track_voxels) {
 		Voxel *vx = _world.GetCreateVoxel(placed.base_voxel + tvx->dxyz, true);
 		// assert(vx->CanPlaceInstance()): Checked by this->CanBePlaced().
 		vx->SetInstance(ride_number);
 		vx->SetInstanceData(this->GetInstanceData(tvx.get()));
+		_world.MarkStackDirty(placed.base_voxel.x + tvx->dxyz.x, placed.base_voxel.y + tvx->dxyz.y);
 	}
 }
 
@@ -1405,11 +1458,13 @@ void CoasterInstance::PlaceTrackPieceInWorld(const PositionedTrackPiece &placed)
  */
 void CoasterInstance::RemoveTrackPieceInWorld(const PositionedTrackPiece &placed)
 {
+	this->surroundings.clear();
 	for (const auto& tvx : placed.piece->track_voxels) {
 		Voxel *vx = _world.GetCreateVoxel(placed.base_voxel + tvx->dxyz, false);
 		assert(vx->GetInstance() == this->GetRideNumber());
 		vx->SetInstance(SRI_FREE);
 		vx->SetInstanceData(0); // Not really needed.
+		_world.MarkStackDirty(placed.base_voxel.x + tvx->dxyz.x, placed.base_voxel.y + tvx->dxyz.y);
 	}
 }
 
@@ -1903,40 +1958,77 @@ void CoasterInstance::RecalculateRatings()
 	nau /= statpoints;
 	exc /= statpoints;
 
-	std::set<XYZPoint16> considered_locations;
-	const uint16 index = this->GetIndex();
+	exc += this->GetSurroundingsBonus();
+
+	exc -= std::min(exc / 2, nau);
+	exc -= std::min(exc / 2, iny);
+
+	this->intensity_rating  = iny;
+	this->nausea_rating     = nau;
+	this->excitement_rating = exc;
+}
+
+static_assert(WORLD_Z_SIZE <= 64, "The heights of a voxel stack must fit in CoasterSurroundings::heights.");
+
+/** Collect the voxel stacks near the track, with the heights of the voxels near the track in each stack. */
+void CoasterInstance::CollectSurroundings()
+{
+	this->surroundings.clear();
+	std::unordered_map<uint32, size_t> stack_indices;  // Index in #surroundings of each voxel stack.
 	const int start_piece = GetFirstPlacedTrackPiece();
 	for (int p = start_piece;;) {
+		const XYZPoint16 &base = this->pieces[p].base_voxel;
 		for (int dx = -2; dx <= 2; dx++) {
 			for (int dy = -2; dy <= 2; dy++) {
-				if (!IsVoxelstackInsideWorld(this->pieces[p].base_voxel.x + dx, this->pieces[p].base_voxel.y + dy)) continue;
-				for (int dh = -4; dh <= 2; dh++) {
-					XYZPoint16 pos(dx, dy, dh);
-					pos += this->pieces[p].base_voxel;
+				if (!IsVoxelstackInsideWorld(base.x + dx, base.y + dy)) continue;
 
-					if (considered_locations.count(pos)) continue;
-					considered_locations.insert(pos);
+				const Point16 pos(base.x + dx, base.y + dy);
+				const auto inserted = stack_indices.emplace(pos.x + pos.y * WORLD_X_SIZE, this->surroundings.size());
+				if (inserted.second) this->surroundings.push_back({pos, 0, 0});
 
-					Voxel *voxel = _world.GetCreateVoxel(pos, false);
-					if (voxel == nullptr) continue;
-
-					if (IsImplodedSteepSlope(voxel->GetGroundSlope()))                 exc += 2;
-					if (voxel->instance == SRI_SCENERY)                                exc += 4;
-					if (voxel->instance >= SRI_FULL_RIDES && voxel->instance != index) exc += 7;
-					/* \todo Also give a bonus for accurately mowed lawns and building near water. */
-				}
+				CoasterSurroundings &stack = this->surroundings[inserted.first->second];
+				for (int z = std::max(base.z - 4, 0); z <= std::min(base.z + 2, WORLD_Z_SIZE - 1); z++) stack.heights |= static_cast<uint64>(1) << z;
 			}
 		}
 		p = FindSuccessorPiece(this->pieces[p]);
 		if (p < 0 || p == start_piece) break;
 	}
+}
 
-	exc -= std::min(exc / 2, nau);
-	exc -= std::min(exc / 2, iny);
+/**
+ * Get the excitement bonus of the surroundings of the track.
+ * The bonus of a voxel stack near the track is only computed again after the stack has changed.
+ * @return The excitement bonus.
+ */
+uint64 CoasterInstance::GetSurroundingsBonus()
+{
+	const uint32 stamp = _world.GetChangeStamp();
+	const bool collect = this->surroundings.empty();
+	if (!collect && stamp == this->surroundings_stamp) return this->surroundings_bonus;
 
-	this->intensity_rating  = iny;
-	this->nausea_rating     = nau;
-	this->excitement_rating = exc;
+	if (collect) this->CollectSurroundings();
+	const uint16 index = this->GetIndex();
+	this->surroundings_bonus = 0;
+	for (CoasterSurroundings &stack : this->surroundings) {
+		if (collect || _world.GetStackChangeStamp(stack.pos.x, stack.pos.y) > this->surroundings_stamp) {
+			const VoxelStack *vs = _world.GetStack(stack.pos.x, stack.pos.y);
+			stack.bonus = 0;
+			for (int z = 0; z < WORLD_Z_SIZE; z++) {
+				if ((stack.heights & (static_cast<uint64>(1) << z)) == 0) continue;
+
+				const Voxel *voxel = vs->Get(z);
+				if (voxel == nullptr) continue;
+
+				if (IsImplodedSteepSlope(voxel->GetGroundSlope()))                 stack.bonus += 2;
+				if (voxel->instance == SRI_SCENERY)                                stack.bonus += 4;
+				if (voxel->instance >= SRI_FULL_RIDES && voxel->instance != index) stack.bonus += 7;
+				/* \todo Also give a bonus for accurately mowed lawns and building near water. */
+			}
+		}
+		this->surroundings_bonus += stack.bonus;
+	}
+	this->surroundings_stamp = stamp;
+	return this->surroundings_bonus;
 }
 
 void CoasterInstance::Load(Loader &ldr)
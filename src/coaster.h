@@ -200,6 +200,13 @@ struct CoasterIntensityStatistics {
 };
 static const int COASTER_INTENSITY_STATISTICS_SAMPLING_PRECISION = 0x8000;  ///< Minimum distance of two points in a coaster's intensity statistics map.
 
+/** A voxel stack near the track of a coaster, with the excitement bonus of its surroundings. */
+struct CoasterSurroundings {
+	Point16 pos;    ///< Position of the voxel stack.
+	uint64 heights; ///< Bit set of the heights of the voxels near the track.
+	uint32 bonus;   ///< Excitement bonus of the voxels at #heights.
+};
+
 /**
  * A roller coaster in the world.
  * Since roller coaster rides need to be constructed by the user first, an instance can exist
@@ -245,6 +252,7 @@ public:
 	int GetFirstPlacedTrackPiece() const;
 	int AddPositionedPiece(const PositionedTrackPiece &placed);
 	void RemovePositionedPiece(PositionedTrackPiece &piece);
+	int BuildTrackPiece(const PositionedTrackPiece &placed, int16 design, TileEdge direction);
 
 	int FindSuccessorPiece(const XYZPoint16 &vox, uint8 entry_connect, int start = 0, int end = MAX_PLACED_TRACK_PIECES);
 	int FindSuccessorPiece(const PositionedTrackPiece &placed);
@@ -302,6 +310,14 @@ public:
 	int max_idle_duration;                 ///< Maximum duration how long a train may wait in a station in milliseconds.
 	int min_idle_duration;                 ///< Minimum duration how long a train may wait in a station in milliseconds.
 	std::map<uint32, CoasterIntensityStatistics> intensity_statistics;  ///< Intensity along the track.
+
+private:
+	void CollectSurroundings();
+	uint64 GetSurroundingsBonus();
+
+	std::vector<CoasterSurroundings> surroundings; ///< Voxel stacks near the track, empty if they must be collected again.
+	uint32 surroundings_stamp;                     ///< World change stamp at which the bonus of the #surroundings was computed.
+	uint64 surroundings_bonus;                     ///< Total excitement bonus of the #surroundings.
 };
 
 void LoadCoasterPlatform(RcdFileReader *rcd_file);
@@ -20,6 +20,7 @@
 #include "entity_gui.h"
 #include "finances.h"
 #include "gamecontrol.h"
+#include "replay.h"
 
 /** Window to prompt for removing a roller coaster. */
 class CoasterRemoveWindow : public EntityRemoveWindow  {
@@ -50,6 +51,7 @@ void CoasterRemoveWindow::OnClick(WidgetNumber number, [[maybe_unused]] const Po
 
 		delete GetWindowByType(WC_COASTER_MANAGER, this->ci->GetIndex());
 
+		RecordRideDeletion(this->ci, cost);
 		_rides_manager.DeleteInstance(this->ci->GetIndex());
 	}
 	delete this;
@@ -277,6 +279,7 @@ private:
  */
 CoasterInstanceWindow::CoasterInstanceWindow(CoasterInstance *instance) : GuiWindow(WC_COASTER_MANAGER, instance->GetIndex()), ci(instance)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The state and the ratings of the coaster change all the time.
 	this->SetupWidgetTree(_coaster_instance_gui_parts, lengthof(_coaster_instance_gui_parts));
 	this->SetCoasterState();
 	this->UpdateRecolourButtons();
@@ -301,6 +304,7 @@ CoasterInstanceWindow::~CoasterInstanceWindow()
 {
 	SetSelector(nullptr);
 	if (!GetWindowByType(WC_COASTER_BUILD, this->wnumber) && !this->ci->IsAccessible()) {
+		RecordRideDeletion(this->ci, Money(0));
 		_rides_manager.DeleteInstance(this->ci->GetIndex());
 	}
 }
@@ -478,6 +482,7 @@ void CoasterInstanceWindow::OnClick(WidgetNumber widget, [[maybe_unused]] const
 
 		case CIW_EDIT:
 			this->ci->CloseRide();
+			RecordRideState(this->ci);
 			ShowCoasterBuildGui(this->ci);
 			delete this;  // The user must not change ride settings while the coaster is under construction.
 			break;
@@ -489,50 +494,63 @@ void CoasterInstanceWindow::OnClick(WidgetNumber widget, [[maybe_unused]] const
 
 		case CIW_MAINTENANCE_INCREASE:
 			this->ci->maintenance_interval += MAINTENANCE_INTERVAL_STEP_SIZE;
+			RecordRideSetting(this->ci, RRS_MAINTENANCE_INTERVAL, this->ci->maintenance_interval);
 			this->SetCoasterState();
 			break;
 		case CIW_MAINTENANCE_DECREASE:
 			this->ci->maintenance_interval -= MAINTENANCE_INTERVAL_STEP_SIZE;
+			RecordRideSetting(this->ci, RRS_MAINTENANCE_INTERVAL, this->ci->maintenance_interval);
 			this->SetCoasterState();
 			break;
 		case CIW_ENTRANCE_FEE_INCREASE:
 			this->ci->item_price[0] += RIDE_ENTRANCE_FEE_STEP_SIZE;
+			RecordItemPrice(this->ci, 0);
 			this->SetCoasterState();
 			break;
 		case CIW_ENTRANCE_FEE_DECREASE:
 			this->ci->item_price[0] = std::max<int>(0, this->ci->item_price[0] - RIDE_ENTRANCE_FEE_STEP_SIZE);
+			RecordItemPrice(this->ci, 0);
 			this->SetCoasterState();
 			break;
 		case CIW_MAX_IDLE_INCREASE:
 			this->ci->max_idle_duration += IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ci, RRS_MAX_IDLE_DURATION, this->ci->max_idle_duration);
 			this->SetCoasterState();
 			break;
 		case CIW_MAX_IDLE_DECREASE:
 			this->ci->max_idle_duration -= IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ci, RRS_MAX_IDLE_DURATION, this->ci->max_idle_duration);
 			this->SetCoasterState();
 			break;
 		case CIW_MIN_IDLE_INCREASE:
 			this->ci->min_idle_duration += IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ci, RRS_MIN_IDLE_DURATION, this->ci->min_idle_duration);
 			this->SetCoasterState();
 			break;
 		case CIW_MIN_IDLE_DECREASE:
 			this->ci->min_idle_duration -= IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ci, RRS_MIN_IDLE_DURATION, this->ci->min_idle_duration);
 			this->SetCoasterState();
 			break;
 
 		case CIW_CLOSE_RIDE_PANEL:
 		case CIW_CLOSE_RIDE_LIGHT:
 			this->ci->CloseRide();
+			RecordRideState(this->ci);
 			this->SetCoasterState();
 			break;
 		case CIW_TEST_RIDE_PANEL:
 		case CIW_TEST_RIDE_LIGHT:
 			this->ci->TestRide();
+			RecordRideState(this->ci);
 			this->SetCoasterState();
 			break;
 		case CIW_OPEN_RIDE_PANEL:
 		case CIW_OPEN_RIDE_LIGHT:
-			if (this->ci->CanOpenRide()) this->ci->OpenRide();
+			if (this->ci->CanOpenRide()) {
+				this->ci->OpenRide();
+				RecordRideState(this->ci);
+			}
 			this->SetCoasterState();
 			break;
 
@@ -676,24 +694,37 @@ void CoasterInstanceWindow::OnChange(const ChangeCode code, const uint32 paramet
 			switch ((parameter >> 16) & 0xFF) {
 				case CIW_CHOOSE_ENTRANCE:
 					this->ci->SetEntranceType(parameter & 0xFF);
+					RecordRideSetting(this->ci, RRS_ENTRANCE_TYPE, parameter & 0xFF);
 					this->UpdateRecolourButtons();
 					break;
 				case CIW_CHOOSE_EXIT:
 					this->ci->SetExitType(parameter & 0xFF);
+					RecordRideSetting(this->ci, RRS_EXIT_TYPE, parameter & 0xFF);
 					this->UpdateRecolourButtons();
 					break;
 				case CIW_NUMBER_TRAINS:
 					this->ci->SetNumberOfTrains((parameter & 0xFF) + 1 /* Counting from 1 on because there can not be 0 cars/trains. */);
+					RecordRideSetting(this->ci, RRS_NUMBER_OF_TRAINS, this->ci->number_of_trains);
 					break;
 				case CIW_NUMBER_CARS:
 					this->ci->SetNumberOfCars((parameter & 0xFF) + 1);
 					/* This also updates the positions of all trains in case the train length changed. */
 					this->ci->SetNumberOfTrains(std::min(this->ci->number_of_trains, this->ci->GetMaxNumberOfTrains(this->ci->number_of_trains)));
+					RecordRideSetting(this->ci, RRS_CARS_PER_TRAIN, this->ci->cars_per_train);
+					RecordRideSetting(this->ci, RRS_NUMBER_OF_TRAINS, this->ci->number_of_trains);
 					break;
 				default:
 					break;
 			}
 			break;
+
+		case CHG_RECOLOUR_RESULT: {
+			const int widget = (parameter >> 16) & 0xFF;
+			if (widget >= CIW_ENTRANCE_RECOLOUR1 && widget <= CIW_ENTRANCE_RECOLOUR3) RecordRecolour(this->ci, RRP_ENTRANCE, widget - CIW_ENTRANCE_RECOLOUR1);
+			if (widget >= CIW_EXIT_RECOLOUR1 && widget <= CIW_EXIT_RECOLOUR3) RecordRecolour(this->ci, RRP_EXIT, widget - CIW_EXIT_RECOLOUR1);
+			break;
+		}
+
 		default:
 			break;
 	}
@@ -738,7 +769,14 @@ void CoasterInstanceWindow::SelectorMouseButtonEvent(const MouseButtons state)
 	if (state != MB_LEFT) return;
 	if (entrance_exit_placement.area.width != 1 || entrance_exit_placement.area.height != 1) return;
 
-	if (this->ci->PlaceEntranceOrExit(this->is_placing_entrance ? this->ci->temp_entrance_pos : this->ci->temp_exit_pos, this->is_placing_entrance, nullptr)) {
+	const XYZPoint16 pos = this->is_placing_entrance ? this->ci->temp_entrance_pos : this->ci->temp_exit_pos;
+	if (this->ci->PlaceEntranceOrExit(pos, this->is_placing_entrance, nullptr)) {
+		ReplayCommand cmd(RCT_RIDE_ENTRANCE_EXIT);
+		cmd.instance = this->ci->GetIndex();
+		cmd.pos = pos;
+		cmd.data[0] = this->is_placing_entrance;
+		_replay.Record(cmd);
+
 		this->ci->temp_entrance_pos = XYZPoint16::invalid();
 		this->ci->temp_exit_pos = XYZPoint16::invalid();
 		SetSelector(nullptr);
@@ -778,9 +816,18 @@ void ShowCoasterManagementGui(RideInstance *coaster)
 	}
 
 	/* Complete the construction process if necessary. */
-	if (ci->state == RIS_BUILDING) ci->CloseRide();
-	if (ci->cars_per_train < 1) ci->SetNumberOfCars(ci->GetMaxNumberOfCars());
-	if (ci->number_of_trains < 1) ci->SetNumberOfTrains(ci->GetMaxNumberOfTrains(ci->cars_per_train));
+	if (ci->state == RIS_BUILDING) {
+		ci->CloseRide();
+		RecordRideState(ci);
+	}
+	if (ci->cars_per_train < 1) {
+		ci->SetNumberOfCars(ci->GetMaxNumberOfCars());
+		RecordRideSetting(ci, RRS_CARS_PER_TRAIN, ci->cars_per_train);
+	}
+	if (ci->number_of_trains < 1) {
+		ci->SetNumberOfTrains(ci->GetMaxNumberOfTrains(ci->cars_per_train));
+		RecordRideSetting(ci, RRS_NUMBER_OF_TRAINS, ci->number_of_trains);
+	}
 
 	Window *w = HighlightWindowByType(WC_COASTER_MANAGER, coaster->GetIndex());
 	if (w != nullptr) {
@@ -1055,6 +1102,7 @@ CoasterBuildWindow::~CoasterBuildWindow()
 	this->SetSelector(nullptr);
 
 	if (!GetWindowByType(WC_COASTER_MANAGER, this->wnumber) && !this->ci->IsAccessible()) {
+		RecordRideDeletion(this->ci, Money(0));
 		_rides_manager.DeleteInstance(this->ci->GetIndex());
 	} else {
 		ShowCoasterManagementGui(this->ci);
@@ -1125,6 +1173,11 @@ void CoasterBuildWindow::OnClick(WidgetNumber widget, [[maybe_unused]] const Poi
 			_finances_manager.PayRideConstruct(cost);
 			_window_manager.GetViewport()->AddFloatawayMoneyAmount(cost, this->cur_piece->base_voxel);
 
+			ReplayCommand cmd(RCT_REMOVE_TRACK_PIECE);
+			cmd.instance = this->ci->GetIndex();
+			cmd.value = this->cur_piece - this->ci->pieces.get();
+			_replay.Record(cmd);
+
 			int pred_index = this->ci->FindPredecessorPiece(*this->cur_piece);
 			this->ci->RemovePositionedPiece(*this->cur_piece);
 
@@ -1472,30 +1525,8 @@ void CoasterBuildWindow::BuildTrackPiece()
 	}
 	if (!BestErrorMessageReason::CheckActionAllowed(BestErrorMessageReason::ACT_BUILD, this->piece_selector.pos_piece.piece->cost)) return;
 
-	/* Add the piece to the coaster instance. */
-	int ptp_index = -1;
-	if (this->design < 0) {
-		ptp_index = this->ci->AddPositionedPiece(this->piece_selector.pos_piece);
-	} else {
-		const CoasterType *ct = this->ci->GetCoasterType();
-		const TrackedRideDesign &trd = ct->designs.at(this->design);
-
-		XYZPoint16 pos = this->piece_selector.pos_piece.base_voxel;
-		for (const TrackedRideDesign::AbstractTrackPiece &abstract_piece : trd.pieces) {
-			int piece_id = ct->GetRotatedPieceIndex(ct->pieces.at(ct->GetPieceIndex(abstract_piece.piece_name)), this->build_direction);
-			assert(piece_id >= 0);
-			ConstTrackPiecePtr piece = ct->pieces.at(piece_id);
-			ptp_index = this->ci->AddPositionedPiece(PositionedTrackPiece(pos, piece));
-			assert(ptp_index >= 0);  // We already checked that placing this design is permitted.
-			pos += piece->exit_dxyz;
-		}
-	}
-
-	assert(ptp_index >= 0);  // We already checked that placing this design is permitted.
-
-	this->ci->PlaceTrackPieceInWorld(this->piece_selector.pos_piece); // Add the piece to the world.
-
-	_finances_manager.PayRideConstruct(this->piece_selector.pos_piece.piece->cost);
+	/* Add the piece to the coaster instance and the world. */
+	const int ptp_index = this->ci->BuildTrackPiece(this->piece_selector.pos_piece, this->design, this->build_direction);
 	_window_manager.GetViewport()->AddFloatawayMoneyAmount(this->piece_selector.pos_piece.piece->cost, this->piece_selector.pos_piece.base_voxel);
 
 	/* Piece was added, change the setup for the next piece. */
@@ -34,6 +34,8 @@ public:
 	void DrawWidget(WidgetNumber wid_num, const BaseWidget *wid) const override;
 	void OnClick(WidgetNumber number, const Point16 &pos) override;
 	void UpdateWidgetSize(WidgetNumber wid_num, BaseWidget *wid) override;
+	void OnMouseMoveEvent(const Point16 &pos) override;
+	void OnMouseLeaveEvent() override;
 
 	WindowTypes parent_type; ///< Parent window type.
 	WindowNumber parent_num; ///< Parent window number.
@@ -45,6 +47,9 @@ public:
 
 private:
 	void SetDropdownSize(const Point16 &pos, uint16 min_width);
+	void SetHoveredItem(int index);
+
+	int hovered_index;       ///< Item below the mouse cursor, \c -1 if none.
 };
 
 /** Widgets of the dropdown window. */
@@ -79,7 +84,8 @@ DropdownMenuWindow::DropdownMenuWindow(WindowTypes parent_type, WindowNumber par
 		parent_btn(parent_btn),
 		items(items),
 		selected_index(initial_select),
-		has_selectable(false)
+		has_selectable(false),
+		hovered_index(-1)
 {
 	for (const DropdownItem &item : this->items) {
 		if ((item.flags & DDIF_SELECTABLE) != 0) {
@@ -155,6 +161,37 @@ void DropdownMenuWindow::UpdateWidgetSize(WidgetNumber wid_num, BaseWidget *wid)
 	wid->min_y = this->size.height;
 }
 
+/**
+ * Change the item below the mouse cursor, and repaint the items whose highlight changes.
+ * @param index Item below the mouse cursor, \c -1 if none.
+ */
+void DropdownMenuWindow::SetHoveredItem(int index)
+{
+	if (index == this->hovered_index) return;
+
+	const int height = GetTextHeight();
+	for (int item : {this->hovered_index, index}) {
+		if (item >= 0) this->MarkDirty(Rectangle16(0, item * height, this->rect.width, height));
+	}
+	this->hovered_index = index;
+}
+
+void DropdownMenuWindow::OnMouseMoveEvent(const Point16 &pos)
+{
+	const BaseWidget *wid = this->GetWidget<BaseWidget>(DD_ITEMS);
+	int index = -1;
+	if (pos.x >= 0 && pos.x < wid->pos.width - 1 && pos.y >= 0) {
+		index = pos.y / GetTextHeight();
+		if (index >= static_cast<int>(this->items.size())) index = -1;
+	}
+	this->SetHoveredItem(index);
+}
+
+void DropdownMenuWindow::OnMouseLeaveEvent()
+{
+	this->SetHoveredItem(-1);
+}
+
 void DropdownMenuWindow::OnClick(WidgetNumber number, [[maybe_unused]] const Point16 &pos)
 {
 	if (number != DD_ITEMS) return;
@@ -280,6 +317,7 @@ void RecolourDropdownWindow::OnClick(WidgetNumber widget, [[maybe_unused]] const
 
 		if (this->entry->dest != widget - RD_BUTTON_00) {
 			this->entry->dest = static_cast<ColourRange>(widget - RD_BUTTON_00);
+			NotifyChange(this->parent_type, this->parent_num, CHG_RECOLOUR_RESULT, this->parent_btn << 16 | this->entry->dest);
 		}
 
 		delete this;
@@ -293,6 +293,7 @@ void FenceGui::SelectorMouseButtonEvent(MouseButtons state)
 	_window_manager.GetViewport()->AddFloatawayMoneyAmount(cost, this->fence_base);
 
 	AddGroundFencesToMap(fences, vs, this->fence_base.z);
+	_world.MarkStackDirty(this->fence_base.x, this->fence_base.y);
 }
 
 /**
@@ -321,6 +321,73 @@ bool RcdFileReader::SkipBytes(uint32 count)
 	return fseek(this->fp, this->file_pos, SEEK_SET) == 0;
 }
 
+/**
+ * Move to a position in the file.
+ * @param pos Position to move to.
+ * @return Moving was successful.
+ */
+bool RcdFileReader::Seek(size_t pos)
+{
+	if (pos > this->file_size) return false;
+	this->file_pos = pos;
+	return fseek(this->fp, this->file_pos, SEEK_SET) == 0;
+}
+
+/**
+ * Read the table of contents ('RTOC' block) at the end of the file, if the file has one.
+ * The block ends with its own length, so it can be found from the end of the file.
+ * The position in the file is not changed.
+ * @param blocks [out] Blocks of the file in file order, excluding the table of contents itself.
+ * @return Whether the file has a valid table of contents. If not, blocks must be found by walking through the file.
+ */
+bool RcdFileReader::ReadTableOfContents(std::vector<RcdBlockEntry> *blocks)
+{
+	blocks->clear();
+	if (this->fp == nullptr || this->file_size < 8 + 12 + 8) return false;
+
+	const size_t old_pos = this->file_pos;
+	bool valid = false;
+	if (this->Seek(this->file_size - 4)) {
+		uint32 length = this->GetUInt32();
+		if (length >= 12 + 8 && length <= this->file_size - 8 && this->Seek(this->file_size - length) &&
+				this->ReadBlockHeader() && strcmp(this->name, "RTOC") == 0 && this->version == 1 && this->size == length - 12) {
+			uint32 count = this->GetUInt32();
+			if (this->size == 4 + 16 * static_cast<uint64>(count) + 4) {
+				/* Blocks must follow each other from the file header up to the table of contents. */
+				size_t offset = 8;
+				valid = true;
+				blocks->resize(count);
+				for (RcdBlockEntry &entry : *blocks) {
+					this->GetBlob(entry.name, 4);
+					entry.name[4] = '\0';
+					entry.version = this->GetUInt32();
+					entry.offset = this->GetUInt32();
+					entry.size = this->GetUInt32();
+					if (entry.offset != offset) valid = false;
+					offset += 12 + static_cast<size_t>(entry.size);
+				}
+				if (offset != this->file_size - length) valid = false;
+			}
+		}
+	}
+
+	if (!valid) blocks->clear();
+	this->Seek(old_pos);
+	return valid;
+}
+
+/**
+ * Move to the data of a block from the table of contents, and put the block information in #name, #version, and #size.
+ * @param entry Block to move to.
+ * @return Whether the block was found at its position in the file.
+ */
+bool RcdFileReader::SeekBlock(const RcdBlockEntry &entry)
+{
+	if (this->file_pos != entry.offset && !this->Seek(entry.offset)) return false;
+	if (!this->ReadBlockHeader()) return false;
+	return strcmp(this->name, entry.name) == 0 && this->version == entry.version && this->size == entry.size;
+}
+
 /**
  * Get a blob of data from the file.
  * @param address Address to load into.
@@ -26,6 +26,14 @@ private:
 
 constexpr  char DIR_SEP = '/';  ///< Directory separator character.
 
+/** Position of a block in an RCD file, as listed in the table of contents of the file. */
+struct RcdBlockEntry {
+	char name[5];   ///< Name of the block.
+	uint32 version; ///< Version number of the block.
+	uint32 offset;  ///< Position of the header of the block in the file.
+	uint32 size;    ///< Data size of the block, excluding its header.
+};
+
 /**
  * Class for reading an RCD file.
  * @ingroup fileio_group
@@ -38,6 +46,8 @@ public:
 	bool CheckFileHeader(const char *hdr_name, uint32 version);
 	bool ReadBlockHeader();
 	bool SkipBytes(uint32 count);
+	bool ReadTableOfContents(std::vector<RcdBlockEntry> *blocks);
+	bool SeekBlock(const RcdBlockEntry &entry);
 
 	bool GetBlob(void *address, size_t length);
 
@@ -73,6 +83,8 @@ public:
 	uint32 size;    ///< Data size of the last found block (with #ReadBlockHeader).
 
 private:
+	bool Seek(size_t pos);
+
 	FILE *fp;         ///< File handle of the opened file.
 	size_t file_pos;  ///< Position in the opened file.
 	size_t file_size; ///< Size of the opened file.
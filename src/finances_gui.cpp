@@ -141,6 +141,7 @@ static const WidgetPart _finances_gui_parts[] = {
 
 FinancesGui::FinancesGui() : GuiWindow(WC_FINANCES, ALL_WINDOWS_OF_TYPE)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // Money comes in and goes out all the time.
 	this->SetupWidgetTree(_finances_gui_parts, lengthof(_finances_gui_parts));
 }
 
@@ -16,6 +16,8 @@
 #include "fileio.h"
 #include "math_func.h"
 #include "viewport.h"
+#include "gamecontrol.h"
+#include "replay.h"
 
 FixedRideType::FixedRideType(const RideTypeKind k) : RideType(k),
 	width_x(0),
@@ -220,6 +222,29 @@ Money FixedRideInstance::ComputeBuildCost() const
 	return cost;
 }
 
+/**
+ * Build the ride at its current location, and pay for it.
+ * @return Whether the ride was built.
+ */
+bool FixedRideInstance::BuildRide()
+{
+	const Money build_cost = this->ComputeBuildCost();
+	if (!BestErrorMessageReason::CheckActionAllowed(BestErrorMessageReason::ACT_BUILD, build_cost)) return false;
+
+	ReplayCommand cmd(RCT_BUILD_FIXED_RIDE);
+	cmd.instance = this->GetIndex();
+	cmd.pos = this->vox_pos;
+	cmd.data[0] = this->orientation;
+	_replay.Record(cmd);
+
+	_rides_manager.NewInstanceAdded(this->GetIndex());
+	AddRemovePathEdges(this->vox_pos, PATH_EMPTY, this->GetEntranceDirections(this->vox_pos), PAS_QUEUE_PATH);
+	_finances_manager.PayRideConstruct(build_cost);
+	Viewport *vp = _window_manager.GetViewport();
+	if (vp != nullptr) vp->AddFloatawayMoneyAmount(build_cost, this->vox_pos);  // There is no viewport while replaying.
+	return true;
+}
+
 void FixedRideInstance::InsertIntoWorld()
 {
 	const SmallRideInstance index = static_cast<SmallRideInstance>(this->GetIndex());
@@ -237,6 +262,7 @@ void FixedRideInstance::InsertIntoWorld()
 				voxel->SetInstance(index);
 				voxel->SetInstanceData(h == 0 ? GetEntranceDirections(p) : static_cast<uint16>(SHF_ENTRANCE_NONE));
 			}
+			_world.MarkStackDirty(this->vox_pos.x + location.x, this->vox_pos.y + location.y);
 		}
 	}
 }
@@ -260,6 +286,7 @@ void FixedRideInstance::RemoveFromWorld()
 					voxel->ClearInstances();
 				}
 			}
+			_world.MarkStackDirty(this->vox_pos.x + unrotated_pos.x, this->vox_pos.y + unrotated_pos.y);
 		}
 	}
 }
@@ -77,6 +77,7 @@ public:
 	void InsertIntoWorld() override;
 	void RemoveFromWorld() override;
 	Money ComputeBuildCost() const;
+	bool BuildRide();
 	inline Money ComputeReturnCost() const override
 	{
 		return this->return_cost;
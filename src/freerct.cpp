@@ -23,6 +23,8 @@
 #include "gamecontrol.h"
 #include "ride_type.h"
 #include "string_func.h"
+#include "park_generator.h"
+#include "replay.h"
 #include "rev.h"
 
 #ifdef WEBASSEMBLY
@@ -61,6 +63,13 @@ static const OptionData _options[] = {
 	GETOPT_VALUE('a', "--language"),
 	GETOPT_VALUE('i', "--installdir"),
 	GETOPT_VALUE('u', "--userdatadir"),
+	GETOPT_VALUE('R', "--record"),
+	GETOPT_VALUE('P', "--replay"),
+	GETOPT_VALUE('G', "--generate"),
+	GETOPT_VALUE('g', "--generator-settings"),
+	GETOPT_VALUE('s', "--screenshot"),
+	GETOPT_VALUE('S', "--screenshot-size"),
+	GETOPT_VALUE('F', "--screenshot-frames"),
 	GETOPT_END()
 };
 
@@ -77,6 +86,19 @@ static void PrintUsage()
 	printf("  -a, --language LANG    Use the specified language.\n");
 	printf("  -i, --installdir DIR   Use the specified installation directory.\n");
 	printf("  -u, --userdatadir DIR  Use the specified user data directory.\n");
+	printf("  -R, --record FILE      Record the player commands of the game to the specified file.\n");
+	printf("  -P, --replay FILE      Replay the specified recording without display, and print\n");
+	printf("                         a hash of the game state after every tick.\n");
+	printf("  -G, --generate FILE    Generate a park without display, and save it to the specified file.\n");
+	printf("  -g, --generator-settings SETTINGS\n");
+	printf("                         Comma-separated settings of the generated park, for example\n");
+	printf("                         'size=64x64,roughness=3,paths=6,shops=20,gentle=8,thrill=8,\n");
+	printf("                         coasters=2,guests=1000,staff=20,seed=1'.\n");
+	printf("  -s, --screenshot FILE  Draw the game without display, and save the screen as PNG file.\n");
+	printf("  -S, --screenshot-size WIDTHxHEIGHT\n");
+	printf("                         Size of the screenshot in pixels (default 800x600).\n");
+	printf("  -F, --screenshot-frames FRAMES\n");
+	printf("                         Number of frames to draw before saving the screenshot (default 1).\n");
 
 	printf("\nValid languages are:\n   ");
 	int length = 0;
@@ -155,6 +177,28 @@ static void MigrateOldFiles()
 	}
 }
 
+/**
+ * Set the font files and sizes from the configuration file, or to their defaults.
+ * @param cfg_file Configuration file of the player.
+ */
+void ReadFontSettings(const ConfigFile &cfg_file)
+{
+	{
+		FONT_LATIN.font_path = cfg_file.GetValue("font-latin", "medium-path");
+		FONT_LATIN.font_size = cfg_file.GetNum("font-latin", "medium-size");
+		/* Use default values if no font has been set. */
+		if (FONT_LATIN.font_path.empty()) FONT_LATIN.font_path = FindDataFile(std::string("data") + DIR_SEP + "font" + DIR_SEP + "latin" + DIR_SEP + "FreeSans.ttf");
+		if (FONT_LATIN.font_size < 1) FONT_LATIN.font_size = 15;
+	}
+	{
+		FONT_CJK.font_path = cfg_file.GetValue("font-cjk", "medium-path");
+		FONT_CJK.font_size = cfg_file.GetNum("font-cjk", "medium-size");
+		/* Use default values if no font has been set. */
+		if (FONT_CJK.font_path.empty()) FONT_CJK.font_path = FindDataFile(std::string("data") + DIR_SEP + "font" + DIR_SEP + "cjk" + DIR_SEP + "NotoSansCJK-Regular.ttc");
+		if (FONT_CJK.font_size < 1) FONT_CJK.font_size = 15;
+	}
+}
+
 /**
  * Main entry point of our FreeRCT game.
  * @param argc Argument count.
@@ -168,6 +212,12 @@ int freerct_main(int argc, char **argv)
 	int opt_id;
 	std::string file_name;
 	std::string preferred_language;
+	std::string replay_file;
+	std::string generate_file;
+	ParkGeneratorSettings generator_settings;
+	std::string screenshot_file;
+	Point32 screenshot_size(800, 600);
+	int screenshot_frames = 1;
 	GameMode game_mode = GM_PLAY;
 	[[maybe_unused]] bool has_install_prefix_override = false;
 	do {
@@ -199,6 +249,34 @@ int freerct_main(int argc, char **argv)
 				game_mode = GM_EDITOR;
 				if (opt_data.opt != nullptr) file_name = opt_data.opt;
 				break;
+			case 'R':
+				if (opt_data.opt != nullptr) _replay.SetRecordFile(opt_data.opt);
+				break;
+			case 'P':
+				if (opt_data.opt != nullptr) replay_file = opt_data.opt;
+				break;
+			case 'G':
+				if (opt_data.opt != nullptr) generate_file = opt_data.opt;
+				break;
+			case 'g':
+				if (opt_data.opt != nullptr && !generator_settings.Parse(opt_data.opt)) return 1;
+				break;
+			case 's':
+				if (opt_data.opt != nullptr) screenshot_file = opt_data.opt;
+				break;
+			case 'S':
+				if (opt_data.opt == nullptr || sscanf(opt_data.opt, "%dx%d", &screenshot_size.x, &screenshot_size.y) != 2 ||
+						screenshot_size.x < 1 || screenshot_size.y < 1) {
+					fprintf(stderr, "Invalid screenshot size, it should be WIDTHxHEIGHT\n");
+					return 1;
+				}
+				break;
+			case 'F':
+				if (opt_data.opt == nullptr || sscanf(opt_data.opt, "%d", &screenshot_frames) != 1 || screenshot_frames < 1) {
+					fprintf(stderr, "Invalid number of screenshot frames\n");
+					return 1;
+				}
+				break;
 
 			case -1:
 				break;
@@ -268,20 +346,7 @@ int freerct_main(int argc, char **argv)
 		if (autosaves >= 0) _max_autosaves = autosaves;
 	}
 
-	{
-		FONT_LATIN.font_path = cfg_file.GetValue("font-latin", "medium-path");
-		FONT_LATIN.font_size = cfg_file.GetNum("font-latin", "medium-size");
-		/* Use default values if no font has been set. */
-		if (FONT_LATIN.font_path.empty()) FONT_LATIN.font_path = FindDataFile(std::string("data") + DIR_SEP + "font" + DIR_SEP + "latin" + DIR_SEP + "FreeSans.ttf");
-		if (FONT_LATIN.font_size < 1) FONT_LATIN.font_size = 15;
-	}
-	{
-		FONT_CJK.font_path = cfg_file.GetValue("font-cjk", "medium-path");
-		FONT_CJK.font_size = cfg_file.GetNum("font-cjk", "medium-size");
-		/* Use default values if no font has been set. */
-		if (FONT_CJK.font_path.empty()) FONT_CJK.font_path = FindDataFile(std::string("data") + DIR_SEP + "font" + DIR_SEP + "cjk" + DIR_SEP + "NotoSansCJK-Regular.ttc");
-		if (FONT_CJK.font_size < 1) FONT_CJK.font_size = 15;
-	}
+	ReadFontSettings(cfg_file);
 
 	/* Overwrite the default language settings if the user specified a custom language on the command line or in the config file. */
 	bool language_set = false;
@@ -312,9 +377,31 @@ int freerct_main(int argc, char **argv)
 		}
 	}
 
+	/* Replaying and generating parks do not need a display. */
+	if (!replay_file.empty() || !generate_file.empty()) {
+		const int result = replay_file.empty() ? GeneratePark(generate_file, generator_settings) : _replay.Play(replay_file);
+		UninitLanguage();
+		DestroyImageStorage();
+		return result;
+	}
+
 	/* Read keyboard shortcuts. */
 	_shortcuts.ReadConfig(cfg_file);
 
+	/* Screenshots are drawn in memory by the software renderer. */
+	if (!screenshot_file.empty()) {
+		_max_autosaves = 0;  // Do not overwrite the autosaves of the player.
+		_video.InitializeSoftware({&FONT_LATIN, &FONT_CJK}, screenshot_size.x, screenshot_size.y);
+		_game_control.Initialize(file_name, game_mode);
+		const int result = _video.RenderScreenshot(screenshot_file, screenshot_frames) ? 0 : 1;
+
+		_game_control.Uninitialize();
+		UninitLanguage();
+		DestroyImageStorage();
+		_video.Shutdown();
+		return result;
+	}
+
 	/* Initialize video. */
 	_video.Initialize({&FONT_LATIN, &FONT_CJK});
 
@@ -10,6 +10,9 @@
 #ifndef FREERCT_H
 #define FREERCT_H
 
+class ConfigFile;
+
 int freerct_main(int argc, char **argv);
+void ReadFontSettings(const ConfigFile &cfg_file);
 
 #endif
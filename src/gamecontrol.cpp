@@ -23,7 +23,10 @@
 #include "weather.h"
 #include "freerct.h"
 #include "fileio.h"
+#include "replay.h"
 #include "rev.h"
+#include <atomic>
+#include <thread>
 
 GameModeManager _game_mode_mgr; ///< Game mode manager object.
 
@@ -36,7 +39,7 @@ void OnNewYear()
 /** Runs various procedures that have to be done monthly. */
 void OnNewMonth()
 {
-	Autosave();
+	_game_control.Autosave();
 	_finances_manager.AdvanceMonth();
 	_staff.OnNewMonth();
 	_rides_manager.OnNewMonth();
@@ -79,16 +82,24 @@ void OnNewFrame(const uint32 frame_delay)
 	_image_variants.Tick();
 	_window_manager.Tick();
 	_inbox.Tick(frame_delay);
-	for (int i = speed_factor(_game_control.speed); i > 0; i--) {
-		_guests.DoTick();
-		_staff.DoTick();
-		DateOnTick();
-		_game_observer.DoTick();
-		_guests.OnAnimate(frame_delay);
-		_staff.OnAnimate(frame_delay);
-		_rides_manager.OnAnimate(frame_delay);
-		_scenery.OnAnimate(frame_delay);
-	}
+	for (int i = speed_factor(_game_control.speed); i > 0; i--) OnNewTick(frame_delay);
+}
+
+/**
+ * Run one tick of the game.
+ * @param frame_delay Number of milliseconds between two frames.
+ */
+void OnNewTick(const uint32 frame_delay)
+{
+	_guests.DoTick();
+	_staff.DoTick();
+	DateOnTick();
+	_game_observer.DoTick();
+	_guests.OnAnimate(frame_delay);
+	_staff.OnAnimate(frame_delay);
+	_rides_manager.OnAnimate(frame_delay);
+	_scenery.OnAnimate(frame_delay);
+	_replay.OnTick();
 }
 
 int _max_autosaves(3);  ///< How many autosave files are retained at most. 0 disables autosave.
@@ -107,8 +118,11 @@ static std::string AutosaveFilename(int i)
 	return file;
 }
 
-/** Create a new automatic savegame, and roll older autosaves. */
-void Autosave()
+/**
+ * Write the automatic savegame. The older autosaves are rolled, and the changes since the previous autosave are appended to its file.
+ * A new file is only written when the file gets too long, or after loading a game.
+ */
+static void WriteAutosave()
 {
 	if (_max_autosaves < 1) return;
 
@@ -121,7 +135,8 @@ void Autosave()
 		}
 	}
 
-	_game_control.SaveGame(AutosaveFilename(1));
+	const std::string fname = AutosaveFilename(1);
+	if (!AppendIncrementalGameFile(fname.c_str())) SaveIncrementalGameFile(fname.c_str());
 }
 
 GameControl::GameControl()
@@ -131,6 +146,7 @@ GameControl::GameControl()
 	speed(GSP_1),
 	action_test_mode(false),
 	next_action(GCA_NONE),
+	autosave_pending(false),
 	next_scenario(nullptr)
 {
 }
@@ -164,6 +180,34 @@ void GameControl::Uninitialize()
 	this->ShutdownLevel();
 }
 
+/**
+ * Load the savegame #fname into the game state.
+ * When a window is shown, the file is loaded by a separate thread, while this thread keeps the window responsive and shows the progress.
+ * This thread does not touch the game state until the loading thread has finished.
+ */
+void GameControl::LoadGameFileWithProgress()
+{
+#ifdef WEBASSEMBLY
+	LoadGameFile(this->fname.c_str());
+#else
+	if (_video.IsSoftwareRendering()) {
+		LoadGameFile(this->fname.c_str());
+		return;
+	}
+
+	std::atomic<uint32> permille(0);
+	std::atomic<bool> finished(false);
+	std::thread loader([this, &permille, &finished]() {
+		LoadGameFile(this->fname.c_str(), [&permille](size_t done, size_t total) {
+			permille = static_cast<uint64>(done) * 1000 / total;
+		});
+		finished = true;
+	});
+	while (!finished) _video.ShowProgress(permille / 1000.0);
+	loader.join();
+#endif
+}
+
 /**
  * Run latest game control action.
  * @pre next_action should not be equal to #GCA_NONE.
@@ -181,8 +225,9 @@ void GameControl::RunAction()
 		case GCA_LOAD_GAME:
 		case GCA_LOAD_EDITOR:
 			this->ShutdownLevel();
-			LoadGameFile(this->fname.c_str());
+			this->LoadGameFileWithProgress();
 			this->StartLevel(this->next_action == GCA_LOAD_EDITOR ? GM_EDITOR : GM_PLAY);
+			if (this->next_action == GCA_LOAD_GAME) _replay.StartRecording();
 			break;
 
 		case GCA_NEW_GAME: {
@@ -193,6 +238,7 @@ void GameControl::RunAction()
 
 			this->InitializeLevel();
 			this->StartLevel(GM_PLAY);
+			_replay.StartRecording();
 
 			this->next_scenario = nullptr;
 			ShowParkManagementGui(PARK_MANAGEMENT_TAB_OBJECTIVE);
@@ -269,12 +315,41 @@ void GameControl::SaveGame(const std::string &fname)
 	this->next_action = GCA_SAVE_GAME;
 }
 
+/**
+ * Write the automatic savegame after the next action. Unlike the other actions, this does not replace an action
+ * of the player that is still waiting to run.
+ */
+void GameControl::Autosave()
+{
+	this->autosave_pending = true;
+}
+
+/** Write the pending automatic savegame. */
+void GameControl::RunAutosave()
+{
+	WriteAutosave();
+	this->autosave_pending = false;
+}
+
 /** Prepare for a #GCA_QUIT action. */
 void GameControl::QuitGame()
 {
 	this->next_action = GCA_QUIT;
 }
 
+/**
+ * Change the speed of the game.
+ * @param new_speed Speed to run the game at.
+ */
+void GameControl::SetSpeed(GameSpeed new_speed)
+{
+	ReplayCommand cmd(RCT_GAME_SPEED);
+	cmd.data[0] = new_speed;
+	_replay.Record(cmd);
+
+	this->speed = new_speed;
+}
+
 /** Initialize all game data structures for playing a new game. */
 void GameControl::InitializeLevel()
 {
@@ -321,6 +396,8 @@ void GameControl::StartLevel(GameMode game_mode)
 void GameControl::ShutdownLevel()
 {
 	/// \todo Clean out the game data structures.
+	_replay.StopRecording();
+	this->autosave_pending = false;  // The autosave belongs to the game that is shut down.
 	_game_mode_mgr.SetGameMode(GM_NONE);
 	_window_manager.CloseAllWindows();
 	_rides_manager.DeleteAllRideInstances();
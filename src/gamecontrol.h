@@ -20,9 +20,11 @@ void OnNewDay();
 void OnNewMonth();
 void OnNewYear();
 void OnNewFrame(uint32 frame_delay);
-void Autosave();
+void OnNewTick(uint32 frame_delay);
 extern int _max_autosaves;
 
+constexpr uint32 FRAME_DELAY = 30;  ///< Minimum number of milliseconds between two frames.
+
 /** Actions that can be run to control the game. */
 enum GameControlAction {
 	GCA_NONE,           ///< No action to run.
@@ -65,11 +67,12 @@ public:
 	GameControl();
 
 	/**
-	 * If applicable, run the latest action.
+	 * If applicable, run the latest action, and then write a pending automatic savegame.
 	 */
 	inline void DoNextAction()
 	{
 		if (this->next_action != GCA_NONE) this->RunAction();
+		if (this->autosave_pending) this->RunAutosave();
 	}
 
 	void Initialize(const std::string &fname, GameMode game_mode);
@@ -80,8 +83,11 @@ public:
 	void LaunchEditor();
 	void LoadGame(const std::string &fname, GameMode game_mode);
 	void SaveGame(const std::string &fname);
+	void Autosave();
 	void QuitGame();
 
+	void SetSpeed(GameSpeed new_speed);
+
 	bool running;    ///< Indicates whether a game is currently running.
 	bool main_menu;  ///< Indicates whether the main menu is currently open.
 
@@ -91,11 +97,14 @@ public:
 
 private:
 	void RunAction();
+	void RunAutosave();
 	void InitializeLevel();
 	void StartLevel(GameMode game_mode);
 	void ShutdownLevel();
+	void LoadGameFileWithProgress();
 
 	GameControlAction next_action; ///< Action game control wants to run, or #GCA_NONE for 'no action'.
+	bool autosave_pending;         ///< Whether the automatic savegame should be written after the next action.
 	std::string fname;             ///< Filename of game level to load from or save to.
 	MissionScenario *next_scenario;  ///< The scenario to load on the next tick.
 };
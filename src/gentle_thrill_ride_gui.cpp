@@ -18,6 +18,7 @@
 #include "finances.h"
 #include "mouse_mode.h"
 #include "viewport.h"
+#include "replay.h"
 #include "generated/entrance_exit_strings.h"
 
 /** Window to prompt for removing a gentle/thrill ride. */
@@ -50,6 +51,7 @@ void GentleThrillRideRemoveWindow::OnClick(WidgetNumber number, [[maybe_unused]]
 
 		delete GetWindowByType(WC_GENTLE_THRILL_RIDE_MANAGER, this->si->GetIndex());
 
+		RecordRideDeletion(this->si, cost);
 		_rides_manager.DeleteInstance(this->si->GetIndex());
 	}
 	delete this;
@@ -246,6 +248,7 @@ private:
  */
 GentleThrillRideManagerWindow::GentleThrillRideManagerWindow(GentleThrillRideInstance *ri) : GuiWindow(WC_GENTLE_THRILL_RIDE_MANAGER, ri->GetIndex())
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The state and the visitors of the ride change all the time.
 	this->ride = ri;
 	this->SetRideType(this->ride->GetGentleThrillRideType());
 	this->SetupWidgetTree(_gentle_thrill_ride_manager_gui_parts, lengthof(_gentle_thrill_ride_manager_gui_parts));
@@ -392,6 +395,7 @@ void GentleThrillRideManagerWindow::OnClick(WidgetNumber wid_num, [[maybe_unused
 		case GTRMW_OPEN_RIDE_PANEL:
 			if (this->ride->CanOpenRide()) {
 				this->ride->OpenRide();
+				RecordRideState(this->ride);
 				this->UpdateButtons();
 			}
 			break;
@@ -400,6 +404,7 @@ void GentleThrillRideManagerWindow::OnClick(WidgetNumber wid_num, [[maybe_unused
 		case GTRMW_CLOSE_RIDE_PANEL:
 			if (this->ride->state != RIS_CLOSED) {
 				this->ride->CloseRide();
+				RecordRideState(this->ride);
 				this->UpdateButtons();
 			}
 			break;
@@ -434,42 +439,52 @@ void GentleThrillRideManagerWindow::OnClick(WidgetNumber wid_num, [[maybe_unused
 
 		case GTRMW_ENTRANCE_FEE_INCREASE:
 			this->ride->item_price[0] += RIDE_ENTRANCE_FEE_STEP_SIZE;
+			RecordItemPrice(this->ride, 0);
 			this->UpdateButtons();
 			break;
 		case GTRMW_ENTRANCE_FEE_DECREASE:
 			this->ride->item_price[0] = std::max<int>(0, this->ride->item_price[0] - RIDE_ENTRANCE_FEE_STEP_SIZE);
+			RecordItemPrice(this->ride, 0);
 			this->UpdateButtons();
 			break;
 		case GTRMW_CYCLES_INCREASE:
 			this->ride->working_cycles++;
+			RecordRideSetting(this->ride, RRS_WORKING_CYCLES, this->ride->working_cycles);
 			this->UpdateButtons();
 			break;
 		case GTRMW_CYCLES_DECREASE:
 			this->ride->working_cycles--;
+			RecordRideSetting(this->ride, RRS_WORKING_CYCLES, this->ride->working_cycles);
 			this->UpdateButtons();
 			break;
 		case GTRMW_MAX_IDLE_INCREASE:
 			this->ride->max_idle_duration += IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ride, RRS_MAX_IDLE_DURATION, this->ride->max_idle_duration);
 			this->UpdateButtons();
 			break;
 		case GTRMW_MAX_IDLE_DECREASE:
 			this->ride->max_idle_duration -= IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ride, RRS_MAX_IDLE_DURATION, this->ride->max_idle_duration);
 			this->UpdateButtons();
 			break;
 		case GTRMW_MIN_IDLE_INCREASE:
 			this->ride->min_idle_duration += IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ride, RRS_MIN_IDLE_DURATION, this->ride->min_idle_duration);
 			this->UpdateButtons();
 			break;
 		case GTRMW_MIN_IDLE_DECREASE:
 			this->ride->min_idle_duration -= IDLE_DURATION_STEP_SIZE;
+			RecordRideSetting(this->ride, RRS_MIN_IDLE_DURATION, this->ride->min_idle_duration);
 			this->UpdateButtons();
 			break;
 		case GTRMW_MAINTENANCE_INCREASE:
 			this->ride->maintenance_interval += MAINTENANCE_INTERVAL_STEP_SIZE;
+			RecordRideSetting(this->ride, RRS_MAINTENANCE_INTERVAL, this->ride->maintenance_interval);
 			this->UpdateButtons();
 			break;
 		case GTRMW_MAINTENANCE_DECREASE:
 			this->ride->maintenance_interval -= MAINTENANCE_INTERVAL_STEP_SIZE;
+			RecordRideSetting(this->ride, RRS_MAINTENANCE_INTERVAL, this->ride->maintenance_interval);
 			this->UpdateButtons();
 			break;
 
@@ -558,13 +573,19 @@ void GentleThrillRideManagerWindow::SelectorMouseButtonEvent(const MouseButtons
 	if (state != MB_LEFT) return;
 	if (entrance_exit_placement.area.width != 1 || entrance_exit_placement.area.height != 1) return;
 
+	ReplayCommand cmd(RCT_RIDE_ENTRANCE_EXIT);
+	cmd.instance = this->ride->GetIndex();
+	cmd.data[0] = this->is_placing_entrance;
 	if (this->is_placing_entrance) {
 		assert(this->ride->CanPlaceEntranceOrExit(this->ride->temp_entrance_pos, true));
 		this->ride->SetEntrancePos(this->ride->temp_entrance_pos);
+		cmd.pos = this->ride->temp_entrance_pos;
 	} else {
 		assert(this->ride->CanPlaceEntranceOrExit(this->ride->temp_exit_pos, false));
 		this->ride->SetExitPos(this->ride->temp_exit_pos);
+		cmd.pos = this->ride->temp_exit_pos;
 	}
+	_replay.Record(cmd);
 
 	this->ride->temp_entrance_pos = XYZPoint16::invalid();
 	this->ride->temp_exit_pos = XYZPoint16::invalid();
@@ -586,16 +607,27 @@ void GentleThrillRideManagerWindow::OnChange(const ChangeCode code, const uint32
 			switch ((parameter >> 16) & 0xFF) {
 				case GTRMW_CHOOSE_ENTRANCE:
 					this->ride->SetEntranceType(parameter & 0xFF);
+					RecordRideSetting(this->ride, RRS_ENTRANCE_TYPE, parameter & 0xFF);
 					this->UpdateRecolourButtons();
 					break;
 				case GTRMW_CHOOSE_EXIT:
 					this->ride->SetExitType(parameter & 0xFF);
+					RecordRideSetting(this->ride, RRS_EXIT_TYPE, parameter & 0xFF);
 					this->UpdateRecolourButtons();
 					break;
 				default:
 					break;
 			}
 			break;
+
+		case CHG_RECOLOUR_RESULT: {
+			const int widget = (parameter >> 16) & 0xFF;
+			if (widget >= GTRMW_RECOLOUR1 && widget <= GTRMW_RECOLOUR3) RecordRecolour(this->ride, RRP_RIDE, widget - GTRMW_RECOLOUR1);
+			if (widget >= GTRMW_ENTRANCE_RECOLOUR1 && widget <= GTRMW_ENTRANCE_RECOLOUR3) RecordRecolour(this->ride, RRP_ENTRANCE, widget - GTRMW_ENTRANCE_RECOLOUR1);
+			if (widget >= GTRMW_EXIT_RECOLOUR1 && widget <= GTRMW_EXIT_RECOLOUR3) RecordRecolour(this->ride, RRP_EXIT, widget - GTRMW_EXIT_RECOLOUR1);
+			break;
+		}
+
 		default:
 			break;
 	}
@@ -294,6 +294,7 @@ void GentleThrillRideInstance::SetEntrancePos(const XYZPoint16& pos)
 				voxel->ClearInstances();
 			}
 		}
+		_world.MarkStackDirty(this->entrance_pos.x, this->entrance_pos.y);
 		AddRemovePathEdges(this->entrance_pos, PATH_EMPTY, EDGE_ALL, PAS_UNUSED);
 	}
 
@@ -312,6 +313,7 @@ void GentleThrillRideInstance::SetEntrancePos(const XYZPoint16& pos)
 				voxel->SetInstanceData(SHF_ENTRANCE_NONE);
 			}
 		}
+		_world.MarkStackDirty(this->entrance_pos.x, this->entrance_pos.y);
 		AddRemovePathEdges(this->entrance_pos, PATH_EMPTY, edges, PAS_QUEUE_PATH);
 	}
 }
@@ -332,6 +334,7 @@ void GentleThrillRideInstance::SetExitPos(const XYZPoint16& pos)
 				voxel->ClearInstances();
 			}
 		}
+		_world.MarkStackDirty(this->exit_pos.x, this->exit_pos.y);
 		AddRemovePathEdges(this->exit_pos, PATH_EMPTY, EDGE_ALL, PAS_UNUSED);
 	}
 
@@ -350,6 +353,7 @@ void GentleThrillRideInstance::SetExitPos(const XYZPoint16& pos)
 				voxel->SetInstanceData(SHF_ENTRANCE_NONE);
 			}
 		}
+		_world.MarkStackDirty(this->exit_pos.x, this->exit_pos.y);
 		AddRemovePathEdges(this->exit_pos, PATH_EMPTY, edges, PAS_NORMAL_PATH);
 	}
 }
@@ -71,6 +71,7 @@ static const WidgetPart _inbox_gui_parts[] = {
 
 InboxGui::InboxGui() : GuiWindow(WC_INBOX, ALL_WINDOWS_OF_TYPE)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // New messages arrive without notice.
 	this->SetupWidgetTree(_inbox_gui_parts, lengthof(_inbox_gui_parts));
 	this->SetScrolledWidget(IBX_MAIN_PANEL, IBX_SCROLLBAR);
 }
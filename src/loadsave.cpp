@@ -21,6 +21,7 @@
 #include "gameobserver.h"
 #include "rev.h"
 #include <algorithm>
+#include <map>
 
 #ifdef WEBASSEMBLY
 #include <emscripten.h>
@@ -29,19 +30,31 @@
 /** Whether savegame files should automatically be resaved after loading. */
 bool _automatically_resave_files = false;
 
+static const size_t LOADER_BUFFER_SIZE = 64 * 1024; ///< Number of bytes read from a savegame file at a time.
+static const size_t LOADER_FIRST_READ_SIZE = 4096;  ///< Number of bytes of the first read from a savegame file, enough for the header.
+
 /**
  * Constructor of the loader class.
  * @param file Input file stream. Use \c nullptr for initialization to default.
  */
-Loader::Loader(FILE *file) : fp(file), rcd_file(nullptr), cache_count(0)
+Loader::Loader(FILE *file) : fp(file), rcd_file(nullptr), buffer_pos(0), buffer_length(0), file_done(0), file_size(0), cache_count(0)
 {
+	if (this->fp == nullptr) return;
+
+	this->file_buffer.reset(new uint8[LOADER_BUFFER_SIZE]);
+	long start = ftell(this->fp);
+	if (start >= 0 && fseek(this->fp, 0, SEEK_END) == 0) {
+		long end = ftell(this->fp);
+		if (end > start) this->file_size = end - start;
+		fseek(this->fp, start, SEEK_SET);
+	}
 }
 
 /**
  * Constructor of the loader class.
  * @param rcd Input file stream.
  */
-Loader::Loader(RcdFileReader *rcd) : fp(nullptr), rcd_file(rcd), cache_count(0)
+Loader::Loader(RcdFileReader *rcd) : fp(nullptr), rcd_file(rcd), buffer_pos(0), buffer_length(0), file_done(0), file_size(0), cache_count(0)
 {
 }
 
@@ -50,7 +63,8 @@ Loader::Loader(RcdFileReader *rcd) : fp(nullptr), rcd_file(rcd), cache_count(0)
  * @param data Data bytes stream.
  * @param length Total length of the data stream.
  */
-Loader::Loader(const uint8 *data, size_t length) : fp(nullptr), rcd_file(nullptr), binary_stream({data, length}), cache_count(0)
+Loader::Loader(const uint8 *data, size_t length)
+		: fp(nullptr), rcd_file(nullptr), binary_stream({data, length}), buffer_pos(0), buffer_length(0), file_done(0), file_size(0), cache_count(0)
 {
 }
 
@@ -63,6 +77,16 @@ bool Loader::HasNoInput() const
 	return this->fp == nullptr && this->rcd_file == nullptr && !this->binary_stream.has_value();
 }
 
+/**
+ * Get the position in the input file of the next byte to load.
+ * @return Number of bytes of the input file that have been loaded.
+ */
+size_t Loader::GetFileOffset() const
+{
+	assert(this->fp != nullptr);
+	return this->file_done - (this->buffer_length - this->buffer_pos) - this->cache_count;
+}
+
 /**
  * Test whether a pattern with the given name is being opened.
  * @param name Name of the expected pattern.
@@ -86,7 +110,10 @@ uint32 Loader::OpenPattern(const char *name, bool may_fail, bool name_only)
 				i--;
 				this->PutByte(name[i]);
 			}
-			if (may_fail) return UINT32_MAX;
+			if (may_fail) {
+				this->pattern_names.pop_back();
+				return UINT32_MAX;
+			}
 			throw LoadingError("Missing pattern name for %s", name);
 			return 0;
 		}
@@ -138,11 +165,49 @@ uint8 Loader::GetByte()
 		return *this->binary_stream->first++;
 	}
 
-	int k = getc(this->fp);
-	if (k == EOF) {
-		throw LoadingError("EOF encountered");
-	}
-	return k;
+	if (this->buffer_pos == this->buffer_length && !this->FillBuffer()) throw LoadingError("EOF encountered");
+	return this->file_buffer[this->buffer_pos++];
+}
+
+/**
+ * Read the next part of the input file into the buffer, and report the progress.
+ * @return Whether data was read, \c false at the end of the file.
+ */
+bool Loader::FillBuffer()
+{
+	assert(this->fp != nullptr && this->buffer_pos == this->buffer_length);
+
+	this->buffer_pos = 0;
+	/* Start with a small read, preloading only needs the header of the file. */
+	this->buffer_length = fread(this->file_buffer.get(), 1, this->file_done == 0 ? LOADER_FIRST_READ_SIZE : LOADER_BUFFER_SIZE, this->fp);
+	if (this->buffer_length == 0) return false;
+
+	this->file_done += this->buffer_length;
+	if (this->progress) this->progress(this->file_done, std::max(this->file_done, this->file_size));
+	return true;
+}
+
+/**
+ * Test whether all data of the input stream has been read.
+ * @return Whether the end of the input stream has been reached.
+ */
+bool Loader::IsAtEnd()
+{
+	if (this->HasNoInput()) return true;
+	if (this->cache_count > 0) return false;
+	if (this->binary_stream.has_value()) return this->binary_stream->second == 0;
+	if (this->fp != nullptr) return this->buffer_pos == this->buffer_length && !this->FillBuffer();
+	return false;
+}
+
+/**
+ * Set the callback to report the progress of loading.
+ * It is called whenever a new part of the input file has been read.
+ * @param callback Callback to call, or \c nullptr to stop reporting.
+ */
+void Loader::SetProgressCallback(const LoadProgressCallback &callback)
+{
+	this->progress = callback;
 }
 
 /**
@@ -232,7 +297,7 @@ void Loader::VersionMismatch(uint saved_version, uint current_version)
  * @param filename Name of the file we're writing to.
  * @param file Output file stream to write to.
  */
-Saver::Saver([[maybe_unused]] const char *filename, FILE *file) : fp(file)
+Saver::Saver([[maybe_unused]] const char *filename, FILE *file) : fp(file), buffer(nullptr)
 {
 #ifdef WEBASSEMBLY
 	this->data_as_js_encoded_string.reserve(1000 * 1000);  // Arbitrary estimate of a smallish savegame.
@@ -254,9 +319,19 @@ Saver::Saver([[maybe_unused]] const char *filename, FILE *file) : fp(file)
 #endif
 }
 
+/**
+ * Constructor for a saver that writes to memory.
+ * @param buffer Memory buffer to append the data to.
+ */
+Saver::Saver(std::vector<uint8> *buffer) : fp(nullptr), buffer(buffer)
+{
+}
+
 #ifdef WEBASSEMBLY
 Saver::~Saver()
 {
+	if (this->fp == nullptr) return;
+
 	this->data_as_js_encoded_string += "');";
 	emscripten_run_script(this->data_as_js_encoded_string.c_str());
 }
@@ -309,6 +384,11 @@ void Saver::EndPattern()
  */
 void Saver::PutByte(uint8 val)
 {
+	if (this->fp == nullptr) {
+		this->buffer->push_back(val);
+		return;
+	}
+
 	putc(val, this->fp);
 
 #ifdef WEBASSEMBLY
@@ -384,7 +464,7 @@ void Saver::PutText(const std::string &str, int length)
 
 /* When making any changes to saveloading code, don't forget to update the file 'doc/savegame.rst'! */
 
-static const uint32 CURRENT_VERSION_FCTS = 12;  ///< Currently supported version of the FCTS pattern.
+static const uint32 CURRENT_VERSION_FCTS = 13;  ///< Currently supported version of the FCTS pattern.
 
 /**
  * Load basic information from the start of a savegame file.
@@ -421,6 +501,76 @@ PreloadData Preload(Loader &ldr)
 	return result;
 }
 
+/** Sections of the game state in a savegame, in the order of loading and saving. */
+enum GameSection {
+	SSE_DATE,      ///< Date.
+	SSE_WORLD,     ///< Voxel world.
+	SSE_FINANCES,  ///< Finances.
+	SSE_WEATHER,   ///< Weather.
+	SSE_OBSERVER,  ///< Game observer.
+	SSE_RIDES,     ///< Rides.
+	SSE_SCENERY,   ///< Scenery.
+	SSE_GUESTS,    ///< Guests.
+	SSE_STAFF,     ///< Staff.
+	SSE_INBOX,     ///< Messages.
+	SSE_RANDOM,    ///< Random number generator.
+
+	SSE_COUNT,     ///< Number of sections.
+};
+
+/**
+ * Load a section of the game state from the input stream.
+ * @param ldr Input stream to load from.
+ * @param section Section to load.
+ * @param preload Result of the preload step.
+ */
+static void LoadSection(Loader &ldr, GameSection section, const PreloadData &preload)
+{
+	switch (section) {
+		case SSE_DATE:     LoadDate(ldr); break;
+		case SSE_WORLD:    _world.Load(ldr); break;
+		case SSE_FINANCES: _finances_manager.Load(ldr); break;
+		case SSE_WEATHER:  _weather.Load(ldr); break;
+		case SSE_OBSERVER:
+			if (preload.fcts_version >= 12) {
+				_game_observer.Load(ldr);
+			} else {
+				_game_observer.Initialize();
+			}
+			break;
+		case SSE_RIDES:    _rides_manager.Load(ldr); break;
+		case SSE_SCENERY:  _scenery.Load(ldr); break;
+		case SSE_GUESTS:   _guests.Load(ldr); break;
+		case SSE_STAFF:    _staff.Load(ldr); break;
+		case SSE_INBOX:    _inbox.Load(ldr); break;
+		case SSE_RANDOM:   Random::Load(ldr); break;
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Write a section of the game state to the output stream.
+ * @param svr Output stream to write to.
+ * @param section Section to write.
+ */
+static void SaveSection(Saver &svr, GameSection section)
+{
+	switch (section) {
+		case SSE_DATE:     SaveDate(svr); break;
+		case SSE_WORLD:    _world.Save(svr); break;
+		case SSE_FINANCES: _finances_manager.Save(svr); break;
+		case SSE_WEATHER:  _weather.Save(svr); break;
+		case SSE_OBSERVER: _game_observer.Save(svr); break;
+		case SSE_RIDES:    _rides_manager.Save(svr); break;
+		case SSE_SCENERY:  _scenery.Save(svr); break;
+		case SSE_GUESTS:   _guests.Save(svr); break;
+		case SSE_STAFF:    _staff.Save(svr); break;
+		case SSE_INBOX:    _inbox.Save(svr); break;
+		case SSE_RANDOM:   Random::Save(svr); break;
+		default: NOT_REACHED();
+	}
+}
+
 /**
  * Load the game elements from the input stream.
  * @param ldr Input stream to load from.
@@ -430,76 +580,283 @@ PreloadData Preload(Loader &ldr)
 static void LoadElements(Loader &ldr, const PreloadData &preload)
 {
 	_scenario = *preload.scenario;
-	LoadDate(ldr);
-	_world.Load(ldr);
-	_finances_manager.Load(ldr);
-	_weather.Load(ldr);
-	if (preload.fcts_version >= 12) {
-		_game_observer.Load(ldr);
-	} else {
-		_game_observer.Initialize();
-	}
-	_rides_manager.Load(ldr);
-	_scenery.Load(ldr);
-	_guests.Load(ldr);
-	_staff.Load(ldr);
-	_inbox.Load(ldr);
-	Random::Load(ldr);
+	for (int section = 0; section < SSE_COUNT; section++) LoadSection(ldr, static_cast<GameSection>(section), preload);
 }
 
 /**
- * Write the game elements to the output stream.
+ * Write the basic information at the start of a savegame.
  * @param svr Output stream to write to.
- * @note Order of saving should be the same as in #LoadElements.
+ * @param timestamp Time of saving.
  */
-static void SaveElements(Saver &svr)
+static void SaveHeader(Saver &svr, time_t timestamp)
 {
 	svr.StartPattern("FCTS", CURRENT_VERSION_FCTS);
-	svr.PutLongLong(std::time(nullptr));
+	svr.PutLongLong(timestamp);
 	svr.PutText(_freerct_revision);
 	_scenario.Save(svr);
 	svr.EndPattern();
+}
 
-	SaveDate(svr);
-	_world.Save(svr);
-	_finances_manager.Save(svr);
-	_weather.Save(svr);
-	_game_observer.Save(svr);
-	_rides_manager.Save(svr);
-	_scenery.Save(svr);
-	_guests.Save(svr);
-	_staff.Save(svr);
-	_inbox.Save(svr);
-	Random::Save(svr);
-
+/**
+ * Write the game elements to the output stream.
+ * @param svr Output stream to write to.
+ * @note Order of saving should be the same as in #LoadElements.
+ */
+static void SaveElements(Saver &svr)
+{
+	SaveHeader(svr, std::time(nullptr));
+	for (int section = 0; section < SSE_COUNT; section++) SaveSection(svr, static_cast<GameSection>(section));
 	svr.CheckNoOpenPattern();
 }
 
+static const uint32 CURRENT_VERSION_ASAV = 1;  ///< Currently supported version of the ASAV pattern.
+static const uint32 CURRENT_VERSION_DLTA = 1;  ///< Currently supported version of the DLTA pattern.
+
+static const int MAX_SAVE_DELTAS = 12;  ///< Maximum number of delta blocks in an incremental savegame before it is written completely again.
+static const long FCTS_TIMESTAMP_OFFSET = 8;  ///< Offset of the timestamp in a savegame file, after the name and version of the FCTS pattern.
+
+/** State of the incremental savegame file written last, to find what changed since. */
+struct IncrementalSave {
+	std::string fname;                       ///< Name of the file, empty if there is no incremental savegame.
+	long base_size = 0;                      ///< Size of the file after writing the complete game state.
+	long file_size = 0;                      ///< Size of the file after the last write.
+	int num_deltas = 0;                      ///< Number of delta blocks in the file.
+	std::vector<uint8> sections[SSE_COUNT];  ///< Saved data of every section as of the last write, except #SSE_WORLD.
+	uint32 change_stamps[SSE_COUNT] = {};    ///< Change stamp of every section as of the last write, see #GetSectionChangeStamp.
+};
+
+static IncrementalSave _incremental_save;  ///< The incremental savegame file written last.
+
+/**
+ * Get the change stamp of a section of the game state, which changes whenever the saved data of the section changes.
+ * @param section Section to query.
+ * @param stamp [out] Receives the current change stamp of the section.
+ * @return Whether the changes of the section are tracked. If not, the section must be saved every time.
+ */
+static bool GetSectionChangeStamp(GameSection section, uint32 *stamp)
+{
+	switch (section) {
+		case SSE_WORLD:   *stamp = _world.GetChangeStamp(); return true;
+		case SSE_RIDES:   *stamp = _rides_manager.GetChangeStamp(); return true;
+		case SSE_SCENERY: *stamp = _scenery.GetChangeStamp(); return true;
+		case SSE_INBOX:   *stamp = _inbox.change_stamp; return true;
+		default: return false;  // The date, the people, and the random generator change with every tick.
+	}
+}
+
+static const uint8 SECTION_PATCH = 0x80;    ///< Flag in the section number of a record, if it holds changes of the section instead of all its data.
+static const uint32 PATCH_RUN_OVERHEAD = 4; ///< Number of bytes to write for each run of changed bytes in a section patch.
+
+/**
+ * Compute the changes of the saved data of a section that kept its size.
+ * @param old_data Previously saved data of the section.
+ * @param new_data Current data of the section, with the same size.
+ * @return Runs of changed bytes, for #ApplySectionPatch.
+ */
+static std::vector<uint8> MakeSectionPatch(const std::vector<uint8> &old_data, const std::vector<uint8> &new_data)
+{
+	assert(old_data.size() == new_data.size());
+	std::vector<std::pair<uint32, uint16>> runs; // Offset and length of runs of changed bytes.
+	for (uint32 i = 0; i < new_data.size(); i++) {
+		if (old_data[i] == new_data[i]) continue;
+		/* Writing a few equal bytes is cheaper than starting a new run. */
+		if (!runs.empty() && i - (runs.back().first + runs.back().second) <= PATCH_RUN_OVERHEAD && i - runs.back().first < UINT16_MAX) {
+			runs.back().second = i + 1 - runs.back().first;
+		} else {
+			runs.emplace_back(i, 1);
+		}
+	}
+
+	/* Runs are written as the number of equal bytes before the run and the length of the run, long distances get empty runs. */
+	std::vector<std::pair<uint16, uint16>> encoded;
+	uint32 pos = 0;
+	for (const auto &run : runs) {
+		for (; run.first - pos > UINT16_MAX; pos += UINT16_MAX) encoded.emplace_back(UINT16_MAX, 0);
+		encoded.emplace_back(run.first - pos, run.second);
+		pos = run.first + run.second;
+	}
+
+	std::vector<uint8> patch;
+	Saver svr(&patch);
+	svr.PutLong(encoded.size());
+	pos = 0;
+	for (const auto &run : encoded) {
+		svr.PutWord(run.first);
+		svr.PutWord(run.second);
+		pos += run.first;
+		for (uint32 i = 0; i < run.second; i++) svr.PutByte(new_data[pos + i]);
+		pos += run.second;
+	}
+	return patch;
+}
+
+/**
+ * Apply the changes computed by #MakeSectionPatch to the saved data of a section.
+ * @param patch Changes of the section.
+ * @param data [inout] Saved data of the section to change.
+ */
+static void ApplySectionPatch(const std::vector<uint8> &patch, std::vector<uint8> *data)
+{
+	Loader ldr(patch.data(), patch.size());
+	size_t pos = 0;
+	for (uint32 runs = ldr.GetLong(); runs > 0; runs--) {
+		pos += ldr.GetWord();
+		const uint16 length = ldr.GetWord();
+		if (pos > data->size() || length > data->size() - pos) throw LoadingError("Invalid savegame section patch");
+		for (uint16 i = 0; i < length; i++) (*data)[pos++] = ldr.GetByte();
+	}
+}
+
+/**
+ * Write a section record of an incremental savegame.
+ * @param svr Output stream to write to.
+ * @param section Section of the data.
+ * @param data Saved data of the section, or its changes.
+ * @param patch Whether \a data holds the changes of the section, see #MakeSectionPatch.
+ */
+static void PutSectionRecord(Saver &svr, GameSection section, const std::vector<uint8> &data, bool patch)
+{
+	svr.PutByte(patch ? (section | SECTION_PATCH) : section);
+	svr.PutLong(data.size());
+	for (uint8 b : data) svr.PutByte(b);
+}
+
+/**
+ * Read the section records of an ASAV or DLTA pattern.
+ * @param ldr Input stream to load from.
+ * @param records [out] Receives the section number (with #SECTION_PATCH) and the data of every record.
+ */
+static void GetSectionRecords(Loader &ldr, std::vector<std::pair<uint8, std::vector<uint8>>> *records)
+{
+	for (int count = ldr.GetByte(); count > 0; count--) {
+		const uint8 record = ldr.GetByte();
+		if ((record & ~SECTION_PATCH) >= SSE_COUNT) throw LoadingError("Unknown savegame section %u", record & ~SECTION_PATCH);
+
+		std::vector<uint8> data(ldr.GetLong());
+		for (uint8 &b : data) b = ldr.GetByte();
+		records->emplace_back(record, std::move(data));
+	}
+}
+
+/**
+ * Apply the section records of an ASAV or DLTA pattern.
+ * @param records Section records, as read by #GetSectionRecords.
+ * @param sections [inout] Data of each section, updated with the records.
+ * @param world_changes [out] If not \c nullptr, changes of the voxel world are appended to it instead of replacing the world section.
+ */
+static void ApplySectionRecords(std::vector<std::pair<uint8, std::vector<uint8>>> &records, std::vector<uint8> *sections, std::vector<std::vector<uint8>> *world_changes)
+{
+	for (auto &record : records) {
+		const uint8 section = record.first & ~SECTION_PATCH;
+		if ((record.first & SECTION_PATCH) != 0) {
+			if (section == SSE_WORLD || sections[section].empty()) throw LoadingError("Unexpected savegame section patch");
+			ApplySectionPatch(record.second, &sections[section]);
+		} else if (section == SSE_WORLD && world_changes != nullptr) {
+			world_changes->push_back(std::move(record.second));
+		} else {
+			sections[section] = std::move(record.second);
+		}
+	}
+}
+
+/**
+ * Load the game elements of an incremental savegame, and apply all its delta blocks.
+ * @param ldr Input stream to load from, just after the name and version of the ASAV pattern.
+ * @param preload Result of the preload step.
+ * @param version Version of the ASAV pattern.
+ */
+static void LoadIncrementalElements(Loader &ldr, PreloadData &preload, uint32 version)
+{
+	if (version != CURRENT_VERSION_ASAV) ldr.VersionMismatch(version, CURRENT_VERSION_ASAV);
+	std::vector<std::pair<uint8, std::vector<uint8>>> records;
+	std::vector<uint8> sections[SSE_COUNT];
+	GetSectionRecords(ldr, &records);
+	ApplySectionRecords(records, sections, nullptr);
+	ldr.ClosePattern();
+
+	std::vector<std::vector<uint8>> world_changes;
+	while (!ldr.IsAtEnd()) {
+		/* Read the records of the delta block first, the game may have stopped while appending the last one. */
+		std::vector<std::pair<uint8, std::vector<uint8>>> records;
+		PreloadData delta_preload;
+		try {
+			version = ldr.OpenPattern("DLTA");
+			if (version == CURRENT_VERSION_DLTA) {
+				delta_preload = Preload(ldr);
+				GetSectionRecords(ldr, &records);
+				ldr.ClosePattern();
+			}
+		} catch (const LoadingError &e) {
+			printf("WARNING: Ignoring the incomplete last changes of the savegame: %s\n", e.what());
+			break;
+		}
+		if (version != CURRENT_VERSION_DLTA) ldr.VersionMismatch(version, CURRENT_VERSION_DLTA);
+
+		preload = std::move(delta_preload);
+		ApplySectionRecords(records, sections, &world_changes);
+	}
+
+	_scenario = *preload.scenario;
+	for (int section = 0; section < SSE_COUNT; section++) {
+		if (sections[section].empty()) throw LoadingError("Missing savegame section %d", section);
+		Loader section_ldr(sections[section].data(), sections[section].size());
+		LoadSection(section_ldr, static_cast<GameSection>(section), preload);
+
+		/* The changes of the world must be applied before the rides load their data into it. */
+		if (section != SSE_WORLD) continue;
+		for (const std::vector<uint8> &changes : world_changes) {
+			Loader changes_ldr(changes.data(), changes.size());
+			_world.LoadChanges(changes_ldr);
+		}
+	}
+}
+
 /**
  * Load a file as saved game.
  * @param ldr Loader to read the game data.
  */
 void LoadGame(Loader &ldr)
 {
+	/* The loaded game replaces the game of the incremental savegame. */
+	_incremental_save = IncrementalSave();
+
 	PreloadData pd = Preload(ldr);
-	LoadElements(ldr, pd);
+	const uint32 version = (pd.fcts_version >= 13) ? ldr.OpenPattern("ASAV", true) : 0;
+	if (version == 0 || version == UINT32_MAX) {
+		LoadElements(ldr, pd);
+	} else {
+		LoadIncrementalElements(ldr, pd, version);
+	}
+}
+
+/**
+ * Save the current game state.
+ * @param svr Saver to write the game data.
+ */
+void SaveGame(Saver &svr)
+{
+	SaveElements(svr);
 }
 
 /**
  * Load a file as saved game. Loading from \c nullptr means initializing to default.
+ * The function does not interact with the user, so it may run on another thread than the main thread,
+ * as long as nothing else accesses the game state in the mean time.
  * @param fname Name of the file to load. Use \c nullptr to initialize to default.
+ * @param progress Optional callback to report the progress of reading the file.
  * @return Whether loading was successful.
  */
-bool LoadGameFile(const char *fname)
+bool LoadGameFile(const char *fname, const LoadProgressCallback &progress)
 {
+	FILE *fp = nullptr;
 	try {
-		FILE *fp = nullptr;
 		if (fname != nullptr) {
 			fp = fopen(fname, "rb");
 			if (fp == nullptr) throw LoadingError("Cannot open file '%s' for reading", fname);
 		}
 
 		Loader ldr(fp);
+		ldr.SetProgressCallback(progress);
 		LoadGame(ldr);
 
 		if (fp != nullptr) {
@@ -508,6 +865,7 @@ bool LoadGameFile(const char *fname)
 		}
 		return true;
 	} catch (const LoadingError &e) {
+		if (fp != nullptr) fclose(fp);
 		if (fname != nullptr) {
 			printf("ERROR: Loading '%s' failed: %s\n", fname, e.what());
 			LoadGameFile(nullptr);
@@ -524,22 +882,28 @@ bool LoadGameFile(const char *fname)
 /**
  * Load basic data from a savegame file.
  * @param fname Name of the file to load.
+ * @param header [out] If not \c nullptr, receives the bytes of the savegame header, or is cleared if preloading failed.
  * @return Basic information about the savegame.
- * @note Check the return value's #load_success attribute to see whether preloading was successful.
  */
-PreloadData PreloadGameFile(const char *fname)
+static PreloadData DoPreloadGameFile(const char *fname, std::vector<uint8> *header)
 {
 	PreloadData result;
+	if (header != nullptr) header->clear();
 	if (fname == nullptr) return result;
 
-	try {
-		FILE *fp = fopen(fname, "rb");
-		if (fp == nullptr) return result;
-		Loader ldr(fp);
-		result = Preload(ldr);
+	FILE *fp = fopen(fname, "rb");
+	if (fp != nullptr) {
+		try {
+			Loader ldr(fp);
+			result = Preload(ldr);
+			if (header != nullptr) {
+				header->resize(ldr.GetFileOffset());
+				if (fseek(fp, 0, SEEK_SET) != 0 || fread(header->data(), 1, header->size(), fp) != header->size()) header->clear();
+			}
+		} catch (const LoadingError&) {
+			result.load_success = false;
+		}
 		fclose(fp);
-	} catch (const LoadingError&) {
-		result.load_success = false;
 	}
 
 	result.filename = fname;
@@ -547,6 +911,139 @@ PreloadData PreloadGameFile(const char *fname)
 	return result;
 }
 
+/**
+ * Load basic data from a savegame file.
+ * @param fname Name of the file to load.
+ * @return Basic information about the savegame.
+ * @note Check the return value's #load_success attribute to see whether preloading was successful.
+ */
+PreloadData PreloadGameFile(const char *fname)
+{
+	return DoPreloadGameFile(fname, nullptr);
+}
+
+static const char *SAVEGAME_INDEX_FILE = "savegames.idx";  ///< Name of the savegame header index file in the savegame directory.
+static const uint32 CURRENT_VERSION_SGIX = 1;              ///< Currently supported version of the SGIX pattern.
+
+/** Cached header of a savegame file in the savegame header index. */
+struct SavegameIndexEntry {
+	int64 mtime;                ///< Modification time of the file when its header was read.
+	uint64 size;                ///< Size of the file in bytes when its header was read.
+	std::vector<uint8> header;  ///< Bytes of the savegame header, empty if the header could not be loaded.
+};
+
+/** Savegame header index, by file name. */
+using SavegameIndex = std::map<std::string, SavegameIndexEntry>;
+
+/**
+ * Load the savegame header index.
+ * @param fname Name of the index file.
+ * @return The loaded index, empty if the index file does not exist or could not be loaded.
+ */
+static SavegameIndex LoadSavegameIndex(const std::string &fname)
+{
+	SavegameIndex index;
+	FILE *fp = fopen(fname.c_str(), "rb");
+	if (fp == nullptr) return index;
+
+	try {
+		Loader ldr(fp);
+		uint32 version = ldr.OpenPattern("SGIX");
+		if (version != CURRENT_VERSION_SGIX) ldr.VersionMismatch(version, CURRENT_VERSION_SGIX);
+		for (uint32 count = ldr.GetLong(); count > 0; count--) {
+			const std::string name = ldr.GetText();
+			SavegameIndexEntry &entry = index[name];
+			entry.mtime = ldr.GetLongLong();
+			entry.size = ldr.GetLongLong();
+			entry.header.resize(ldr.GetLong());
+			for (uint8 &val : entry.header) val = ldr.GetByte();
+		}
+		ldr.ClosePattern();
+	} catch (const LoadingError&) {
+		index.clear();
+	}
+	fclose(fp);
+	return index;
+}
+
+/**
+ * Save the savegame header index.
+ * @param fname Name of the index file.
+ * @param index Index to save.
+ */
+static void SaveSavegameIndex(const std::string &fname, const SavegameIndex &index)
+{
+	std::vector<uint8> buffer;
+	Saver svr(&buffer);
+	svr.StartPattern("SGIX", CURRENT_VERSION_SGIX);
+	svr.PutLong(index.size());
+	for (const auto &pair : index) {
+		svr.PutText(pair.first);
+		svr.PutLongLong(pair.second.mtime);
+		svr.PutLongLong(pair.second.size);
+		svr.PutLong(pair.second.header.size());
+		for (uint8 val : pair.second.header) svr.PutByte(val);
+	}
+	svr.EndPattern();
+
+	FILE *fp = fopen(fname.c_str(), "wb");
+	if (fp == nullptr) return;
+	fwrite(buffer.data(), 1, buffer.size(), fp);
+	fclose(fp);
+}
+
+/**
+ * Load basic data of all savegame files in the savegame directory.
+ * The headers of the files are cached in an index file in the directory,
+ * so only the files that are new or changed since the previous call are read.
+ * @return Basic information about the savegames.
+ */
+std::vector<PreloadData> PreloadSavegameDirectory()
+{
+	const std::string index_fname = SavegameDirectory() + SAVEGAME_INDEX_FILE;
+	SavegameIndex old_index = LoadSavegameIndex(index_fname);
+	const size_t old_index_size = old_index.size();
+	SavegameIndex new_index;
+	bool changed = false;
+
+	std::vector<PreloadData> result;
+	for (const std::string &path : GetAllFileEntries(SavegameDirectory())) {
+		if (path.size() <= 4 || path.compare(path.size() - 4, 4, ".fct") != 0) continue;
+
+		std::error_code time_error, size_error;
+		const std::filesystem::path fs_path(path);
+		const int64 mtime = std::filesystem::last_write_time(fs_path, time_error).time_since_epoch().count();
+		const uint64 size = std::filesystem::file_size(fs_path, size_error);
+		const std::string name = fs_path.filename().string();
+
+		auto iter = old_index.find(name);
+		if (!time_error && !size_error && iter != old_index.end() && iter->second.mtime == mtime && iter->second.size == size) {
+			const SavegameIndexEntry &entry = new_index.emplace(name, std::move(iter->second)).first->second;
+			PreloadData pd;
+			if (!entry.header.empty()) {
+				try {
+					Loader ldr(entry.header.data(), entry.header.size());
+					pd = Preload(ldr);
+				} catch (const LoadingError&) {
+					pd.load_success = false;
+				}
+			}
+			pd.filename = name;
+			result.push_back(std::move(pd));
+			continue;
+		}
+
+		SavegameIndexEntry &entry = new_index[name];
+		entry.mtime = mtime;
+		entry.size = size;
+		result.push_back(DoPreloadGameFile(path.c_str(), &entry.header));
+		changed = true;
+	}
+
+	if (changed || new_index.size() != old_index_size) SaveSavegameIndex(index_fname, new_index);
+	return result;
+}
+
 /**
  * Save the current game state to file.
  * @param fname Name of the file to write.
@@ -559,9 +1056,142 @@ bool SaveGameFile(const char *fname)
 	if (fp == nullptr) return false;
 
 	Saver svr(fname, fp);
-	SaveElements(svr);
+	SaveGame(svr);
 	fclose(fp);
 
 	return true;
 }
 
+
+/**
+ * Save the current game state to file as the start of an incremental savegame,
+ * so later changes can be appended with #AppendIncrementalGameFile.
+ * @param fname Name of the file to write.
+ * @return Whether saving was successful.
+ */
+bool SaveIncrementalGameFile(const char *fname)
+{
+	_incremental_save = IncrementalSave();
+	FILE *fp = fopen(fname, "wb");
+	if (fp == nullptr) return false;
+
+	IncrementalSave state;
+	{
+		Saver svr(fname, fp);
+		SaveHeader(svr, std::time(nullptr));
+		svr.StartPattern("ASAV", CURRENT_VERSION_ASAV);
+		svr.PutByte(SSE_COUNT);
+		for (int section = 0; section < SSE_COUNT; section++) {
+			std::vector<uint8> data;
+			Saver section_svr(&data);
+			SaveSection(section_svr, static_cast<GameSection>(section));
+			PutSectionRecord(svr, static_cast<GameSection>(section), data, false);
+			GetSectionChangeStamp(static_cast<GameSection>(section), &state.change_stamps[section]);
+			if (section != SSE_WORLD) state.sections[section] = std::move(data);
+		}
+		svr.EndPattern();
+		svr.CheckNoOpenPattern();
+	}
+
+	state.base_size = ftell(fp);
+	bool failed = ferror(fp) != 0;
+	failed |= fclose(fp) != 0;
+	if (failed) return false;
+
+	state.fname = fname;
+	state.file_size = state.base_size;
+	_incremental_save = std::move(state);
+	return true;
+}
+
+/**
+ * Append the changes of the game state since the previous save to the incremental savegame file.
+ * Only the changed voxel stacks and the changed sections of the game state are written. Sections with
+ * tracked changes (see #GetSectionChangeStamp) are not even saved to memory if their stamp did not change.
+ * @param fname Name of the file to append to.
+ * @return Whether the changes were appended. If not, the file should be written with #SaveIncrementalGameFile.
+ */
+bool AppendIncrementalGameFile(const char *fname)
+{
+#ifdef WEBASSEMBLY
+	/* Files of the browser are always written completely. */
+	return false;
+#else
+	IncrementalSave &state = _incremental_save;
+	if (state.fname.empty() || state.fname != fname || state.num_deltas >= MAX_SAVE_DELTAS) return false;
+
+	FILE *fp = fopen(fname, "r+b");
+	if (fp == nullptr) return false;
+	/* Another program or the player may have replaced the file. */
+	if (fseek(fp, 0, SEEK_END) != 0 || ftell(fp) != state.file_size) {
+		fclose(fp);
+		return false;
+	}
+
+	const time_t timestamp = std::time(nullptr);
+	std::vector<uint8> changed_sections[SSE_COUNT];
+	uint32 change_stamps[SSE_COUNT] = {};
+	std::vector<uint8> delta;
+	Saver svr(&delta);
+	svr.StartPattern("DLTA", CURRENT_VERSION_DLTA);
+	SaveHeader(svr, timestamp);
+	for (int section = 0; section < SSE_COUNT; section++) {
+		const bool tracked = GetSectionChangeStamp(static_cast<GameSection>(section), &change_stamps[section]);
+		if (tracked && change_stamps[section] == state.change_stamps[section]) continue;
+
+		changed_sections[section].reserve(state.sections[section].size());
+		Saver section_svr(&changed_sections[section]);
+		if (section == SSE_WORLD) {
+			_world.SaveChanges(section_svr, state.change_stamps[section]);
+		} else {
+			SaveSection(section_svr, static_cast<GameSection>(section));
+			if (changed_sections[section] == state.sections[section]) changed_sections[section].clear();
+		}
+	}
+	svr.PutByte(std::count_if(std::begin(changed_sections), std::end(changed_sections), [](const std::vector<uint8> &data) { return !data.empty(); }));
+	for (int section = 0; section < SSE_COUNT; section++) {
+		const std::vector<uint8> &data = changed_sections[section];
+		if (data.empty()) continue;
+
+		/* Sections of people change a little everywhere, while their size mostly stays the same. */
+		if (section != SSE_WORLD && data.size() == state.sections[section].size()) {
+			const std::vector<uint8> patch = MakeSectionPatch(state.sections[section], data);
+			if (patch.size() < data.size()) {
+				PutSectionRecord(svr, static_cast<GameSection>(section), patch, true);
+				continue;
+			}
+		}
+		PutSectionRecord(svr, static_cast<GameSection>(section), data, false);
+	}
+	svr.EndPattern();
+
+	/* Compact the file when the delta blocks get bigger than the complete game state. */
+	if (state.file_size + static_cast<long>(delta.size()) > 2 * state.base_size) {
+		fclose(fp);
+		_incremental_save = IncrementalSave();
+		return false;
+	}
+
+	/* Append the delta block, and update the timestamp in the header of the file. */
+	std::vector<uint8> timestamp_data;
+	Saver timestamp_svr(&timestamp_data);
+	timestamp_svr.PutLongLong(timestamp);
+
+	bool failed = fwrite(delta.data(), 1, delta.size(), fp) != delta.size();
+	failed |= fseek(fp, FCTS_TIMESTAMP_OFFSET, SEEK_SET) != 0;
+	failed |= fwrite(timestamp_data.data(), 1, timestamp_data.size(), fp) != timestamp_data.size();
+	failed |= fclose(fp) != 0;
+	if (failed) {
+		_incremental_save = IncrementalSave();
+		return false;
+	}
+
+	for (int section = 0; section < SSE_COUNT; section++) {
+		if (section != SSE_WORLD && !changed_sections[section].empty()) state.sections[section] = std::move(changed_sections[section]);
+	}
+	std::copy(std::begin(change_stamps), std::end(change_stamps), std::begin(state.change_stamps));
+	state.file_size += delta.size();
+	state.num_deltas++;
+	return true;
+#endif
+}
@@ -11,6 +11,7 @@
 #define LOADSAVE_H
 
 #include <ctime>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -21,6 +22,12 @@ struct Scenario;
 static const std::string SAVEGAME_DIRECTORY("save");  ///< The directory where savegames are stored, relative to the user data directory.
 static const std::string TRACK_DESIGN_DIRECTORY("tracks");  ///< The directory where track designs are stored, relative to the user data directory.
 
+/**
+ * Callback to report the progress of loading a file.
+ * The first parameter is the number of bytes read so far, the second parameter is the size of the file in bytes.
+ */
+using LoadProgressCallback = std::function<void(size_t, size_t)>;
+
 /** Class for loading a save game. */
 class Loader {
 public:
@@ -39,9 +46,14 @@ public:
 
 	void VersionMismatch(uint saved_version, uint current_version);
 
+	void SetProgressCallback(const LoadProgressCallback &callback);
+	size_t GetFileOffset() const;
+	bool IsAtEnd();
+
 private:
 	bool HasNoInput() const;
 	void PutByte(uint8 val);
+	bool FillBuffer();
 
 	std::vector<std::string> pattern_names; ///< Stack of the currently loaded pattern.
 
@@ -50,6 +62,13 @@ private:
 	RcdFileReader *rcd_file;
 	std::optional<std::pair<const uint8*, size_t>> binary_stream;
 
+	std::unique_ptr<uint8[]> file_buffer; ///< Data read from #fp, but not yet returned.
+	size_t buffer_pos;                    ///< Index of the next byte to return from #file_buffer.
+	size_t buffer_length;                 ///< Number of valid bytes in #file_buffer.
+	size_t file_done;                     ///< Number of bytes read from #fp so far.
+	size_t file_size;                     ///< Number of bytes in #fp, \c 0 if unknown.
+	LoadProgressCallback progress;        ///< Callback to report the progress of reading #fp, may be empty.
+
 	int cache_count;      ///< Number of values in #cache.
 	uint8 cache[8];       ///< Stack with temporary values to return on next read.
 };
@@ -58,6 +77,7 @@ private:
 class Saver {
 public:
 	Saver(const char *filename, FILE *fp);
+	explicit Saver(std::vector<uint8> *buffer);
 
 #ifdef WEBASSEMBLY
 	~Saver();
@@ -77,6 +97,7 @@ public:
 
 private:
 	FILE *fp; ///< Output file stream.
+	std::vector<uint8> *buffer; ///< Output memory buffer, used if there is no output file stream.
 	std::vector<std::string> pattern_names; ///< Stack of the current pattern names.
 
 #ifdef WEBASSEMBLY
@@ -105,10 +126,14 @@ struct PreloadData {
 };
 
 void LoadGame(Loader &ldr);
-bool LoadGameFile(const char *fname);
+void SaveGame(Saver &svr);
+bool LoadGameFile(const char *fname, const LoadProgressCallback &progress = nullptr);
 bool SaveGameFile(const char *fname);
+bool SaveIncrementalGameFile(const char *fname);
+bool AppendIncrementalGameFile(const char *fname);
 PreloadData Preload(Loader &ldr);
 PreloadData PreloadGameFile(const char *fname);
+std::vector<PreloadData> PreloadSavegameDirectory();
 
 extern bool _automatically_resave_files;
 
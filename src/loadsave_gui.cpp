@@ -142,13 +142,7 @@ static const WidgetPart _loadsave_gui_parts[] = {
 
 LoadSaveGui::LoadSaveGui(const Type t) : GuiWindow(WC_LOADSAVE, ALL_WINDOWS_OF_TYPE), type(t), current_sort(nullptr)
 {
-	/* Get all .fct files in the directory. */
-
-	for (const std::string &name : GetAllEntries((freerct_userdata_prefix() + DIR_SEP + SAVEGAME_DIRECTORY))) {
-		if (name.size() > 4 && name.compare(name.size() - 4, 4, ".fct") == 0) {
-			this->all_files.push_back(PreloadGameFile(name.c_str()));
-		}
-	}
+	this->all_files = PreloadSavegameDirectory();
 
 	this->SetupWidgetTree(_loadsave_gui_parts, lengthof(_loadsave_gui_parts));
 	this->SetScrolledWidget(LSW_LIST, LSW_SCROLLBAR);
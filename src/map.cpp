@@ -27,6 +27,7 @@ VoxelWorld _world;
 /** Make the voxel empty. */
 void Voxel::ClearVoxel()
 {
+	this->ground = 0;  // Also clears the foundation slopes and the unused bits.
 	this->SetGroundType(GTP_INVALID);
 	this->SetFoundationType(FDT_INVALID);
 	this->SetGroundSlope(ISL_FLAT);
@@ -36,8 +37,8 @@ void Voxel::ClearVoxel()
 	this->voxel_objects = nullptr;
 }
 
-static const uint32 CURRENT_VERSION_VSTK  = 3;   ///< Currently supported version of the VSTK pattern.
-static const uint32 CURRENT_VERSION_Voxel = 4;   ///< Currently supported version of the voxel pattern.
+static const uint32 CURRENT_VERSION_VSTK  = 3;   ///< Last version of the VSTK pattern, the stacks are now saved in the world pattern.
+static const uint32 CURRENT_VERSION_Voxel = 4;   ///< Last version of the voxel pattern, the voxels are now saved in the world pattern.
 
 /**
  * Load a voxel from the save game.
@@ -69,24 +70,6 @@ void Voxel::Load(Loader &ldr)
 	ldr.ClosePattern();
 }
 
-/**
- * Write a voxel to the save game.
- * @param svr Output stream to write.
- */
-void Voxel::Save(Saver &svr) const
-{
-	svr.StartPattern("voxl", CURRENT_VERSION_Voxel);
-	svr.PutLong(this->ground);
-	if (this->instance >= SRI_RIDES_START && this->instance < SRI_FULL_RIDES) {
-		svr.PutByte(this->instance);
-		svr.PutWord(this->instance_data);
-	} else {
-		svr.PutByte(SRI_FREE); // Full rides save their own data from the world.
-	}
-	svr.PutWord(this->fences);
-	svr.EndPattern();
-}
-
 VoxelObject::~VoxelObject()
 {
 	if (this->added) {
@@ -231,8 +214,9 @@ Voxel *VoxelStack::GetCreate(int16 z, bool create)
 }
 
 /** Default constructor of the voxel world. */
-VoxelWorld::VoxelWorld() : x_size(64), y_size(64)
+VoxelWorld::VoxelWorld() : x_size(64), y_size(64), change_stamp(0), all_stacks_change_stamp(0), path_network_version(1), path_changes_start(1)
 {
+	std::fill_n(this->stack_change_stamps, lengthof(this->stack_change_stamps), 0);
 }
 
 /**
@@ -252,6 +236,8 @@ void VoxelWorld::SetWorldSize(uint16 xs, uint16 ys)
 	for (uint pos = 0; pos < WORLD_X_SIZE * WORLD_Y_SIZE; pos++) {
 		this->stacks[pos].Clear();
 	}
+	this->MarkAllStacksDirty();
+	this->NotifyPathChange();
 }
 
 /**
@@ -299,6 +285,7 @@ void VoxelWorld::MakeFlatWorld(int16 z)
 		AddFoundations(this, 0, ypos, z, 0x03);
 		AddFoundations(this, this->x_size - 1, ypos, z, 0x30);
 	}
+	this->MarkAllStacksDirty();
 }
 
 /**
@@ -335,7 +322,7 @@ void VoxelStack::Load(Loader &ldr)
 {
 	this->Clear();
 	uint32 version = ldr.OpenPattern("VSTK");
-	if (version >= 1 && version <= 3) {
+	if (version >= 1 && version <= CURRENT_VERSION_VSTK) {
 		int16 base = ldr.GetWord();
 		uint16 height = ldr.GetWord();
 		uint8 owner = ldr.GetByte();
@@ -386,21 +373,6 @@ void VoxelStack::Load(Loader &ldr)
 	ldr.ClosePattern();
 }
 
-/**
- * Save a voxel stack to the save game file.
- * @param svr Output stream to write.
- */
-void VoxelStack::Save(Saver &svr) const
-{
-	svr.CheckNoOpenPattern();
-	svr.StartPattern("VSTK", CURRENT_VERSION_VSTK);
-	svr.PutWord(this->base);
-	svr.PutWord(this->height);
-	svr.PutByte(this->owner);
-	for (uint i = 0; i < this->height; i++) this->voxels[i]->Save(svr);
-	svr.EndPattern();
-}
-
 /**
  * Get a voxel stack.
  * @param x X coordinate of the stack.
@@ -624,6 +596,7 @@ uint16 GetGroundFencesFromMap(const VoxelStack *stack, int base_z)
 void VoxelWorld::AddEdgesWithoutBorderFence(const Point16& p, TileEdge e)
 {
 	this->edges_without_border_fence.insert(std::make_pair(p, e));
+	this->MarkStackDirty(p.x, p.y);  // The set of edges is saved with the world.
 	this->UpdateLandBorderFence(p.x - std::min<int>(p.x, 1), p.y - std::min<int>(p.y, 1), 3, 3);
 }
 
@@ -652,6 +625,7 @@ void VoxelWorld::UpdateLandBorderFence(uint16 x, uint16 y, uint16 width, uint16
 
 			int16 height = vs->GetBaseGroundOffset() + vs->base;
 			uint16 fences = GetGroundFencesFromMap(vs, height);
+			const uint16 old_fences = fences;
 			for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
 				FenceType ftype = GetFenceType(fences, edge);
 				/* Don't overwrite user-buildable fences. */
@@ -673,7 +647,10 @@ void VoxelWorld::UpdateLandBorderFence(uint16 x, uint16 y, uint16 width, uint16
 
 				fences = SetFenceType(fences, edge, ftype);
 			}
+			if (fences == old_fences) continue;
+
 			AddGroundFencesToMap(fences, vs, height);
+			this->MarkStackDirty(ix, iy);
 		}
 	}
 }
@@ -687,6 +664,7 @@ void VoxelWorld::UpdateLandBorderFence(uint16 x, uint16 y, uint16 width, uint16
 void VoxelWorld::SetTileOwner(uint16 x, uint16 y, TileOwner owner)
 {
 	this->GetModifyStack(x, y)->owner = owner;
+	this->MarkStackDirty(x, y);
 
 	UpdateLandBorderFence(x, y, 1, 1);
 }
@@ -704,6 +682,7 @@ void VoxelWorld::SetTileOwnerRect(uint16 x, uint16 y, uint16 width, uint16 heigh
 	for (unsigned ix = x; ix < x + width; ix++) {
 		for (unsigned iy = y; iy < y + height; iy++) {
 			this->GetModifyStack(ix, iy)->owner = owner;
+			this->MarkStackDirty(ix, iy);
 		}
 	}
 
@@ -732,7 +711,354 @@ XYZPoint16 VoxelWorld::GetParkEntrance() const
 	return XYZPoint16(p.x, p.y, this->GetBaseGroundHeight(p.x, p.y));
 }
 
-static const uint32 CURRENT_VERSION_WRLD = 2;   ///< Currently supported version of the WRLD Pattern.
+/**
+ * Record that the contents of a voxel stack have changed in a way that is visible in an overview of the world,
+ * such as its ground height, ownership, paths, rides, or scenery.
+ * @param x X coordinate of the stack.
+ * @param y Y coordinate of the stack.
+ * @see GetStackChangeStamp, GetChangedStacks
+ */
+void VoxelWorld::MarkStackDirty(uint16 x, uint16 y)
+{
+	assert(x < WORLD_X_SIZE && y < WORLD_Y_SIZE);
+	this->stack_change_stamps[x + y * WORLD_X_SIZE] = ++this->change_stamp;
+}
+
+/** Record that every voxel stack of the world has changed. */
+void VoxelWorld::MarkAllStacksDirty()
+{
+	this->all_stacks_change_stamp = ++this->change_stamp;
+}
+
+/**
+ * Find the voxel stacks that changed after a stamp. Every user of the changes keeps its own stamp,
+ * the stamp of the world at its previous update (see #GetChangeStamp).
+ * @param stamp Stamp of the world at the previous update of the caller.
+ * @param stacks [out] Receives the coordinates of the changed stacks. Not filled if the entire world changed.
+ * @return Whether the entire world has changed.
+ */
+bool VoxelWorld::GetChangedStacks(uint32 stamp, std::vector<Point16> *stacks) const
+{
+	stacks->clear();
+	if (this->all_stacks_change_stamp > stamp) return true;
+	if (this->change_stamp == stamp) return false;
+
+	for (uint16 y = 0; y < this->y_size; y++) {
+		const uint32 *row = this->stack_change_stamps + y * WORLD_X_SIZE;
+		for (uint16 x = 0; x < this->x_size; x++) {
+			if (row[x] > stamp) stacks->emplace_back(x, y);
+		}
+	}
+	return false;
+}
+
+/** Record that paths anywhere in the world may have been added or removed. */
+void VoxelWorld::NotifyPathChange()
+{
+	this->path_network_version++;
+	this->path_changes_start = this->path_network_version;
+	this->path_changes.clear();
+}
+
+/**
+ * Record that paths, or the connections between them, have been added or removed around a voxel.
+ * @param vox Voxel of the changed path. Connections to the paths in the voxels next to it may have changed as well.
+ * @see GetPathChanges
+ */
+void VoxelWorld::NotifyPathChange(const XYZPoint16 &vox)
+{
+	static const size_t MAX_PATH_CHANGES = 1024; ///< Number of kept changes, older changes are forgotten.
+
+	this->path_network_version++;
+	if (this->path_changes.size() >= MAX_PATH_CHANGES) {
+		this->path_changes_start = this->path_changes.front().first;
+		this->path_changes.pop_front();
+	}
+	this->path_changes.emplace_back(this->path_network_version, vox);
+}
+
+/**
+ * Find the voxels around which paths changed after a version of the path network. Every user of the changes keeps
+ * its own version, the version of the path network at its previous update (see #GetPathNetworkVersion).
+ * @param version Path network version at the previous update of the caller.
+ * @param voxels [out] Receives the voxels of the changed paths. Not filled if all paths may have changed.
+ * @return Whether all paths of the world may have changed, or the changes are too old to be known.
+ */
+bool VoxelWorld::GetPathChanges(uint32 version, std::vector<XYZPoint16> *voxels) const
+{
+	voxels->clear();
+	if (version < this->path_changes_start) return true;
+
+	for (auto it = this->path_changes.rbegin(); it != this->path_changes.rend() && it->first > version; ++it) {
+		voxels->push_back(it->second);
+	}
+	return false;
+}
+
+static const uint32 CURRENT_VERSION_WRLD = 3;   ///< Currently supported version of the WRLD Pattern.
+
+/**
+ * Write a value of a run-length encoded field.
+ * @param svr Output stream to write.
+ * @param val Value to write.
+ */
+static void PutRunValue(Saver &svr, uint8 val)
+{
+	svr.PutByte(val);
+}
+
+/** @copydoc PutRunValue(Saver &, uint8) */
+static void PutRunValue(Saver &svr, uint16 val)
+{
+	svr.PutWord(val);
+}
+
+/** @copydoc PutRunValue(Saver &, uint8) */
+static void PutRunValue(Saver &svr, uint32 val)
+{
+	svr.PutLong(val);
+}
+
+/**
+ * Read a value of a run-length encoded field.
+ * @param ldr Input stream to read.
+ * @param val [out] Read value.
+ */
+static void GetRunValue(Loader &ldr, uint8 *val)
+{
+	*val = ldr.GetByte();
+}
+
+/** @copydoc GetRunValue(Loader &, uint8 *) */
+static void GetRunValue(Loader &ldr, uint16 *val)
+{
+	*val = ldr.GetWord();
+}
+
+/** @copydoc GetRunValue(Loader &, uint8 *) */
+static void GetRunValue(Loader &ldr, uint32 *val)
+{
+	*val = ldr.GetLong();
+}
+
+/**
+ * Write one field of all voxel stacks or voxels of the world, as runs of equal values.
+ * @tparam T Type of the field.
+ * @param svr Output stream to write.
+ * @param values Value of the field for every voxel stack or voxel, in saving order.
+ */
+template <typename T>
+static void SaveRunLengthField(Saver &svr, const std::vector<T> &values)
+{
+	std::vector<std::pair<uint16, T>> runs;
+	for (const T &val : values) {
+		if (!runs.empty() && runs.back().second == val && runs.back().first < UINT16_MAX) {
+			runs.back().first++;
+		} else {
+			runs.emplace_back(1, val);
+		}
+	}
+
+	svr.PutLong(runs.size());
+	for (const auto &run : runs) {
+		svr.PutWord(run.first);
+		PutRunValue(svr, run.second);
+	}
+}
+
+/**
+ * Read one field of all voxel stacks or voxels of the world, written by #SaveRunLengthField.
+ * @tparam T Type of the field.
+ * @param ldr Input stream to read.
+ * @param count Expected number of values.
+ * @param values [out] Value of the field for every voxel stack or voxel, in saving order.
+ */
+template <typename T>
+static void LoadRunLengthField(Loader &ldr, size_t count, std::vector<T> *values)
+{
+	values->clear();
+	values->reserve(count);
+	for (uint32 runs = ldr.GetLong(); runs > 0; runs--) {
+		uint16 length = ldr.GetWord();
+		T val;
+		GetRunValue(ldr, &val);
+		if (length > count - values->size()) throw LoadingError("Too much world data");
+		values->insert(values->end(), length, val);
+	}
+	if (values->size() != count) throw LoadingError("Too little world data");
+}
+
+/**
+ * Get the ride instance and its data of a voxel, as saved with the world.
+ * @param voxel %Voxel to save.
+ * @return Ride instance and instance data to save.
+ */
+static std::pair<uint8, uint16> GetSavedInstance(const Voxel &voxel)
+{
+	if (voxel.instance >= SRI_RIDES_START && voxel.instance < SRI_FULL_RIDES) return {voxel.instance, voxel.instance_data};
+	return {SRI_FREE, 0}; // Full rides save their own data from the world.
+}
+
+/**
+ * Fill a voxel with the data saved with the world.
+ * @param voxel [out] %Voxel to fill.
+ * @param ground Saved ground data.
+ * @param instance Saved ride instance.
+ * @param instance_data Saved ride instance data.
+ * @param fences Saved fences.
+ */
+static void SetSavedVoxel(Voxel *voxel, uint32 ground, uint8 instance, uint16 instance_data, uint16 fences)
+{
+	voxel->ClearVoxel();
+	voxel->ground = ground; /// \todo Check sanity of the data.
+	voxel->instance = instance;
+	if (voxel->instance == SRI_FREE) {
+		voxel->instance_data = 0; // Full rides load after the world, overwriting map data.
+	} else if (voxel->instance >= SRI_RIDES_START && voxel->instance < SRI_FULL_RIDES) {
+		voxel->instance_data = instance_data;
+	} else {
+		throw LoadingError("Unknown voxel instance data");
+	}
+	voxel->fences = fences;
+}
+
+/** Fields of voxel stacks and their voxels, as saved with the world. Each field is written as one sequence of runs of equal values. */
+struct SavedStackFields {
+	std::vector<uint16> bases;          ///< Base heights of the stacks.
+	std::vector<uint16> heights;        ///< Number of voxels of the stacks.
+	std::vector<uint8> owners;          ///< Owners of the stacks.
+	std::vector<uint32> grounds;        ///< Ground data of the voxels.
+	std::vector<uint8> instances;       ///< Ride instances of the voxels.
+	std::vector<uint16> instance_data;  ///< Ride instance data of the voxels.
+	std::vector<uint16> fences;         ///< Fences of the voxels.
+
+	/**
+	 * Add the fields of a voxel stack and its voxels.
+	 * @param vs Voxel stack to add.
+	 */
+	void Add(const VoxelStack *vs)
+	{
+		this->bases.push_back(vs->base);
+		this->heights.push_back(vs->height);
+		this->owners.push_back(vs->owner);
+		for (const auto &voxel : vs->voxels) {
+			const auto instance = GetSavedInstance(*voxel);
+			this->grounds.push_back(voxel->ground);
+			this->instances.push_back(instance.first);
+			this->instance_data.push_back(instance.second);
+			this->fences.push_back(voxel->fences);
+		}
+	}
+
+	/**
+	 * Write the fields of the added voxel stacks.
+	 * @param svr Output stream to write.
+	 */
+	void Save(Saver &svr) const
+	{
+		SaveRunLengthField(svr, this->bases);
+		SaveRunLengthField(svr, this->heights);
+		SaveRunLengthField(svr, this->owners);
+		SaveRunLengthField(svr, this->grounds);
+		SaveRunLengthField(svr, this->instances);
+		SaveRunLengthField(svr, this->instance_data);
+		SaveRunLengthField(svr, this->fences);
+	}
+
+	/**
+	 * Read the fields of voxel stacks written by #Save.
+	 * @param ldr Input stream to read.
+	 * @param stack_count Number of saved voxel stacks.
+	 */
+	void Load(Loader &ldr, size_t stack_count)
+	{
+		LoadRunLengthField(ldr, stack_count, &this->bases);
+		LoadRunLengthField(ldr, stack_count, &this->heights);
+		LoadRunLengthField(ldr, stack_count, &this->owners);
+
+		size_t voxel_count = 0;
+		for (size_t i = 0; i < stack_count; i++) {
+			const int16 base = this->bases[i];
+			if (base < 0 || base + this->heights[i] > WORLD_Z_SIZE || this->owners[i] >= OWN_COUNT) throw LoadingError("Invalid voxel stack size");
+			voxel_count += this->heights[i];
+		}
+
+		LoadRunLengthField(ldr, voxel_count, &this->grounds);
+		LoadRunLengthField(ldr, voxel_count, &this->instances);
+		LoadRunLengthField(ldr, voxel_count, &this->instance_data);
+		LoadRunLengthField(ldr, voxel_count, &this->fences);
+	}
+
+	/**
+	 * Replace a voxel stack with the next loaded voxel stack.
+	 * @param vs [out] Voxel stack to replace.
+	 * @param stack_index [inout] Index of the next loaded voxel stack.
+	 * @param voxel_index [inout] Index of the first voxel of the next loaded voxel stack.
+	 */
+	void Fill(VoxelStack *vs, size_t *stack_index, size_t *voxel_index) const
+	{
+		vs->Clear();
+		vs->base = this->bases[*stack_index];
+		vs->height = this->heights[*stack_index];
+		vs->owner = static_cast<TileOwner>(this->owners[*stack_index]);
+		(*stack_index)++;
+
+		vs->voxels.resize(vs->height);
+		for (auto &voxel : vs->voxels) {
+			voxel.reset(new Voxel);
+			SetSavedVoxel(voxel.get(), this->grounds[*voxel_index], this->instances[*voxel_index], this->instance_data[*voxel_index], this->fences[*voxel_index]);
+			(*voxel_index)++;
+		}
+	}
+};
+
+/**
+ * Load the voxel stacks of the world, saved in bulk by #VoxelWorld::Save.
+ * @param ldr Input stream to read.
+ */
+void VoxelWorld::LoadStacks(Loader &ldr)
+{
+	SavedStackFields fields;
+	fields.Load(ldr, this->GetXSize() * this->GetYSize());
+
+	size_t stack_index = 0;
+	size_t voxel_index = 0;
+	for (uint16 x = 0; x < this->GetXSize(); x++) {
+		for (uint16 y = 0; y < this->GetYSize(); y++) {
+			fields.Fill(this->GetModifyStack(x, y), &stack_index, &voxel_index);
+		}
+	}
+}
+
+/**
+ * Load the tile edges at which no border fence is desired.
+ * @param ldr Input stream to read.
+ * @param edges [out] Loaded tile edges, added to the existing entries.
+ */
+static void LoadEdgesWithoutBorderFence(Loader &ldr, std::set<std::pair<Point16, TileEdge>> *edges)
+{
+	for (int i = ldr.GetWord(); i > 0; i--) {
+		Point16 p;
+		p.x = ldr.GetWord();
+		p.y = ldr.GetWord();
+		edges->insert(std::make_pair(p, static_cast<TileEdge>(ldr.GetByte())));
+	}
+}
+
+/**
+ * Save the tile edges at which no border fence is desired.
+ * @param svr Output stream to write.
+ * @param edges Tile edges to save.
+ */
+static void SaveEdgesWithoutBorderFence(Saver &svr, const std::set<std::pair<Point16, TileEdge>> &edges)
+{
+	svr.PutWord(edges.size());
+	for (const auto &pair : edges) {
+		svr.PutWord(pair.first.x);
+		svr.PutWord(pair.first.y);
+		svr.PutByte(pair.second);
+	}
+}
 
 /**
  * Load the world from a file.
@@ -744,27 +1070,22 @@ void VoxelWorld::Load(Loader &ldr)
 	uint16 xsize = 64;
 	uint16 ysize = 64;
 	this->edges_without_border_fence.clear();
-	if (version >= 1 && version <= 2) {
+	if (version >= 1 && version <= CURRENT_VERSION_WRLD) {
 		xsize = ldr.GetWord();
 		ysize = ldr.GetWord();
-		if (version > 1) {
-			for (int i = ldr.GetWord(); i > 0; i--) {
-				Point16 p;
-				p.x = ldr.GetWord();
-				p.y = ldr.GetWord();
-				this->edges_without_border_fence.insert(std::make_pair(p, static_cast<TileEdge>(ldr.GetByte())));
-			}
-		}
+		if (version > 1) LoadEdgesWithoutBorderFence(ldr, &this->edges_without_border_fence);
 	} else if (version != 0) {
 		ldr.VersionMismatch(version, CURRENT_VERSION_WRLD);
 	}
 	if (xsize >= WORLD_X_SIZE || ysize >= WORLD_Y_SIZE) {
 		throw LoadingError("World size out of bounds (%u × %u)", xsize, ysize);
 	}
-	ldr.ClosePattern();
 
 	this->SetWorldSize(xsize, ysize);
-	if (version != 0) {
+	if (version >= 3) this->LoadStacks(ldr);
+	ldr.ClosePattern();
+
+	if (version == 1 || version == 2) {
 		for (uint16 x = 0; x < xsize; x++) {
 			for (uint16 y = 0; y < ysize; y++) {
 				VoxelStack *vs = this->GetModifyStack(x, y);
@@ -777,6 +1098,7 @@ void VoxelWorld::Load(Loader &ldr)
 
 /**
  * Save the world to a file.
+ * The voxel stacks are saved as #SavedStackFields, in the same order as the old "VSTK" patterns.
  * @param svr Output stream to save to.
  */
 void VoxelWorld::Save(Saver &svr) const
@@ -786,17 +1108,89 @@ void VoxelWorld::Save(Saver &svr) const
 	svr.StartPattern("WRLD", CURRENT_VERSION_WRLD);
 	svr.PutWord(this->GetXSize());
 	svr.PutWord(this->GetYSize());
-	svr.PutWord(this->edges_without_border_fence.size());
-	for (const auto &pair : this->edges_without_border_fence) {
-		svr.PutWord(pair.first.x);
-		svr.PutWord(pair.first.y);
-		svr.PutByte(pair.second);
+	SaveEdgesWithoutBorderFence(svr, this->edges_without_border_fence);
+
+	SavedStackFields fields;
+	for (uint16 x = 0; x < this->GetXSize(); x++) {
+		for (uint16 y = 0; y < this->GetYSize(); y++) {
+			fields.Add(this->GetStack(x, y));
+		}
 	}
+	fields.Save(svr);
 	svr.EndPattern();
-	for (uint16 x = 0; x < this->GetXSize(); x++) {
+}
+
+static const uint32 CURRENT_VERSION_wdlt = 1;   ///< Currently supported version of the wdlt Pattern.
+
+/**
+ * Save the changes of the world since a change stamp, for an incremental savegame.
+ * Applying the changes with #LoadChanges to the world of that time gives the current world.
+ * @param svr Output stream to save to.
+ * @param stamp Change stamp of the world at the previous save (see #GetChangeStamp).
+ *              If the entire world changed since, all voxel stacks are saved.
+ */
+void VoxelWorld::SaveChanges(Saver &svr, uint32 stamp) const
+{
+	std::vector<Point16> changed;
+	if (this->GetChangedStacks(stamp, &changed)) {
+		changed.reserve(this->GetXSize() * this->GetYSize());
 		for (uint16 y = 0; y < this->GetYSize(); y++) {
-			const VoxelStack *vs = this->GetStack(x, y);
-			vs->Save(svr);
+			for (uint16 x = 0; x < this->GetXSize(); x++) changed.emplace_back(x, y);
 		}
 	}
+
+	svr.CheckNoOpenPattern();
+	svr.StartPattern("wdlt", CURRENT_VERSION_wdlt);
+	svr.PutWord(this->GetXSize());
+	svr.PutWord(this->GetYSize());
+	SaveEdgesWithoutBorderFence(svr, this->edges_without_border_fence);
+	svr.PutLong(changed.size());
+	SavedStackFields fields;
+	for (const Point16 &p : changed) {
+		svr.PutWord(p.x);
+		svr.PutWord(p.y);
+		fields.Add(this->GetStack(p.x, p.y));
+	}
+	fields.Save(svr);
+	svr.EndPattern();
+}
+
+/**
+ * Apply changes saved by #SaveChanges to the loaded world.
+ * @param ldr Input stream to read from.
+ */
+void VoxelWorld::LoadChanges(Loader &ldr)
+{
+	const uint32 version = ldr.OpenPattern("wdlt");
+	if (version != CURRENT_VERSION_wdlt) ldr.VersionMismatch(version, CURRENT_VERSION_wdlt);
+
+	const uint16 xsize = ldr.GetWord();
+	const uint16 ysize = ldr.GetWord();
+	if (xsize >= WORLD_X_SIZE || ysize >= WORLD_Y_SIZE) {
+		throw LoadingError("World size out of bounds (%u × %u)", xsize, ysize);
+	}
+	if (xsize != this->GetXSize() || ysize != this->GetYSize()) this->SetWorldSize(xsize, ysize);
+
+	this->edges_without_border_fence.clear();
+	LoadEdgesWithoutBorderFence(ldr, &this->edges_without_border_fence);
+
+	const uint32 count = ldr.GetLong();
+	if (count > static_cast<uint32>(xsize * ysize)) throw LoadingError("Too many changed voxel stacks");
+	std::vector<Point16> changed(count);
+	for (Point16 &p : changed) {
+		p.x = ldr.GetWord();
+		p.y = ldr.GetWord();
+		if (p.x < 0 || p.x >= xsize || p.y < 0 || p.y >= ysize) throw LoadingError("Invalid voxel stack position");
+	}
+	SavedStackFields fields;
+	fields.Load(ldr, changed.size());
+
+	size_t stack_index = 0;
+	size_t voxel_index = 0;
+	for (const Point16 &p : changed) {
+		fields.Fill(this->GetModifyStack(p.x, p.y), &stack_index, &voxel_index);
+		this->MarkStackDirty(p.x, p.y);
+	}
+	this->NotifyPathChange();
+	ldr.ClosePattern();
 }
@@ -16,6 +16,7 @@
 #include "sprite_store.h"
 #include "bitmath.h"
 
+#include <deque>
 #include <map>
 #include <set>
 
@@ -292,14 +293,23 @@ public:
 	}
 
 	void ClearVoxel();
-	void Save(Saver &svr) const;
 	void Load(Loader &ldr);
 };
 
+/** Kinds of voxel objects, to find objects of a kind in a voxel without run-time type information. */
+enum VoxelObjectKind : uint8 {
+	VOK_OTHER,  ///< Object without a special kind, for example a car of a ride.
+	VOK_PERSON, ///< The object is a #Person, its \c type tells what kind of person.
+};
+
 /** Base class for (moving) objects that are stored at a voxel position for easy retrieval during drawing. */
 class VoxelObject {
 public:
-	VoxelObject() : next_object(nullptr), prev_object(nullptr), added(false)
+	/**
+	 * Constructor.
+	 * @param kind Kind of the object.
+	 */
+	explicit VoxelObject(VoxelObjectKind kind = VOK_OTHER) : next_object(nullptr), prev_object(nullptr), added(false), kind(kind)
 	{
 	}
 
@@ -402,6 +412,7 @@ public:
 	VoxelObject *next_object; ///< Next voxel object in the linked list.
 	VoxelObject *prev_object; ///< Previous voxel object in the linked list.
 	bool added;               ///< Whether the voxel object has been added to a voxel.
+	const VoxelObjectKind kind; ///< Kind of the object.
 
 	XYZPoint16 vox_pos; ///< %Voxel position of the object.
 	XYZPoint16 pix_pos; ///< Position of the object inside the voxel (0..255, but may be outside).
@@ -555,7 +566,6 @@ public:
 	int GetTopGroundOffset() const;
 	int GetBaseGroundOffset() const;
 
-	void Save(Saver &svr) const;
 	void Load(Loader &ldr);
 
 	std::vector<std::unique_ptr<Voxel>> voxels;  ///< %Voxel array at this stack.
@@ -600,7 +610,11 @@ public:
 	 */
 	inline Voxel *GetCreateVoxel(const XYZPoint16 &vox, bool create)
 	{
-		return this->GetModifyStack(vox.x, vox.y)->GetCreate(vox.z, create);
+		VoxelStack *vs = this->GetModifyStack(vox.x, vox.y);
+		const uint16 old_height = vs->height;
+		Voxel *v = vs->GetCreate(vox.z, create);
+		if (vs->height != old_height) this->MarkStackDirty(vox.x, vox.y); // The stack grew, which changes its saved data.
+		return v;
 	}
 
 	/**
@@ -644,14 +658,64 @@ public:
 
 	XYZPoint16 GetParkEntrance() const;
 
+	void MarkStackDirty(uint16 x, uint16 y);
+	void MarkAllStacksDirty();
+	bool GetChangedStacks(uint32 stamp, std::vector<Point16> *stacks) const;
+
+	/**
+	 * Get the stamp of the latest change of the world, see #MarkStackDirty.
+	 * Stamps increase with every change, so a voxel stack has changed since a stamp if its own stamp is bigger.
+	 * @return Stamp of the latest change.
+	 */
+	inline uint32 GetChangeStamp() const
+	{
+		return this->change_stamp;
+	}
+
+	/**
+	 * Get the stamp of the latest change of a voxel stack.
+	 * @param x X coordinate of the stack.
+	 * @param y Y coordinate of the stack.
+	 * @return Stamp of the latest change of the stack.
+	 * @see GetChangeStamp
+	 */
+	inline uint32 GetStackChangeStamp(uint16 x, uint16 y) const
+	{
+		return std::max(this->stack_change_stamps[x + y * WORLD_X_SIZE], this->all_stacks_change_stamp);
+	}
+
+	void NotifyPathChange();
+	void NotifyPathChange(const XYZPoint16 &vox);
+	bool GetPathChanges(uint32 version, std::vector<XYZPoint16> *voxels) const;
+
+	/**
+	 * Get the version of the path network, which changes whenever paths or their connections change.
+	 * @return Current version of the path network.
+	 */
+	inline uint32 GetPathNetworkVersion() const
+	{
+		return this->path_network_version;
+	}
+
 	void Save(Saver &svr) const;
 	void Load(Loader &ldr);
+	void SaveChanges(Saver &svr, uint32 stamp) const;
+	void LoadChanges(Loader &ldr);
 
 private:
+	void LoadStacks(Loader &ldr);
+
 	uint16 x_size; ///< Current max x size (in voxels).
 	uint16 y_size; ///< Current max y size (in voxels).
 
 	VoxelStack stacks[WORLD_X_SIZE * WORLD_Y_SIZE]; ///< All voxel stacks in the world.
+
+	uint32 change_stamp;                                  ///< Stamp of the latest change. @see GetChangeStamp
+	uint32 all_stacks_change_stamp;                       ///< Stamp of the latest change of all voxel stacks at once.
+	uint32 stack_change_stamps[WORLD_X_SIZE * WORLD_Y_SIZE]; ///< For each voxel stack, the stamp of its latest change.
+	uint32 path_network_version;                          ///< Version of the path network. @see GetPathNetworkVersion
+	uint32 path_changes_start;                            ///< Path network version from which on every change is in #path_changes.
+	std::deque<std::pair<uint32, XYZPoint16>> path_changes; ///< Recent path changes, as path network version of the change and voxel of the changed path.
 	std::set<std::pair<Point16, TileEdge>> edges_without_border_fence;  ///< Tile edges at which no border fence is desired.
 };
 
@@ -691,4 +755,15 @@ static inline bool IsVoxelInsideWorld(const XYZPoint16 &vox)
 	return vox.z >= 0 && vox.z < WORLD_Z_SIZE && IsVoxelstackInsideWorld(vox.x, vox.y);
 }
 
+/**
+ * Compute the key of a voxel in a hashed voxel container.
+ * Keys of voxels inside the world sort in the same order as their coordinates.
+ * @param vox Voxel coordinate.
+ * @return Key of the voxel.
+ */
+static inline uint32 GetVoxelKey(const XYZPoint16 &vox)
+{
+	return ((vox.x & 0xFF) << 16) | ((vox.y & 0xFF) << 8) | (vox.z & 0xFF);
+}
+
 #endif
@@ -177,6 +177,7 @@ void Inbox::Clear()
 	this->display_time = 0;
 	this->display_message = nullptr;
 	this->messages.clear();
+	this->change_stamp++;
 }
 
 /**
@@ -186,6 +187,7 @@ void Inbox::Clear()
 void Inbox::SendMessage(Message *message)
 {
 	this->messages.push_back(std::unique_ptr<Message>(message));
+	this->change_stamp++;
 	if (this->display_message == nullptr) {
 		this->display_time = 0;
 		this->display_message = message;
@@ -229,6 +231,7 @@ void Inbox::NotifyRideDeletion(const uint16 ride)
 		if ((*it)->data_type == MDT_RIDE_INSTANCE && (*it)->data1 == ride) {
 			if (it->get() == this->display_message) this->DismissDisplayMessage();
 			it = this->messages.erase(it);
+			this->change_stamp++;
 		} else {
 			it++;
 		}
@@ -245,6 +248,7 @@ void Inbox::NotifyGuestDeletion(const uint16 guest)
 		if ((*it)->data_type == MDT_GUEST && (*it)->data1 == guest) {
 			if (it->get() == this->display_message) this->DismissDisplayMessage();
 			it = this->messages.erase(it);
+			this->change_stamp++;
 		} else {
 			it++;
 		}
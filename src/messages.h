@@ -75,6 +75,7 @@ struct Inbox {
 	std::list<std::unique_ptr<Message>> messages;  ///< All messages belonging to the player.
 	Message *display_message;                      ///< Message to display in the bottom toolbar (may be \c nullptr).
 	uint32 display_time;                           ///< Number of milliseconds for which the #display_message (if any) has been shown.
+	uint32 change_stamp;                           ///< Incremented with every change of the #messages, to find out whether they must be saved again.
 };
 extern Inbox _inbox;
 
@@ -16,28 +16,66 @@
 #include "gamecontrol.h"
 #include "gui_sprites.h"
 #include "sprite_data.h"
+#include "people.h"
 
 /**
  * %Minimap window.
+ * The map itself is rendered once into a texture with a cell of 2×1 pixels per voxel stack,
+ * which is updated only for the voxel stacks that changed (see #VoxelWorld::GetChangedStacks).
  * @ingroup gui_group
  */
 class Minimap : public GuiWindow {
 public:
 	Minimap();
+	~Minimap();
 
 	void DrawWidget(WidgetNumber wid_num, const BaseWidget *wid) const override;
+	void OnDraw(MouseModeSelector *selector) override;
 	void OnClick(WidgetNumber wid, const Point16 &pos) override;
 
 private:
 	void UpdateButtons();
 	Point32 GetRenderingBase(const Rectangle32 &widget_pos) const;
 
+	void UpdateMapImage() const;
+	void UpdatePeopleDots() const;
+	bool UpdateStackHeight(int x, int y) const;
+	void UpdateColourGradient() const;
+	uint32 GetStackColour(int x, int y) const;
+	void SetStackPixels(int x, int y, uint32 colour) const;
+
 	int zoom;   ///< Size of a voxel in pixels on the minimap.
+
+	/* Cached rendering of the map, brought up to date when drawing. */
+	mutable GLuint texture;                     ///< Texture containing the rendered map, \c 0 if not created yet.
+	mutable Point16 texture_size;               ///< Size of the world that #texture was rendered for.
+	mutable std::vector<uint8> pixels;          ///< RGBA contents of #texture.
+	mutable std::vector<uint32> stack_colours;  ///< Colour of every voxel stack, without people on top.
+	mutable std::vector<uint8> stack_heights;   ///< Top ground height of every voxel stack.
+	mutable std::vector<uint8> people_dots;     ///< Kind of people dot drawn at every voxel stack.
+	mutable std::vector<uint8> new_people_dots; ///< Scratch buffer for computing the next #people_dots.
+	mutable uint32 change_stamp;                ///< Change stamp of the world when the map image was last updated.
+	mutable std::vector<Point16> dirty_stacks;  ///< Scratch buffer for collecting the changed voxel stacks.
+	mutable std::vector<XYZPoint16> positions;  ///< Scratch buffer for collecting people positions.
+	mutable uint32 height_counts[WORLD_Z_SIZE]; ///< Number of voxel stacks with their top ground at each height.
+	mutable int min_z;                          ///< Lowest top ground height in the world.
+	mutable int max_z;                          ///< Highest top ground height in the world.
+	mutable int colour_base;                    ///< Colour shade of the lowest ground.
+	mutable float colour_step;                  ///< Colour shade difference between two ground heights.
+	mutable Point32 dirty_min;                  ///< Top-left pixel of the part of #pixels not yet sent to #texture.
+	mutable Point32 dirty_max;                  ///< Bottom-right pixel (exclusive) of the part of #pixels not yet sent to #texture.
 };
 
 static const int MIN_ZOOM =  1;  ///< Minimum size of a voxel in pixels on the minimap.
 static const int MAX_ZOOM = 16;  ///< Maximum size of a voxel in pixels on the minimap.
 
+/** Kinds of people dots at a voxel stack of the minimap. */
+enum MinimapPeopleDot {
+	MPD_NONE,   ///< No people at the voxel stack.
+	MPD_GUEST,  ///< One or more guests at the voxel stack.
+	MPD_STAFF,  ///< One or more staff members at the voxel stack.
+};
+
 /**
  * Widget numbers of the minimap window.
  * @ingroup gui_group
@@ -74,7 +112,7 @@ static const WidgetPart _minimap_build_gui_parts[] = {
 	EndContainer(),
 };
 
-Minimap::Minimap() : GuiWindow(WC_MINIMAP, ALL_WINDOWS_OF_TYPE)
+Minimap::Minimap() : GuiWindow(WC_MINIMAP, ALL_WINDOWS_OF_TYPE), texture(0), change_stamp(0)
 {
 	this->SetupWidgetTree(_minimap_build_gui_parts, lengthof(_minimap_build_gui_parts));
 	this->SetScrolledWidget(MM_MAIN, MM_SCROLL_HORZ);
@@ -84,6 +122,11 @@ Minimap::Minimap() : GuiWindow(WC_MINIMAP, ALL_WINDOWS_OF_TYPE)
 	this->UpdateButtons();
 }
 
+Minimap::~Minimap()
+{
+	if (this->texture != 0) _video.DeleteTexture(this->texture);
+}
+
 /** Update whether the zoom buttons are enabled, and the size of the scrollbars. */
 void Minimap::UpdateButtons()
 {
@@ -119,6 +162,216 @@ Point32 Minimap::GetRenderingBase(const Rectangle32 &widget_pos) const
 	return base;
 }
 
+/**
+ * Mix a semi-transparent colour over an opaque colour.
+ * @param base Opaque background colour.
+ * @param overlay Colour to put on top.
+ * @return The resulting opaque colour.
+ */
+static uint32 BlendColours(uint32 base, uint32 overlay)
+{
+	const int a = GetA(overlay);
+	return MakeRGBA((GetR(base) * (OPAQUE - a) + GetR(overlay) * a) / OPAQUE,
+			(GetG(base) * (OPAQUE - a) + GetG(overlay) * a) / OPAQUE,
+			(GetB(base) * (OPAQUE - a) + GetB(overlay) * a) / OPAQUE, OPAQUE);
+}
+
+/**
+ * Store the top ground height of a voxel stack, and update the height statistics of the world.
+ * @param x X coordinate of the voxel stack.
+ * @param y Y coordinate of the voxel stack.
+ * @return Whether the lowest or highest ground height of the world changed.
+ */
+bool Minimap::UpdateStackHeight(int x, int y) const
+{
+	uint8 &stored = this->stack_heights[x + y * this->texture_size.x];
+	const uint8 h = _world.GetTopGroundHeight(x, y);
+	if (h == stored) return false;
+
+	this->height_counts[stored]--;
+	this->height_counts[h]++;
+	stored = h;
+
+	int new_min = 0;
+	while (this->height_counts[new_min] == 0) new_min++;
+	int new_max = WORLD_Z_SIZE - 1;
+	while (this->height_counts[new_max] == 0) new_max--;
+	if (new_min == this->min_z && new_max == this->max_z) return false;
+
+	this->min_z = new_min;
+	this->max_z = new_max;
+	return true;
+}
+
+/** Compute the colour shades of the ground heights from the lowest and highest ground in the world. */
+void Minimap::UpdateColourGradient() const
+{
+	if (this->max_z - this->min_z < COL_SERIES_LENGTH) {
+		this->colour_step = 1;
+		this->colour_base = (COL_SERIES_LENGTH - this->max_z + this->min_z) / 2;
+	} else {
+		this->colour_step = COL_SERIES_LENGTH / (this->max_z - this->min_z + 1.0f);
+		this->colour_base = 0;
+	}
+}
+
+/**
+ * Compute the colour of a voxel stack on the map.
+ * @param x X coordinate of the voxel stack.
+ * @param y Y coordinate of the voxel stack.
+ * @return Colour of the voxel stack.
+ */
+uint32 Minimap::GetStackColour(int x, int y) const
+{
+	const VoxelStack *vs = _world.GetStack(x, y);
+	const int h = vs->GetTopGroundOffset();
+
+	ColourRange col_range = _ground_type_colour[vs->voxels[h]->GetGroundType()];
+	for (int i = vs->voxels.size() - 1; i >= h; i--) {
+		const Voxel *v = vs->voxels[i].get();
+		if (v->instance == SRI_PATH && HasValidPath(v)) {
+			col_range = COL_RANGE_GREY;
+			break;
+		} else if (v->instance >= SRI_FULL_RIDES) {
+			switch (_rides_manager.GetRideInstance(v->instance)->GetKind()) {
+				case RTK_SHOP:    col_range = COL_RANGE_SEA_GREEN;  break;
+				case RTK_GENTLE:  col_range = COL_RANGE_PINK_BROWN; break;
+				case RTK_THRILL:  col_range = COL_RANGE_ORANGE;     break;
+				case RTK_WET:     col_range = COL_RANGE_BLUE;       break;
+				case RTK_COASTER: col_range = COL_RANGE_PURPLE;     break;
+				default: NOT_REACHED();
+			}
+			break;
+		}
+	}
+
+	uint32 colour = _palette[static_cast<int>(COL_SERIES_START + col_range * COL_SERIES_LENGTH + this->colour_base + this->colour_step * (h + vs->base - this->min_z))];
+	if (vs->owner != OWN_PARK) colour = BlendColours(colour, _palette[OVERLAY_DARKEN]);
+	return colour;
+}
+
+/**
+ * Fill the cell of a voxel stack in the map image, and mark it for sending to the texture.
+ * @param x X coordinate of the voxel stack.
+ * @param y Y coordinate of the voxel stack.
+ * @param colour Colour to fill with.
+ */
+void Minimap::SetStackPixels(int x, int y, uint32 colour) const
+{
+	const int px = y - x - 1 + this->texture_size.x;
+	const int py = y + x;
+	uint8 *p = &this->pixels[4 * (px + py * (this->texture_size.x + this->texture_size.y))];
+	for (int i = 0; i < 2; i++) {
+		*p++ = GetR(colour);
+		*p++ = GetG(colour);
+		*p++ = GetB(colour);
+		*p++ = GetA(colour);
+	}
+
+	this->dirty_min.x = std::min(this->dirty_min.x, px);
+	this->dirty_min.y = std::min(this->dirty_min.y, py);
+	this->dirty_max.x = std::max(this->dirty_max.x, px + 2);
+	this->dirty_max.y = std::max(this->dirty_max.y, py + 1);
+}
+
+/** Bring the cached map image up to date with the changes in the world. */
+void Minimap::UpdateMapImage() const
+{
+	const int xsize = _world.GetXSize();
+	const int ysize = _world.GetYSize();
+	const int nstacks = xsize * ysize;
+
+	bool full_update = _world.GetChangedStacks(this->change_stamp, &this->dirty_stacks);
+	this->change_stamp = _world.GetChangeStamp();
+	if (this->texture == 0 || this->texture_size.x != xsize || this->texture_size.y != ysize) {
+		if (this->texture != 0) _video.DeleteTexture(this->texture);
+		this->texture_size = Point16(xsize, ysize);
+		this->texture = _video.CreateTexture(xsize + ysize, xsize + ysize - 1);
+		this->pixels.assign(4 * (xsize + ysize) * (xsize + ysize - 1), 0);  // Outside the map is transparent.
+		this->stack_colours.resize(nstacks);
+		this->people_dots.assign(nstacks, MPD_NONE);
+		full_update = true;
+	}
+
+	if (full_update) {
+		std::fill_n(this->height_counts, WORLD_Z_SIZE, 0);
+		this->stack_heights.resize(nstacks);
+		for (int y = 0; y < ysize; y++) {
+			for (int x = 0; x < xsize; x++) {
+				const uint8 h = _world.GetTopGroundHeight(x, y);
+				this->stack_heights[x + y * xsize] = h;
+				this->height_counts[h]++;
+			}
+		}
+		this->min_z = 0;
+		while (this->height_counts[this->min_z] == 0) this->min_z++;
+		this->max_z = WORLD_Z_SIZE - 1;
+		while (this->height_counts[this->max_z] == 0) this->max_z--;
+	} else {
+		for (const Point16 &p : this->dirty_stacks) {
+			if (p.x < xsize && p.y < ysize && this->UpdateStackHeight(p.x, p.y)) full_update = true;
+		}
+	}
+
+	/* Any change in the lowest or highest ground changes the colour of every voxel stack. */
+	if (full_update) {
+		this->UpdateColourGradient();
+		for (int y = 0; y < ysize; y++) {
+			for (int x = 0; x < xsize; x++) {
+				this->stack_colours[x + y * xsize] = this->GetStackColour(x, y);
+				this->people_dots[x + y * xsize] = MPD_NONE;
+				this->SetStackPixels(x, y, this->stack_colours[x + y * xsize]);
+			}
+		}
+	} else {
+		for (const Point16 &p : this->dirty_stacks) {
+			if (p.x >= xsize || p.y >= ysize) continue;
+			const int index = p.x + p.y * xsize;
+			this->stack_colours[index] = this->GetStackColour(p.x, p.y);
+			if (this->people_dots[index] == MPD_NONE) this->SetStackPixels(p.x, p.y, this->stack_colours[index]);
+		}
+	}
+}
+
+/** Move the dots of guests and staff in the cached map image to their current positions. */
+void Minimap::UpdatePeopleDots() const
+{
+	const int xsize = this->texture_size.x;
+	const int ysize = this->texture_size.y;
+	this->new_people_dots.assign(xsize * ysize, MPD_NONE);
+
+	_guests.GetVoxelPositions(&this->positions);
+	for (const XYZPoint16 &p : this->positions) {
+		if (IsVoxelstackInsideWorld(p.x, p.y)) this->new_people_dots[p.x + p.y * xsize] = MPD_GUEST;
+	}
+	_staff.GetVoxelPositions(&this->positions);
+	for (const XYZPoint16 &p : this->positions) {
+		if (IsVoxelstackInsideWorld(p.x, p.y)) this->new_people_dots[p.x + p.y * xsize] = MPD_STAFF;
+	}
+
+	for (int y = 0; y < ysize; y++) {
+		for (int x = 0; x < xsize; x++) {
+			const int index = x + y * xsize;
+			const uint8 dot = this->new_people_dots[index];
+			if (dot == this->people_dots[index]) continue;
+
+			switch (dot) {
+				case MPD_NONE:  this->SetStackPixels(x, y, this->stack_colours[index]); break;
+				case MPD_GUEST: this->SetStackPixels(x, y, _palette[TEXT_WHITE]); break;
+				case MPD_STAFF: this->SetStackPixels(x, y, _palette[COL_SERIES_START + COL_RANGE_RED * COL_SERIES_LENGTH + COL_SERIES_LENGTH - 3]); break;
+				default: NOT_REACHED();
+			}
+		}
+	}
+	this->people_dots.swap(this->new_people_dots);
+}
+
+void Minimap::OnDraw(MouseModeSelector *selector)
+{
+	this->GetWidget<BaseWidget>(MM_MAIN)->MarkDirty();  // The park and the outline of the main view change all the time.
+	GuiWindow::OnDraw(selector);
+}
+
 void Minimap::DrawWidget(WidgetNumber wid_num, const BaseWidget *wid) const
 {
 	if (wid_num != MM_MAIN) return GuiWindow::DrawWidget(wid_num, wid);
@@ -134,56 +387,19 @@ void Minimap::DrawWidget(WidgetNumber wid_num, const BaseWidget *wid) const
 	baseX += rb.x;
 	baseY += rb.y;
 
-	/* First pass: Find highest and lowest Z positions in the world, to adjust the colour ranges. */
-	int minZ = WORLD_Z_SIZE;
-	int maxZ = 0;
-	for (int x = 0; x < _world.GetXSize(); x++) {
-		for (int y = 0; y < _world.GetYSize(); y++) {
-			const int h = _world.GetTopGroundHeight(x, y);
-			minZ = std::min(minZ, h);
-			maxZ = std::max(maxZ, h);
-		}
-	}
-	int colour_base;
-	float colour_step;
-	if (maxZ - minZ < COL_SERIES_LENGTH) {
-		colour_step = 1;
-		colour_base = (COL_SERIES_LENGTH - maxZ + minZ) / 2;
-	} else {
-		colour_step = COL_SERIES_LENGTH / (maxZ - minZ + 1.0f);
-		colour_base = 0;
-	}
-
-	/* Second pass: Draw the map. */
-	for (int x = 0; x < _world.GetXSize(); x++) {
-		for (int y = 0; y < _world.GetYSize(); y++) {
-			const VoxelStack *vs = _world.GetStack(x, y);
-			const int h = vs->GetTopGroundOffset();
-
-			ColourRange col_range = _ground_type_colour[vs->voxels[h]->GetGroundType()];
-			for (int i = vs->voxels.size() - 1; i >= h; i--) {
-				const Voxel *v = vs->voxels[i].get();
-				if (v->instance == SRI_PATH && HasValidPath(v)) {
-					col_range = COL_RANGE_GREY;
-					break;
-				} else if (v->instance >= SRI_FULL_RIDES) {
-					switch (_rides_manager.GetRideInstance(v->instance)->GetKind()) {
-						case RTK_SHOP:    col_range = COL_RANGE_SEA_GREEN;  break;
-						case RTK_GENTLE:  col_range = COL_RANGE_PINK_BROWN; break;
-						case RTK_THRILL:  col_range = COL_RANGE_ORANGE;     break;
-						case RTK_WET:     col_range = COL_RANGE_BLUE;       break;
-						case RTK_COASTER: col_range = COL_RANGE_PURPLE;     break;
-						default: NOT_REACHED();
-					}
-					break;
-				}
-			}
-
-			const Rectangle32 r(baseX + this->zoom * (y - x - 1), baseY + this->zoom * (y + x - 0.5f), 2 * this->zoom, this->zoom);
-			_video.FillRectangle(r, _palette[static_cast<int>(COL_SERIES_START + col_range * COL_SERIES_LENGTH + colour_base + colour_step * (h + vs->base - minZ))]);
-			if (vs->owner != OWN_PARK) _video.FillRectangle(r, _palette[OVERLAY_DARKEN]);
-		}
+	/* Update the changed parts of the map, and draw it. */
+	this->dirty_min = Point32(INT32_MAX, INT32_MAX);
+	this->dirty_max = Point32(INT32_MIN, INT32_MIN);
+	this->UpdateMapImage();
+	this->UpdatePeopleDots();
+	if (this->dirty_min.x < this->dirty_max.x) {
+		_video.UpdateTexture(this->texture, Rectangle32(this->dirty_min.x, this->dirty_min.y,
+				this->dirty_max.x - this->dirty_min.x, this->dirty_max.y - this->dirty_min.y),
+				this->pixels.data(), this->texture_size.x + this->texture_size.y);
 	}
+	const int nrows = this->texture_size.x + this->texture_size.y;
+	_video.BlitTexture(this->texture, Rectangle32(baseX - this->zoom * this->texture_size.x, baseY - (this->zoom + 1) / 2,
+			this->zoom * nrows, this->zoom * (nrows - 1)));
 
 	/* Finally, add the viewport overlay. */
 	{
@@ -108,6 +108,7 @@ Recolouring::Recolouring()
 Recolouring::Recolouring(const Recolouring &rc)
 {
 	std::copy(&rc.entries[0], endof(rc.entries), this->entries);
+	this->InvalidateColourMap();
 }
 
 /**
@@ -119,6 +120,7 @@ Recolouring &Recolouring::operator=(const Recolouring &rc)
 {
 	if (this != &rc) {
 		std::copy(&rc.entries[0], endof(rc.entries), this->entries);
+		this->InvalidateColourMap();
 	}
 	return *this;
 }
@@ -230,6 +232,53 @@ const uint8 *Recolouring::GetPalette(GradientShift shift) const
 	return this->colour_map;
 }
 
+/**
+ * Get the tables to recolour and gradient shift the pixels of images. The tables are kept until the recolouring
+ * changes, so all images drawn with the same recolouring share them.
+ * @param shift Applied gradient shift.
+ * @return Tables for recolouring 8bpp and 32bpp images.
+ */
+const RecolourTables &Recolouring::GetRecolourTables(GradientShift shift) const
+{
+	assert(shift < lengthof(this->tables));
+	for (int i = 0; i < MAX_RECOLOUR; i++) {
+		if (this->tables_entries[i].source == this->entries[i].source && this->tables_entries[i].dest == this->entries[i].dest) continue;
+
+		for (auto &t : this->tables) t.reset();
+		std::copy(&this->entries[0], endof(this->entries), this->tables_entries);
+		break;
+	}
+	if (this->tables[shift] != nullptr) return *this->tables[shift];
+
+	RecolourTables *tables = new RecolourTables;
+	this->tables[shift].reset(tables);
+
+	/* Combine recolouring, gradient shift, palette, and opacity shift for 8bpp images. */
+	const uint8 *alpha_shift = GetAlphaShiftTable(shift);
+	this->shift = GS_INVALID;  // The entries may have changed without invalidating the colour map.
+	const uint8 *colour_map = this->GetPalette(shift);
+	for (int i = 0; i < 256; i++) {
+		const uint32 pixel = _palette[colour_map[i]];
+		tables->palette[i][0] = GetR(pixel);
+		tables->palette[i][1] = GetG(pixel);
+		tables->palette[i][2] = GetB(pixel);
+		tables->palette[i][3] = alpha_shift[GetA(pixel)];
+	}
+
+	/* Combine the recolour palette of every layer with the gradient shift for 32bpp images. */
+	const uint8 *gradient_shift = GetGradientShiftTable(shift);
+	for (int layer = 0; layer <= MAX_RECOLOUR; layer++) {
+		const uint32 *recolour = this->GetRecolourTable(layer);
+		for (int i = 0; i < 256; i++) {
+			tables->layers[layer][i][0] = gradient_shift[GetR(recolour[i])];
+			tables->layers[layer][i][1] = gradient_shift[GetG(recolour[i])];
+			tables->layers[layer][i][2] = gradient_shift[GetB(recolour[i])];
+			tables->layers[layer][i][3] = 0;
+		}
+	}
+	return *tables;
+}
+
 /**
  * Find the coloure range to use as replacement for the \a src colour range.
  * @param src Colour range to replace.
@@ -255,6 +304,52 @@ CondensedRecolouring Recolouring::ToCondensed() const
 	return r;
 }
 
+/** The gradient shift and opacity shift functions, applied to every possible value. */
+struct ShiftTables {
+	ShiftTables()
+	{
+		for (int shift = 0; shift < SHIFT_COUNT; shift++) {
+			ShiftFunc sf = GetGradientShiftFunc(static_cast<GradientShift>(shift));
+			ShiftFunc af = GetAlphaShiftFunc(static_cast<GradientShift>(shift));
+			for (int value = 0; value < 256; value++) {
+				this->gradient[shift][value] = sf(value);
+				this->alpha[shift][value] = af(value);
+			}
+		}
+	}
+
+	static const int SHIFT_COUNT = GS_WIREFRAME + 1;  ///< Number of gradient shifts with a table.
+
+	uint8 gradient[SHIFT_COUNT][256];  ///< Result of the gradient shift function of each shift.
+	uint8 alpha[SHIFT_COUNT][256];     ///< Result of the opacity shift function of each shift.
+};
+
+static const ShiftTables _shift_tables;  ///< Precomputed results of the shift functions.
+
+/**
+ * Get the result of the gradient shift function for every colour intensity, to shift many pixels at once.
+ * @param shift Desired amount of gradient shift.
+ * @return Table with the shifted intensity of every intensity.
+ * @see GetGradientShiftFunc
+ */
+const uint8 *GetGradientShiftTable(GradientShift shift)
+{
+	assert(shift < ShiftTables::SHIFT_COUNT);
+	return _shift_tables.gradient[shift];
+}
+
+/**
+ * Get the result of the opacity shift function for every opacity, to shift many pixels at once.
+ * @param shift Desired amount of gradient shift.
+ * @return Table with the shifted opacity of every opacity.
+ * @see GetAlphaShiftFunc
+ */
+const uint8 *GetAlphaShiftTable(GradientShift shift)
+{
+	assert(shift < ShiftTables::SHIFT_COUNT);
+	return _shift_tables.alpha[shift];
+}
+
 /** 8 bpp colours mapped to 32 bpp. */
 const uint32 _palette[256] = {
  	MakeRGBA(  0,   0,   0, TRANSPARENT), //  0 COL_BACKGROUND (background behind world display)
@@ -10,6 +10,8 @@
 #ifndef PALETTE_H
 #define PALETTE_H
 
+#include <memory>
+
 class Random;
 
 extern const uint32 _palette[256];  ///< The 8bpp FreeRCT palette.
@@ -389,6 +391,9 @@ static inline ShiftFunc GetAlphaShiftFunc(GradientShift shift)
 	}
 }
 
+const uint8 *GetGradientShiftTable(GradientShift shift);
+const uint8 *GetAlphaShiftTable(GradientShift shift);
+
 /**
  * Get the index of the base colour of a colour range.
  * @param cr Colour range to use.
@@ -424,6 +429,12 @@ struct RecolourEntry {
 	uint32 dest_set;    ///< Bit set of destination colour ranges to chose from.
 };
 
+/** Tables to recolour and gradient shift all pixels of an image with one lookup per pixel, see #Recolouring::GetRecolourTables. */
+struct RecolourTables {
+	uint8 palette[256][4];                   ///< Red, green, blue, and opacity of every 8bpp colour index.
+	uint8 layers[MAX_RECOLOUR + 1][256][4];  ///< Red, green, and blue of every intensity of every 32bpp recolour layer, the last one for unknown layers.
+};
+
 /** Information of a sprite recolouring instantiation. */
 using CondensedRecolouring = std::vector<std::pair<ColourRange, ColourRange>>;
 
@@ -446,6 +457,7 @@ public:
 	void Save(Saver &svr);
 
 	const uint8 *GetPalette(GradientShift shift) const;
+	const RecolourTables &GetRecolourTables(GradientShift shift) const;
 
 	/**
 	 * Get the table with recolouring of a layer.
@@ -478,6 +490,9 @@ private:
 
 	mutable uint8 colour_map[256]; ///< Colour map used last time.
 	mutable GradientShift shift;   ///< Gradient shift used last time, #GS_INVALID if the #colour_map is not valid.
+
+	mutable std::unique_ptr<RecolourTables> tables[GS_WIREFRAME + 1]; ///< Recolour tables of each gradient shift, allocated on first use.
+	mutable RecolourEntry tables_entries[MAX_RECOLOUR];                ///< Recolour entries of the #tables, the #entries may be changed directly.
 };
 
 extern const Recolouring _no_recolour;
@@ -0,0 +1,524 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file park_generator.cpp Generation of synthetic parks for benchmarking. */
+
+#include "stdafx.h"
+#include "park_generator.h"
+#include "coaster.h"
+#include "dates.h"
+#include "finances.h"
+#include "gamecontrol.h"
+#include "gameobserver.h"
+#include "gentle_thrill_ride_type.h"
+#include "loadsave.h"
+#include "map.h"
+#include "mouse_mode.h"
+#include "path_build.h"
+#include "people.h"
+#include "random.h"
+#include "sprite_store.h"
+#include "terraform.h"
+#include "weather.h"
+
+#include <vector>
+
+static const int16 GROUND_HEIGHT = 8;           ///< Height of the ground before adding hills and valleys.
+static const int PLACEMENT_ATTEMPTS = 500;      ///< Number of random locations to try for placing a single ride.
+
+/** Default settings, a medium-sized park. */
+ParkGeneratorSettings::ParkGeneratorSettings()
+:
+	x_size(64),
+	y_size(64),
+	roughness(3),
+	path_spacing(6),
+	shops(20),
+	gentle_rides(8),
+	thrill_rides(8),
+	coasters(2),
+	guests(1000),
+	staff(20),
+	seed(1)
+{
+}
+
+/**
+ * Read the settings from a comma-separated list of \c key=value pairs,
+ * for example <tt>size=120x100,roughness=5,guests=4000</tt>. Keys that are not mentioned keep their value.
+ * @param text Text to parse.
+ * @return Whether the text was valid. An error is printed if it was not.
+ */
+bool ParkGeneratorSettings::Parse(const std::string &text)
+{
+	size_t start = 0;
+	while (start < text.size()) {
+		size_t end = text.find(',', start);
+		if (end == std::string::npos) end = text.size();
+		const std::string item = text.substr(start, end - start);
+		start = end + 1;
+
+		const size_t eq = item.find('=');
+		if (eq == std::string::npos) {
+			fprintf(stderr, "Park generator setting '%s' has no value\n", item.c_str());
+			return false;
+		}
+		const std::string key = item.substr(0, eq);
+		const char *value = item.c_str() + eq + 1;
+
+		if (key == "size") {
+			int xs, ys;
+			if (sscanf(value, "%dx%d", &xs, &ys) != 2 || xs < 16 || ys < 16 || xs >= WORLD_X_SIZE || ys >= WORLD_Y_SIZE) {
+				fprintf(stderr, "Park generator size '%s' is invalid, it should be between 16x16 and %dx%d\n", value, WORLD_X_SIZE - 1, WORLD_Y_SIZE - 1);
+				return false;
+			}
+			this->x_size = xs;
+			this->y_size = ys;
+			continue;
+		}
+
+		char *number_end;
+		const long number = strtol(value, &number_end, 10);
+		if (*value == '\0' || *number_end != '\0' || number < 0) {
+			fprintf(stderr, "Park generator setting '%s' should have a non-negative number as value\n", key.c_str());
+			return false;
+		}
+
+		if (key == "roughness") {
+			if (number > 10) {
+				fprintf(stderr, "Park generator roughness should be between 0 and 10\n");
+				return false;
+			}
+			this->roughness = number;
+		} else if (key == "paths") {
+			if (number < 3) {
+				fprintf(stderr, "Park generator path spacing should be at least 3\n");
+				return false;
+			}
+			this->path_spacing = number;
+		} else if (key == "shops") {
+			this->shops = number;
+		} else if (key == "gentle") {
+			this->gentle_rides = number;
+		} else if (key == "thrill") {
+			this->thrill_rides = number;
+		} else if (key == "coasters") {
+			this->coasters = number;
+		} else if (key == "guests") {
+			this->guests = number;
+		} else if (key == "staff") {
+			this->staff = number;
+		} else if (key == "seed") {
+			this->seed = number;
+		} else {
+			fprintf(stderr, "Unknown park generator setting '%s'\n", key.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Draw a random element from a non-empty vector.
+ * @param rnd Random generator to use.
+ * @param items Items to choose from.
+ * @return One of the items.
+ */
+template <typename T>
+static const T &RandomElement(Random &rnd, const std::vector<T> &items)
+{
+	assert(!items.empty());
+	return items[rnd.Uniform(items.size() - 1)];
+}
+
+/**
+ * Does a path end at the bottom of the neighbouring voxel in any of the given directions?
+ * @param pos Position of the voxel.
+ * @param edges Bit set of edges to examine.
+ * @return A path can be reached from the voxel.
+ */
+static bool HasPathAtEdges(const XYZPoint16 &pos, uint8 edges)
+{
+	for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
+		if ((edges & (1 << edge)) != 0 && PathExistsAtBottomEdge(pos, edge)) return true;
+	}
+	return false;
+}
+
+/**
+ * Find a type of path that has graphics, for the generated paths.
+ * @return Type of the generated paths, or #PAT_INVALID if no path graphics are loaded.
+ */
+static PathType GetGeneratedPathType()
+{
+	if (_sprite_manager.HasPath(PAT_CONCRETE, PAS_NORMAL_PATH)) return PAT_CONCRETE;
+	for (int i = 0; i < PAT_COUNT; i++) {
+		const PathType type = static_cast<PathType>(i);
+		if (_sprite_manager.HasPath(type, PAS_NORMAL_PATH)) return type;
+	}
+	return PAT_INVALID;
+}
+
+/**
+ * Build a grid of flat paths across the entire world, running into the world edges so guests can enter.
+ * @param settings Park parameters.
+ * @param path_type Type of the paths.
+ * @param path_tiles [out] Positions of the built paths.
+ */
+static void BuildPathGrid(const ParkGeneratorSettings &settings, PathType path_type, std::vector<XYZPoint16> *path_tiles)
+{
+	const int offset = settings.path_spacing / 2;
+	for (uint16 x = 0; x < settings.x_size; x++) {
+		for (uint16 y = 0; y < settings.y_size; y++) {
+			if ((x % settings.path_spacing) != offset && (y % settings.path_spacing) != offset) continue;
+
+			const XYZPoint16 pos(x, y, GROUND_HEIGHT);
+			if (BuildFlatPath(pos, path_type, PAS_NORMAL_PATH, false, false)) path_tiles->push_back(pos);
+		}
+	}
+
+	/* Declare the first path at the world edge to be the park entrance. */
+	if (offset < settings.x_size) _world.AddEdgesWithoutBorderFence(Point16(offset, 0), EDGE_NW);
+}
+
+/**
+ * Raise a hill or dig a valley. Terrain next to paths is left alone.
+ * @param rnd Random generator to use.
+ * @param roughness Roughness of the terrain.
+ */
+static void AddHill(Random &rnd, int roughness)
+{
+	const int cx = rnd.Uniform(_world.GetXSize() - 1);
+	const int cy = rnd.Uniform(_world.GetYSize() - 1);
+	const int radius = 1 + rnd.Uniform(roughness);
+	const int height = 1 + rnd.Uniform(roughness - 1);
+	const int direction = rnd.Success(70) ? 1 : -1;
+
+	for (int level = 0; level < height && level <= radius; level++) {
+		const int r = radius - level;
+		Rectangle16 area(cx - r, cy - r, 2 * r + 1, 2 * r + 1);
+		area.RestrictTo(0, 0, _world.GetXSize(), _world.GetYSize());
+
+		/* Changes cover the entire world, so the tiles around the area become slopes instead of cliffs. */
+		TerrainChanges changes(Point16(0, 0), _world.GetXSize(), _world.GetYSize());
+		for (int x = area.base.x; x < area.base.x + area.width; x++) {
+			for (int y = area.base.y; y < area.base.y + area.height; y++) {
+				if (!changes.ChangeVoxel(Point16(x, y), direction > 0 ? WORLD_Z_SIZE : 0, direction)) return;
+			}
+		}
+		if (!changes.ModifyWorld(direction)) return;
+	}
+}
+
+/**
+ * Can a fixed ride be placed at the given position?
+ * @param type Type of the ride.
+ * @param pos Base voxel of the ride.
+ * @param orientation Orientation of the ride.
+ * @return The ride fits at flat, free ground.
+ */
+static bool CanPlaceFixedRide(const FixedRideType *type, const XYZPoint16 &pos, uint8 orientation)
+{
+	for (int8 x = 0; x < type->width_x; x++) {
+		for (int8 y = 0; y < type->width_y; y++) {
+			const XYZPoint16 location = pos + OrientatedOffset(orientation, x, y);
+			if (!IsVoxelstackInsideWorld(location.x, location.y)) return false;
+			if (_world.GetBaseGroundHeight(location.x, location.y) != location.z) return false;
+
+			for (int16 h = 0; h < type->GetHeight(x, y); h++) {
+				const Voxel *v = _world.GetVoxel(location + XYZPoint16(0, 0, h));
+				if (v == nullptr) continue;
+				if (!v->CanPlaceInstance()) return false;
+				if (h == 0 ? v->GetGroundSlope() != SL_FLAT : v->GetGroundType() != GTP_INVALID) return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Find locations for the entrance and the exit of a gentle or thrill ride, next to a path.
+ * @param ri Ride to examine, with its position set.
+ * @param entrance [out] Position of the entrance.
+ * @param exit [out] Position of the exit.
+ * @return Whether both positions were found.
+ */
+static bool FindEntranceAndExit(const GentleThrillRideInstance *ri, XYZPoint16 *entrance, XYZPoint16 *exit)
+{
+	const FixedRideType *t = ri->GetFixedRideType();
+	const XYZPoint16 corner = ri->vox_pos + OrientatedOffset(ri->orientation, t->width_x - 1, t->width_y - 1);
+
+	*entrance = XYZPoint16::invalid();
+	*exit = XYZPoint16::invalid();
+	for (int x = std::min(ri->vox_pos.x, corner.x) - 1; x <= std::max(ri->vox_pos.x, corner.x) + 1; x++) {
+		for (int y = std::min(ri->vox_pos.y, corner.y) - 1; y <= std::max(ri->vox_pos.y, corner.y) + 1; y++) {
+			const XYZPoint16 pos(x, y, ri->vox_pos.z);
+			const bool entrance_ok = *entrance == XYZPoint16::invalid() && ri->CanPlaceEntranceOrExit(pos, true);
+			const bool exit_ok = !entrance_ok && *exit == XYZPoint16::invalid() && ri->CanPlaceEntranceOrExit(pos, false);
+			if (!entrance_ok && !exit_ok) continue;
+			if (!HasPathAtEdges(pos, 1 << ri->EntranceExitRotation(pos))) continue;
+
+			if (entrance_ok) {
+				*entrance = pos;
+			} else {
+				*exit = pos;
+			}
+		}
+	}
+	return *entrance != XYZPoint16::invalid() && *exit != XYZPoint16::invalid();
+}
+
+/**
+ * Build a shop, gentle ride, or thrill ride at a random location next to a path.
+ * @param rnd Random generator to use.
+ * @param type Type of the ride.
+ * @param path_tiles Positions of the paths in the park.
+ * @return Whether the ride was built.
+ */
+static bool BuildFixedRide(Random &rnd, const FixedRideType *type, const std::vector<XYZPoint16> &path_tiles)
+{
+	const uint16 number = _rides_manager.GetFreeInstance(type);
+	if (number == INVALID_RIDE_INSTANCE) return false;
+	FixedRideInstance *ri = nullptr;  // Created at the first free position, deleting an unpositioned ride is not possible.
+
+	for (int attempt = 0; attempt < PLACEMENT_ATTEMPTS; attempt++) {
+		/* Try a position a few tiles away from a path. */
+		const XYZPoint16 &path = RandomElement(rnd, path_tiles);
+		const int x = path.x + rnd.Uniform(2 * type->width_x + 2) - type->width_x - 1;
+		const int y = path.y + rnd.Uniform(2 * type->width_y + 2) - type->width_y - 1;
+		if (!IsVoxelstackInsideWorld(x, y)) continue;
+
+		const XYZPoint16 pos(x, y, _world.GetBaseGroundHeight(x, y));
+		const uint8 orientation = rnd.Uniform(3);
+		if (!CanPlaceFixedRide(type, pos, orientation)) continue;
+		if (ri == nullptr) ri = static_cast<FixedRideInstance *>(_rides_manager.CreateInstance(type, number));
+		ri->SetRide(orientation, pos);
+
+		XYZPoint16 entrance, exit;
+		if (type->kind == RTK_SHOP) {
+			if (!HasPathAtEdges(pos, ri->GetEntranceDirections(pos))) continue;
+		} else if (!FindEntranceAndExit(static_cast<GentleThrillRideInstance *>(ri), &entrance, &exit)) {
+			continue;
+		}
+
+		ri->BuildRide();
+		if (type->kind != RTK_SHOP) {
+			static_cast<GentleThrillRideInstance *>(ri)->SetEntrancePos(entrance);
+			static_cast<GentleThrillRideInstance *>(ri)->SetExitPos(exit);
+		}
+		if (ri->CanOpenRide()) ri->OpenRide();
+		return true;
+	}
+
+	if (ri != nullptr) _rides_manager.DeleteInstance(number);
+	return false;
+}
+
+/**
+ * Place the entrance and the exit of every station of a roller coaster, preferably next to a path.
+ * @param ci Roller coaster to complete.
+ */
+static void PlaceCoasterEntrances(CoasterInstance *ci)
+{
+	for (bool need_path : {true, false}) {
+		for (CoasterStation &station : ci->stations) {
+			for (const XYZPoint16 &loc : station.locations) {
+				for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
+					const XYZPoint16 pos(loc.x + _tile_dxy[edge].x, loc.y + _tile_dxy[edge].y, loc.z);
+					for (bool entrance : {true, false}) {
+						XYZPoint16 &current = entrance ? station.entrance : station.exit;
+						if (current != XYZPoint16::invalid() || !ci->CanPlaceEntranceOrExit(pos, entrance, &station)) continue;
+						if (need_path && !HasPathAtEdges(pos, 1 << ci->EntranceExitRotation(pos, &station))) continue;
+						ci->PlaceEntranceOrExit(pos, entrance, &station);
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Build a roller coaster from a saved track design at a random location.
+ * @param rnd Random generator to use.
+ * @param type Type of the coaster.
+ * @param design Design to build.
+ * @return Whether the coaster was built.
+ */
+static bool BuildCoaster(Random &rnd, const CoasterType *type, const TrackedRideDesign &design)
+{
+	const uint16 number = _rides_manager.GetFreeInstance(type);
+	if (number == INVALID_RIDE_INSTANCE) return false;
+
+	std::vector<PositionedTrackPiece> pieces;
+	for (int attempt = 0; attempt < PLACEMENT_ATTEMPTS; attempt++) {
+		const int x = rnd.Uniform(_world.GetXSize() - 1);
+		const int y = rnd.Uniform(_world.GetYSize() - 1);
+		const uint8 direction = rnd.Uniform(3);
+
+		/* Lay out the design, as the coaster build window does. */
+		pieces.clear();
+		XYZPoint16 pos(x, y, _world.GetBaseGroundHeight(x, y));
+		bool fits = true;
+		for (const TrackedRideDesign::AbstractTrackPiece &abstract_piece : design.pieces) {
+			const int index = type->GetPieceIndex(abstract_piece.piece_name);
+			const int piece_id = index < 0 ? -1 : type->GetRotatedPieceIndex(type->pieces.at(index), direction);
+			if (piece_id < 0) return false;  // Design does not match the coaster type.
+
+			ConstTrackPiecePtr piece = type->pieces.at(piece_id);
+			pieces.emplace_back(pos, piece);
+			if (pieces.back().CanBePlaced() != STR_NULL) {
+				fits = false;
+				break;
+			}
+			pos += piece->exit_dxyz;
+		}
+		if (!fits) continue;
+
+		CoasterInstance *ci = static_cast<CoasterInstance *>(_rides_manager.CreateInstance(type, number));
+		_rides_manager.NewInstanceAdded(number);
+		for (const PositionedTrackPiece &ptp : pieces) {
+			ci->AddPositionedPiece(ptp);
+			ci->PlaceTrackPieceInWorld(ptp);
+			_finances_manager.PayRideConstruct(ptp.piece->cost);
+		}
+		if (!ci->MakePositionedPiecesLooping(nullptr)) {
+			_rides_manager.DeleteInstance(number);
+			return false;
+		}
+
+		/* Complete the construction, as the coaster management window does. */
+		ci->CloseRide();
+		ci->SetNumberOfCars(ci->GetMaxNumberOfCars());
+		ci->SetNumberOfTrains(ci->GetMaxNumberOfTrains(ci->cars_per_train));
+		PlaceCoasterEntrances(ci);
+		if (ci->CanOpenRide()) ci->OpenRide();
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Generate a park, and save it.
+ * @param fname Name of the savegame file to write.
+ * @param settings Parameters of the park.
+ * @return Exit code of the program.
+ */
+int GeneratePark(const std::string &fname, const ParkGeneratorSettings &settings)
+{
+	/* Start from the default scenario, as the scenario editor does. */
+	LoadGameFile(nullptr);
+	{
+		Loader ldr(_main_menu_config.default_scenario_bytes.get(), _main_menu_config.default_scenario_length);
+		LoadGame(ldr);
+	}
+	_game_control.Uninitialize();  // The world is replaced, drop everything in it.
+	_date.Initialize();
+	_weather.Initialize();
+	_game_observer.Initialize();
+	Random::SetSeed(settings.seed);
+	Random rnd;
+
+	/* Build as in the scenario editor, and do not charge the park for it. */
+	_game_mode_mgr.SetGameMode(GM_EDITOR);
+	std::vector<uint8> finances;
+	{
+		Saver svr(&finances);
+		_finances_manager.Save(svr);
+	}
+
+	_world.SetWorldSize(settings.x_size, settings.y_size);
+	_world.MakeFlatWorld(GROUND_HEIGHT);
+	_world.SetTileOwnerGlobally(OWN_PARK);
+
+	const PathType path_type = GetGeneratedPathType();
+	if (path_type == PAT_INVALID) {
+		fprintf(stderr, "Park generator found no path graphics\n");
+		return 1;
+	}
+	std::vector<XYZPoint16> path_tiles;
+	BuildPathGrid(settings, path_type, &path_tiles);
+	if (path_tiles.empty()) {
+		fprintf(stderr, "Park generator could not build any paths\n");
+		return 1;
+	}
+
+	if (settings.roughness > 0) {
+		const int hill_count = settings.roughness * settings.x_size * settings.y_size / 256;
+		for (int i = 0; i < hill_count; i++) AddHill(rnd, settings.roughness);
+	}
+
+	/* Collect the available types of rides. */
+	std::vector<const FixedRideType *> fixed_types[RTK_RIDE_KIND_COUNT];
+	std::vector<std::pair<const CoasterType *, const TrackedRideDesign *>> coaster_designs;
+	for (const auto &rt : _rides_manager.ride_types) {
+		switch (rt->kind) {
+			case RTK_SHOP:
+			case RTK_GENTLE:
+			case RTK_THRILL:
+				fixed_types[rt->kind].push_back(static_cast<const FixedRideType *>(rt.get()));
+				break;
+			case RTK_COASTER:
+				for (const TrackedRideDesign &design : rt->designs) {
+					coaster_designs.emplace_back(static_cast<const CoasterType *>(rt.get()), &design);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	const std::pair<RideTypeKind, int> fixed_counts[] = {
+		{RTK_SHOP, settings.shops}, {RTK_GENTLE, settings.gentle_rides}, {RTK_THRILL, settings.thrill_rides},
+	};
+	int built[RTK_RIDE_KIND_COUNT] = {};
+	for (const auto &kind_count : fixed_counts) {
+		const std::vector<const FixedRideType *> &types = fixed_types[kind_count.first];
+		if (types.empty()) continue;
+		for (int i = 0; i < kind_count.second; i++) {
+			if (BuildFixedRide(rnd, types[i % types.size()], path_tiles)) built[kind_count.first]++;
+		}
+	}
+	if (!coaster_designs.empty()) {
+		for (int i = 0; i < settings.coasters; i++) {
+			const auto &design = coaster_designs[i % coaster_designs.size()];
+			if (BuildCoaster(rnd, design.first, *design.second)) built[RTK_COASTER]++;
+		}
+	}
+
+	/* Spread the guests over the paths, and hire staff of every kind. */
+	for (int i = 0; i < settings.guests; i++) {
+		const XYZPoint16 &pos = RandomElement(rnd, path_tiles);
+		_guests.AddGuest(Point16(pos.x, pos.y));
+	}
+	for (int i = 0; i < settings.staff; i++) {
+		switch (i % 4) {
+			case 0: _staff.HireHandyman();    break;
+			case 1: _staff.HireMechanic();    break;
+			case 2: _staff.HireGuard();       break;
+			case 3: _staff.HireEntertainer(); break;
+		}
+	}
+
+	{
+		Loader ldr(finances.data(), finances.size());
+		_finances_manager.Load(ldr);
+	}
+
+	const bool saved = SaveGameFile(fname.c_str());
+	if (saved) {
+		printf("Generated a %ux%u park with %u path tiles, %d/%d shops, %d/%d gentle rides, %d/%d thrill rides, %d/%d coasters, %d guests and %d staff in '%s'\n",
+				settings.x_size, settings.y_size, static_cast<uint>(path_tiles.size()),
+				built[RTK_SHOP], settings.shops, built[RTK_GENTLE], settings.gentle_rides, built[RTK_THRILL], settings.thrill_rides,
+				built[RTK_COASTER], settings.coasters, settings.guests, settings.staff, fname.c_str());
+	} else {
+		fprintf(stderr, "Cannot write the generated park to '%s'\n", fname.c_str());
+	}
+
+	_game_control.Uninitialize();
+	return saved ? 0 : 1;
+}
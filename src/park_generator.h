@@ -0,0 +1,36 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file park_generator.h Generation of synthetic parks for benchmarking. */
+
+#ifndef PARK_GENERATOR_H
+#define PARK_GENERATOR_H
+
+#include <string>
+
+/** Parameters of a generated park. */
+struct ParkGeneratorSettings {
+	ParkGeneratorSettings();
+
+	bool Parse(const std::string &text);
+
+	uint16 x_size;      ///< Length of the X side of the world.
+	uint16 y_size;      ///< Length of the Y side of the world.
+	int roughness;      ///< Roughness of the terrain, \c 0 is flat, \c 10 is very hilly.
+	int path_spacing;   ///< Distance between two parallel paths of the path grid (lower is denser).
+	int shops;          ///< Number of shops to build.
+	int gentle_rides;   ///< Number of gentle rides to build.
+	int thrill_rides;   ///< Number of thrill rides to build.
+	int coasters;       ///< Number of roller coasters to build.
+	int guests;         ///< Number of guests in the park.
+	int staff;          ///< Number of staff members in the park.
+	uint32 seed;        ///< Seed of the random generator, equal seeds generate equal parks.
+};
+
+int GeneratePark(const std::string &fname, const ParkGeneratorSettings &settings);
+
+#endif
@@ -20,6 +20,7 @@
 #include "gui_sprites.h"
 #include "sprite_data.h"
 #include "gameobserver.h"
+#include "replay.h"
 
 static const uint MIN_MAX_GUESTS       = 100;  ///< Smallest allowed value for the guests limit.
 static const uint MAX_GUESTS_STEP_SIZE = 100;  ///< Change when clicking the max guests buttons once.
@@ -273,6 +274,7 @@ static const WidgetPart _pm_build_gui_parts[] = {
 
 ParkManagementGui::ParkManagementGui(ParkManagementGuiTabs tab) : GuiWindow(WC_PARK_MANAGEMENT, ALL_WINDOWS_OF_TYPE)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The guests, ratings, and objective of the park change all the time.
 	this->SetupWidgetTree(_pm_build_gui_parts, lengthof(_pm_build_gui_parts));
 	this->SelectTab(tab);
 
@@ -421,10 +423,12 @@ void ParkManagementGui::OnClick(WidgetNumber number, [[maybe_unused]] const Poin
 
 		case PM_ENTRANCE_FEE_INCREASE:
 			_game_observer.entrance_fee += PARK_ENTRANCE_FEE_STEP_SIZE;
+			RecordParkEntranceFee();
 			this->UpdateButtons();
 			break;
 		case PM_ENTRANCE_FEE_DECREASE:
 			_game_observer.entrance_fee = std::max<int>(0, _game_observer.entrance_fee - PARK_ENTRANCE_FEE_STEP_SIZE);
+			RecordParkEntranceFee();
 			this->UpdateButtons();
 			break;
 
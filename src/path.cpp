@@ -14,6 +14,9 @@
 #include "scenery.h"
 #include "viewport.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 /** Imploded path tile sprite number to use for an 'up' slope from a given edge. */
 const PathSprites _path_up_from_edge[EDGE_COUNT] = {
 	PATH_RAMP_NE, ///< EDGE_NE
@@ -250,15 +253,26 @@ uint8 GetPathExits(const Voxel *v)
 	return GetPathExits(GetImplodedPathSlope(inst_data), true);
 }
 
+/** A walk over a queue path, as found by #WalkQueuePath. */
+struct QueueSegment {
+	bool used;                   ///< Whether the segment is in use.
+	bool found;                  ///< Whether the walk leads somewhere.
+	XYZPoint16 pos;              ///< Last voxel of the walk.
+	TileEdge edge;               ///< Exit edge of #pos.
+	uint16 length;               ///< Number of queue path voxels of the walk.
+	uint16 capacity;             ///< Number of guests that fit in the queue path voxels of the walk.
+	uint64 start;                ///< Key of the start voxel and entry edge of the walk.
+	std::vector<uint32> voxels;  ///< Keys of the voxels examined by the walk (see #GetVoxelKey).
+};
+
 /**
- * Walk over a queue path from the given entry edge at the given position.
- * If it leads to a new voxel edge, the provided position and edge is update with the exit point.
+ * Walk voxel by voxel over a queue path, and record the walk if requested.
  * @param voxel_pos [inout] Start voxel position before the queue path, updated to last voxel position.
  * @param entry Direction used for entry to the path, updated to last edge exit direction.
+ * @param segment [out] If not \c nullptr, receives the length of the walk, and the voxels examined by it.
  * @return Whether a (possibly) new last voxel could be found, \c false means the path leads to nowhere.
- * @note Parameter values may get changed during the call, do not rely on their values except when \c true is returned.
  */
-bool TravelQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry)
+static bool WalkQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry, QueueSegment *segment)
 {
 	XYZPoint16 new_pos = *voxel_pos;
 	TileEdge edge = *entry;
@@ -271,11 +285,13 @@ bool TravelQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry)
 		new_pos.y += _tile_dxy[edge].y;
 		if (!IsVoxelstackInsideWorld(new_pos.x, new_pos.y)) return false;
 
+		if (segment != nullptr) segment->voxels.push_back(GetVoxelKey(new_pos));
 		const Voxel *vx = _world.GetVoxel(new_pos);
 		if (vx == nullptr || !HasValidPath(vx)) {
 			/* No path here, check the voxel below. */
 			if (new_pos.z == 0) return true; // Path ends here.
 			new_pos.z--;
+			if (segment != nullptr) segment->voxels.push_back(GetVoxelKey(new_pos));
 			vx = _world.GetVoxel(new_pos);
 			if (vx == nullptr || !HasValidPath(vx)) return true; // Path ends here.
 		}
@@ -313,7 +329,150 @@ bool TravelQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry)
 
 		*voxel_pos = new_pos;
 		*entry = edge;
+		if (segment != nullptr) segment->length++;
+	}
+}
+
+/**
+ * Walk voxel by voxel over a queue path from the given entry edge at the given position.
+ * @param voxel_pos [inout] Start voxel position before the queue path, updated to last voxel position.
+ * @param entry Direction used for entry to the path, updated to last edge exit direction.
+ * @return Whether a (possibly) new last voxel could be found, \c false means the path leads to nowhere.
+ * @note Parameter values may get changed during the call, do not rely on their values except when \c true is returned.
+ * @see TravelQueuePath
+ */
+bool WalkQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry)
+{
+	return WalkQueuePath(voxel_pos, entry, nullptr);
+}
+
+/*
+ * Walks over queue paths are kept as segments. Every voxel examined by a walk has handles to the segments of the walks
+ * that examined it. A change of a path drops only the segments with a handle at the changed voxel or next to it.
+ */
+static std::vector<QueueSegment> _queue_segments;                             ///< Segments of the walks over queue paths, unused ones are in #_free_queue_segments.
+static std::vector<uint32> _free_queue_segments;                              ///< Indices of the unused entries of #_queue_segments.
+static std::unordered_map<uint64, uint32> _queue_segment_starts;              ///< Segment of a walk, by start voxel and entry edge.
+static std::unordered_map<uint32, std::vector<uint32>> _queue_segment_handles; ///< Segments examining a voxel, by voxel key.
+static uint32 _queue_segments_version = 0;                                    ///< Path network version of the queue segments.
+
+/**
+ * Drop the segments of the walks that examined a voxel.
+ * @param vox Voxel with a changed path.
+ */
+static void DropQueueSegments(const XYZPoint16 &vox)
+{
+	if (!IsVoxelInsideWorld(vox)) return;
+	auto handles = _queue_segment_handles.find(GetVoxelKey(vox));
+	if (handles == _queue_segment_handles.end()) return;
+
+	const std::vector<uint32> indices = std::move(handles->second);
+	_queue_segment_handles.erase(handles);
+	for (uint32 index : indices) {
+		QueueSegment &segment = _queue_segments[index];
+		if (!segment.used) continue;
+
+		/* Remove the handles of the other voxels of the walk. */
+		for (uint32 key : segment.voxels) {
+			auto other = _queue_segment_handles.find(key);
+			if (other == _queue_segment_handles.end()) continue;
+			std::vector<uint32> &other_indices = other->second;
+			other_indices.erase(std::remove(other_indices.begin(), other_indices.end(), index), other_indices.end());
+			if (other_indices.empty()) _queue_segment_handles.erase(other);
+		}
+		_queue_segment_starts.erase(segment.start);
+		segment.used = false;
+		segment.voxels.clear();
+		_free_queue_segments.push_back(index);
+	}
+}
+
+/** Drop the queue segments that may have changed since the previous walk. */
+static void UpdateQueueSegments()
+{
+	if (_queue_segments_version == _world.GetPathNetworkVersion()) return;
+
+	std::vector<XYZPoint16> changes;
+	const bool all_changed = _world.GetPathChanges(_queue_segments_version, &changes);
+	_queue_segments_version = _world.GetPathNetworkVersion();
+	if (all_changed) {
+		_queue_segments.clear();
+		_free_queue_segments.clear();
+		_queue_segment_starts.clear();
+		_queue_segment_handles.clear();
+		return;
+	}
+
+	/* Paths changed in the voxels of a change, and their connections to the voxels next to it. */
+	for (const XYZPoint16 &vox : changes) {
+		for (int dz = 0; dz <= 2; dz++) DropQueueSegments(XYZPoint16(vox.x, vox.y, vox.z + dz)); // Voxels above a path belong to it.
+		for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
+			for (int dz = -1; dz <= 1; dz++) DropQueueSegments(XYZPoint16(vox.x + _tile_dxy[edge].x, vox.y + _tile_dxy[edge].y, vox.z + dz));
+		}
+	}
+}
+
+/**
+ * Does the walk over a queue path enter a voxel with a queue path?
+ * @param voxel_pos Voxel entered by the walk, inside the world.
+ * @return Whether the voxel or the voxel below it has a queue path, where #WalkQueuePath continues.
+ */
+static bool HasQueuePathAtBottom(const XYZPoint16 &voxel_pos)
+{
+	const Voxel *vx = _world.GetVoxel(voxel_pos);
+	if ((vx == nullptr || !HasValidPath(vx)) && voxel_pos.z > 0) vx = _world.GetVoxel(voxel_pos + XYZPoint16(0, 0, -1));
+	return vx != nullptr && HasValidPath(vx) && GetPathStatus(vx->GetInstanceData()) == PAS_QUEUE_PATH;
+}
+
+/**
+ * Walk over a queue path from the given entry edge at the given position.
+ * If it leads to a new voxel edge, the provided position and edge is update with the exit point.
+ * Walks over queue paths are remembered as segments until a path at or next to one of their voxels changes, as guests
+ * often look at the same queues.
+ * @param voxel_pos [inout] Start voxel position before the queue path, updated to last voxel position.
+ * @param entry Direction used for entry to the path, updated to last edge exit direction.
+ * @param capacity [out] If not \c nullptr, receives the number of guests that fit in the walked queue.
+ * @return Whether a (possibly) new last voxel could be found, \c false means the path leads to nowhere.
+ * @note Parameter values may get changed during the call, do not rely on their values except when \c true is returned.
+ */
+bool TravelQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry, uint16 *capacity)
+{
+	if (capacity != nullptr) *capacity = 0;
+	if (!IsVoxelstackInsideWorld(voxel_pos->x, voxel_pos->y)) return false;
+	const XYZPoint16 first(voxel_pos->x + _tile_dxy[*entry].x, voxel_pos->y + _tile_dxy[*entry].y, voxel_pos->z);
+	if (!IsVoxelstackInsideWorld(first.x, first.y)) return false;
+	if (!HasQueuePathAtBottom(first)) return true; // The walk ends at the start voxel.
+
+	UpdateQueueSegments();
+	const uint64 key = (static_cast<uint64>(GetVoxelKey(*voxel_pos)) << 8) | *entry;
+	auto iter = _queue_segment_starts.find(key);
+	if (iter == _queue_segment_starts.end()) {
+		uint32 index;
+		if (_free_queue_segments.empty()) {
+			index = _queue_segments.size();
+			_queue_segments.emplace_back();
+		} else {
+			index = _free_queue_segments.back();
+			_free_queue_segments.pop_back();
+		}
+		QueueSegment &segment = _queue_segments[index];
+		segment.used = true;
+		segment.pos = *voxel_pos;
+		segment.edge = *entry;
+		segment.length = 0;
+		segment.start = key;
+		segment.found = WalkQueuePath(&segment.pos, &segment.edge, &segment);
+		segment.capacity = segment.length * (256 / QUEUE_DISTANCE);
+		for (uint32 voxel_key : segment.voxels) _queue_segment_handles[voxel_key].push_back(index);
+		iter = _queue_segment_starts.emplace(key, index).first;
 	}
+
+	const QueueSegment &segment = _queue_segments[iter->second];
+	if (!segment.found) return false;
+	*voxel_pos = segment.pos;
+	*entry = segment.edge;
+	if (capacity != nullptr) *capacity = segment.capacity;
+	return true;
 }
 
 /**
@@ -448,6 +607,7 @@ uint8 AddRemovePathEdges(const XYZPoint16 &voxel_pos, uint8 slope, uint8 dirs, P
 
 	Voxel *v = _world.GetCreateVoxel(voxel_pos, false);
 	uint16 fences = v->GetFences();
+	_world.NotifyPathChange(voxel_pos);
 
 	std::fill_n(ngb_status, lengthof(ngb_status), PAS_UNUSED); // Clear path all statuses to prevent connecting to it if an edge is skipped.
 	for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
@@ -491,6 +651,7 @@ uint8 AddRemovePathEdges(const XYZPoint16 &voxel_pos, uint8 slope, uint8 dirs, P
 					if (slope < PATH_FLAT_COUNT) slope = SetPathEdge(slope, edge, status != PAS_UNUSED);
 					if (ngb_voxel[edge] != nullptr) {
 						ngb_voxel[edge]->SetInstanceData(ngb_instance_data[edge]);
+						_world.MarkStackDirty(ngb_pos[edge].x, ngb_pos[edge].y);
 					}
 				}
 				PathObjectInstance *obj = _scenery.GetPathObject(ngb_pos[edge]);
@@ -511,6 +672,7 @@ uint8 AddRemovePathEdges(const XYZPoint16 &voxel_pos, uint8 slope, uint8 dirs, P
 					if (slope < PATH_FLAT_COUNT) slope = SetPathEdge(slope, edge, true);
 					if (ngb_voxel[edge] != nullptr) {
 						ngb_voxel[edge]->SetInstanceData(ngb_instance_data[edge]);
+						_world.MarkStackDirty(ngb_pos[edge].x, ngb_pos[edge].y);
 					}
 				}
 			}
@@ -522,6 +684,7 @@ uint8 AddRemovePathEdges(const XYZPoint16 &voxel_pos, uint8 slope, uint8 dirs, P
 					if (slope < PATH_FLAT_COUNT) slope = SetPathEdge(slope, edge, true);
 					if (ngb_voxel[edge] != nullptr) {
 						ngb_voxel[edge]->SetInstanceData(ngb_instance_data[edge]);
+						_world.MarkStackDirty(ngb_pos[edge].x, ngb_pos[edge].y);
 					}
 				}
 				PathObjectInstance *obj = _scenery.GetPathObject(ngb_pos[edge]);
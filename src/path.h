@@ -124,12 +124,16 @@ extern const uint8 _path_expand[];
 extern const uint8 _path_implode[256];
 extern const uint8 _path_rotation[PATH_COUNT][4];
 
+static const int QUEUE_DISTANCE = 64;  ///< The pixel distance between two guests queuing for a ride.
+assert_compile(256 % QUEUE_DISTANCE == 0);
+
 struct Voxel;
 
 uint8 GetPathExits(PathSprites slope, bool use_path_connections);
 uint8 GetPathExits(const Voxel *v);
 
-bool TravelQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry);
+bool WalkQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry);
+bool TravelQueuePath(XYZPoint16 *voxel_pos, TileEdge *entry, uint16 *capacity = nullptr);
 
 bool PathExistsAtBottomEdge(XYZPoint16 voxel_pos, TileEdge edge);
 
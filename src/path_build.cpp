@@ -16,6 +16,27 @@
 #include "gamecontrol.h"
 #include "window.h"
 #include "math_func.h"
+#include "replay.h"
+
+/**
+ * Record a change of a path by the player, for replaying the game.
+ * @param type Kind of change.
+ * @param voxel_pos Coordinate of the voxel.
+ * @param edge Entry edge.
+ * @param path_type The type of path.
+ * @param path_status Whether the path is a queue or normal path.
+ * @param pay Whether the path is paid for.
+ */
+static void RecordPathCommand(ReplayCommandType type, const XYZPoint16 &voxel_pos, TileEdge edge, PathType path_type, PathStatus path_status, bool pay)
+{
+	ReplayCommand cmd(type);
+	cmd.pos = voxel_pos;
+	cmd.data[0] = edge;
+	cmd.data[1] = path_type;
+	cmd.data[2] = path_status;
+	cmd.data[3] = pay ? 1 : 0;
+	_replay.Record(cmd);
+}
 
 /**
  * Test how much it would cost to build a path in a given voxel.
@@ -28,12 +49,11 @@
  */
 Money PathBuildingCost(const XYZPoint16 &voxel_pos, [[maybe_unused]] PathType path_type, [[maybe_unused]] PathStatus path_status, uint8 path_spr)
 {
-	VoxelStack *avs = _world.GetModifyStack(voxel_pos.x, voxel_pos.y);
-	Voxel *av = avs->GetCreate(voxel_pos.z, true);
+	const Voxel *av = _world.GetVoxel(voxel_pos);
 	const int ground_height = _world.GetBaseGroundHeight(voxel_pos.x, voxel_pos.y);
 	assert(voxel_pos.z >= ground_height);  // \todo Allow building underground.
 	Money cost = CONSTRUCTION_COST_PATH;
-	if (av->GetGroundType() == GTP_INVALID) {
+	if (av == nullptr || av->GetGroundType() == GTP_INVALID) {
 		cost += CONSTRUCTION_COST_SUPPORT * (voxel_pos.z - ground_height + 1);
 	} else if (path_spr >= PATH_FLAT_COUNT) {
 		cost += CONSTRUCTION_COST_SUPPORT;
@@ -52,8 +72,6 @@ Money PathBuildingCost(const XYZPoint16 &voxel_pos, [[maybe_unused]] PathType pa
  */
 static void BuildPathAtTile(const XYZPoint16 &voxel_pos, PathType path_type, PathStatus path_status, uint8 path_spr, bool pay)
 {
-	VoxelStack *avs = _world.GetModifyStack(voxel_pos.x, voxel_pos.y);
-	Voxel *av = avs->GetCreate(voxel_pos.z, true);
 	const Money cost = PathBuildingCost(voxel_pos, path_type, path_status, path_spr);
 
 	if (!BestErrorMessageReason::CheckActionAllowed(BestErrorMessageReason::ACT_BUILD, cost)) return;
@@ -63,9 +81,12 @@ static void BuildPathAtTile(const XYZPoint16 &voxel_pos, PathType path_type, Pat
 	}
 	if (pay) {
 		_finances_manager.PayRideConstruct(cost);
-		_window_manager.GetViewport()->AddFloatawayMoneyAmount(cost, voxel_pos);
+		Viewport *vp = _window_manager.GetViewport();
+		if (vp != nullptr) vp->AddFloatawayMoneyAmount(cost, voxel_pos);  // There is no viewport while replaying.
 	}
 
+	VoxelStack *avs = _world.GetModifyStack(voxel_pos.x, voxel_pos.y);
+	Voxel *av = avs->GetCreate(voxel_pos.z, true);
 	av->SetInstance(SRI_PATH);
 	uint8 slope = AddRemovePathEdges(voxel_pos, path_spr, EDGE_ALL, path_status);
 	av->SetInstanceData(MakePathInstanceData(slope, path_type, path_status));
@@ -81,6 +102,7 @@ static void BuildPathAtTile(const XYZPoint16 &voxel_pos, PathType path_type, Pat
 		av->SetInstance(SRI_PATH);
 		av->SetInstanceData(PATH_INVALID);
 	}
+	_world.MarkStackDirty(voxel_pos.x, voxel_pos.y);
 }
 
 /**
@@ -114,10 +136,12 @@ static void RemovePathAtTile(const XYZPoint16 &voxel_pos, uint8 path_spr, bool p
 		av->SetInstance(SRI_FREE);
 		av->SetInstanceData(0);
 	}
+	_world.MarkStackDirty(voxel_pos.x, voxel_pos.y);
 
 	if (pay) {
 		_finances_manager.PayRideConstruct(CONSTRUCTION_COST_PATH_RETURN);
-		_window_manager.GetViewport()->AddFloatawayMoneyAmount(CONSTRUCTION_COST_PATH_RETURN, voxel_pos);
+		Viewport *vp = _window_manager.GetViewport();
+		if (vp != nullptr) vp->AddFloatawayMoneyAmount(CONSTRUCTION_COST_PATH_RETURN, voxel_pos);
 	}
 }
 
@@ -148,10 +172,12 @@ static void ChangePathAtTile(const XYZPoint16 &voxel_pos, PathType path_type, Pa
 
 	uint8 slope = AddRemovePathEdges(voxel_pos, path_spr, EDGE_ALL, path_status);
 	av->SetInstanceData(MakePathInstanceData(slope, path_type, path_status));
+	_world.MarkStackDirty(voxel_pos.x, voxel_pos.y);
 
 	if (pay) {
 		_finances_manager.PayRideConstruct(CONSTRUCTION_COST_PATH_CHANGE);
-		_window_manager.GetViewport()->AddFloatawayMoneyAmount(CONSTRUCTION_COST_PATH_CHANGE, voxel_pos);
+		Viewport *vp = _window_manager.GetViewport();
+		if (vp != nullptr) vp->AddFloatawayMoneyAmount(CONSTRUCTION_COST_PATH_CHANGE, voxel_pos);
 	}
 }
 
@@ -223,7 +249,10 @@ bool BuildUpwardPath(const XYZPoint16 &voxel_pos, TileEdge edge, PathType path_t
 		}
 	}
 
-	if (!test_only) BuildPathAtTile(voxel_pos, path_type, path_status, _path_up_from_edge[edge], pay);
+	if (!test_only) {
+		RecordPathCommand(RCT_BUILD_UPWARD_PATH, voxel_pos, edge, path_type, path_status, pay);
+		BuildPathAtTile(voxel_pos, path_type, path_status, _path_up_from_edge[edge], pay);
+	}
 	return true;
 }
 
@@ -260,7 +289,10 @@ bool BuildFlatPath(const XYZPoint16 &voxel_pos, PathType path_type, PathStatus p
 		}
 	}
 
-	if (!test_only) BuildPathAtTile(voxel_pos, path_type, path_status, PATH_EMPTY, pay);
+	if (!test_only) {
+		RecordPathCommand(RCT_BUILD_FLAT_PATH, voxel_pos, INVALID_EDGE, path_type, path_status, pay);
+		BuildPathAtTile(voxel_pos, path_type, path_status, PATH_EMPTY, pay);
+	}
 	return true;
 }
 
@@ -305,6 +337,7 @@ bool BuildDownwardPath(XYZPoint16 voxel_pos, TileEdge edge, PathType path_type,
 	}
 
 	if (!test_only) {
+		RecordPathCommand(RCT_BUILD_DOWNWARD_PATH, voxel_pos, edge, path_type, path_status, pay);
 		voxel_pos.z--;
 		BuildPathAtTile(voxel_pos, path_type, path_status, _path_down_from_edge[edge], pay);
 	}
@@ -339,7 +372,10 @@ bool RemovePath(const XYZPoint16 &voxel_pos, bool test_only, bool pay)
 		assert(v->GetInstance() == SRI_PATH && !HasValidPath(v->GetInstanceData()));
 	}
 
-	if (!test_only) RemovePathAtTile(voxel_pos, ps, pay);
+	if (!test_only) {
+		RecordPathCommand(RCT_REMOVE_PATH, voxel_pos, INVALID_EDGE, PAT_INVALID, PAS_UNUSED, pay);
+		RemovePathAtTile(voxel_pos, ps, pay);
+	}
 	return true;
 }
 
@@ -367,7 +403,10 @@ bool ChangePath(const XYZPoint16 &voxel_pos, PathType path_type, PathStatus path
 		assert(v->GetInstance() == SRI_PATH && !HasValidPath(v->GetInstanceData()));
 	}
 
-	if (!test_only) ChangePathAtTile(voxel_pos, path_type, path_status, ps, pay);
+	if (!test_only) {
+		RecordPathCommand(RCT_CHANGE_PATH, voxel_pos, INVALID_EDGE, path_type, path_status, pay);
+		ChangePathAtTile(voxel_pos, path_type, path_status, ps, pay);
+	}
 	return true;
 }
 
@@ -11,6 +11,10 @@
 #include "path_finding.h"
 #include "map.h"
 
+#include <unordered_set>
+
+PathComponents _path_components; ///< Connected components of the path network.
+
 /**
  * Constructor of a walked position.
  * @param cur_vox Current voxel position.
@@ -73,6 +77,7 @@ PathSearcher::PathSearcher(const XYZPoint16 &init_dest_vox)
  */
 void PathSearcher::AddStart(const XYZPoint16 &start_vox)
 {
+	this->starts.push_back(start_vox);
 	this->AddOpen(start_vox, 0, nullptr);
 }
 
@@ -117,6 +122,52 @@ void PathSearcher::AddOpen(const XYZPoint16 &vox, uint32 traveled, const WalkedP
 	this->open_points.emplace(traveled, estimate, pwp);
 }
 
+/**
+ * Find the voxels that can be reached in one step from a voxel with a path.
+ * @param vox Voxel to walk from.
+ * @param neighbours [out] Reachable voxels. Must have room for #EDGE_COUNT entries.
+ * @param edges [out] If not \c nullptr, the edge of \a vox leading to each of the \a neighbours. Must have room for #EDGE_COUNT entries.
+ * @return Number of reachable voxels stored in \a neighbours.
+ */
+static int GetPathNeighbours(const XYZPoint16 &vox, XYZPoint16 *neighbours, TileEdge *edges = nullptr)
+{
+	const Voxel *v = _world.GetVoxel(vox);
+	if (v == nullptr) return 0; // No voxel at the expected point, don't bother.
+
+	int count = 0;
+	uint8 exits = GetPathExits(v);
+	for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
+		if ((exits & (0x11 << edge)) == 0) continue;
+
+		/* There is an outgoing connection, is it also on the world? */
+		Point16 dxy = _tile_dxy[edge];
+		if (dxy.x < 0 && vox.x == 0) continue;
+		if (dxy.x > 0 && vox.x + 1 == _world.GetXSize()) continue;
+		if (dxy.y < 0 && vox.y == 0) continue;
+		if (dxy.y > 0 && vox.y + 1 == _world.GetYSize()) continue;
+
+		int extra_z = ((exits & (0x10 << edge)) != 0);
+		if (vox.z + extra_z < 0 || vox.z + extra_z >= WORLD_Z_SIZE) continue;
+
+		/* Now check the other side, new_z is the voxel where the path should be at the bottom. */
+		const Voxel *v2 = _world.GetVoxel(vox + XYZPoint16(dxy.x, dxy.y, extra_z));
+		if (v2 == nullptr) continue;
+
+		uint8 other_exits = GetPathExits(v2);
+		if ((other_exits & (1 << ((edge + 2) % 4))) == 0) { // No path here, try one voxel below
+			extra_z--;
+			if (vox.z + extra_z < 0) continue;
+			v2 = _world.GetVoxel(vox + XYZPoint16(dxy.x, dxy.y, extra_z));
+			if (v2 == nullptr) continue;
+			other_exits = GetPathExits(v2);
+			if ((other_exits & (0x10 << ((edge + 2) % 4))) == 0) continue;
+		}
+		if (edges != nullptr) edges[count] = edge;
+		neighbours[count++] = vox + XYZPoint16(dxy.x, dxy.y, extra_z);
+	}
+	return count;
+}
+
 /**
  * Search for a path to the destination.
  * @return Whether a path has been found.
@@ -124,6 +175,20 @@ void PathSearcher::AddOpen(const XYZPoint16 &vox, uint32 traveled, const WalkedP
 bool PathSearcher::Search()
 {
 	this->dest_pos = nullptr;
+
+	/* Give up immediately if none of the starting points is connected to the destination. */
+	bool reachable = false;
+	for (const XYZPoint16 &start : this->starts) {
+		if (_path_components.IsConnected(start, this->dest_vox)) {
+			reachable = true;
+			break;
+		}
+	}
+	if (!reachable) {
+		this->open_points.clear();
+		return false;
+	}
+
 	while (!this->open_points.empty()) {
 		WalkedDistance wd = *this->open_points.begin();
 		this->open_points.erase(this->open_points.begin());
@@ -138,48 +203,305 @@ bool PathSearcher::Search()
 		}
 
 		/* Add new open points. */
-		const Voxel *v = _world.GetVoxel(wp->cur_vox);
-		if (v == nullptr) continue; // No voxel at the expected point, don't bother.
+		XYZPoint16 neighbours[EDGE_COUNT];
+		int count = GetPathNeighbours(wp->cur_vox, neighbours);
+		for (int i = 0; i < count; i++) this->AddOpen(neighbours[i], wp->traveled + 1, wp);
+	}
+	return false;
+}
 
-		uint8 exits = GetPathExits(v);
-		for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
-			if ((exits & (0x11 << edge)) == 0) continue;
+/** Clear the used data structures of the path searcher. */
+void PathSearcher::Clear()
+{
+	this->open_points.clear();
+	this->positions.clear();
+	this->starts.clear();
+	this->dest_pos = nullptr;
+}
 
-			/* There is an outgoing connection, is it also on the world? */
-			Point16 dxy = _tile_dxy[edge];
-			if (dxy.x < 0 && wp->cur_vox.x == 0) continue;
-			if (dxy.x > 0 && wp->cur_vox.x + 1 == _world.GetXSize()) continue;
-			if (dxy.y < 0 && wp->cur_vox.y == 0) continue;
-			if (dxy.y > 0 && wp->cur_vox.y + 1 == _world.GetYSize()) continue;
+/**
+ * Compute the walking distances from the starting voxels to all reachable voxels, with a breadth-first search.
+ * @param starts Voxels to start walking from.
+ */
+void PathDistanceField::Compute(const std::vector<XYZPoint16> &starts)
+{
+	this->distances.clear();
 
-			int extra_z = ((exits & (0x10 << edge)) != 0);
-			if (wp->cur_vox.z + extra_z < 0 || wp->cur_vox.z + extra_z >= WORLD_Z_SIZE) continue;
+	std::vector<XYZPoint16> current;
+	for (const XYZPoint16 &start : starts) {
+		if (this->distances.emplace(GetVoxelKey(start), 0).second) current.push_back(start);
+	}
 
-			/* Now check the other side, new_z is the voxel where the path should be at the bottom. */
-			const Voxel *v2 = _world.GetVoxel(wp->cur_vox + XYZPoint16(dxy.x, dxy.y, extra_z));
-			if (v2 == nullptr) continue;
+	std::vector<XYZPoint16> next;
+	for (uint32 traveled = 1; !current.empty(); traveled++) {
+		for (const XYZPoint16 &vox : current) {
+			XYZPoint16 neighbours[EDGE_COUNT];
+			int count = GetPathNeighbours(vox, neighbours);
+			for (int i = 0; i < count; i++) {
+				if (this->distances.emplace(GetVoxelKey(neighbours[i]), traveled).second) next.push_back(neighbours[i]);
+			}
+		}
+		current.swap(next);
+		next.clear();
+	}
+}
+
+/**
+ * Get the walking distance from the nearest starting voxel to a voxel.
+ * @param vox Voxel to walk to.
+ * @return Number of steps to walk, or #UNREACHABLE if no path exists.
+ */
+uint32 PathDistanceField::GetDistance(const XYZPoint16 &vox) const
+{
+	const auto it = this->distances.find(GetVoxelKey(vox));
+	return (it == this->distances.end()) ? UNREACHABLE : it->second;
+}
+
+/**
+ * Get the direction to walk to get one step closer to the nearest starting voxel.
+ * @param vox Current voxel.
+ * @return Edge of \a vox to leave through, or #INVALID_EDGE if \a vox is a starting voxel or cannot be reached.
+ */
+TileEdge PathDistanceField::GetDirectionToStart(const XYZPoint16 &vox) const
+{
+	const uint32 distance = this->GetDistance(vox);
+	if (distance == 0 || distance == UNREACHABLE) return INVALID_EDGE;
 
-			uint8 other_exits = GetPathExits(v2);
-			if ((other_exits & (1 << ((edge + 2) % 4))) == 0) { // No path here, try one voxel below
-				extra_z--;
-				if (wp->cur_vox.z + extra_z < 0) continue;
-				v2 = _world.GetVoxel(wp->cur_vox + XYZPoint16(dxy.x, dxy.y, extra_z));
-				if (v2 == nullptr) continue;
-				other_exits = GetPathExits(v2);
-				if ((other_exits & (0x10 << ((edge + 2) % 4))) == 0) continue;
+	XYZPoint16 neighbours[EDGE_COUNT];
+	TileEdge edges[EDGE_COUNT];
+	int count = GetPathNeighbours(vox, neighbours, edges);
+	for (int i = 0; i < count; i++) {
+		if (this->GetDistance(neighbours[i]) < distance) return edges[i];
+	}
+	return INVALID_EDGE;
+}
+
+/**
+ * Find the nearest voxel over the path network that satisfies a condition, with a breadth-first search.
+ * @param start Voxel to start walking from.
+ * @param max_distance Maximal number of steps to walk.
+ * @param accept Condition to satisfy.
+ * @param found [out] The nearest voxel satisfying the condition, if any.
+ * @return Whether a voxel was found.
+ */
+bool FindNearestPathVoxel(const XYZPoint16 &start, uint32 max_distance, const std::function<bool(const XYZPoint16 &)> &accept, XYZPoint16 *found)
+{
+	std::unordered_set<uint32> visited;
+	std::vector<XYZPoint16> current = {start};
+	std::vector<XYZPoint16> next;
+	visited.insert(GetVoxelKey(start));
+
+	for (uint32 traveled = 0; !current.empty() && traveled <= max_distance; traveled++) {
+		for (const XYZPoint16 &vox : current) {
+			if (accept(vox)) {
+				*found = vox;
+				return true;
+			}
+
+			XYZPoint16 neighbours[EDGE_COUNT];
+			int count = GetPathNeighbours(vox, neighbours);
+			for (int i = 0; i < count; i++) {
+				if (visited.insert(GetVoxelKey(neighbours[i])).second) next.push_back(neighbours[i]);
 			}
-			/* Add new open point to the path finder. */
-			this->AddOpen(wp->cur_vox + XYZPoint16(dxy.x, dxy.y, extra_z), wp->traveled + 1, wp);
 		}
+		current.swap(next);
+		next.clear();
 	}
 	return false;
 }
 
-/** Clear the used data structures of the path searcher. */
-void PathSearcher::Clear()
+/**
+ * Get the connected component of the path network that contains a voxel.
+ * @param vox Voxel to examine.
+ * @return Component of the voxel, or #NO_COMPONENT if the voxel has no path exits.
+ */
+uint32 PathComponents::GetComponent(const XYZPoint16 &vox)
 {
-	this->open_points.clear();
-	this->positions.clear();
-	this->dest_pos = nullptr;
+	this->Update();
+	const auto it = this->labels.find(GetVoxelKey(vox));
+	return (it == this->labels.end()) ? NO_COMPONENT : this->FindRoot(it->second.node);
 }
 
+/**
+ * Can a voxel be reached from another voxel by walking over paths?
+ * @param from Voxel to walk from.
+ * @param to Voxel to walk to.
+ * @return Whether a walk over the paths exists.
+ */
+bool PathComponents::IsConnected(const XYZPoint16 &from, const XYZPoint16 &to)
+{
+	if (from == to) return true;
+	if (!IsVoxelInsideWorld(from) || !IsVoxelInsideWorld(to)) return false;
+
+	const uint32 component = this->GetComponent(from);
+	return component != NO_COMPONENT && component == this->GetComponent(to);
+}
+
+/** Process the path changes of the world since the previous update. */
+void PathComponents::Update()
+{
+	if (this->path_network_version == _world.GetPathNetworkVersion()) return;
+
+	std::vector<XYZPoint16> changes;
+	const bool all_changed = _world.GetPathChanges(this->path_network_version, &changes);
+	this->path_network_version = _world.GetPathNetworkVersion();
+	if (all_changed || this->parents.size() > 2 * this->labels.size() + 4096) {
+		this->Recompute();
+		return;
+	}
+	if (changes.empty()) return;
+
+	/* Paths changed in the voxel of a change, and their connections to the voxels next to it. */
+	std::vector<XYZPoint16> affected;
+	std::unordered_set<uint32> affected_keys;
+	auto add_affected = [&affected, &affected_keys](const XYZPoint16 &pos) {
+		if (IsVoxelInsideWorld(pos) && affected_keys.insert(GetVoxelKey(pos)).second) affected.push_back(pos);
+	};
+	for (const XYZPoint16 &vox : changes) {
+		add_affected(vox);
+		for (TileEdge edge = EDGE_BEGIN; edge < EDGE_COUNT; edge++) {
+			for (int dz = -1; dz <= 1; dz++) add_affected(XYZPoint16(vox.x + _tile_dxy[edge].x, vox.y + _tile_dxy[edge].y, vox.z + dz));
+		}
+	}
+
+	/* A voxel that lost exits may have split its component, label the voxels of such components again. */
+	std::unordered_set<uint32> split_roots;
+	for (const XYZPoint16 &vox : affected) {
+		const auto it = this->labels.find(GetVoxelKey(vox));
+		if (it == this->labels.end()) continue;
+
+		const Voxel *v = _world.GetVoxel(vox);
+		const uint8 exits = (v == nullptr) ? 0 : GetPathExits(v);
+		if ((it->second.exits & ~exits) != 0) split_roots.insert(this->FindRoot(it->second.node));
+	}
+	for (uint32 root : split_roots) this->Relabel(root);
+
+	/* Merge the components that got connected. */
+	for (const XYZPoint16 &vox : affected) {
+		const Voxel *v = _world.GetVoxel(vox);
+		const uint8 exits = (v == nullptr) ? 0 : GetPathExits(v);
+		if (exits == 0) continue;
+
+		if (this->labels.count(GetVoxelKey(vox)) == 0) this->Flood(vox, this->AddNode());
+		VoxelLabel &label = this->labels.at(GetVoxelKey(vox));
+		label.exits = exits;
+		const uint32 node = label.node;
+
+		XYZPoint16 neighbours[EDGE_COUNT];
+		int count = GetPathNeighbours(vox, neighbours);
+		for (int i = 0; i < count; i++) {
+			const uint32 key = GetVoxelKey(neighbours[i]);
+			if (this->labels.count(key) == 0) this->Flood(neighbours[i], this->AddNode());
+			this->Join(node, this->labels.at(key).node);
+		}
+	}
+}
+
+/** Label all voxels with a path from scratch. */
+void PathComponents::Recompute()
+{
+	this->labels.clear();
+	this->parents.clear();
+	this->members.clear();
+
+	for (int x = 0; x < _world.GetXSize(); x++) {
+		for (int y = 0; y < _world.GetYSize(); y++) {
+			const VoxelStack *vs = _world.GetStack(x, y);
+			for (int h = 0; h < vs->height; h++) {
+				if (GetPathExits(vs->voxels[h].get()) == 0) continue;
+
+				const XYZPoint16 vox(x, y, vs->base + h);
+				if (this->labels.count(GetVoxelKey(vox)) == 0) this->Flood(vox, this->AddNode());
+			}
+		}
+	}
+}
+
+/**
+ * Make a new node, as root of a new component.
+ * @return The new node.
+ */
+uint32 PathComponents::AddNode()
+{
+	const uint32 node = this->parents.size();
+	this->parents.push_back(node);
+	this->members.emplace_back();
+	return node;
+}
+
+/**
+ * Find the root node of a node, the root identifies the component.
+ * @param node Node to examine.
+ * @return The root node of \a node.
+ */
+uint32 PathComponents::FindRoot(uint32 node)
+{
+	uint32 root = node;
+	while (this->parents[root] != root) root = this->parents[root];
+	while (this->parents[node] != root) {
+		const uint32 next = this->parents[node];
+		this->parents[node] = root;
+		node = next;
+	}
+	return root;
+}
+
+/**
+ * Merge the components of two nodes.
+ * @param node1 First node.
+ * @param node2 Second node.
+ */
+void PathComponents::Join(uint32 node1, uint32 node2)
+{
+	uint32 root1 = this->FindRoot(node1);
+	uint32 root2 = this->FindRoot(node2);
+	if (root1 == root2) return;
+
+	/* Move the voxels of the smaller component to the bigger one. */
+	if (this->members[root1].size() < this->members[root2].size()) std::swap(root1, root2);
+	this->parents[root2] = root1;
+	this->members[root1].insert(this->members[root1].end(), this->members[root2].begin(), this->members[root2].end());
+	std::vector<XYZPoint16>().swap(this->members[root2]);
+}
+
+/**
+ * Label the unlabeled voxels reachable from a voxel with a node, with a breadth-first search.
+ * @param start Unlabeled voxel with a path to start from.
+ * @param node Root node to give to the voxels.
+ */
+void PathComponents::Flood(const XYZPoint16 &start, uint32 node)
+{
+	std::vector<XYZPoint16> &voxels = this->members[node];
+	size_t index = voxels.size();
+	this->labels[GetVoxelKey(start)] = {node, GetPathExits(_world.GetVoxel(start))};
+	voxels.push_back(start);
+
+	for (; index < voxels.size(); index++) {
+		XYZPoint16 neighbours[EDGE_COUNT];
+		int count = GetPathNeighbours(voxels[index], neighbours);
+		for (int i = 0; i < count; i++) {
+			const uint32 key = GetVoxelKey(neighbours[i]);
+			if (this->labels.count(key) != 0) continue;
+
+			this->labels[key] = {node, GetPathExits(_world.GetVoxel(neighbours[i]))};
+			voxels.push_back(neighbours[i]);
+		}
+	}
+}
+
+/**
+ * Label the voxels of a component again, after connections inside it have been removed.
+ * @param root Root node of the component.
+ */
+void PathComponents::Relabel(uint32 root)
+{
+	std::vector<XYZPoint16> voxels;
+	voxels.swap(this->members[root]);
+	for (const XYZPoint16 &vox : voxels) this->labels.erase(GetVoxelKey(vox));
+
+	for (const XYZPoint16 &vox : voxels) {
+		const Voxel *v = _world.GetVoxel(vox);
+		if (v == nullptr || GetPathExits(v) == 0 || this->labels.count(GetVoxelKey(vox)) != 0) continue;
+		this->Flood(vox, this->AddNode());
+	}
+}
@@ -10,9 +10,13 @@
 #ifndef PATH_FINDING_H
 #define PATH_FINDING_H
 
+#include <functional>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "geometry.h"
+#include "tile.h"
 
 /** Intermediate position of a walk. */
 class WalkedPosition {
@@ -53,10 +57,64 @@ public:
 protected:
 	PositionSet positions;   ///< Examined positions.
 	OpenPoints  open_points; ///< Open points to examine further.
+	std::vector<XYZPoint16> starts; ///< Starting points of the search.
 
 	inline uint32 GetEstimate(const XYZPoint16 &vox);
 	void AddOpen(const XYZPoint16 &vox, uint32 traveled, const WalkedPosition *prev_pos);
 };
 
+/**
+ * Walking distances over the path network from a set of starting voxels to every voxel that can be reached.
+ * Answers the same path lengths as a #PathSearcher with the same starting points, for all destinations at once.
+ */
+class PathDistanceField {
+public:
+	static const uint32 UNREACHABLE = UINT32_MAX; ///< Distance of a voxel that cannot be reached.
+
+	void Compute(const std::vector<XYZPoint16> &starts);
+	uint32 GetDistance(const XYZPoint16 &vox) const;
+	TileEdge GetDirectionToStart(const XYZPoint16 &vox) const;
+
+private:
+	std::unordered_map<uint32, uint32> distances; ///< Walking distance of every reached voxel, indexed by voxel key.
+};
+
+/**
+ * Connected components of the path network, to decide whether a voxel can be reached from another voxel without searching a path.
+ * The components are updated from the path changes recorded by the world (see VoxelWorld::GetPathChanges).
+ * Added connections merge components, removed connections cause the affected components to be labeled again.
+ */
+class PathComponents {
+public:
+	static const uint32 NO_COMPONENT = UINT32_MAX; ///< Component of a voxel without path connections.
+
+	uint32 GetComponent(const XYZPoint16 &vox);
+	bool IsConnected(const XYZPoint16 &from, const XYZPoint16 &to);
+
+private:
+	/** Component data of a voxel with a path. */
+	struct VoxelLabel {
+		uint32 node; ///< Node of the voxel in #parents, its root is the component of the voxel.
+		uint8 exits; ///< Path exits of the voxel when it was labeled, see #GetPathExits.
+	};
+
+	void Update();
+	void Recompute();
+	uint32 AddNode();
+	uint32 FindRoot(uint32 node);
+	void Join(uint32 node1, uint32 node2);
+	void Flood(const XYZPoint16 &start, uint32 node);
+	void Relabel(uint32 root);
+
+	std::unordered_map<uint32, VoxelLabel> labels;   ///< Labels of the voxels with a path, indexed by voxel key.
+	std::vector<uint32> parents;                     ///< Union-find parent of every node, a root node is its own parent.
+	std::vector<std::vector<XYZPoint16>> members;    ///< Voxels of every root node, empty for other nodes.
+	uint32 path_network_version = 0;                 ///< Version of the path network at the latest update.
+};
+
+extern PathComponents _path_components;
+
+bool FindNearestPathVoxel(const XYZPoint16 &start, uint32 max_distance, const std::function<bool(const XYZPoint16 &)> &accept, XYZPoint16 *found);
+
 #endif
 
@@ -21,6 +21,7 @@
 #include "gamelevel.h"
 #include "gameobserver.h"
 #include "finances.h"
+#include "scenery.h"
 #include <limits>
 
 Guests _guests; ///< %Guests in the world/park.
@@ -206,6 +207,16 @@ uint32 Guests::CountGuestsInPark() const
 	return count;
 }
 
+/**
+ * Collect the voxel positions of all active guests.
+ * @param positions [out] Receives the positions, one entry per guest.
+ */
+void Guests::GetVoxelPositions(std::vector<XYZPoint16> *positions) const
+{
+	positions->clear();
+	FOR_EACH_ACTIVE_GUEST(block, g) positions->push_back(g->vox_pos);
+}
+
 /**
  * Some time has passed, update the animation.
  * @param delay Number of milliseconds time that have past since the last animation update.
@@ -253,6 +264,16 @@ void Guests::OnNewDay()
 	}
 
 	/* New guest! */
+	this->AddGuest(this->start_voxel);
+}
+
+/**
+ * Add a new guest to the world.
+ * @param start X/Y position of the voxel stack where the guest appears.
+ * @return The new guest.
+ */
+Guest *Guests::AddGuest(const Point16 &start)
+{
 	Guest *g;
 	if (this->free_guest_indices.empty()) {
 		/* All guest slots filled to capacity, preallocate more memory. */
@@ -262,7 +283,8 @@ void Guests::OnNewDay()
 		g = this->GetCreate(this->free_guest_indices.back());
 		this->free_guest_indices.pop_back();
 	}
-	g->Activate(this->start_voxel, PERSON_GUEST);
+	g->Activate(start, PERSON_GUEST);
+	return g;
 }
 
 /**
@@ -358,6 +380,8 @@ void Staff::Uninitialize()
 	this->guards.clear();
 	this->entertainers.clear();
 	this->mechanic_requests.clear();
+	this->mechanic_distances.clear();
+	this->cleaning_tasks.clear();
 	this->last_person_id = STAFF_BASE_ID;
 }
 
@@ -573,6 +597,19 @@ uint16 Staff::Count(const PersonType t) const
 	}
 }
 
+/**
+ * Collect the voxel positions of all staff members.
+ * @param positions [out] Receives the positions, one entry per staff member.
+ */
+void Staff::GetVoxelPositions(std::vector<XYZPoint16> *positions) const
+{
+	positions->clear();
+	for (const auto &m : this->mechanics)    positions->push_back(m->vox_pos);
+	for (const auto &m : this->handymen)     positions->push_back(m->vox_pos);
+	for (const auto &m : this->guards)       positions->push_back(m->vox_pos);
+	for (const auto &m : this->entertainers) positions->push_back(m->vox_pos);
+}
+
 /**
  * Get a staff member of given type.
  * @param t Type of staff.
@@ -642,6 +679,7 @@ void Staff::Dismiss(const StaffMember *person)
  */
 void Staff::NotifyRideDeletion(const RideInstance *ri) {
 	for (auto &m : this->mechanics) m->NotifyRideDeletion(ri);
+	this->mechanic_distances.erase(ri);
 }
 
 /**
@@ -656,29 +694,115 @@ void Staff::OnAnimate(const int delay)
 	for (auto &m : this->entertainers) m->OnAnimate(delay);
 }
 
+static const uint32 CLEANING_SEARCH_DISTANCE = 16;  ///< Maximal walking distance of a handyman to a dirty path to clean.
+
+/**
+ * Find the nearest dirty path that no handyman takes care of yet, and claim it.
+ * @param handyman Handyman looking for work.
+ * @param pos [out] The claimed dirty path, if any.
+ * @return Whether a dirty path was claimed.
+ */
+bool Staff::FindCleaningTask(const Handyman *handyman, XYZPoint16 *pos)
+{
+	if (!_scenery.HasLitterAndVomitNearby(handyman->vox_pos, CLEANING_SEARCH_DISTANCE)) return false;
+
+	auto is_unclaimed_dirty_path = [this](const XYZPoint16 &p) {
+		return this->cleaning_tasks.count(p) == 0 && _scenery.CountLitterAndVomit(p) > 0;
+	};
+	if (!FindNearestPathVoxel(handyman->vox_pos, CLEANING_SEARCH_DISTANCE, is_unclaimed_dirty_path, pos)) return false;
+	return this->ClaimCleaningTask(handyman, *pos);
+}
+
+/**
+ * Claim a dirty path for sweeping.
+ * @param handyman Handyman who wants to sweep the path.
+ * @param pos Coordinate of the path.
+ * @return Whether the path is claimed by \a handyman (possibly already before).
+ */
+bool Staff::ClaimCleaningTask(const Handyman *handyman, const XYZPoint16 &pos)
+{
+	const auto it = this->cleaning_tasks.find(pos);
+	if (it != this->cleaning_tasks.end()) return it->second.handyman == handyman;
+
+	this->cleaning_tasks[pos].handyman = handyman;
+	return true;
+}
+
+/**
+ * Give up a claim on a dirty path.
+ * @param handyman Handyman who claimed the path.
+ * @param pos Coordinate of the path.
+ */
+void Staff::ReleaseCleaningTask(const Handyman *handyman, const XYZPoint16 &pos)
+{
+	const auto it = this->cleaning_tasks.find(pos);
+	if (it != this->cleaning_tasks.end() && it->second.handyman == handyman) this->cleaning_tasks.erase(it);
+}
+
+/**
+ * Find the direction to walk to a claimed dirty path. The walking distances are kept until the path network changes.
+ * @param task Coordinate of the claimed path.
+ * @param pos Current position of the handyman.
+ * @return Edge of \a pos to leave through, or #INVALID_EDGE if the path cannot be reached from \a pos.
+ */
+TileEdge Staff::GetCleaningTaskDirection(const XYZPoint16 &task, const XYZPoint16 &pos)
+{
+	const auto it = this->cleaning_tasks.find(task);
+	if (it == this->cleaning_tasks.end()) return INVALID_EDGE;
+
+	CleaningTask &ct = it->second;
+	if (!ct.has_distances || ct.distances_version != _world.GetPathNetworkVersion()) {
+		ct.distances.Compute({task});
+		ct.distances_version = _world.GetPathNetworkVersion();
+		ct.has_distances = true;
+	}
+	return ct.distances.GetDirectionToStart(pos);
+}
+
+/**
+ * Get the walking distances from the path network to the mechanic entrance of a ride.
+ * The distances are kept until the path network or the entrance changes.
+ * @param ride Ride that needs a mechanic.
+ * @return Walking distances to the mechanic entrance of the ride.
+ */
+const PathDistanceField &Staff::GetMechanicDistances(const RideInstance *ride)
+{
+	if (this->mechanic_distances_version != _world.GetPathNetworkVersion()) {
+		this->mechanic_distances.clear();
+		this->mechanic_distances_version = _world.GetPathNetworkVersion();
+	}
+
+	EdgeCoordinate destination = ride->GetMechanicEntrance();
+	destination.coords.x += _tile_dxy[destination.edge].x;
+	destination.coords.y += _tile_dxy[destination.edge].y;
+
+	const XYZPoint16 entrance(destination.coords);
+
+	auto it = this->mechanic_distances.find(ride);
+	if (it != this->mechanic_distances.end() && it->second.entrance == entrance) return it->second.distances;
+
+	MechanicDistances &md = this->mechanic_distances[ride];
+	md.entrance = entrance;
+	XYZPoint16 below(entrance);
+	below.z--;  // In case the path leading to the mechanic entrance is sloping upwards.
+	md.distances.Compute({entrance, below});
+	return md.distances;
+}
+
 /** A new frame arrived. */
 void Staff::DoTick()
 {
 	/* Assign one mechanic request to the nearest available mechanic, if any. */
 	if (!this->mechanic_requests.empty() && !this->mechanics.empty()) {
-		EdgeCoordinate destination = this->mechanic_requests.front()->GetMechanicEntrance();
-		destination.coords.x += _tile_dxy[destination.edge].x;
-		destination.coords.y += _tile_dxy[destination.edge].y;
+		const PathDistanceField &distances = this->GetMechanicDistances(this->mechanic_requests.front());
 
 		Mechanic *best = nullptr;
 		uint32 distance = 0;
 		for (auto &m : this->mechanics) {
 			if (m->ride != nullptr) continue;
 
-			PathSearcher ps(m->vox_pos);
-			XYZPoint16 p(destination.coords);
-			ps.AddStart(p);
-			p.z--;
-			ps.AddStart(p);  // In case the path leading to the mechanic entrance is sloping upwards.
-
-			if (!ps.Search()) continue;  // No path exists.
-			uint32 d = 0;
-			for (const WalkedPosition *it = ps.dest_pos; it->prev_pos != nullptr; it = it->prev_pos) d++;
+			uint32 d = distances.GetDistance(m->vox_pos);
+			if (d == PathDistanceField::UNREACHABLE) continue;  // No path exists.
 
 			if (best == nullptr || d < distance) {
 				best = m.get();
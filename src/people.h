@@ -14,6 +14,7 @@
 #include <map>
 
 #include "person.h"
+#include "path_finding.h"
 
 /**
  * All our guests.
@@ -30,11 +31,13 @@ public:
 
 	uint32 CountActiveGuests() const;
 	uint32 CountGuestsInPark() const;
+	void GetVoxelPositions(std::vector<XYZPoint16> *positions) const;
 
 	Guest *GetExisting(int idx);
 	const Guest *GetExisting(int idx) const;
 
 	Guest *GetCreate(int idx);
+	Guest *AddGuest(const Point16 &start);
 	void NotifyGuestDeactivation(int idx);
 
 	void OnAnimate(int delay);
@@ -84,6 +87,11 @@ public:
 	void RequestMechanic(RideInstance *ride);
 	void NotifyRideDeletion(const RideInstance *);
 
+	bool FindCleaningTask(const Handyman *handyman, XYZPoint16 *pos);
+	bool ClaimCleaningTask(const Handyman *handyman, const XYZPoint16 &pos);
+	void ReleaseCleaningTask(const Handyman *handyman, const XYZPoint16 &pos);
+	TileEdge GetCleaningTaskDirection(const XYZPoint16 &task, const XYZPoint16 &pos);
+
 	Mechanic    *HireMechanic();
 	Handyman    *HireHandyman();
 	Guard       *HireGuard();
@@ -93,6 +101,7 @@ public:
 	uint16 CountGuards()       const;
 	uint16 CountEntertainers() const;
 	uint16 Count(PersonType t) const;
+	void GetVoxelPositions(std::vector<XYZPoint16> *positions) const;
 
 	StaffMember *Get(PersonType t, uint list_index) const;
 	void Dismiss(const StaffMember* m);
@@ -106,10 +115,28 @@ public:
 	void Save(Saver &svr);
 
 private:
+	/** Walking distances to the mechanic entrance of a ride. */
+	struct MechanicDistances {
+		XYZPoint16 entrance;          ///< Path voxel in front of the mechanic entrance.
+		PathDistanceField distances;  ///< Walking distances to #entrance.
+	};
+
+	/** A dirty path claimed by a handyman for sweeping. */
+	struct CleaningTask {
+		const Handyman *handyman = nullptr;  ///< Handyman who claimed the path.
+		bool has_distances = false;          ///< Whether #distances have been computed.
+		uint32 distances_version = 0;        ///< Path network version of the #distances.
+		PathDistanceField distances;         ///< Walking distances to the path.
+	};
+
 	uint16 GenerateID();
+	const PathDistanceField &GetMechanicDistances(const RideInstance *ride);
 
 	uint16 last_person_id;                                 ///< ID of the last staff member hired.
 	std::list<RideInstance*> mechanic_requests;            ///< Rides in need of a mechanic.
+	std::map<const RideInstance*, MechanicDistances> mechanic_distances;  ///< Cached walking distances to rides that needed a mechanic.
+	uint32 mechanic_distances_version = 0;                 ///< Path network version of the #mechanic_distances.
+	std::map<XYZPoint16, CleaningTask> cleaning_tasks;     ///< Dirty paths claimed by handymen, shared by all handymen.
 	std::list<std::unique_ptr<Mechanic>>    mechanics;     ///< All mechanics    in the park.
 	std::list<std::unique_ptr<Handyman>>    handymen;      ///< All handymen     in the park.
 	std::list<std::unique_ptr<Guard>>       guards;        ///< All guards       in the park.
@@ -29,9 +29,6 @@
 
 static PersonTypeData _person_type_datas[PERSON_TYPE_COUNT]; ///< Data about each type of person.
 
-static const int QUEUE_DISTANCE = 64;  // The pixel distance between two guests queuing for a ride.
-assert_compile(256 % QUEUE_DISTANCE == 0);
-
 const std::map<PersonType, Money> StaffMember::SALARY = {
 	{PERSON_MECHANIC,    Money(270)},  ///< Daily salary of a mechanic.
 	{PERSON_HANDYMAN,    Money(150)},  ///< Daily salary of a handyman.
@@ -103,7 +100,7 @@ void LoadPRSG(RcdFileReader *rcd_file)
 	}
 }
 
-Person::Person() : rnd(), type(PERSON_INVALID), offset(this->rnd.Uniform(100)), ride(nullptr), status(GUI_PERSON_STATUS_WANDER)
+Person::Person() : VoxelObject(VOK_PERSON), rnd(), type(PERSON_INVALID), offset(0), ride(nullptr), status(GUI_PERSON_STATUS_WANDER)
 {
 }
 
@@ -394,6 +391,7 @@ void Person::Activate(const Point16 &start, PersonType person_type)
 
 	this->type = person_type;
 	this->name.clear();
+	this->offset = this->rnd.Uniform(100);  // Not when allocating the person, loading a game allocates persons as well.
 	this->SetStatus(GUI_PERSON_STATUS_WANDER);
 
 	/* Set up the person sprite recolouring table. */
@@ -1445,8 +1443,8 @@ const Person *Person::GetQueuingGuestNearby(const XYZPoint16& vox_pos, const XYZ
 
 			for (VoxelObject *v = voxel->voxel_objects; v != nullptr; v = v->next_object) {
 				if (v == this) continue;
-				Guest *g = dynamic_cast<Guest*>(v);
-				if (g == nullptr || !g->IsQueuingGuest()) continue;
+				Guest *g = GetPersonOfType<Guest>(v, PERSON_GUEST);
+				if (g == nullptr || g->activity != GA_QUEUING) continue;
 
 				const XYZPoint32 coords = g->MergeCoordinates();
 				if (hypot(coords.x - merged_pos.x, coords.y - merged_pos.y) < QUEUE_DISTANCE) {
@@ -2009,7 +2007,7 @@ AnimateResult Guest::InteractWithPathObject(PathObjectInstance *obj)
 					const Voxel *vx = _world.GetVoxel(XYZPoint16(this->vox_pos.x + dx, this->vox_pos.y + dy, this->vox_pos.z + dz));
 					if (vx == nullptr) continue;
 					for (VoxelObject *o = vx->voxel_objects; o != nullptr; o = o->next_object) {
-						if (dynamic_cast<Guard*>(o) != nullptr) {
+						if (GetPersonOfType<Guard>(o, PERSON_GUARD) != nullptr) {
 							/* A security guard is nearby, so no vandalism just yet. */
 							return OAR_CONTINUE;
 						}
@@ -2648,6 +2646,37 @@ Handyman::Handyman() : activity(HandymanActivity::WANDER)
 {
 }
 
+Handyman::~Handyman()
+{
+	this->DropCleaningTask();
+}
+
+/** Give up the claim on the dirty path this handyman was going to sweep, if any. */
+void Handyman::DropCleaningTask()
+{
+	if (!this->cleaning_task.has_value()) return;
+	_staff.ReleaseCleaningTask(this, *this->cleaning_task);
+	this->cleaning_task.reset();
+}
+
+/**
+ * Decide in which direction to walk to the nearest dirty path, claiming one if needed.
+ * @return Edge of the current voxel to leave through, or #INVALID_EDGE if there is no dirty path to walk to.
+ */
+TileEdge Handyman::GetCleaningTaskDirection()
+{
+	if (this->cleaning_task.has_value() && _scenery.CountLitterAndVomit(*this->cleaning_task) == 0) this->DropCleaningTask();
+	if (!this->cleaning_task.has_value()) {
+		XYZPoint16 pos;
+		if (!_staff.FindCleaningTask(this, &pos)) return INVALID_EDGE;
+		this->cleaning_task = pos;
+	}
+
+	const TileEdge edge = _staff.GetCleaningTaskDirection(*this->cleaning_task, this->vox_pos);
+	if (edge == INVALID_EDGE) this->DropCleaningTask();  // The path cannot be reached (anymore).
+	return edge;
+}
+
 void Handyman::Load(Loader &ldr)
 {
 	const uint32 version = ldr.OpenPattern("hndy");
@@ -2689,26 +2718,19 @@ void Handyman::DecideMoveDirection()
 
 	const Voxel *vx = _world.GetVoxel(this->vox_pos);
 	const bool is_on_path = HasValidPath(vx);
-	if (is_on_path && _scenery.CountLitterAndVomit(this->vox_pos) > 0) {
-		bool found_other_handyman = false;
-		for (VoxelObject *o = vx->voxel_objects; o != nullptr; o = o->next_object) {
-			if (Handyman *h = dynamic_cast<Handyman*>(o)) {
-				if (h->activity == HandymanActivity::SWEEP) {
-					found_other_handyman = true;
-					break;
-				}
-			}
-		}
-		if (!found_other_handyman) {
-			this->SetStatus(GUI_PERSON_STATUS_SWEEPING);
-			this->activity = HandymanActivity::SWEEP;
-			this->StartAnimation(_handyman_sweep[(start_edge + 2) % 4]);
-			return;
+	if (is_on_path && _scenery.CountLitterAndVomit(this->vox_pos) > 0 && _staff.ClaimCleaningTask(this, this->vox_pos)) {
+		if (this->cleaning_task != this->vox_pos) {
+			this->DropCleaningTask();
+			this->cleaning_task = this->vox_pos;
 		}
+		this->SetStatus(GUI_PERSON_STATUS_SWEEPING);
+		this->activity = HandymanActivity::SWEEP;
+		this->StartAnimation(_handyman_sweep[(start_edge + 2) % 4]);
+		return;
 	}
 
 	/* Consider emptying a bin if an overflowing one is nearby. */
-	std::set<TileEdge> possible_edges;
+	TileEdge possible_edges[EDGE_COUNT];
 	uint8 nr_possible_edges = 0;
 	const PathObjectInstance *obj = _scenery.GetPathObject(this->vox_pos);
 	if (obj != nullptr) {
@@ -2717,25 +2739,21 @@ void Handyman::DecideMoveDirection()
 				if (obj->GetExistsOnTileEdge(e) && !obj->GetDemolishedOnTileEdge(e) && obj->BinNeedsEmptying(e)) {
 					bool found_other_handyman = false;
 					for (VoxelObject *o = vx->voxel_objects; o != nullptr; o = o->next_object) {
-						if (Handyman *h = dynamic_cast<Handyman*>(o)) {
+						if (Handyman *h = GetPersonOfType<Handyman>(o, PERSON_HANDYMAN)) {
 							if (h->activity == static_cast<Handyman::HandymanActivity>(static_cast<int>(HandymanActivity::EMPTY_NE) + e)) {
 								found_other_handyman = true;
 								break;
 							}
 						}
 					}
-					if (!found_other_handyman) {
-						possible_edges.insert(e);
-						nr_possible_edges++;
-					}
+					if (!found_other_handyman) possible_edges[nr_possible_edges++] = e;
 				}
 			}
 		}
 	}
 	if (nr_possible_edges > 0) {
-		auto it = possible_edges.begin();
-		if (nr_possible_edges > 1) std::advance(it, rnd.Uniform(nr_possible_edges - 1));
-		this->StartAnimation(_center_path_tile[start_edge][*it]);
+		const uint8 index = (nr_possible_edges > 1) ? rnd.Uniform(nr_possible_edges - 1) : 0;
+		this->StartAnimation(_center_path_tile[start_edge][possible_edges[index]]);
 		return;
 	}
 
@@ -2759,29 +2777,35 @@ void Handyman::DecideMoveDirection()
 		if (item->ShouldBeWatered()) {
 			bool found_other_handyman = false;
 			for (VoxelObject *o = voxel->voxel_objects; o != nullptr; o = o->next_object) {
-				if (Handyman *h = dynamic_cast<Handyman*>(o)) {
+				if (Handyman *h = GetPersonOfType<Handyman>(o, PERSON_HANDYMAN)) {
 					if (h->activity == HandymanActivity::WATER) {
 						found_other_handyman = true;
 						break;
 					}
 				}
 			}
-			if (!found_other_handyman) {
-				possible_edges.insert(edge);
-				nr_possible_edges++;
-			}
+			if (!found_other_handyman) possible_edges[nr_possible_edges++] = edge;
 		}
 	}
 	if (nr_possible_edges > 0) {
-		auto it = possible_edges.begin();
-		if (nr_possible_edges > 1) std::advance(it, rnd.Uniform(nr_possible_edges - 1));
+		const uint8 index = (nr_possible_edges > 1) ? rnd.Uniform(nr_possible_edges - 1) : 0;
 
 		this->activity = HandymanActivity::HEADING_TO_WATERING;
 		this->SetStatus(GUI_PERSON_STATUS_WATERING);
-		this->StartAnimation(_center_path_tile[start_edge][*it]);
+		this->StartAnimation(_center_path_tile[start_edge][possible_edges[index]]);
 		return;
 	}
 
+	/* Walk to the nearest dirty path that no other handyman takes care of. */
+	if (is_on_path) {
+		const TileEdge edge = this->GetCleaningTaskDirection();
+		if (edge != INVALID_EDGE) {
+			this->SetStatus(GUI_PERSON_STATUS_WANDER);
+			this->StartAnimation(_walk_path_tile[start_edge][edge]);
+			return;
+		}
+	}
+
 	return StaffMember::DecideMoveDirection();
 }
 
@@ -2808,6 +2832,7 @@ AnimateResult Handyman::ActionAnimationCallback()
 
 		case HandymanActivity::SWEEP:
 			_scenery.RemoveLitterAndVomit(this->vox_pos);
+			this->DropCleaningTask();
 			break;
 
 		case HandymanActivity::EMPTY_NE:
@@ -15,6 +15,8 @@
 #include "money.h"
 #include "ride_type.h"
 
+#include <optional>
+
 class PathObjectInstance;
 struct WalkInformation;
 class RideInstance;
@@ -366,6 +368,7 @@ public:
 	};
 
 	Handyman();
+	~Handyman();
 
 	void Load(Loader &ldr);
 	void Save(Saver &svr);
@@ -380,6 +383,36 @@ public:
 	}
 
 	HandymanActivity activity;  ///< What the handyman is doing right now.
+
+private:
+	TileEdge GetCleaningTaskDirection();
+	void DropCleaningTask();
+
+	std::optional<XYZPoint16> cleaning_task;  ///< Dirty path claimed by this handyman for sweeping, if any.
 };
 
+/**
+ * Get the person of a voxel object.
+ * @param vo Voxel object.
+ * @return The person, or \c nullptr if the object is not a person.
+ */
+inline const Person *GetPerson(const VoxelObject *vo)
+{
+	return (vo->kind == VOK_PERSON) ? static_cast<const Person *>(vo) : nullptr;
+}
+
+/**
+ * Get the person of a voxel object, if it is of the given type.
+ * @tparam P Class of the persons of type \a person_type.
+ * @param vo Voxel object.
+ * @param person_type Type of the wanted person.
+ * @return The person, or \c nullptr if the object is not a person of type \a person_type.
+ */
+template <typename P>
+inline P *GetPersonOfType(VoxelObject *vo, PersonType person_type)
+{
+	if (vo->kind != VOK_PERSON || static_cast<Person *>(vo)->type != person_type) return nullptr;
+	return static_cast<P *>(vo);
+}
+
 #endif
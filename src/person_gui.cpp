@@ -15,6 +15,7 @@
 #include "ride_type.h"
 #include "person.h"
 #include "people.h"
+#include "replay.h"
 
 /** Widgets of the guest info window. */
 enum GuestInfoWidgets {
@@ -85,6 +86,7 @@ private:
  */
 GuestInfoWindow::GuestInfoWindow(const Guest *guest) : GuiWindow(WC_PERSON_INFO, guest->id)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The guest walks around and changes its mind all the time.
 	this->guest = guest;
 	this->SetupWidgetTree(_guest_info_gui_parts, lengthof(_guest_info_gui_parts));
 }
@@ -177,6 +179,7 @@ private:
  */
 StaffInfoWindow::StaffInfoWindow(const StaffMember *person) : GuiWindow(WC_PERSON_INFO, person->id)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The staff member walks around and changes its work all the time.
 	this->person = person;
 	this->SetupWidgetTree(_staff_info_gui_parts, lengthof(_guest_info_gui_parts));
 }
@@ -203,7 +206,10 @@ void StaffInfoWindow::SetWidgetStringParameters(WidgetNumber wid_num) const
 
 void StaffInfoWindow::OnClick(WidgetNumber number, [[maybe_unused]] const Point16 &pos)
 {
-	if (number == SIW_DISMISS) _staff.Dismiss(this->person);  // This also deletes this window.
+	if (number == SIW_DISMISS) {
+		RecordStaffDismissal(this->person);
+		_staff.Dismiss(this->person);  // This also deletes this window.
+	}
 }
 
 void StaffInfoWindow::OnChange(ChangeCode code, [[maybe_unused]] uint32 parameter)
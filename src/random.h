@@ -19,6 +19,25 @@ public:
 	uint16 Exponential(uint16 mean);
 
 	static void Initialize();
+
+	/**
+	 * Get the current state of the generators.
+	 * @return The seed.
+	 */
+	static uint32 GetSeed()
+	{
+		return seed;
+	}
+
+	/**
+	 * Restart the generators from a known state.
+	 * @param new_seed The new seed.
+	 */
+	static void SetSeed(uint32 new_seed)
+	{
+		seed = new_seed;
+	}
+
 	static void Load(Loader &ldr);
 	static void Save(Saver &svr);
 
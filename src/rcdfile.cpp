@@ -12,6 +12,7 @@
 #include "fileio.h"
 #include "string_func.h"
 #include "rev.h"
+#include <algorithm>
 #include <memory>
 
 RcdFileCollection _rcd_collection; ///< Available RCD files.
@@ -147,10 +148,13 @@ const char *RcdFileCollection::ScanFileForMetaInfo(const std::string &fname)
 	RcdFileReader rcd_file(fname);
 	if (!rcd_file.CheckFileHeader("RCDF", 2)) return "Wrong header";
 
-	/* Load block. */
+	/* The INFO block is normally the first block. Otherwise, look it up in the table of contents. */
 	if (!rcd_file.ReadBlockHeader() || (strcmp(rcd_file.name, "INFO") != 0)) {
-		/* End reached or found a non-meta block, end scanning. */
-		return "No INFO block found.";
+		std::vector<RcdBlockEntry> toc;
+		if (!rcd_file.ReadTableOfContents(&toc)) return "No INFO block found.";
+
+		auto info = std::find_if(toc.begin(), toc.end(), [](const RcdBlockEntry &entry) { return strcmp(entry.name, "INFO") == 0; });
+		if (info == toc.end() || !rcd_file.SeekBlock(*info)) return "No INFO block found.";
 	}
 
 	/* Load INFO block. */
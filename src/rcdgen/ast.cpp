@@ -543,6 +543,7 @@ std::shared_ptr<NamedValueList> LoadFile(const char *filename, int line)
 			fprintf(stderr, "Error: Could not open file \"%s\"\n", filename);
 			exit(1);
 		}
+		AddDependency(filename);
 	}
 	_parsed_data = nullptr;
 	SetupScanner(filename, infile);
@@ -97,6 +97,7 @@ static void ReadFile(const Position &pos, const char *filepath, uint32 *out_leng
 		fprintf(stderr, "Error at %s: Could not open input file.\n", pos.ToString());
 		exit(1);
 	}
+	AddDependency(filepath);
 
 	fseek(in_file, 0L, SEEK_END);
 	*out_length = ftell(in_file);
@@ -1653,13 +1654,13 @@ static std::shared_ptr<SpriteBlock> ConvertSpriteNode(std::shared_ptr<NodeGroup>
 
 		BitMaskData *bmd = (bm == nullptr) ? nullptr : &bm->data;
 		if (imf->Is8bpp()) {
-			Image8bpp img(imf.get(), bmd);
+			std::shared_ptr<Image8bpp> img = std::make_shared<Image8bpp>(imf, bmd);
 			if (!recolour.empty()) fprintf(stderr, "Error at %s, cannot recolour an 8bpp image, ignoring the file.\n", ng->pos.ToString());
-			err = sb->sprite_image.CopySprite(&img, xoffset, yoffset, xbase, ybase, width, height, crop);
+			err = sb->sprite_image.CopySprite(img, xoffset, yoffset, xbase, ybase, width, height, crop);
 		} else {
-			Image32bpp img(imf.get(), bmd);
+			std::shared_ptr<Image32bpp> img = std::make_shared<Image32bpp>(imf, bmd);
 			if (recolour.empty()) {
-				err = sb->sprite_image.CopySprite(&img, xoffset, yoffset, xbase, ybase, width, height, crop);
+				err = sb->sprite_image.CopySprite(img, xoffset, yoffset, xbase, ybase, width, height, crop);
 			} else {
 				std::shared_ptr<const ImageFile> rmf;
 				err = ImageFile::LoadFile(recolour, rmf);
@@ -1671,9 +1672,8 @@ static std::shared_ptr<SpriteBlock> ConvertSpriteNode(std::shared_ptr<NodeGroup>
 					fprintf(stderr, "Error at %s, recolour file must be an 8bpp image.\n", ng->pos.ToString());
 					exit(1);
 				}
-				Image8bpp rim(rmf.get(), nullptr);
-				img.SetRecolourImage(&rim);
-				err = sb->sprite_image.CopySprite(&img, xoffset, yoffset, xbase, ybase, width, height, crop);
+				img->SetRecolourImage(std::make_shared<Image8bpp>(rmf, nullptr));
+				err = sb->sprite_image.CopySprite(img, xoffset, yoffset, xbase, ybase, width, height, crop);
 			}
 		}
 		if (err != nullptr) {
@@ -2037,7 +2037,7 @@ static std::shared_ptr<TIMABlock> ConvertTIMANode(std::shared_ptr<NodeGroup> ng)
 		const int sprite_h = sheet->height;
 		const int x_offset = sheet->x_offset;
 		const int y_offset = sheet->y_offset;
-		Image *image = sheet->GetSheet();
+		std::shared_ptr<const Image> image = sheet->GetSheet();
 
 		for (int f = 0; f < block->frames; ++f) {
 			std::shared_ptr<FSETBlock> fset(new FSETBlock);
@@ -9,6 +9,7 @@
 
 #include "../stdafx.h"
 #include "file_writing.h"
+#include "utils.h"
 
 FileBlock::FileBlock() : data(nullptr), length(0)
 {
@@ -144,6 +145,16 @@ void FileBlock::Write(FILE *fp)
 	}
 }
 
+/**
+ * Compute a hash of the contents of the file block.
+ * Identical blocks have the same hash, different blocks almost never do.
+ * @return Hash value of the block.
+ */
+uint64 FileBlock::Hash() const
+{
+	return HashBytes(this->data, this->length);
+}
+
 /**
  * Check whether two file blocks are identical.
  * @param fb1 First block to compare.
@@ -157,6 +168,14 @@ bool operator==(const FileBlock &fb1, const FileBlock &fb2)
 	return memcmp(fb1.data, fb2.data, fb1.length) == 0;
 }
 
+/**
+ * Constructor of the RCD output file.
+ * @param dedup_by_length Find duplicate blocks among all earlier blocks with the same length, instead of with the same hash.
+ */
+FileWriter::FileWriter(bool dedup_by_length) : dedup_by_length(dedup_by_length)
+{
+}
+
 /**
  * Add a block to the file.
  * @param blk Block to add.
@@ -165,7 +184,7 @@ bool operator==(const FileBlock &fb1, const FileBlock &fb2)
  */
 int FileWriter::AddBlock(FileBlock *blk)
 {
-	auto &group = this->blocks_by_length[blk->length];
+	auto &group = this->blocks_by_hash[this->dedup_by_length ? blk->length : blk->Hash()];
 	for (auto &iter : group) {
 		/* Block already added, just return the old block number. */
 		if (*iter.second == *blk) {
@@ -200,5 +219,21 @@ void FileWriter::WriteFile(std::string fname)
 
 	for (auto &iter : this->blocks) iter->Write(fp);
 
+	/* Add a table of contents, so readers can find the blocks without walking through the file.
+	 * It is the last block, to keep the block numbers intact, and ends with its own length to find it from the end of the file. */
+	FileBlock toc;
+	toc.StartSave("RTOC", 1, 4 + 16 * this->blocks.size() + 4);
+	toc.SaveUInt32(this->blocks.size());
+	uint32 offset = 8;
+	for (auto &iter : this->blocks) {
+		toc.SaveBytes(iter->data, 8); // Name and version of the block.
+		toc.SaveUInt32(offset);
+		toc.SaveUInt32(iter->length - 12);
+		offset += iter->length;
+	}
+	toc.SaveUInt32(toc.length);
+	toc.CheckEndSave();
+	toc.Write(fp);
+
 	fclose(fp);
 }
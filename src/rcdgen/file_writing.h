@@ -10,8 +10,8 @@
 #ifndef FILE_WRITING_H
 #define FILE_WRITING_H
 
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 /** A block in an RCD file. See #StartSave for details on usage. */
@@ -32,6 +32,7 @@ public:
 	void CheckEndSave();
 
 	void Write(FILE *fp);
+	uint64 Hash() const;
 
 	uint8 *data;    ///< Data of the block.
 	int length;     ///< Length of the block.
@@ -46,7 +47,7 @@ using FileBlockPtrList = std::vector<std::unique_ptr<FileBlock>>;
 /** RCD output file. */
 class FileWriter {
 public:
-	FileWriter() = default;
+	explicit FileWriter(bool dedup_by_length = false);
 	~FileWriter() = default;
 
 	int AddBlock(FileBlock *fb);
@@ -55,7 +56,8 @@ public:
 
 private:
 	FileBlockPtrList blocks; ///< Blocks stored in the file so far.
-	std::map<size_t, std::vector<std::pair<int, FileBlock*>>> blocks_by_length;  ///< All blocks with their index grouped by their length for faster searching.
+	bool dedup_by_length;    ///< Group the blocks by their length instead of by their hash, to test the hash.
+	std::unordered_map<uint64, std::vector<std::pair<int, FileBlock*>>> blocks_by_hash;  ///< All blocks with their index grouped by their #FileBlock::Hash (or their length) for faster searching.
 };
 
 #endif
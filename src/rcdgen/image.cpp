@@ -8,9 +8,15 @@
 /** @file image.cpp %Image loading, cutting, and saving the sprites. */
 
 #include "../stdafx.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <map>
+#include <thread>
 #include <vector>
 #include "image.h"
+#include "sprite_cache.h"
+#include "utils.h"
 
 #include "mask64.xbm"
 
@@ -49,7 +55,7 @@ static const MaskInformation *GetMask(const std::string &name)
 	exit(1);
 }
 
-ImageFile::ImageFile() : png_initialized(false), row_pointers(nullptr)
+ImageFile::ImageFile() : png_initialized(false), row_pointers(nullptr), width(-1), height(-1), pixels_error(nullptr), content_hashed(false)
 {
 }
 
@@ -63,6 +69,14 @@ void ImageFile::Clear()
 {
 	if (!this->png_initialized) return;
 
+	if (this->pixels != nullptr) {
+		this->pixels.reset();
+		this->rows.reset();
+		this->row_pointers = nullptr;
+		this->png_initialized = false;
+		return;
+	}
+
 	png_destroy_read_struct(&this->png_ptr, &this->info_ptr, &this->end_info);
 	this->row_pointers = nullptr;
 	this->png_initialized = false;
@@ -70,7 +84,7 @@ void ImageFile::Clear()
 }
 
 /**
- * Load a .png file from the disk.
+ * Load a .png file from the disk. Only the header is read, the pixels are decoded by ImageFile::LoadPixels.
  * @param fname Name of the .png file to load.
  * @param result [out] Will become a pointer to the loaded image on success.
  * @return An error message if loading failed, or \c nullptr if loading succeeded.
@@ -85,8 +99,9 @@ const char *ImageFile::LoadFile(const std::string &fname, std::shared_ptr<const
 	}
 
 	std::shared_ptr<ImageFile> file(new ImageFile);
-	const char *err = file->LoadFile(fname);
+	const char *err = file->ReadHeader(fname);
 	if (err != nullptr) return err;
+	AddDependency(fname);
 
 	result = file;
 	cache.emplace(fname, file);
@@ -94,45 +109,163 @@ const char *ImageFile::LoadFile(const std::string &fname, std::shared_ptr<const
 }
 
 /**
- * Load a .png file from the disk.
- * @param fname Name of the .png file to load.
- * @return An error message if loading failed, or \c nullptr if loading succeeded.
+ * Create an image in memory, with all pixels fully transparent.
+ * @param width Width of the new image.
+ * @param height Height of the new image.
+ * @param is_8bpp Whether to create an 8bpp paletted image rather than an RGBA image.
+ * @return The created image, its pixels can be changed through its #row_pointers.
  */
-const char *ImageFile::LoadFile(const std::string &fname)
+std::shared_ptr<ImageFile> ImageFile::CreateEmpty(int width, int height, bool is_8bpp)
 {
-	FILE *fp = fopen(fname.c_str(), "rb");
-	if (fp == nullptr) return "Input file does not exist";
+	assert(width > 0 && height > 0);
+
+	std::shared_ptr<ImageFile> file(new ImageFile);
+	const int row_size = width * (is_8bpp ? 1 : 4);
+	file->pixels.reset(new uint8[row_size * height]());
+	file->rows.reset(new uint8 *[height]);
+	for (int y = 0; y < height; y++) file->rows[y] = file->pixels.get() + y * row_size;
+
+	file->row_pointers = file->rows.get();
+	file->width = width;
+	file->height = height;
+	file->color_type = is_8bpp ? PNG_COLOR_TYPE_PALETTE : PNG_COLOR_TYPE_RGB_ALPHA;
+	file->png_initialized = true;
+	std::call_once(file->pixels_loaded, [](){}); // There is nothing to decode.
+	return file;
+}
+
+/**
+ * Open a .png file, and prepare the png data structures for reading it.
+ * @param fname Name of the .png file to open.
+ * @param fp [out] Opened file.
+ * @param png_ptr [out] Png image data.
+ * @param info_ptr [out] Png information.
+ * @param end_info [out] Png end information.
+ * @return An error message if opening failed, or \c nullptr if the file is ready for reading.
+ */
+static const char *OpenPngFile(const std::string &fname, FILE **fp, png_structp *png_ptr, png_infop *info_ptr, png_infop *end_info)
+{
+	*fp = fopen(fname.c_str(), "rb");
+	if (*fp == nullptr) return "Input file does not exist";
 
 	uint8 header[HEADER_SIZE];
-	if (fread(header, 1, HEADER_SIZE, fp) != HEADER_SIZE) {
-		fclose(fp);
+	if (fread(header, 1, HEADER_SIZE, *fp) != HEADER_SIZE) {
+		fclose(*fp);
 		return "Failed to read the PNG header";
 	}
 	bool is_png = !png_sig_cmp(header, 0, HEADER_SIZE);
 	if (!is_png) {
-		fclose(fp);
+		fclose(*fp);
 		return "Header indicates it is not a PNG file";
 	}
 
-	this->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-	if (!this->png_ptr) {
-		fclose(fp);
+	*png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	if (!*png_ptr) {
+		fclose(*fp);
 		return "Failed to initialize the png data";
 	}
 
-	this->info_ptr = png_create_info_struct(this->png_ptr);
-	if (!this->info_ptr) {
-		png_destroy_read_struct(&this->png_ptr, (png_infopp)nullptr, (png_infopp)nullptr);
-		fclose(fp);
+	*info_ptr = png_create_info_struct(*png_ptr);
+	if (!*info_ptr) {
+		png_destroy_read_struct(png_ptr, (png_infopp)nullptr, (png_infopp)nullptr);
+		fclose(*fp);
 		return "Failed to setup a png info structure";
 	}
 
-	this->end_info = png_create_info_struct(this->png_ptr);
-	if (!this->end_info) {
-		png_destroy_read_struct(&this->png_ptr, &this->info_ptr, (png_infopp)nullptr);
-		fclose(fp);
+	*end_info = png_create_info_struct(*png_ptr);
+	if (!*end_info) {
+		png_destroy_read_struct(png_ptr, info_ptr, (png_infopp)nullptr);
+		fclose(*fp);
 		return "Failed to setup a png end info structure";
 	}
+	return nullptr;
+}
+
+/**
+ * Read the header of a .png file from the disk, and check whether the image can be used.
+ * @param fname Name of the .png file to load.
+ * @return An error message if loading failed, or \c nullptr if loading succeeded.
+ */
+const char *ImageFile::ReadHeader(const std::string &fname)
+{
+	FILE *fp;
+	png_structp png_ptr;
+	png_infop info_ptr;
+	png_infop end_info;
+	const char *err = OpenPngFile(fname, &fp, &png_ptr, &info_ptr, &end_info);
+	if (err != nullptr) return err;
+
+	/* Setup callback in case of errors. */
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+		fclose(fp);
+		return "Error detected while reading PNG file";
+	}
+
+	/* Initialize for file reading. */
+	png_init_io(png_ptr, fp);
+	png_set_sig_bytes(png_ptr, HEADER_SIZE);
+
+	png_read_info(png_ptr, info_ptr);
+	int bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+	this->width = png_get_image_width(png_ptr, info_ptr);
+	this->height = png_get_image_height(png_ptr, info_ptr);
+	this->color_type = png_get_color_type(png_ptr, info_ptr);
+	png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+	fclose(fp);
+
+	if (bit_depth != 8) return "Depth of the image channels is not 8 bit";
+	if (this->color_type != PNG_COLOR_TYPE_PALETTE && this->color_type != PNG_COLOR_TYPE_RGB_ALPHA) {
+		return "Incorrect type of image (expected either 8bpp paletted image or RGBA)";
+	}
+
+	this->fname = fname;
+	return nullptr; // Loading was a success.
+}
+
+/**
+ * Decode the pixels of the image, if that has not been done yet.
+ * Several threads may call this method at the same time, the file is read only once.
+ * @return An error message if decoding failed, or \c nullptr if the pixels are available.
+ */
+const char *ImageFile::LoadPixels() const
+{
+	std::call_once(this->pixels_loaded, [this]() { this->pixels_error = this->ReadPixels(); });
+	return this->pixels_error;
+}
+
+/**
+ * Get a hash of the contents of the image file, to recognize changes to the file.
+ * The file is read on the first call, which should not be done by several threads at the same time.
+ * @return Hash value of the file contents, \c 0 for an image created in memory.
+ */
+uint64 ImageFile::GetContentHash() const
+{
+	if (this->content_hashed) return this->content_hash;
+
+	this->content_hash = 0;
+	FILE *fp = this->fname.empty() ? nullptr : fopen(this->fname.c_str(), "rb");
+	if (fp != nullptr) {
+		std::vector<uint8> data;
+		uint8 buffer[16384];
+		size_t count;
+		while ((count = fread(buffer, 1, sizeof(buffer), fp)) > 0) data.insert(data.end(), buffer, buffer + count);
+		fclose(fp);
+		this->content_hash = HashBytes(data.data(), data.size());
+	}
+	this->content_hashed = true;
+	return this->content_hash;
+}
+
+/**
+ * Read the pixels of the .png file from the disk.
+ * @return An error message if loading failed, or \c nullptr if loading succeeded.
+ */
+const char *ImageFile::ReadPixels() const
+{
+	FILE *fp;
+	const char *err = OpenPngFile(this->fname, &fp, &this->png_ptr, &this->info_ptr, &this->end_info);
+	if (err != nullptr) return err;
 
 	/* Setup callback in case of errors. */
 	if (setjmp(png_jmpbuf(this->png_ptr))) {
@@ -150,18 +283,12 @@ const char *ImageFile::LoadFile(const std::string &fname)
 	fclose(fp);
 	this->png_initialized = true; // Clear will now clean up.
 
-	int bit_depth = png_get_bit_depth(this->png_ptr, this->info_ptr);
-	if (bit_depth != 8) return "Depth of the image channels is not 8 bit";
-
-	this->width = png_get_image_width(this->png_ptr, this->info_ptr);
-	this->height = png_get_image_height(this->png_ptr, this->info_ptr);
-	this->color_type = png_get_color_type(this->png_ptr, this->info_ptr);
-	if (this->color_type != PNG_COLOR_TYPE_PALETTE && this->color_type != PNG_COLOR_TYPE_RGB_ALPHA) {
-		return "Incorrect type of image (expected either 8bpp paletted image or RGBA)";
+	if (static_cast<int>(png_get_image_width(this->png_ptr, this->info_ptr)) != this->width ||
+			static_cast<int>(png_get_image_height(this->png_ptr, this->info_ptr)) != this->height ||
+			png_get_color_type(this->png_ptr, this->info_ptr) != this->color_type) {
+		return "File was changed while loading it";
 	}
-
-	this->fname = fname;
-	return nullptr; // Loading was a success.
+	return nullptr;
 }
 
 /**
@@ -170,7 +297,6 @@ const char *ImageFile::LoadFile(const std::string &fname)
  */
 int ImageFile::GetWidth() const
 {
-	if (!this->png_initialized) return -1;
 	return this->width;
 }
 
@@ -180,7 +306,6 @@ int ImageFile::GetWidth() const
  */
 int ImageFile::GetHeight() const
 {
-	if (!this->png_initialized) return -1;
 	return this->height;
 }
 
@@ -214,10 +339,8 @@ static void WriteUInt32(uint32 value, uint8 *ptr)
  * @param block_version Version number of the sprite block.
  * @param mask Bitmask to apply, or \c nullptr.
  */
-Image::Image(const ImageFile *imf, const char *block_name, int block_version, BitMaskData *mask) : block_name(block_name), block_version(block_version), imf(imf)
+Image::Image(std::shared_ptr<const ImageFile> imf, const char *block_name, int block_version, BitMaskData *mask) : block_name(block_name), block_version(block_version), imf(imf)
 {
-	assert(this->imf->png_initialized);
-
 	if (mask != nullptr) {
 		this->mask = GetMask(mask->type);
 		this->mask_xpos = mask->x_pos;
@@ -233,6 +356,29 @@ Image::Image(const ImageFile *imf, const char *block_name, int block_version, Bi
 Image::~Image()
 = default;
 
+/**
+ * Make sure the pixels of the image are available.
+ * @return An error message if decoding failed, or \c nullptr if the pixels can be accessed.
+ */
+const char *Image::LoadPixels() const
+{
+	return this->imf->LoadPixels();
+}
+
+/**
+ * Get a hash of everything that decides the pixels of the image and how sprites get encoded,
+ * that is the image file, the mask, and the type of sprite.
+ * @return Hash value of the image.
+ */
+uint64 Image::GetHash() const
+{
+	uint64 hash = HashBytes(reinterpret_cast<const uint8 *>(this->block_name), strlen(this->block_name), this->imf->GetContentHash());
+	int32 mask_data[3] = {this->block_version, this->mask_xpos, this->mask_ypos};
+	hash = HashBytes(reinterpret_cast<const uint8 *>(mask_data), sizeof(mask_data), hash);
+	if (this->mask != nullptr) hash = HashBytes(reinterpret_cast<const uint8 *>(this->mask->name), strlen(this->mask->name), hash);
+	return hash;
+}
+
 /**
  * Get the height of the image.
  * @return Height of the loaded image, or \c -1.
@@ -251,6 +397,15 @@ int Image::GetWidth() const
 	return this->imf->GetWidth();
 }
 
+/**
+ * Get the name of the file containing the image.
+ * @return %Name of the image file, empty for an image created in memory.
+ */
+const std::string &Image::GetFileName() const
+{
+	return this->imf->fname;
+}
+
 /**
  * Is the queried set of pixels empty?
  * @param xpos Horizontal start position.
@@ -318,7 +473,7 @@ bool Image::IsMaskedOut(int x, int y) const
  * @param imf Image file to use.
  * @param mask Bitmask to apply, or \c nullptr.
  */
-Image8bpp::Image8bpp(const ImageFile *imf, BitMaskData *mask) : Image(imf, "8PXL", 2, mask)
+Image8bpp::Image8bpp(std::shared_ptr<const ImageFile> imf, BitMaskData *mask) : Image(imf, "8PXL", 2, mask)
 {
 }
 
@@ -509,7 +664,7 @@ static inline uint8 GetA(uint32 rgba)
  * @param imf Image file to use.
  * @param mask Bitmask to apply, or \c nullptr.
  */
-Image32bpp::Image32bpp(const ImageFile *imf, BitMaskData *mask) : Image(imf, "32PX", 1, mask)
+Image32bpp::Image32bpp(std::shared_ptr<const ImageFile> imf, BitMaskData *mask) : Image(imf, "32PX", 1, mask)
 {
 	this->recolour = nullptr;
 }
@@ -517,15 +672,31 @@ Image32bpp::Image32bpp(const ImageFile *imf, BitMaskData *mask) : Image(imf, "32
 /**
  * Setup a recolour image.
  * @param recolour Recolour image to use.
- * @note Recolour image is not owned by the 32bpp sprite creation class.
  */
-void Image32bpp::SetRecolourImage(Image8bpp *recolour)
+void Image32bpp::SetRecolourImage(std::shared_ptr<const Image8bpp> recolour)
 {
 	this->recolour = recolour;
 	assert(this->GetWidth()  <= recolour->GetWidth());
 	assert(this->GetHeight() <= recolour->GetHeight());
 }
 
+uint64 Image32bpp::GetHash() const
+{
+	uint64 hash = Image::GetHash();
+	if (this->recolour != nullptr) {
+		uint64 recolour_hash = this->recolour->GetHash();
+		hash = HashBytes(reinterpret_cast<const uint8 *>(&recolour_hash), sizeof(recolour_hash), hash);
+	}
+	return hash;
+}
+
+const char *Image32bpp::LoadPixels() const
+{
+	const char *err = Image::LoadPixels();
+	if (err == nullptr && this->recolour != nullptr) err = this->recolour->LoadPixels();
+	return err;
+}
+
 /**
  * Get a pixel from the image.
  * @param x Horizontal position.
@@ -723,21 +894,27 @@ uint8 *Image32bpp::Encode(int xpos, int ypos, int width, int height, int *size)
 	return data;
 }
 
+/** Sprites waiting to be encoded by SpriteImage::EncodePending, entries of deleted sprites are \c nullptr. */
+static std::vector<SpriteImage *> _pending_sprites;
+
 SpriteImage::SpriteImage()
 {
 	this->data = nullptr;
 	this->data_size = 0;
 	this->width = 0;
 	this->height = 0;
+	this->pending_index = -1;
 }
 
 SpriteImage::~SpriteImage()
 {
+	if (this->pending_index >= 0) _pending_sprites[this->pending_index] = nullptr;
 	delete[] this->data;
 }
 
 /**
  * Copy a part of the image as a sprite.
+ * Only the position and size are checked here, the sprite is cropped and encoded by #EncodePending.
  * @param img %Image source.
  * @param xoffset Horizontal offset of the origin to the top-left pixel of the sprite.
  * @param yoffset Vertical offset of the origin to the top-left pixel of the sprite.
@@ -748,7 +925,7 @@ SpriteImage::~SpriteImage()
  * @param crop Perform cropping of the sprite.
  * @return Error message if the conversion failed, else \c nullptr.
  */
-const char *SpriteImage::CopySprite(Image *img, int xoffset, int yoffset, int xpos, int ypos, int xsize, int ysize, bool crop)
+const char *SpriteImage::CopySprite(std::shared_ptr<const Image> img, int xoffset, int yoffset, int xpos, int ypos, int xsize, int ysize, bool crop)
 {
 	/* Remove any old data. */
 	delete[] this->data;
@@ -766,7 +943,56 @@ const char *SpriteImage::CopySprite(Image *img, int xoffset, int yoffset, int xp
 	if (xpos + xsize > img_width) return "Sprite too wide";
 	if (ypos + ysize > img_height) return "Sprite too high";
 
-	if (crop) {
+	this->xoffset = xoffset;
+	this->yoffset = yoffset;
+	this->width = xsize;
+	this->height = ysize;
+	this->source = img;
+	this->source_xpos = xpos;
+	this->source_ypos = ypos;
+	this->source_crop = crop;
+	if (this->pending_index < 0) {
+		this->pending_index = _pending_sprites.size();
+		_pending_sprites.push_back(this);
+	}
+	return nullptr;
+}
+
+/**
+ * Get the description of the sprite for the #SpriteCache.
+ * @return Key of the sprite in the cache.
+ */
+SpriteCacheKey SpriteImage::GetCacheKey() const
+{
+	SpriteCacheKey key;
+	key.image = this->source->GetHash();
+	key.xpos = this->source_xpos;
+	key.ypos = this->source_ypos;
+	key.width = this->width;
+	key.height = this->height;
+	key.xoffset = this->xoffset;
+	key.yoffset = this->yoffset;
+	key.crop = this->source_crop;
+	return key;
+}
+
+/**
+ * Crop and encode the sprite from its #source image.
+ * @return Error message if the conversion failed, else \c nullptr.
+ */
+const char *SpriteImage::EncodeSource()
+{
+	const Image *img = this->source.get();
+	const char *err = img->LoadPixels();
+	if (err != nullptr) return err;
+
+	int xoffset = this->xoffset;
+	int yoffset = this->yoffset;
+	int xpos = this->source_xpos;
+	int ypos = this->source_ypos;
+	int xsize = this->width;
+	int ysize = this->height;
+	if (this->source_crop) {
 		/* Perform cropping. */
 
 		/* Crop left columns. */
@@ -795,9 +1021,6 @@ const char *SpriteImage::CopySprite(Image *img, int xoffset, int yoffset, int xp
 	}
 
 	if (xsize == 0 || ysize == 0) {
-		delete[] this->data;
-		this->data = nullptr;
-		this->data_size = 0;
 		this->xoffset = 0;
 		this->yoffset = 0;
 		this->width = 0;
@@ -813,3 +1036,335 @@ const char *SpriteImage::CopySprite(Image *img, int xoffset, int yoffset, int xp
 	if (this->data == nullptr && this->data_size != 0) return "Cannot store sprite (not enough memory)";
 	return nullptr;
 }
+
+/**
+ * Decode the images and encode all sprites copied by #CopySprite since the previous call.
+ * Sprites available in the #SpriteCache are taken from it, the source images of those sprites are not decoded.
+ * The other sprites are independent of each other, and get divided over several threads.
+ * Each sprite is encoded the same way regardless of the number of threads, so the written output does not change.
+ * @param num_threads Number of threads to use.
+ * @note Exits the program if a sprite cannot be encoded.
+ */
+void SpriteImage::EncodePending(int num_threads)
+{
+	std::vector<SpriteImage *> sprites;
+	std::vector<SpriteCacheKey> keys;
+	for (SpriteImage *sprite : _pending_sprites) {
+		if (sprite == nullptr) continue;
+		sprite->pending_index = -1;
+		if (_sprite_cache.IsEnabled()) {
+			SpriteCacheKey key = sprite->GetCacheKey();
+			if (_sprite_cache.Lookup(key, sprite)) {
+				sprite->source = nullptr;
+				continue;
+			}
+			keys.push_back(key);
+		}
+		sprites.push_back(sprite);
+	}
+	_pending_sprites.clear();
+
+	std::vector<const char *> errors(sprites.size(), nullptr);
+	std::atomic<size_t> next(0);
+	auto encode = [&sprites, &errors, &next]() {
+		for (size_t i = next++; i < sprites.size(); i = next++) errors[i] = sprites[i]->EncodeSource();
+	};
+
+	num_threads = std::min<size_t>(std::max(num_threads, 1), sprites.size());
+	std::vector<std::thread> threads;
+	for (int i = 1; i < num_threads; i++) threads.emplace_back(encode);
+	encode();
+	for (std::thread &thread : threads) thread.join();
+
+	for (size_t i = 0; i < sprites.size(); i++) {
+		if (errors[i] != nullptr) {
+			fprintf(stderr, "Error: Encoding a sprite from \"%s\" failed: %s\n", sprites[i]->source->GetFileName().c_str(), errors[i]);
+			exit(1);
+		}
+		sprites[i]->source = nullptr;
+		if (_sprite_cache.IsEnabled()) _sprite_cache.Store(keys[i], *sprites[i]);
+	}
+}
+
+/**
+ * Read an unsigned 32 bit value from a byte array (little endian format).
+ * @param ptr Starting point for reading in the array.
+ * @return The read value.
+ */
+static uint32 ReadUInt32(const uint8 *ptr)
+{
+	return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (static_cast<uint32>(ptr[3]) << 24);
+}
+
+/**
+ * Decode the pixels of an 8bpp sprite.
+ * @param indices [out] Colour index of each pixel, row by row. Must have room for #width times #height entries.
+ */
+void SpriteImage::Decode8bpp(uint8 *indices) const
+{
+	std::fill(indices, indices + this->width * this->height, TRANSPARENT_INDEX);
+	for (int y = 0; y < this->height; y++) {
+		uint32 offset = ReadUInt32(this->data + 4 * y);
+		if (offset == 0) continue;
+
+		const uint8 *ptr = this->data + offset;
+		uint8 *row = indices + y * this->width;
+		int x = 0;
+		for (;;) {
+			uint8 gap = *ptr++;
+			uint8 count = *ptr++;
+			x += gap & 127;
+			assert(x + count <= this->width);
+			std::copy(ptr, ptr + count, row + x);
+			ptr += count;
+			x += count;
+			if ((gap & 128) != 0) break;
+		}
+	}
+}
+
+/**
+ * Decode the pixels of a 32bpp sprite.
+ * @param rgba [out] Colour and opacity of each pixel, row by row. Recoloured pixels get their intensity as grey colour.
+ *             Must have room for #width times #height pixels.
+ * @param layers [out] Recolour layer of each pixel, row by row, \c 0 means the pixel is not recoloured.
+ *               Must have room for #width times #height entries.
+ */
+void SpriteImage::Decode32bpp(uint8 *rgba, uint8 *layers) const
+{
+	std::fill(rgba, rgba + 4 * this->width * this->height, 0);
+	std::fill(layers, layers + this->width * this->height, 0);
+	const uint8 *ptr = this->data;
+	for (int y = 0; y < this->height; y++) {
+		ptr += 2; // Skip the length of the line.
+		int x = 0;
+		for (;;) {
+			uint8 mode = *ptr++;
+			if (mode == 0) break; // End of the line.
+
+			int count = mode & 63;
+			assert(x + count <= this->width);
+			uint8 *pixel = rgba + 4 * (y * this->width + x);
+			switch (mode >> 6) {
+				case 0: // Fully opaque pixels.
+				case 1: { // Partially transparent pixels.
+					uint8 opacity = (mode >> 6 == 0) ? FULLY_OPAQUE : *ptr++;
+					for (int i = 0; i < count; i++) {
+						*pixel++ = *ptr++;
+						*pixel++ = *ptr++;
+						*pixel++ = *ptr++;
+						*pixel++ = opacity;
+					}
+					break;
+				}
+
+				case 2: // Fully transparent pixels.
+					break;
+
+				case 3: { // Recoloured pixels.
+					uint8 layer = *ptr++;
+					uint8 opacity = *ptr++;
+					std::fill(layers + y * this->width + x, layers + y * this->width + x + count, layer);
+					for (int i = 0; i < count; i++) {
+						uint8 intensity = *ptr++;
+						*pixel++ = intensity;
+						*pixel++ = intensity;
+						*pixel++ = intensity;
+						*pixel++ = opacity;
+					}
+					break;
+				}
+			}
+			x += count;
+		}
+	}
+}
+
+/** Contribution of a source pixel to a pixel of a scaled sprite, in one direction. */
+struct ScaleWeight {
+	int source; ///< Position of the source pixel.
+	int weight; ///< Amount of overlap between the source pixel and the scaled pixel.
+};
+
+/**
+ * Compute which source pixels contribute to each pixel of a scaled sprite, in one direction.
+ * Positions are aligned at the origin of the sprite, so neighbouring sprites stay aligned after scaling.
+ * The weights of a scaled pixel add up to \a src_tile_width if the source covers it completely.
+ * @param src_size Number of pixels of the source.
+ * @param src_offset Offset of the source from the origin.
+ * @param size Number of pixels of the scaled sprite.
+ * @param offset Offset of the scaled sprite from the origin.
+ * @param tile_width Width of a tile in the scaled sprite.
+ * @param src_tile_width Width of a tile in the source.
+ * @return Contributing source pixels of each scaled pixel.
+ */
+static std::vector<std::vector<ScaleWeight>> GetScaleWeights(int src_size, int src_offset, int size, int offset, int tile_width, int src_tile_width)
+{
+	/* A source pixel is 'tile_width' units long, a scaled pixel is 'src_tile_width' units long. */
+	std::vector<std::vector<ScaleWeight>> weights(size);
+	for (int i = 0; i < size; i++) {
+		int start = (offset + i) * src_tile_width;
+		int end = start + src_tile_width;
+		/* First source pixel ending after 'start' (rounding towards negative infinity). */
+		int first = (start >= 0) ? start / tile_width : -((tile_width - 1 - start) / tile_width);
+		for (int pos = first; pos * tile_width < end; pos++) {
+			int source = pos - src_offset;
+			if (source < 0 || source >= src_size) continue;
+			int overlap = std::min(end, (pos + 1) * tile_width) - std::max(start, pos * tile_width);
+			if (overlap > 0) weights[i].push_back({source, overlap});
+		}
+	}
+	return weights;
+}
+
+/**
+ * Make a sprite by downscaling another sprite, with the scaled sprite having the size
+ * and offset that the game derives when scaling the source at run time.
+ *
+ * Every pixel is the area-weighted (box filter) average of the source pixels that it covers. Colours of
+ * 32bpp sprites are averaged with their opacity as weight. Recolour layers and colour indices of 8bpp
+ * sprites cannot be averaged, the value covering the largest part of the pixel is used instead.
+ * @param src Sprite to scale.
+ * @param tile_width Width of a tile at the scaled size.
+ * @param src_tile_width Width of a tile at the size of the source, should be bigger than \a tile_width.
+ * @return Error message if the conversion failed, else \c nullptr.
+ * @note An empty result is stored as a sprite without data.
+ */
+const char *SpriteImage::CopyScaled(const SpriteImage &src, int tile_width, int src_tile_width)
+{
+	assert(tile_width > 0 && tile_width < src_tile_width);
+
+	delete[] this->data;
+	this->data = nullptr;
+	this->data_size = 0;
+	this->block_name = src.block_name;
+	this->block_version = src.block_version;
+	this->width = src.width * tile_width / src_tile_width;
+	this->height = src.height * tile_width / src_tile_width;
+	this->xoffset = src.xoffset * tile_width / src_tile_width;
+	this->yoffset = src.yoffset * tile_width / src_tile_width;
+	if (src.data == nullptr || this->width == 0 || this->height == 0) {
+		this->width = 0;
+		this->height = 0;
+		return nullptr;
+	}
+
+	const auto columns = GetScaleWeights(src.width, src.xoffset, this->width, this->xoffset, tile_width, src_tile_width);
+	const auto rows = GetScaleWeights(src.height, src.yoffset, this->height, this->yoffset, tile_width, src_tile_width);
+	const uint32 full_weight = src_tile_width * src_tile_width; // Total weight of a completely covered pixel.
+
+	const bool is_8bpp = strcmp(src.block_name, "8PXL") == 0;
+	if (is_8bpp) {
+		std::vector<uint8> indices(src.width * src.height);
+		src.Decode8bpp(indices.data());
+
+		std::shared_ptr<ImageFile> imf = ImageFile::CreateEmpty(this->width, this->height, true);
+		std::vector<uint32> index_weights(256, 0);
+		std::vector<uint8> used; // Colour indices with a non-zero weight.
+		for (int y = 0; y < this->height; y++) {
+			for (int x = 0; x < this->width; x++) {
+				uint32 opaque_weight = 0;
+				for (const ScaleWeight &row : rows[y]) {
+					for (const ScaleWeight &column : columns[x]) {
+						uint8 index = indices[row.source * src.width + column.source];
+						if (index == TRANSPARENT_INDEX) continue;
+
+						if (index_weights[index] == 0) used.push_back(index);
+						index_weights[index] += row.weight * column.weight;
+						opaque_weight += row.weight * column.weight;
+					}
+				}
+
+				uint8 best = TRANSPARENT_INDEX;
+				for (uint8 index : used) {
+					if (best == TRANSPARENT_INDEX || index_weights[index] > index_weights[best] ||
+							(index_weights[index] == index_weights[best] && index < best)) {
+						best = index;
+					}
+				}
+				if (2 * opaque_weight > full_weight) imf->row_pointers[y][x] = best;
+
+				for (uint8 index : used) index_weights[index] = 0;
+				used.clear();
+			}
+		}
+
+		Image8bpp img(imf, nullptr);
+		this->data = img.Encode(0, 0, this->width, this->height, &this->data_size);
+	} else {
+		std::vector<uint8> rgba(4 * src.width * src.height);
+		std::vector<uint8> layers(src.width * src.height);
+		src.Decode32bpp(rgba.data(), layers.data());
+
+		std::shared_ptr<ImageFile> imf = ImageFile::CreateEmpty(this->width, this->height, false);
+		std::shared_ptr<ImageFile> rmf = ImageFile::CreateEmpty(this->width, this->height, true);
+		std::vector<uint64> layer_weights(256, 0);    // Opacity-weighted coverage of each recolour layer, '0' is the plain colour.
+		std::vector<uint64> layer_intensity(256, 0);  // Opacity-weighted sum of intensities of each recolour layer.
+		std::vector<uint8> used;                      // Recolour layers with a non-zero weight.
+		bool visible = false;                         // Whether any pixel of the scaled sprite is visible.
+		for (int y = 0; y < this->height; y++) {
+			for (int x = 0; x < this->width; x++) {
+				uint64 colour[3] = {0, 0, 0}; // Opacity-weighted sums of the plain colours.
+				uint64 opacity = 0;
+				for (const ScaleWeight &row : rows[y]) {
+					for (const ScaleWeight &column : columns[x]) {
+						int index = row.source * src.width + column.source;
+						const uint8 *pixel = &rgba[4 * index];
+						if (pixel[3] == FULLY_TRANSPARENT) continue;
+
+						uint64 weight = static_cast<uint64>(pixel[3]) * row.weight * column.weight;
+						uint8 layer = layers[index];
+						if (layer_weights[layer] == 0) used.push_back(layer);
+						layer_weights[layer] += weight;
+						opacity += weight;
+						if (layer == 0) {
+							for (int i = 0; i < 3; i++) colour[i] += pixel[i] * weight;
+						} else {
+							layer_intensity[layer] += pixel[0] * weight;
+						}
+					}
+				}
+
+				uint8 alpha = (opacity + full_weight / 2) / full_weight;
+				if (alpha != FULLY_TRANSPARENT) {
+					uint8 best = used[0];
+					for (uint8 layer : used) {
+						if (layer_weights[layer] > layer_weights[best] || (layer_weights[layer] == layer_weights[best] && layer < best)) {
+							best = layer;
+						}
+					}
+
+					uint8 *pixel = imf->row_pointers[y] + 4 * x;
+					const uint64 weight = layer_weights[best];
+					if (best == 0) {
+						for (int i = 0; i < 3; i++) pixel[i] = (colour[i] + weight / 2) / weight;
+					} else {
+						uint8 intensity = (layer_intensity[best] + weight / 2) / weight;
+						for (int i = 0; i < 3; i++) pixel[i] = intensity;
+						rmf->row_pointers[y][x] = best;
+					}
+					pixel[3] = alpha;
+					visible = true;
+				}
+
+				for (uint8 layer : used) {
+					layer_weights[layer] = 0;
+					layer_intensity[layer] = 0;
+				}
+				used.clear();
+			}
+		}
+
+		if (!visible) { // No pixels -> no need to store any data.
+			this->width = 0;
+			this->height = 0;
+			return nullptr;
+		}
+
+		Image32bpp img(imf, nullptr);
+		img.SetRecolourImage(std::make_shared<Image8bpp>(rmf, nullptr));
+		this->data = img.Encode(0, 0, this->width, this->height, &this->data_size);
+	}
+	if (this->data == nullptr && this->data_size != 0) return "Cannot store sprite (not enough memory)";
+	return nullptr;
+}
@@ -11,6 +11,7 @@
 #define IMAGE_H
 
 #include <memory>
+#include <mutex>
 #include <png.h>
 
 /** Bitmask description. */
@@ -22,20 +23,28 @@ public:
 };
 
 struct MaskInformation;
+struct SpriteCacheKey;
 
-/** A PNG image file. */
+/**
+ * A PNG image file.
+ * Loading a file only reads its header, the pixels are decoded by #LoadPixels when they are first needed.
+ */
 class ImageFile {
 public:
 	static const char *LoadFile(const std::string &fname, std::shared_ptr<const ImageFile> &result);
+	static std::shared_ptr<ImageFile> CreateEmpty(int width, int height, bool is_8bpp);
 
 	~ImageFile();
 
+	const char *LoadPixels() const;
+	uint64 GetContentHash() const;
+
 	int GetWidth() const;
 	int GetHeight() const;
 	bool Is8bpp() const;
 
-	bool png_initialized; ///< Whether the data structures below are initialized.
-	uint8 **row_pointers; ///< Pointers into the rows of the image.
+	mutable bool png_initialized; ///< Whether the data structures below are initialized.
+	mutable uint8 **row_pointers; ///< Pointers into the rows of the image.
 
 	int width;         ///< Width of the loaded image.
 	int height;        ///< Height of the loaded image.
@@ -45,11 +54,20 @@ public:
 private:
 	ImageFile();
 	void Clear();
-	const char *LoadFile(const std::string &fname);
+	const char *ReadHeader(const std::string &fname);
+	const char *ReadPixels() const;
+
+	mutable png_structp png_ptr; ///< Png image data.
+	mutable png_infop info_ptr;  ///< Png information.
+	mutable png_infop end_info;  ///< Png end information.
+
+	mutable std::once_flag pixels_loaded; ///< Guard for decoding the pixels only once, also with several threads.
+	mutable const char *pixels_error;     ///< Error message of decoding the pixels, or \c nullptr.
+	mutable uint64 content_hash;          ///< Hash of the file contents, if #content_hashed.
+	mutable bool content_hashed;          ///< Whether #content_hash has been computed.
 
-	png_structp png_ptr; ///< Png image data.
-	png_infop info_ptr;  ///< Png information.
-	png_infop end_info;  ///< Png end information.
+	std::unique_ptr<uint8[]> pixels; ///< Pixels of an image created in memory, \c nullptr for a loaded file.
+	std::unique_ptr<uint8 *[]> rows; ///< Row pointers of an image created in memory.
 };
 
 /**
@@ -60,11 +78,15 @@ private:
  */
 class Image {
 public:
-	Image(const ImageFile *imf, const char *block_name, int block_version, BitMaskData *mask);
+	Image(std::shared_ptr<const ImageFile> imf, const char *block_name, int block_version, BitMaskData *mask);
 	virtual ~Image();
 
+	virtual const char *LoadPixels() const;
+	virtual uint64 GetHash() const;
+
 	int GetWidth() const;
 	int GetHeight() const;
+	const std::string &GetFileName() const;
 	bool IsEmpty(int xpos, int ypos, int dx, int dy, int length) const;
 	bool IsMaskedOut(int xpos, int ypos) const;
 
@@ -75,16 +97,16 @@ public:
 	const int block_version; ///< Version number of the block to write.
 
 protected:
-	const ImageFile *imf;        ///< Image file (not owned by the object).
-	int mask_xpos;               ///< X position of the left of the mask.
-	int mask_ypos;               ///< Y position of the top of the mask.
-	const MaskInformation *mask; ///< Information about the used bitmask (or \c nullptr).
+	std::shared_ptr<const ImageFile> imf; ///< Image file.
+	int mask_xpos;                        ///< X position of the left of the mask.
+	int mask_ypos;                        ///< Y position of the top of the mask.
+	const MaskInformation *mask;          ///< Information about the used bitmask (or \c nullptr).
 };
 
 /** An 8bpp image. */
 class Image8bpp : public Image {
 public:
-	Image8bpp(const ImageFile *imf, BitMaskData *mask);
+	Image8bpp(std::shared_ptr<const ImageFile> imf, BitMaskData *mask);
 
 	uint8 GetPixel(int x, int y) const;
 	virtual bool IsTransparent(int xpos, int ypos) const override;
@@ -94,9 +116,11 @@ public:
 /** A 32bpp image. */
 class Image32bpp : public Image {
 public:
-	Image32bpp(const ImageFile *imf, BitMaskData *mask);
+	Image32bpp(std::shared_ptr<const ImageFile> imf, BitMaskData *mask);
 
-	void SetRecolourImage(Image8bpp *recolour);
+	void SetRecolourImage(std::shared_ptr<const Image8bpp> recolour);
+	const char *LoadPixels() const override;
+	uint64 GetHash() const override;
 
 	uint32 GetPixel(int x, int y) const;
 	virtual bool IsTransparent(int xpos, int ypos) const override;
@@ -106,7 +130,7 @@ protected:
 	uint8 GetCurrentRecolour(int x, int y, int max_length, int *count) const;
 	uint8 GetSameOpaqueness(int x, int y, int max_length, int *count) const;
 
-	Image8bpp *recolour; ///< Recolour information (not owned by this class).
+	std::shared_ptr<const Image8bpp> recolour; ///< Recolour information.
 };
 
 /** A Sprite. */
@@ -115,7 +139,10 @@ public:
 	SpriteImage();
 	~SpriteImage();
 
-	const char *CopySprite(Image *img, int xoffset, int yoffset, int xpos, int ypos, int xsize, int ysize, bool crop);
+	const char *CopySprite(std::shared_ptr<const Image> img, int xoffset, int yoffset, int xpos, int ypos, int xsize, int ysize, bool crop);
+	const char *CopyScaled(const SpriteImage &src, int tile_width, int src_tile_width);
+
+	static void EncodePending(int num_threads);
 
 	int xoffset;            ///< Horizontal offset from the origin to the top-left pixel of the sprite image.
 	int yoffset;            ///< Vertical offset from the origin to the top-left pixel of the sprite image.
@@ -126,6 +153,18 @@ public:
 
 	uint8 *data;   ///< Compressed image data.
 	int data_size; ///< Size of the #data field.
+
+private:
+	SpriteCacheKey GetCacheKey() const;
+	const char *EncodeSource();
+	void Decode8bpp(uint8 *indices) const;
+	void Decode32bpp(uint8 *rgba, uint8 *layers) const;
+
+	std::shared_ptr<const Image> source; ///< %Image to encode the sprite from by #EncodePending, \c nullptr if the sprite is encoded.
+	int source_xpos;                     ///< Left position of the sprite in the #source image.
+	int source_ypos;                     ///< Top position of the sprite in the #source image.
+	bool source_crop;                    ///< Whether to crop the sprite while encoding it.
+	int pending_index;                   ///< Index of the sprite in the list of sprites waiting to be encoded, \c -1 if not waiting.
 };
 
 #endif
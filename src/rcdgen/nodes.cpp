@@ -86,6 +86,35 @@ void FileNode::Write(FileWriter *fw)
 	}
 }
 
+/**
+ * Tile widths of the zoom levels of the game, from small to big.
+ * @note Keep in sync with \c _zoom_scales in the game.
+ */
+static const int _zoom_tile_widths[] = {16, 32, 64, 96, 128, 192, 256};
+
+/**
+ * Write an 8PXL or 32PX block.
+ * @param sprite_image Sprite to write.
+ * @param fw File to write to.
+ * @return Block number in the written file for this sprite, \c 0 for an empty sprite.
+ */
+static int WriteSpriteImage(const SpriteImage &sprite_image, FileWriter *fw)
+{
+	if (sprite_image.data_size == 0) return 0; // Don't make empty sprites.
+
+	FileBlock *fb = new FileBlock;
+	int length = 4 * 2 + sprite_image.data_size;
+	fb->StartSave(sprite_image.block_name, sprite_image.block_version, length);
+
+	fb->SaveUInt16(sprite_image.width);
+	fb->SaveUInt16(sprite_image.height);
+	fb->SaveUInt16(sprite_image.xoffset);
+	fb->SaveUInt16(sprite_image.yoffset);
+	fb->SaveBytes(sprite_image.data, sprite_image.data_size);
+	fb->CheckEndSave();
+	return fw->AddBlock(fb);
+}
+
 /**
  * Write an 8PXL block.
  * @param fw File to write to.
@@ -93,19 +122,62 @@ void FileNode::Write(FileWriter *fw)
  */
 int SpriteBlock::Write(FileWriter *fw)
 {
-	if (this->sprite_image.data_size == 0) return 0; // Don't make empty sprites.
+	return WriteSpriteImage(this->sprite_image, fw);
+}
+
+/**
+ * Write an 8PXL or 32PX block, followed by downscaled variants of it for the smaller zoom levels of the game.
+ * The variants are linked to the sprite with a SCAL block, so the game does not need to scale the sprite at run time.
+ * @param fw File to write to.
+ * @param tile_width Width of a tile of the sprite.
+ * @param smaller_tile_width Zoom levels with a tile width of at most this size are skipped,
+ *                           as the sprite is also available at that tile width.
+ * @return Block number in the written file for this sprite.
+ */
+int SpriteBlock::Write(FileWriter *fw, int tile_width, int smaller_tile_width)
+{
+	int sprite = WriteSpriteImage(this->sprite_image, fw);
+	if (sprite == 0) return 0;
+
+	std::vector<int> variants;
+	for (int zoom_width : _zoom_tile_widths) {
+		if (zoom_width <= smaller_tile_width || zoom_width >= tile_width) continue;
+
+		SpriteImage scaled;
+		const char *err = scaled.CopyScaled(this->sprite_image, zoom_width, tile_width);
+		if (err != nullptr) {
+			fprintf(stderr, "Error: Scaling a sprite to tile width %d failed: %s\n", zoom_width, err);
+			exit(1);
+		}
+		int variant = WriteSpriteImage(scaled, fw);
+		if (variant != 0) variants.push_back(variant);
+	}
+	if (variants.empty()) return sprite;
 
 	FileBlock *fb = new FileBlock;
-	int length = 4 * 2 + this->sprite_image.data_size;
-	fb->StartSave(this->sprite_image.block_name, this->sprite_image.block_version, length);
-
-	fb->SaveUInt16(this->sprite_image.width);
-	fb->SaveUInt16(this->sprite_image.height);
-	fb->SaveUInt16(this->sprite_image.xoffset);
-	fb->SaveUInt16(this->sprite_image.yoffset);
-	fb->SaveBytes(this->sprite_image.data, this->sprite_image.data_size);
+	fb->StartSave("SCAL", 1, 4 + 2 + 4 * variants.size());
+	fb->SaveUInt32(sprite);
+	fb->SaveUInt16(variants.size());
+	for (int variant : variants) fb->SaveUInt32(variant);
 	fb->CheckEndSave();
-	return fw->AddBlock(fb);
+	fw->AddBlock(fb);
+	return sprite;
+}
+
+/**
+ * Find the next smaller tile width of a set of scales.
+ * @param tile_widths Tile width of each scale.
+ * @param scales Number of scales.
+ * @param index Index of the scale to examine.
+ * @return The biggest tile width smaller than the tile width at \a index, or \c 0 if there is none.
+ */
+static int GetSmallerTileWidth(const uint16 *tile_widths, int scales, int index)
+{
+	int smaller = 0;
+	for (int i = 0; i < scales; i++) {
+		if (tile_widths[i] < tile_widths[index]) smaller = std::max<int>(smaller, tile_widths[i]);
+	}
+	return smaller;
 }
 
 FilePattern::FilePattern()
@@ -265,20 +337,13 @@ SheetBlock::SheetBlock(const Position &pos) : pos(pos)
 	this->imf = nullptr;
 	this->img_sheet = nullptr;
 	this->rmf = nullptr;
-	this->rim = nullptr;
-}
-
-SheetBlock::~SheetBlock()
-{
-	delete this->img_sheet;
-	delete this->rim;
 }
 
 /**
  * Get the sprite sheet. Loads the sheet from the disk on the first call.
  * @return The loaded image.
  */
-Image *SheetBlock::GetSheet()
+std::shared_ptr<const Image> SheetBlock::GetSheet()
 {
 	if (this->img_sheet != nullptr) return this->img_sheet;
 
@@ -290,10 +355,10 @@ Image *SheetBlock::GetSheet()
 	}
 	BitMaskData *bmd = (this->mask == nullptr) ? nullptr : &this->mask->data;
 	if (this->imf->Is8bpp()) {
-		this->img_sheet = new Image8bpp(this->imf.get(), bmd);
+		this->img_sheet = std::make_shared<Image8bpp>(this->imf, bmd);
 		if (!this->recolour.empty()) fprintf(stderr, "Error at %s, cannot recolour an 8bpp image, ignoring the file.\n", this->pos.ToString());
 	} else {
-		Image32bpp *im = new Image32bpp(this->imf.get(), bmd);
+		std::shared_ptr<Image32bpp> im = std::make_shared<Image32bpp>(this->imf, bmd);
 		this->img_sheet = im;
 		if (!this->recolour.empty()) {
 			this->rmf.reset();
@@ -306,8 +371,7 @@ Image *SheetBlock::GetSheet()
 				fprintf(stderr, "Error at %s, recolour file must be an 8bpp image.\n", this->pos.ToString());
 				exit(1);
 			}
-			this->rim = new Image8bpp(this->rmf.get(), nullptr);
-			im->SetRecolourImage(this->rim);
+			im->SetRecolourImage(std::make_shared<Image8bpp>(this->rmf, nullptr));
 		}
 	}
 	return this->img_sheet;
@@ -315,7 +379,7 @@ Image *SheetBlock::GetSheet()
 
 std::shared_ptr<BlockNode> SheetBlock::GetSubNode(int row, int col, const char *name, const Position &pos)
 {
-	Image *img = this->GetSheet();
+	std::shared_ptr<const Image> img = this->GetSheet();
 	std::shared_ptr<SpriteBlock> spr_blk(new SpriteBlock);
 	const char *err = nullptr;
 	if (this->y_count >= 0 && row >= this->y_count) err = "No sprite available at the queried row.";
@@ -345,18 +409,17 @@ report_error:
 
 	std::shared_ptr<const ImageFile> imf;
 	std::shared_ptr<const ImageFile> rmf;
-	Image *img = nullptr;
-	Image8bpp *rim = nullptr;
+	std::shared_ptr<Image> img;
 
 	err = ImageFile::LoadFile(this->file.MakeFilename(col), imf);
 	if (err != nullptr) goto report_error;
 
 	BitMaskData *bmd = (this->mask == nullptr) ? nullptr : &this->mask->data;
 	if (imf->Is8bpp()) {
-		img = new Image8bpp(imf.get(), bmd);
+		img = std::make_shared<Image8bpp>(imf, bmd);
 		if (this->recolour.length >= 0) fprintf(stderr, "Error at %s, cannot recolour an 8bpp image, ignoring the file.\n", this->pos.ToString());
 	} else {
-		Image32bpp *im32 = new Image32bpp(imf.get(), bmd);
+		std::shared_ptr<Image32bpp> im32 = std::make_shared<Image32bpp>(imf, bmd);
 		img = im32;
 		if (this->recolour.length >= 0) {
 			err = ImageFile::LoadFile(this->recolour.MakeFilename(col), rmf);
@@ -365,8 +428,7 @@ report_error:
 				err = "Recolour file is not an 8bpp image.\n";
 				goto report_error;
 			}
-			rim = new Image8bpp(rmf.get(), nullptr);
-			im32->SetRecolourImage(rim);
+			im32->SetRecolourImage(std::make_shared<Image8bpp>(rmf, nullptr));
 		}
 	}
 
@@ -374,8 +436,6 @@ report_error:
 	err = spr_blk->sprite_image.CopySprite(img, this->xoffset, this->yoffset, this->xbase, this->ybase, this->width, this->height, this->crop);
 	if (err != nullptr) goto report_error;
 
-	delete img;
-	delete rim;
 	return spr_blk;
 }
 
@@ -390,7 +450,7 @@ int TSELBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->z_height);
 	for (int i = 0; i < SURFACE_COUNT; i++) {
-		fb->SaveUInt32(this->sprites[i]->Write(fw));
+		fb->SaveUInt32(this->sprites[i]->Write(fw, this->tile_width));
 	}
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
@@ -406,10 +466,10 @@ int TCORBlock::Write(FileWriter *fw)
 	fb->StartSave(this->blk_name, this->version, 384 - 12);
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->z_height);
-	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->north[i]->Write(fw));
-	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->east[i]->Write(fw));
-	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->south[i]->Write(fw));
-	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->west[i]->Write(fw));
+	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->north[i]->Write(fw, this->tile_width));
+	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->east[i]->Write(fw, this->tile_width));
+	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->south[i]->Write(fw, this->tile_width));
+	for (int i = 0; i < SURFACE_COUNT; i++) fb->SaveUInt32(this->west[i]->Write(fw, this->tile_width));
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
 }
@@ -426,7 +486,7 @@ int SURFBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->z_height);
 	for (int i = 0; i < SURFACE_COUNT; i++) {
-		fb->SaveUInt32(this->sprites[i]->Write(fw));
+		fb->SaveUInt32(this->sprites[i]->Write(fw, this->tile_width));
 	}
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
@@ -444,7 +504,7 @@ int FUNDBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->z_height);
 	for (int i = 0; i < FOUNDATION_COUNT; i++) {
-		fb->SaveUInt32(this->sprites[i]->Write(fw));
+		fb->SaveUInt32(this->sprites[i]->Write(fw, this->tile_width));
 	}
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
@@ -539,7 +599,7 @@ int ANSPBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->anim_type);
 	fb->SaveUInt16(this->frames.size());
 	for (const auto& iter : this->frames) {
-		fb->SaveUInt32(iter->Write(fw));
+		fb->SaveUInt32(iter->Write(fw, this->tile_width));
 	}
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
@@ -556,7 +616,7 @@ int PATHBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->path_type);
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->z_height);
-	for (int i = 0; i < PTS_COUNT; i++) fb->SaveUInt32(this->sprites[i]->Write(fw));
+	for (int i = 0; i < PTS_COUNT; i++) fb->SaveUInt32(this->sprites[i]->Write(fw, this->tile_width));
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
 }
@@ -569,12 +629,13 @@ PDECBlock::PDECBlock() : GameBlock("PDEC", 1)
  * Write the sprite if available.
  * @param spr Sprite to wite (if not \c nullptr).
  * @param fw File to write to.
+ * @param tile_width Width of a tile of the sprite.
  * @return \c 0 if no sprite available, else the block number of the written sprite.
  */
-static uint32 WriteSprite(std::shared_ptr<SpriteBlock> &spr, FileWriter *fw)
+static uint32 WriteSprite(std::shared_ptr<SpriteBlock> &spr, FileWriter *fw, int tile_width)
 {
 	if (spr == nullptr) return 0;
-	return spr->Write(fw);
+	return spr->Write(fw, tile_width);
 }
 
 int PDECBlock::Write(FileWriter *fw)
@@ -582,23 +643,23 @@ int PDECBlock::Write(FileWriter *fw)
 	FileBlock *fb = new FileBlock;
 	fb->StartSave(this->blk_name, this->version, 286 - 12);
 	fb->SaveUInt16(this->tile_width);
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_bin[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->overflow_bin[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->demolished_bin[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->lamp_post[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->demolished_post[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->bench[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->demolished_bench[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_flat[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_ne[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_se[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_sw[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_nw[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_flat[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_ne[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_se[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_sw[i], fw));
-	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_nw[i], fw));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_bin[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->overflow_bin[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->demolished_bin[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->lamp_post[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->demolished_post[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->bench[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->demolished_bench[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_flat[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_ne[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_se[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_sw[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->litter_nw[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_flat[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_ne[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_se[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_sw[i], fw, this->tile_width));
+	for (int i = 0; i < 4; i++) fb->SaveUInt32(WriteSprite(this->vomit_nw[i], fw, this->tile_width));
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
 }
@@ -614,7 +675,7 @@ int PLATBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->z_height);
 	fb->SaveUInt16(this->platform_type);
-	for (int i = 0; i < PLA_COUNT; i++) fb->SaveUInt32(this->sprites[i]->Write(fw));
+	for (int i = 0; i < PLA_COUNT; i++) fb->SaveUInt32(this->sprites[i]->Write(fw, this->tile_width));
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
 }
@@ -630,7 +691,7 @@ int SUPPBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->support_type);
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->z_height);
-	for (int i = 0; i < SPP_COUNT; i++) fb->SaveUInt32(this->sprites[i]->Write(fw));
+	for (int i = 0; i < SPP_COUNT; i++) fb->SaveUInt32(this->sprites[i]->Write(fw, this->tile_width));
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
 }
@@ -997,7 +1058,8 @@ int FSETBlock::Write(FileWriter *fw, int rot)
 		for (int x = 0; x < this->width_x; ++x) {
 			for (int y = 0; y < this->width_y; ++y) {
 				for (int z = 0; z < this->scales; ++z) {
-					fb->SaveUInt32((*arrays[rotated])[x * this->width_y * this->scales + y * this->scales + z]->Write(fw));
+					fb->SaveUInt32((*arrays[rotated])[x * this->width_y * this->scales + y * this->scales + z]->Write(fw,
+							this->tile_width[z], GetSmallerTileWidth(this->tile_width.get(), this->scales, z)));
 				}
 			}
 		}
@@ -1237,10 +1299,10 @@ int BDIRBlock::Write(FileWriter *fw)
 	FileBlock *fb = new FileBlock;
 	fb->StartSave(this->blk_name, this->version, 30 - 12);
 	fb->SaveUInt16(this->tile_width);
-	fb->SaveUInt32(this->sprite_ne->Write(fw));
-	fb->SaveUInt32(this->sprite_se->Write(fw));
-	fb->SaveUInt32(this->sprite_sw->Write(fw));
-	fb->SaveUInt32(this->sprite_nw->Write(fw));
+	fb->SaveUInt32(this->sprite_ne->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->sprite_se->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->sprite_sw->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->sprite_nw->Write(fw, this->tile_width));
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
 }
@@ -1871,13 +1933,15 @@ int CARSBlock::Write(FileWriter *fw)
 	fb->SaveUInt16(this->num_passengers);
 	fb->SaveUInt16(this->num_entrances);
 	for (int z = 0; z < this->scales; ++z) {
+		const int smaller_tile_width = GetSmallerTileWidth(this->tile_width.get(), this->scales, z);
 		for (auto &index : this->sprites[z]) {
-			fb->SaveUInt32(index->Write(fw));
+			fb->SaveUInt32(index->Write(fw, this->tile_width[z], smaller_tile_width));
 		}
 	}
 	for (int z = 0; z < this->scales; ++z) {
+		const int smaller_tile_width = GetSmallerTileWidth(this->tile_width.get(), this->scales, z);
 		for (uint32 index = 0; index < this->num_passengers * 16U*16U*16U; ++index) {
-			fb->SaveUInt32(this->guest_overlays[z][index]->Write(fw));
+			fb->SaveUInt32(this->guest_overlays[z][index]->Write(fw, this->tile_width[z], smaller_tile_width));
 		}
 	}
 	fb->SaveUInt32(this->recol[0].Encode());
@@ -1977,18 +2041,18 @@ int FENCBlock::Write(FileWriter *fw)
 	fb->StartSave(this->blk_name, this->version, 64 - 12);
 	fb->SaveUInt16(this->tile_width);
 	fb->SaveUInt16(this->type);
-	fb->SaveUInt32(this->ne_hor->Write(fw));
-	fb->SaveUInt32(this->ne_n->Write(fw));
-	fb->SaveUInt32(this->ne_e->Write(fw));
-	fb->SaveUInt32(this->se_hor->Write(fw));
-	fb->SaveUInt32(this->se_e->Write(fw));
-	fb->SaveUInt32(this->se_s->Write(fw));
-	fb->SaveUInt32(this->sw_hor->Write(fw));
-	fb->SaveUInt32(this->sw_s->Write(fw));
-	fb->SaveUInt32(this->sw_w->Write(fw));
-	fb->SaveUInt32(this->nw_hor->Write(fw));
-	fb->SaveUInt32(this->nw_w->Write(fw));
-	fb->SaveUInt32(this->nw_n->Write(fw));
+	fb->SaveUInt32(this->ne_hor->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->ne_n->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->ne_e->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->se_hor->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->se_e->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->se_s->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->sw_hor->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->sw_s->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->sw_w->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->nw_hor->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->nw_w->Write(fw, this->tile_width));
+	fb->SaveUInt32(this->nw_n->Write(fw, this->tile_width));
 	fb->CheckEndSave();
 	return fw->AddBlock(fb);
 }
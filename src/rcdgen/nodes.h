@@ -105,6 +105,7 @@ public:
 	virtual ~SpriteBlock() = default;
 
 	int Write(FileWriter *fw);
+	int Write(FileWriter *fw, int tile_width, int smaller_tile_width = 0);
 
 	SpriteImage sprite_image; ///< The stored sprite.
 };
@@ -131,10 +132,9 @@ public:
 class SheetBlock : public BlockNode {
 public:
 	SheetBlock(const Position &pos);
-	virtual ~SheetBlock();
 
 	std::shared_ptr<BlockNode> GetSubNode(int row, int col, const char *name, const Position &pos) override;
-	Image *GetSheet();
+	std::shared_ptr<const Image> GetSheet();
 
 	Position pos;         ///< Line number defining the sheet.
 	std::string file;     ///< %Name of the file containing the sprite sheet.
@@ -153,10 +153,9 @@ public:
 	bool crop;    ///< Crop sprite.
 
 	std::shared_ptr<const ImageFile> imf;  ///< Loaded image file.
-	Image *img_sheet;                      ///< Sheet of images.
+	std::shared_ptr<Image> img_sheet;      ///< Sheet of images.
 	std::shared_ptr<BitMask> mask;         ///< Bit mask to apply first (if available).
 	std::shared_ptr<const ImageFile> rmf;  ///< Loaded recolour file.
-	Image8bpp *rim;                        ///< Recolour image.
 };
 
 /** A 'spritefiles' block. */
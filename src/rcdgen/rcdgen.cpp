@@ -15,7 +15,11 @@
 #include "nodes.h"
 #include "string_storage.h"
 #include "file_writing.h"
+#include "image.h"
+#include "sprite_cache.h"
+#include "utils.h"
 #include <cstdarg>
+#include <thread>
 
 /**
  * Error handling for fatal non-user errors.
@@ -40,6 +44,11 @@ static const OptionData _options[] = {
 	GETOPT_VALUE('c', "--code"),
 	GETOPT_VALUE('b', "--base"),
 	GETOPT_VALUE('p', "--prefix"),
+	GETOPT_VALUE('j', "--jobs"),
+	GETOPT_VALUE('D', "--depfile"),
+	GETOPT_VALUE('T', "--deptarget"),
+	GETOPT_VALUE('s', "--sprite-cache"),
+	GETOPT_NOVAL('l', "--dedup-by-length"),
 	GETOPT_END()
 };
 
@@ -54,7 +63,14 @@ static void PrintUsage()
 	printf("\n");
 	printf("2. Generate RCD data files from input files or stdin:\n");
 	printf("\n");
-	printf("\trcdgen [FILE ...]\n");
+	printf("\trcdgen [--jobs JOBS] [--sprite-cache DIR] [--depfile DEPFILE [--deptarget TARGET]] [--dedup-by-length] [FILE ...]\n");
+	printf("\n");
+	printf("   JOBS    is the number of threads for encoding the sprites. If omitted, it is the number of processors.\n");
+	printf("   DIR     is a directory to keep encoded sprites in, to reuse them in a next run.\n");
+	printf("   DEPFILE is the name of a file to write the used input files into, in makefile syntax.\n");
+	printf("   TARGET  is the target of the rule in DEPFILE. If omitted, it is the generated RCD file.\n");
+	printf("   --dedup-by-length finds duplicate blocks by comparing each block with all earlier blocks of the same length,\n");
+	printf("   instead of by their hash. It is slower, and gives the same result. It exists for testing.\n");
 	printf("\n");
 	printf("3. Generate .h and/or .cpp files for strings of the program:\n");
 	printf("\n");
@@ -81,6 +97,10 @@ int main(int argc, char *argv[])
 	const char *code = nullptr;
 	const char *prefix = nullptr;
 	const char *base = "0";
+	int num_jobs = std::max(1u, std::thread::hardware_concurrency());
+	const char *depfile = nullptr;
+	const char *deptarget = nullptr;
+	bool dedup_by_length = false;
 
 	int opt_id;
 	do {
@@ -106,6 +126,30 @@ int main(int argc, char *argv[])
 				prefix = opt_data.opt;
 				break;
 
+			case 'j':
+				num_jobs = atoi(opt_data.opt);
+				if (num_jobs < 1) {
+					fprintf(stderr, "ERROR: The number of jobs must be at least 1\n");
+					exit(1);
+				}
+				break;
+
+			case 'D':
+				depfile = opt_data.opt;
+				break;
+
+			case 'T':
+				deptarget = opt_data.opt;
+				break;
+
+			case 's':
+				_sprite_cache.SetDirectory(opt_data.opt);
+				break;
+
+			case 'l':
+				dedup_by_length = true;
+				break;
+
 			case -1:
 				break;
 
@@ -127,6 +171,9 @@ int main(int argc, char *argv[])
 	if (header != nullptr) printf("Warning: --header option is not used.\n");
 	if (code != nullptr) printf("Warning: --code option is not used.\n");
 
+	std::vector<std::string> targets;
+	if (deptarget != nullptr) targets.push_back(deptarget);
+
 	int num_files = std::max(1, opt_data.numleft);
 	for (int i = 0; i < num_files; i++) {
 		assert(i < opt_data.numleft);
@@ -152,14 +199,21 @@ int main(int argc, char *argv[])
 		FileNodeList *file_nodes = CheckTree(nvs);
 		nvs = nullptr;
 
-		/* Phase 3: Construct output files. */
+		/* Phase 3: Decode the images, and encode the sprites. */
+		SpriteImage::EncodePending(num_jobs);
+		_sprite_cache.Save();
+
+		/* Phase 4: Construct output files. */
 		for (const auto& iter : file_nodes->files) {
-			FileWriter fw;
+			FileWriter fw(dedup_by_length);
 			iter->Write(&fw);
 			fw.WriteFile(iter->file_name);
+			if (deptarget == nullptr) targets.push_back(iter->file_name);
 		}
 
 		delete file_nodes;
 	}
+
+	if (depfile != nullptr) WriteDependencyFile(depfile, targets);
 	exit(0);
 }
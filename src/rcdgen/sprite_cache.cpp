@@ -0,0 +1,275 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file sprite_cache.cpp On-disk cache of encoded sprites. */
+
+#include "../stdafx.h"
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <tuple>
+#include "image.h"
+#include "sprite_cache.h"
+
+/**
+ * Version of the cache files.
+ * Increment it when the encoding of sprites changes, so old cache files get ignored.
+ */
+static const uint32 SPRITE_CACHE_VERSION = 1;
+
+SpriteCache _sprite_cache; ///< Cache of encoded sprites, only used if a directory is set.
+
+bool SpriteCacheKey::operator<(const SpriteCacheKey &other) const
+{
+	return std::tie(this->image, this->xpos, this->ypos, this->width, this->height, this->xoffset, this->yoffset, this->crop) <
+			std::tie(other.image, other.xpos, other.ypos, other.width, other.height, other.xoffset, other.yoffset, other.crop);
+}
+
+/**
+ * Set the directory to store the cache files, and enable the cache.
+ * @param directory Directory of the cache files, it is created if it does not exist.
+ */
+void SpriteCache::SetDirectory(const std::string &directory)
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error) {
+		fprintf(stderr, "Error: Cannot create the sprite cache directory \"%s\": %s\n", directory.c_str(), error.message().c_str());
+		exit(1);
+	}
+	this->directory = directory;
+}
+
+/**
+ * Is the cache used?
+ * @return Whether a cache directory has been set.
+ */
+bool SpriteCache::IsEnabled() const
+{
+	return !this->directory.empty();
+}
+
+/**
+ * Get the name of the cache file of an image.
+ * @param image Hash of the image.
+ * @return Name of the cache file.
+ */
+std::string SpriteCache::GetFileName(uint64 image) const
+{
+	char name[32];
+	snprintf(name, lengthof(name), "%016llx.spc", image);
+	return (std::filesystem::path(this->directory) / name).string();
+}
+
+/** Reader of the data of a cache file. */
+class CacheFileReader {
+public:
+	/**
+	 * Constructor.
+	 * @param data Content of the cache file.
+	 */
+	CacheFileReader(const std::vector<uint8> &data) : data(data), pos(0), ok(true)
+	{
+	}
+
+	/**
+	 * Read a value from the file.
+	 * @param value [out] Read value.
+	 * @return Whether the value could be read.
+	 */
+	template <typename T>
+	bool Read(T *value)
+	{
+		return this->ReadBytes(reinterpret_cast<uint8 *>(value), sizeof(T));
+	}
+
+	/**
+	 * Read bytes from the file.
+	 * @param dest [out] Destination of the bytes.
+	 * @param size Number of bytes to read.
+	 * @return Whether the bytes could be read.
+	 */
+	bool ReadBytes(uint8 *dest, size_t size)
+	{
+		if (!this->ok || this->data.size() - this->pos < size) {
+			this->ok = false;
+			return false;
+		}
+		if (size > 0) memcpy(dest, this->data.data() + this->pos, size);
+		this->pos += size;
+		return true;
+	}
+
+	const std::vector<uint8> &data; ///< Content of the file.
+	size_t pos;                     ///< Read position in #data.
+	bool ok;                        ///< Whether all reads so far succeeded.
+};
+
+/**
+ * Get the cached sprites of an image, loading its cache file on first use.
+ * A missing, old, or damaged cache file gives an empty collection of sprites.
+ * @param image Hash of the image.
+ * @return The cached sprites of the image.
+ */
+SpriteCache::ImageEntries &SpriteCache::GetImage(uint64 image)
+{
+	auto iter = this->images.find(image);
+	if (iter != this->images.end()) return iter->second;
+
+	ImageEntries &entries = this->images[image];
+	FILE *fp = fopen(this->GetFileName(image).c_str(), "rb");
+	if (fp == nullptr) return entries;
+
+	std::vector<uint8> data;
+	uint8 buffer[16384];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), fp)) > 0) data.insert(data.end(), buffer, buffer + count);
+	fclose(fp);
+
+	CacheFileReader reader(data);
+	char magic[4];
+	uint32 version, num_sprites;
+	if (!reader.ReadBytes(reinterpret_cast<uint8 *>(magic), 4) || memcmp(magic, "RSPC", 4) != 0) return entries;
+	if (!reader.Read(&version) || version != SPRITE_CACHE_VERSION) return entries;
+	if (!reader.Read(&num_sprites)) return entries;
+
+	std::map<SpriteCacheKey, Entry> sprites;
+	for (uint32 i = 0; i < num_sprites; i++) {
+		SpriteCacheKey key;
+		key.image = image;
+		uint8 crop = 0;
+		reader.Read(&key.xpos);
+		reader.Read(&key.ypos);
+		reader.Read(&key.width);
+		reader.Read(&key.height);
+		reader.Read(&key.xoffset);
+		reader.Read(&key.yoffset);
+		reader.Read(&crop);
+		key.crop = crop != 0;
+
+		Entry entry;
+		uint32 data_size;
+		reader.Read(&entry.xoffset);
+		reader.Read(&entry.yoffset);
+		reader.Read(&entry.width);
+		reader.Read(&entry.height);
+		if (!reader.Read(&data_size) || data.size() - reader.pos < data_size) return entries;
+		entry.data.resize(data_size);
+		if (!reader.ReadBytes(entry.data.data(), data_size)) return entries;
+		sprites[key] = std::move(entry);
+	}
+	entries.sprites = std::move(sprites);
+	return entries;
+}
+
+/**
+ * Find an encoded sprite in the cache.
+ * @param key Description of the sprite.
+ * @param sprite [out] Sprite to fill with the cached encoded data.
+ * @return Whether the sprite was found in the cache.
+ */
+bool SpriteCache::Lookup(const SpriteCacheKey &key, SpriteImage *sprite)
+{
+	const ImageEntries &entries = this->GetImage(key.image);
+	auto iter = entries.sprites.find(key);
+	if (iter == entries.sprites.end()) return false;
+
+	const Entry &entry = iter->second;
+	sprite->xoffset = entry.xoffset;
+	sprite->yoffset = entry.yoffset;
+	sprite->width = entry.width;
+	sprite->height = entry.height;
+	delete[] sprite->data;
+	sprite->data = nullptr;
+	sprite->data_size = entry.data.size();
+	if (!entry.data.empty()) {
+		sprite->data = new uint8[entry.data.size()];
+		memcpy(sprite->data, entry.data.data(), entry.data.size());
+	}
+	return true;
+}
+
+/**
+ * Add an encoded sprite to the cache.
+ * @param key Description of the sprite.
+ * @param sprite Encoded sprite.
+ */
+void SpriteCache::Store(const SpriteCacheKey &key, const SpriteImage &sprite)
+{
+	ImageEntries &entries = this->GetImage(key.image);
+	Entry &entry = entries.sprites[key];
+	entry.xoffset = sprite.xoffset;
+	entry.yoffset = sprite.yoffset;
+	entry.width = sprite.width;
+	entry.height = sprite.height;
+	entry.data.assign(sprite.data, sprite.data + sprite.data_size);
+	entries.changed = true;
+}
+
+/**
+ * Write a value to a cache file.
+ * @param fp File to write to.
+ * @param value Value to write.
+ */
+template <typename T>
+static void WriteValue(FILE *fp, const T &value)
+{
+	fwrite(&value, sizeof(T), 1, fp);
+}
+
+/**
+ * Write the cache files of the images with new sprites.
+ * A file is written under a temporary name first, so other rcdgen runs sharing the directory never read a partial file.
+ */
+void SpriteCache::Save()
+{
+	std::random_device random;
+	for (auto &iter : this->images) {
+		ImageEntries &entries = iter.second;
+		if (!entries.changed) continue;
+
+		const std::string fname = this->GetFileName(iter.first);
+		const std::string temp_fname = fname + "." + std::to_string(random()) + ".tmp";
+		FILE *fp = fopen(temp_fname.c_str(), "wb");
+		if (fp == nullptr) {
+			fprintf(stderr, "Warning: Cannot write sprite cache file \"%s\"\n", temp_fname.c_str());
+			continue;
+		}
+
+		fwrite("RSPC", 1, 4, fp);
+		WriteValue(fp, SPRITE_CACHE_VERSION);
+		WriteValue(fp, static_cast<uint32>(entries.sprites.size()));
+		for (const auto &sprite : entries.sprites) {
+			const SpriteCacheKey &key = sprite.first;
+			const Entry &entry = sprite.second;
+			WriteValue(fp, key.xpos);
+			WriteValue(fp, key.ypos);
+			WriteValue(fp, key.width);
+			WriteValue(fp, key.height);
+			WriteValue(fp, key.xoffset);
+			WriteValue(fp, key.yoffset);
+			WriteValue(fp, static_cast<uint8>(key.crop ? 1 : 0));
+			WriteValue(fp, entry.xoffset);
+			WriteValue(fp, entry.yoffset);
+			WriteValue(fp, entry.width);
+			WriteValue(fp, entry.height);
+			WriteValue(fp, static_cast<uint32>(entry.data.size()));
+			if (!entry.data.empty()) fwrite(entry.data.data(), 1, entry.data.size(), fp);
+		}
+		bool failed = ferror(fp) != 0;
+		failed |= fclose(fp) != 0;
+
+		std::error_code error;
+		if (!failed) std::filesystem::rename(temp_fname, fname, error);
+		if (failed || error) {
+			fprintf(stderr, "Warning: Cannot write sprite cache file \"%s\"\n", fname.c_str());
+			std::filesystem::remove(temp_fname, error);
+			continue;
+		}
+		entries.changed = false;
+	}
+}
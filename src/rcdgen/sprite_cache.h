@@ -0,0 +1,72 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file sprite_cache.h On-disk cache of encoded sprites. */
+
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class SpriteImage;
+
+/** Description of a sprite to encode, everything that decides the encoded result. */
+struct SpriteCacheKey {
+	uint64 image;  ///< Hash of the source image, see Image::GetHash.
+	int32 xpos;    ///< Left position of the sprite in the image.
+	int32 ypos;    ///< Top position of the sprite in the image.
+	int32 width;   ///< Width of the sprite in the image.
+	int32 height;  ///< Height of the sprite in the image.
+	int32 xoffset; ///< Horizontal offset of the origin to the top-left pixel of the sprite.
+	int32 yoffset; ///< Vertical offset of the origin to the top-left pixel of the sprite.
+	bool crop;     ///< Whether the sprite is cropped.
+
+	bool operator<(const SpriteCacheKey &other) const;
+};
+
+/**
+ * Cache of encoded sprites in a directory, to avoid decoding images and encoding sprites again in a next run.
+ * Each source image has its own cache file, named after the hash of the image.
+ * A changed image gets a different hash, its old cache file is simply not used any more.
+ */
+class SpriteCache {
+public:
+	void SetDirectory(const std::string &directory);
+	bool IsEnabled() const;
+
+	bool Lookup(const SpriteCacheKey &key, SpriteImage *sprite);
+	void Store(const SpriteCacheKey &key, const SpriteImage &sprite);
+	void Save();
+
+private:
+	/** An encoded sprite. */
+	struct Entry {
+		int32 xoffset;           ///< Horizontal offset of the sprite after cropping.
+		int32 yoffset;           ///< Vertical offset of the sprite after cropping.
+		int32 width;             ///< Width of the sprite after cropping.
+		int32 height;            ///< Height of the sprite after cropping.
+		std::vector<uint8> data; ///< Encoded sprite data.
+	};
+
+	/** Encoded sprites of one source image. */
+	struct ImageEntries {
+		std::map<SpriteCacheKey, Entry> sprites; ///< Encoded sprites of the image.
+		bool changed = false;                    ///< Whether sprites were added since the cache file was loaded.
+	};
+
+	std::string GetFileName(uint64 image) const;
+	ImageEntries &GetImage(uint64 image);
+
+	std::string directory;                 ///< Directory of the cache files, empty if the cache is not used.
+	std::map<uint64, ImageEntries> images; ///< Loaded cache files, by image hash.
+};
+
+extern SpriteCache _sprite_cache;
+
+#endif
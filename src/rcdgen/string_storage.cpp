@@ -17,6 +17,7 @@
 #include "ast.h"
 #include "nodes.h"
 #include "string_storage.h"
+#include "utils.h"
 
 StringsStorage _strings_storage; ///< Storage of all (translated) strings by key.
 
@@ -353,6 +354,7 @@ void YAMLParser::SaveResults(const std::pair<std::string, BundleContent> &bundle
  */
 void StringsStorage::ReadFromYAML(const char *filename)
 {
+	AddDependency(filename);
 	YAMLParser p(this, filename);
 	p.Parse();
 }
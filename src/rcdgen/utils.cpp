@@ -8,10 +8,16 @@
 /** @file utils.cpp %Support code for rcdgen. */
 
 #include "../stdafx.h"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <set>
 #include "ast.h"
 #include "utils.h"
 
+static std::set<std::string> _dependencies; ///< Absolute paths of all input files read so far.
+
 ParameterizedNameRange::ParameterizedNameRange() : used(false), min_value(-1), max_value(-1)
 {
 }
@@ -202,3 +208,82 @@ void CheckIsSingleName(const std::string &name, const Position &pos)
 		exit(1);
 	}
 }
+
+/**
+ * Compute a hash of a sequence of bytes.
+ * The data is mixed 8 bytes at a time, followed by the final mixing step of MurmurHash3.
+ * Identical data has the same hash, different data almost never does.
+ * @param data Start of the data.
+ * @param length Number of bytes of the data.
+ * @param seed Initial value, to combine the hash with an earlier hash.
+ * @return Hash value of the data.
+ */
+uint64 HashBytes(const uint8 *data, size_t length, uint64 seed)
+{
+	uint64 hash = seed ^ 0x9e3779b97f4a7c15ULL ^ length;
+	for (size_t i = 0; i < length; i += 8) {
+		uint64 word = 0;
+		memcpy(&word, data + i, std::min<size_t>(8, length - i));
+		hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 32;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+/**
+ * Record that an input file was read, for the dependency file.
+ * @param fname Name of the file.
+ */
+void AddDependency(const std::string &fname)
+{
+	std::error_code error;
+	std::filesystem::path path = std::filesystem::absolute(fname, error);
+	if (error) path = fname;
+	_dependencies.insert(path.lexically_normal().generic_string());
+}
+
+/**
+ * Escape a file name for use in a makefile rule.
+ * @param fname File name to escape.
+ * @return The escaped name.
+ */
+static std::string EscapeMakeName(const std::string &fname)
+{
+	std::string escaped;
+	for (char c : fname) {
+		if (c == ' ' || c == '#') escaped += '\\';
+		if (c == '$') escaped += '$';
+		escaped += c;
+	}
+	return escaped;
+}
+
+/**
+ * Write a dependency file in makefile syntax, listing all input files read by the program (see #AddDependency).
+ * Build systems use it to regenerate the targets only when an input file changes.
+ * @param depfile Name of the dependency file to write.
+ * @param targets Files that depend on the input files.
+ */
+void WriteDependencyFile(const char *depfile, const std::vector<std::string> &targets)
+{
+	FILE *fp = fopen(depfile, "w");
+	if (fp == nullptr) {
+		fprintf(stderr, "Error: Could not write the dependency file \"%s\".\n", depfile);
+		exit(1);
+	}
+
+	const char *separator = "";
+	for (const std::string &target : targets) {
+		fprintf(fp, "%s%s", separator, EscapeMakeName(target).c_str());
+		separator = " ";
+	}
+	fprintf(fp, ":");
+	for (const std::string &dep : _dependencies) fprintf(fp, " \\\n  %s", EscapeMakeName(dep).c_str());
+	fprintf(fp, "\n");
+	fclose(fp);
+}
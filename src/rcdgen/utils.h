@@ -10,6 +10,9 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <string>
+#include <vector>
+
 class Position;
 
 /** Data about one range in a parameterized name. */
@@ -57,4 +60,9 @@ public:
 
 void CheckIsSingleName(const std::string &name, const Position &pos);
 
+uint64 HashBytes(const uint8 *data, size_t length, uint64 seed = 0);
+
+void AddDependency(const std::string &fname);
+void WriteDependencyFile(const char *depfile, const std::vector<std::string> &targets);
+
 #endif
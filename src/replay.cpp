@@ -0,0 +1,576 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file replay.cpp Recording and replaying of player commands. */
+
+#include "stdafx.h"
+#include "replay.h"
+#include "coaster.h"
+#include "dates.h"
+#include "finances.h"
+#include "fixed_ride_type.h"
+#include "gamecontrol.h"
+#include "gameobserver.h"
+#include "gentle_thrill_ride_type.h"
+#include "loadsave.h"
+#include "map.h"
+#include "mouse_mode.h"
+#include "path_build.h"
+#include "people.h"
+#include "person.h"
+#include "random.h"
+#include "scenery.h"
+#include "terraform.h"
+
+#include <vector>
+
+Replay _replay; ///< Recorder and player of player commands.
+
+/* When making any changes to the replay file format, don't forget to update the file 'doc/savegame.rst'! */
+
+static const uint32 CURRENT_VERSION_RPLY = 2;  ///< Currently supported version of the RPLY pattern.
+
+/**
+ * Constructor of a command without parameters.
+ * @param type Type of the command.
+ */
+ReplayCommand::ReplayCommand(ReplayCommandType type) : type(type), tick(0), pos(0, 0, 0), size(0, 0), instance(0), data{0, 0, 0, 0}, value(0)
+{
+}
+
+/**
+ * Load a command from a replay file.
+ * @param ldr Input stream to read.
+ */
+void ReplayCommand::Load(Loader &ldr)
+{
+	const uint8 t = ldr.GetByte();
+	if (t >= RCT_COUNT) throw LoadingError("Unknown replay command %u", t);
+	this->type = static_cast<ReplayCommandType>(t);
+
+	this->tick = ldr.GetLong();
+	this->pos.x = ldr.GetWord();
+	this->pos.y = ldr.GetWord();
+	this->pos.z = ldr.GetWord();
+	this->size.x = ldr.GetWord();
+	this->size.y = ldr.GetWord();
+	this->instance = ldr.GetWord();
+	for (uint8 &d : this->data) d = ldr.GetByte();
+	this->value = static_cast<int64>(ldr.GetLongLong());
+	this->name = ldr.GetText();
+}
+
+/**
+ * Save a command to a replay file.
+ * @param svr Output stream to write.
+ */
+void ReplayCommand::Save(Saver &svr) const
+{
+	svr.PutByte(this->type);
+	svr.PutLong(this->tick);
+	svr.PutWord(this->pos.x);
+	svr.PutWord(this->pos.y);
+	svr.PutWord(this->pos.z);
+	svr.PutWord(this->size.x);
+	svr.PutWord(this->size.y);
+	svr.PutWord(this->instance);
+	for (uint8 d : this->data) svr.PutByte(d);
+	svr.PutLongLong(static_cast<uint64>(this->value));
+	svr.PutText(this->name);
+}
+
+/**
+ * Get a ride instance of a replayed command.
+ * @param instance Ride instance number from the replay file.
+ * @return The ride instance, or \c nullptr if it does not exist.
+ */
+static RideInstance *GetReplayRide(uint16 instance)
+{
+	if (instance < SRI_FULL_RIDES || instance >= SRI_LAST) return nullptr;
+	return _rides_manager.GetRideInstance(instance);
+}
+
+/** Perform the command again. */
+void ReplayCommand::Execute() const
+{
+	switch (this->type) {
+		case RCT_GAME_SPEED:
+			if (this->data[0] < GSP_COUNT) _game_control.SetSpeed(static_cast<GameSpeed>(this->data[0]));
+			break;
+
+		case RCT_TERRAFORM_TILE:
+			ChangeTileCursorMode(Point16(this->pos.x, this->pos.y), static_cast<CursorType>(this->data[0]), this->data[1] != 0, this->value, this->data[2] != 0);
+			break;
+
+		case RCT_TERRAFORM_AREA:
+			ChangeAreaCursorMode(Rectangle16(this->pos.x, this->pos.y, this->size.x, this->size.y), this->data[1] != 0, this->value);
+			break;
+
+		case RCT_BUILD_UPWARD_PATH:
+			BuildUpwardPath(this->pos, static_cast<TileEdge>(this->data[0]), static_cast<PathType>(this->data[1]), static_cast<PathStatus>(this->data[2]), false, this->data[3] != 0);
+			break;
+
+		case RCT_BUILD_FLAT_PATH:
+			BuildFlatPath(this->pos, static_cast<PathType>(this->data[1]), static_cast<PathStatus>(this->data[2]), false, this->data[3] != 0);
+			break;
+
+		case RCT_BUILD_DOWNWARD_PATH:
+			BuildDownwardPath(this->pos, static_cast<TileEdge>(this->data[0]), static_cast<PathType>(this->data[1]), static_cast<PathStatus>(this->data[2]), false, this->data[3] != 0);
+			break;
+
+		case RCT_REMOVE_PATH:
+			RemovePath(this->pos, false, this->data[3] != 0);
+			break;
+
+		case RCT_CHANGE_PATH:
+			ChangePath(this->pos, static_cast<PathType>(this->data[1]), static_cast<PathStatus>(this->data[2]), false, this->data[3] != 0);
+			break;
+
+		case RCT_CREATE_RIDE: {
+			const RideType *ride_type = _rides_manager.GetRideType(this->name);
+			if (ride_type == nullptr || this->instance < SRI_FULL_RIDES || this->instance >= SRI_LAST || GetReplayRide(this->instance) != nullptr) {
+				printf("WARNING: Cannot create ride %u of type '%s'\n", this->instance, this->name.c_str());
+				break;
+			}
+			/* Like in the game, the new instance draws its colours from the random generator. */
+			_rides_manager.CreateInstance(ride_type, this->instance);
+			if (ride_type->kind == RTK_COASTER) _rides_manager.NewInstanceAdded(this->instance);
+			break;
+		}
+
+		case RCT_BUILD_FIXED_RIDE: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri == nullptr || (ri->GetKind() != RTK_SHOP && ri->GetKind() != RTK_GENTLE && ri->GetKind() != RTK_THRILL)) break;
+
+			FixedRideInstance *fri = static_cast<FixedRideInstance *>(ri);
+			fri->SetRide(this->data[0], this->pos);
+			fri->BuildRide();
+			break;
+		}
+
+		case RCT_DELETE_RIDE:
+			if (GetReplayRide(this->instance) == nullptr) break;
+			_finances_manager.PayRideConstruct(Money(this->value));
+			_rides_manager.DeleteInstance(this->instance);
+			break;
+
+		case RCT_RIDE_STATE: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri == nullptr) break;
+			switch (this->data[0]) {
+				case RIS_OPEN:    ri->OpenRide();  break;
+				case RIS_CLOSED:  ri->CloseRide(); break;
+				case RIS_TESTING:
+					if (ri->GetKind() == RTK_COASTER) static_cast<CoasterInstance *>(ri)->TestRide();
+					break;
+				default: break;
+			}
+			break;
+		}
+
+		case RCT_RIDE_ENTRANCE_EXIT: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri == nullptr) break;
+			if (ri->GetKind() == RTK_GENTLE || ri->GetKind() == RTK_THRILL) {
+				GentleThrillRideInstance *gri = static_cast<GentleThrillRideInstance *>(ri);
+				if (!gri->CanPlaceEntranceOrExit(this->pos, this->data[0] != 0)) break;
+				if (this->data[0] != 0) {
+					gri->SetEntrancePos(this->pos);
+				} else {
+					gri->SetExitPos(this->pos);
+				}
+			} else if (ri->GetKind() == RTK_COASTER) {
+				static_cast<CoasterInstance *>(ri)->PlaceEntranceOrExit(this->pos, this->data[0] != 0, nullptr);
+			}
+			break;
+		}
+
+		case RCT_RIDE_SETTING: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri == nullptr) break;
+			FixedRideInstance *fri = (ri->GetKind() == RTK_GENTLE || ri->GetKind() == RTK_THRILL) ? static_cast<FixedRideInstance *>(ri) : nullptr;
+			CoasterInstance *ci = (ri->GetKind() == RTK_COASTER) ? static_cast<CoasterInstance *>(ri) : nullptr;
+			switch (this->data[0]) {
+				case RRS_WORKING_CYCLES:
+					if (fri != nullptr) fri->working_cycles = this->value;
+					break;
+				case RRS_MIN_IDLE_DURATION:
+					if (fri != nullptr) fri->min_idle_duration = this->value;
+					if (ci != nullptr) ci->min_idle_duration = this->value;
+					break;
+				case RRS_MAX_IDLE_DURATION:
+					if (fri != nullptr) fri->max_idle_duration = this->value;
+					if (ci != nullptr) ci->max_idle_duration = this->value;
+					break;
+				case RRS_MAINTENANCE_INTERVAL:
+					ri->maintenance_interval = this->value;
+					break;
+				case RRS_ENTRANCE_TYPE:
+					if (this->value >= 0 && this->value < static_cast<int64>(_rides_manager.entrances.size())) ri->SetEntranceType(this->value);
+					break;
+				case RRS_EXIT_TYPE:
+					if (this->value >= 0 && this->value < static_cast<int64>(_rides_manager.exits.size())) ri->SetExitType(this->value);
+					break;
+				case RRS_NUMBER_OF_TRAINS:
+					if (ci != nullptr && this->value >= 1) ci->SetNumberOfTrains(this->value);
+					break;
+				case RRS_CARS_PER_TRAIN:
+					if (ci != nullptr && this->value >= 1) ci->SetNumberOfCars(this->value);
+					break;
+				default: break;
+			}
+			break;
+		}
+
+		case RCT_RECOLOUR_RIDE: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri == nullptr || this->data[1] >= MAX_RECOLOUR || this->data[2] >= COL_RANGE_COUNT) break;
+			Recolouring *recolours = nullptr;
+			switch (this->data[0]) {
+				case RRP_RIDE:     recolours = &ri->recolours;          break;
+				case RRP_ENTRANCE: recolours = &ri->entrance_recolours; break;
+				case RRP_EXIT:     recolours = &ri->exit_recolours;     break;
+				default: break;
+			}
+			if (recolours != nullptr) recolours->entries[this->data[1]].dest = static_cast<ColourRange>(this->data[2]);
+			break;
+		}
+
+		case RCT_ITEM_PRICE: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri != nullptr && this->data[0] < NUMBER_ITEM_TYPES_SOLD) ri->item_price[this->data[0]] = this->value;
+			break;
+		}
+
+		case RCT_BUILD_TRACK_PIECE: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri == nullptr || ri->GetKind() != RTK_COASTER) break;
+			CoasterInstance *ci = static_cast<CoasterInstance *>(ri);
+			const CoasterType *ct = ci->GetCoasterType();
+			const int16 design = static_cast<int16>(this->size.x);
+			if (this->value < 0 || this->value >= static_cast<int64>(ct->pieces.size()) || design >= static_cast<int>(ct->designs.size())) break;
+
+			const PositionedTrackPiece placed(this->pos, ct->pieces[this->value]);
+			if (placed.CanBePlaced() != STR_NULL) break;
+			ci->BuildTrackPiece(placed, design, static_cast<TileEdge>(this->data[0]));
+			break;
+		}
+
+		case RCT_REMOVE_TRACK_PIECE: {
+			RideInstance *ri = GetReplayRide(this->instance);
+			if (ri == nullptr || ri->GetKind() != RTK_COASTER) break;
+			CoasterInstance *ci = static_cast<CoasterInstance *>(ri);
+			if (this->value < 0 || this->value >= ci->capacity || ci->pieces[this->value].piece == nullptr) break;
+
+			_finances_manager.PayRideConstruct(ci->pieces[this->value].return_cost);
+			ci->RemovePositionedPiece(ci->pieces[this->value]);
+			break;
+		}
+
+		case RCT_PARK_ENTRANCE_FEE:
+			_game_observer.entrance_fee = this->value;
+			break;
+
+		case RCT_HIRE_STAFF:
+			switch (this->data[0]) {
+				case PERSON_MECHANIC:    _staff.HireMechanic();    break;
+				case PERSON_HANDYMAN:    _staff.HireHandyman();    break;
+				case PERSON_GUARD:       _staff.HireGuard();       break;
+				case PERSON_ENTERTAINER: _staff.HireEntertainer(); break;
+				default: break;
+			}
+			break;
+
+		case RCT_DISMISS_STAFF:
+			if (this->data[0] < PERSON_HANDYMAN || this->data[0] > PERSON_ENTERTAINER) break;
+			if (this->value < 0 || this->value >= _staff.Count(static_cast<PersonType>(this->data[0]))) break;
+			_staff.Dismiss(_staff.Get(static_cast<PersonType>(this->data[0]), this->value));
+			break;
+
+		case RCT_CHANGE_LAND_OWNER:
+			if (this->data[0] < OWN_COUNT) _world.SetTileOwnerRect(this->pos.x, this->pos.y, this->size.x, this->size.y, static_cast<TileOwner>(this->data[0]));
+			break;
+
+		case RCT_PLACE_SCENERY: {
+			const SceneryType *type = _scenery.GetType(this->name);
+			if (type == nullptr) {
+				printf("WARNING: Cannot place unknown scenery type '%s'\n", this->name.c_str());
+				break;
+			}
+			SceneryInstance *item = new SceneryInstance(type);
+			item->orientation = this->data[0] & 3;
+			item->vox_pos = this->pos;
+			_finances_manager.PayLandscaping(type->buy_cost);
+			_scenery.AddItem(item);
+			break;
+		}
+
+		case RCT_REMOVE_SCENERY:
+			if (_scenery.GetItem(this->pos) == nullptr) break;
+			_finances_manager.PayLandscaping(Money(this->value));
+			_scenery.RemoveItem(this->pos);
+			break;
+
+		default: NOT_REACHED();
+	}
+}
+
+Replay::Replay() : record_fp(nullptr), tick(0)
+{
+}
+
+Replay::~Replay()
+{
+	this->StopRecording();
+}
+
+/**
+ * Set the file to record the next started game to.
+ * @param fname Name of the file.
+ */
+void Replay::SetRecordFile(const std::string &fname)
+{
+	this->record_fname = fname;
+}
+
+/** Start recording the player commands of the game that was just started, if requested. */
+void Replay::StartRecording()
+{
+	if (this->record_fname.empty() || this->IsRecording()) return;
+
+	this->record_fp = fopen(this->record_fname.c_str(), "wb");
+	if (this->record_fp == nullptr) {
+		printf("ERROR: Cannot open replay file '%s' for writing\n", this->record_fname.c_str());
+		this->record_fname.clear();
+		return;
+	}
+
+	/* The replay starts with a normal savegame of the starting state. */
+	this->saver.reset(new Saver(this->record_fname.c_str(), this->record_fp));
+	SaveGame(*this->saver);
+
+	this->saver->StartPattern("RPLY", CURRENT_VERSION_RPLY);
+	this->saver->PutByte(_game_control.speed);
+	this->saver->PutLong(Random::GetSeed());
+	this->tick = 0;
+	this->record_fname.clear();  // Only record one game.
+}
+
+/** Stop recording player commands, and finish the replay file. */
+void Replay::StopRecording()
+{
+	if (!this->IsRecording()) return;
+
+	ReplayCommand end(RCT_END);
+	end.tick = this->tick;
+	end.Save(*this->saver);
+	this->saver->EndPattern();
+
+	this->saver.reset();
+	fclose(this->record_fp);
+	this->record_fp = nullptr;
+}
+
+/**
+ * Record a command given by the player, if recording.
+ * @param cmd Command to record.
+ */
+void Replay::Record(ReplayCommand cmd)
+{
+	if (!this->IsRecording() || _game_control.action_test_mode) return;
+
+	cmd.tick = this->tick;
+	cmd.Save(*this->saver);
+}
+
+/**
+ * Play a recorded game without display, and print a hash of the game state after every tick.
+ * @param fname Name of the replay file.
+ * @return Exit code of the program.
+ */
+int Replay::Play(const std::string &fname)
+{
+	FILE *fp = fopen(fname.c_str(), "rb");
+	if (fp == nullptr) {
+		fprintf(stderr, "Cannot open replay file '%s'\n", fname.c_str());
+		return 1;
+	}
+
+	std::vector<ReplayCommand> commands;
+	uint8 speed;
+	try {
+		Loader ldr(fp);
+		LoadGame(ldr);
+
+		const uint32 version = ldr.OpenPattern("RPLY");
+		if (version != CURRENT_VERSION_RPLY) ldr.VersionMismatch(version, CURRENT_VERSION_RPLY);
+		speed = ldr.GetByte();
+		if (speed >= GSP_COUNT) throw LoadingError("Invalid game speed %u", speed);
+		if (ldr.GetLong() != Random::GetSeed()) throw LoadingError("State of the random generator does not match the savegame");
+		do {
+			commands.emplace_back(RCT_END);
+			commands.back().Load(ldr);
+		} while (commands.back().type != RCT_END);
+		ldr.ClosePattern();
+	} catch (const LoadingError &e) {
+		fprintf(stderr, "Loading replay file '%s' failed: %s\n", fname.c_str(), e.what());
+		fclose(fp);
+		return 1;
+	}
+	fclose(fp);
+
+	_max_autosaves = 0;  // Do not overwrite the autosaves of the player.
+	_game_mode_mgr.SetGameMode(GM_PLAY);
+	_game_control.speed = static_cast<GameSpeed>(speed);
+
+	const uint32 last_tick = commands.back().tick;
+	auto cmd = commands.begin();
+	for (this->tick = 0;; OnNewTick(FRAME_DELAY)) {
+		for (; cmd->type != RCT_END && cmd->tick <= this->tick; ++cmd) cmd->Execute();
+		printf("%u %016llx\n", this->tick, ComputeGameStateHash());
+		if (this->tick >= last_tick) break;
+	}
+
+	_game_control.Uninitialize();
+	return 0;
+}
+
+/**
+ * Record the creation of a new ride instance by the player.
+ * @param ri The new ride.
+ */
+void RecordRideCreation(const RideInstance *ri)
+{
+	ReplayCommand cmd(RCT_CREATE_RIDE);
+	cmd.instance = ri->GetIndex();
+	cmd.name = ri->GetRideType()->InternalName();
+	_replay.Record(cmd);
+}
+
+/**
+ * Record the deletion of a ride instance by the player.
+ * @param ri Ride that is about to be deleted.
+ * @param returned Money returned for the ride.
+ */
+void RecordRideDeletion(const RideInstance *ri, const Money &returned)
+{
+	ReplayCommand cmd(RCT_DELETE_RIDE);
+	cmd.instance = ri->GetIndex();
+	cmd.value = returned;
+	_replay.Record(cmd);
+}
+
+/**
+ * Record opening, closing, or testing a ride by the player.
+ * @param ri Ride with its new state.
+ */
+void RecordRideState(const RideInstance *ri)
+{
+	ReplayCommand cmd(RCT_RIDE_STATE);
+	cmd.instance = ri->GetIndex();
+	cmd.data[0] = ri->state;
+	_replay.Record(cmd);
+}
+
+/**
+ * Record a change of a setting of a ride by the player.
+ * @param ri Ride that changed.
+ * @param setting Setting that changed.
+ * @param value New value of the setting.
+ */
+void RecordRideSetting(const RideInstance *ri, ReplayRideSetting setting, int64 value)
+{
+	ReplayCommand cmd(RCT_RIDE_SETTING);
+	cmd.instance = ri->GetIndex();
+	cmd.data[0] = setting;
+	cmd.value = value;
+	_replay.Record(cmd);
+}
+
+/**
+ * Record a change of a colour of a ride by the player.
+ * @param ri Ride with its new colour.
+ * @param part Recolour map that changed.
+ * @param entry Entry of the recolour map that changed.
+ */
+void RecordRecolour(const RideInstance *ri, ReplayRecolourPart part, int entry)
+{
+	const Recolouring &recolours = (part == RRP_RIDE) ? ri->recolours : (part == RRP_ENTRANCE) ? ri->entrance_recolours : ri->exit_recolours;
+	ReplayCommand cmd(RCT_RECOLOUR_RIDE);
+	cmd.instance = ri->GetIndex();
+	cmd.data[0] = part;
+	cmd.data[1] = entry;
+	cmd.data[2] = recolours.entries[entry].dest;
+	_replay.Record(cmd);
+}
+
+/**
+ * Record a change of a price of a ride by the player.
+ * @param ri Ride with its new price.
+ * @param item Index of the changed price in RideInstance::item_price, \c 0 is the entrance fee of a ride.
+ */
+void RecordItemPrice(const RideInstance *ri, int item)
+{
+	ReplayCommand cmd(RCT_ITEM_PRICE);
+	cmd.instance = ri->GetIndex();
+	cmd.data[0] = item;
+	cmd.value = ri->item_price[item];
+	_replay.Record(cmd);
+}
+
+/**
+ * Record the dismissal of a staff member by the player.
+ * @param person Staff member that is about to be dismissed.
+ */
+void RecordStaffDismissal(const StaffMember *person)
+{
+	for (uint i = 0; i < _staff.Count(person->type); i++) {
+		if (_staff.Get(person->type, i) != person) continue;
+
+		ReplayCommand cmd(RCT_DISMISS_STAFF);
+		cmd.data[0] = person->type;
+		cmd.value = i;
+		_replay.Record(cmd);
+		return;
+	}
+}
+
+/** Record a change of the entrance fee of the park by the player. */
+void RecordParkEntranceFee()
+{
+	ReplayCommand cmd(RCT_PARK_ENTRANCE_FEE);
+	cmd.value = _game_observer.entrance_fee;
+	_replay.Record(cmd);
+}
+
+/**
+ * Compute a hash of the game state, to find differences in the behaviour of the game.
+ * @return Hash of the world, the rides, the people, and the finances.
+ */
+uint64 ComputeGameStateHash()
+{
+	static std::vector<uint8> buffer;
+	buffer.clear();
+
+	Saver svr(&buffer);
+	SaveDate(svr);
+	_world.Save(svr);
+	_finances_manager.Save(svr);
+	_rides_manager.Save(svr);
+	_scenery.Save(svr);
+	_guests.Save(svr);
+	_staff.Save(svr);
+	Random::Save(svr);
+
+	/* 64 bit FNV-1a hash. */
+	uint64 hash = 0xcbf29ce484222325ULL;
+	for (uint8 b : buffer) {
+		hash ^= b;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
@@ -0,0 +1,164 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file replay.h Recording and replaying of player commands. */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "geometry.h"
+
+#include <memory>
+#include <string>
+
+class Loader;
+class Money;
+class RideInstance;
+class Saver;
+class StaffMember;
+
+/** Player commands that change the game state. */
+enum ReplayCommandType {
+	RCT_END,                  ///< End of the recorded commands.
+	RCT_GAME_SPEED,           ///< Change the speed of the game.
+	RCT_TERRAFORM_TILE,       ///< Change the terrain of a tile (or the entire world in dot mode).
+	RCT_TERRAFORM_AREA,       ///< Change the terrain of an area.
+	RCT_BUILD_UPWARD_PATH,    ///< Build a path going up.
+	RCT_BUILD_FLAT_PATH,      ///< Build a flat path.
+	RCT_BUILD_DOWNWARD_PATH,  ///< Build a path going down.
+	RCT_REMOVE_PATH,          ///< Remove a path.
+	RCT_CHANGE_PATH,          ///< Change the type or status of a path.
+	RCT_CREATE_RIDE,          ///< Create a new ride instance, before building it.
+	RCT_BUILD_FIXED_RIDE,     ///< Build a shop, gentle ride, or thrill ride.
+	RCT_DELETE_RIDE,          ///< Delete a ride instance.
+	RCT_RIDE_STATE,           ///< Open, close, or test a ride.
+	RCT_RIDE_ENTRANCE_EXIT,   ///< Place the entrance or exit of a ride.
+	RCT_RIDE_SETTING,         ///< Change a setting of a ride.
+	RCT_RECOLOUR_RIDE,        ///< Change a colour of a ride.
+	RCT_ITEM_PRICE,           ///< Change the price of an item sold by a ride, or its entrance fee.
+	RCT_BUILD_TRACK_PIECE,    ///< Build a track piece or a track design of a coaster.
+	RCT_REMOVE_TRACK_PIECE,   ///< Remove a track piece of a coaster.
+	RCT_PARK_ENTRANCE_FEE,    ///< Change the entrance fee of the park.
+	RCT_HIRE_STAFF,           ///< Hire a staff member.
+	RCT_DISMISS_STAFF,        ///< Dismiss a staff member.
+	RCT_CHANGE_LAND_OWNER,    ///< Change the owner of an area of land.
+	RCT_PLACE_SCENERY,        ///< Place a scenery item.
+	RCT_REMOVE_SCENERY,       ///< Remove a scenery item.
+
+	RCT_COUNT,                ///< Number of command types.
+};
+
+/** Settings of a ride that are changed with a #RCT_RIDE_SETTING command. */
+enum ReplayRideSetting {
+	RRS_WORKING_CYCLES,       ///< Number of working cycles of a gentle or thrill ride.
+	RRS_MIN_IDLE_DURATION,    ///< Minimum idle duration.
+	RRS_MAX_IDLE_DURATION,    ///< Maximum idle duration.
+	RRS_MAINTENANCE_INTERVAL, ///< Interval between maintenance operations.
+	RRS_ENTRANCE_TYPE,        ///< Type of the entrance.
+	RRS_EXIT_TYPE,            ///< Type of the exit.
+	RRS_NUMBER_OF_TRAINS,     ///< Number of trains of a coaster.
+	RRS_CARS_PER_TRAIN,       ///< Number of cars of a coaster train.
+};
+
+/** Recolour maps of a ride that are changed with a #RCT_RECOLOUR_RIDE command. */
+enum ReplayRecolourPart {
+	RRP_RIDE,     ///< Recolouring of the ride itself.
+	RRP_ENTRANCE, ///< Recolouring of the entrance.
+	RRP_EXIT,     ///< Recolouring of the exit.
+};
+
+/**
+ * A player command that changes the game state.
+ * The meaning of the fields depends on the #type of the command:
+ * - #RCT_GAME_SPEED: \c data[0] is the new speed.
+ * - #RCT_TERRAFORM_TILE: #pos is the tile, \c data[0] the cursor type, \c data[1] whether levelling, \c data[2] whether in dot mode, #value the direction.
+ * - #RCT_TERRAFORM_AREA: #pos and #size are the area, \c data[1] whether levelling, #value the direction.
+ * - Building a path: #pos is the voxel, \c data[0] the entry edge, \c data[1] the path type, \c data[2] the path status, \c data[3] whether to pay.
+ * - #RCT_REMOVE_PATH: #pos is the voxel, \c data[3] whether to pay.
+ * - #RCT_CREATE_RIDE: #name is the ride type, #instance the new ride.
+ * - #RCT_BUILD_FIXED_RIDE: #instance is the ride, #pos the base voxel, \c data[0] the orientation.
+ * - #RCT_DELETE_RIDE: #instance is the ride, #value the money returned for it.
+ * - #RCT_RIDE_STATE: #instance is the ride, \c data[0] the new #RideInstanceState (open, closed, or testing).
+ * - #RCT_RIDE_ENTRANCE_EXIT: #instance is the ride, #pos the voxel, \c data[0] whether it is the entrance.
+ * - #RCT_RIDE_SETTING: #instance is the ride, \c data[0] the #ReplayRideSetting, #value the new value.
+ * - #RCT_RECOLOUR_RIDE: #instance is the ride, \c data[0] the #ReplayRecolourPart, \c data[1] the recolour entry, \c data[2] the new colour.
+ * - #RCT_ITEM_PRICE: #instance is the ride, \c data[0] the item index (\c 0 is the entrance fee of a ride), #value the new price.
+ * - #RCT_BUILD_TRACK_PIECE: #instance is the coaster, #pos the base voxel, #value the index of the track piece,
+ *   \c data[0] the build direction, \c size.x the index of the built design (\c 0xFFFF for a single piece).
+ * - #RCT_REMOVE_TRACK_PIECE: #instance is the coaster, #value the index of the positioned track piece.
+ * - #RCT_PARK_ENTRANCE_FEE: #value is the new fee.
+ * - #RCT_HIRE_STAFF: \c data[0] is the type of staff.
+ * - #RCT_DISMISS_STAFF: \c data[0] is the type of staff, #value the index in the staff list.
+ * - #RCT_CHANGE_LAND_OWNER: #pos and #size are the area, \c data[0] the new owner.
+ * - #RCT_PLACE_SCENERY: #name is the scenery type, #pos the base voxel, \c data[0] the orientation.
+ * - #RCT_REMOVE_SCENERY: #pos is the base voxel of the item, #value the money returned for it.
+ */
+struct ReplayCommand {
+	explicit ReplayCommand(ReplayCommandType type);
+
+	void Load(Loader &ldr);
+	void Save(Saver &svr) const;
+	void Execute() const;
+
+	ReplayCommandType type; ///< Type of the command.
+	uint32 tick;            ///< Game tick at which the command was given.
+	XYZPoint16 pos;         ///< Voxel or tile the command applies to.
+	Point16 size;           ///< Size of the area the command applies to.
+	uint16 instance;        ///< Ride instance the command applies to.
+	uint8 data[4];          ///< Small command parameters.
+	int64 value;            ///< Larger command parameter, for example an amount of money.
+	std::string name;       ///< Name parameter of the command.
+};
+
+/** Records the player commands of a game, and plays them back. */
+class Replay {
+public:
+	Replay();
+	~Replay();
+
+	void SetRecordFile(const std::string &fname);
+	void StartRecording();
+	void StopRecording();
+	void Record(ReplayCommand cmd);
+
+	/**
+	 * Whether player commands are being recorded.
+	 * @return Commands are being recorded.
+	 */
+	inline bool IsRecording() const
+	{
+		return this->saver != nullptr;
+	}
+
+	/** A game tick has passed. */
+	inline void OnTick()
+	{
+		this->tick++;
+	}
+
+	int Play(const std::string &fname);
+
+private:
+	std::string record_fname;      ///< File to record the next game to, empty if nothing should be recorded.
+	FILE *record_fp;               ///< File being recorded to, if any.
+	std::unique_ptr<Saver> saver;  ///< Writes the commands to #record_fp while recording.
+	uint32 tick;                   ///< Number of game ticks since recording or playing started.
+};
+
+void RecordRideCreation(const RideInstance *ri);
+void RecordRideDeletion(const RideInstance *ri, const Money &returned);
+void RecordRideState(const RideInstance *ri);
+void RecordRideSetting(const RideInstance *ri, ReplayRideSetting setting, int64 value);
+void RecordRecolour(const RideInstance *ri, ReplayRecolourPart part, int entry);
+void RecordItemPrice(const RideInstance *ri, int item);
+void RecordStaffDismissal(const StaffMember *person);
+void RecordParkEntranceFee();
+uint64 ComputeGameStateHash();
+
+extern Replay _replay;
+
+#endif
@@ -15,6 +15,7 @@
 #include "mouse_mode.h"
 #include "gamecontrol.h"
 #include "finances.h"
+#include "replay.h"
 
 #include "gui_sprites.h"
 
@@ -124,7 +125,10 @@ RideBuildWindow::RideBuildWindow(FixedRideInstance *ri)
 RideBuildWindow::~RideBuildWindow()
 {
 	this->SetSelector(nullptr);
-	if (this->instance != nullptr) _rides_manager.DeleteInstance(this->instance->GetIndex());
+	if (this->instance != nullptr) {
+		RecordRideDeletion(this->instance, Money(0));
+		_rides_manager.DeleteInstance(this->instance->GetIndex());
+	}
 }
 
 void RideBuildWindow::SetWidgetStringParameters(WidgetNumber wid_num) const
@@ -394,17 +398,11 @@ void RideBuildWindow::SelectorMouseButtonEvent(MouseButtons state)
 		this->build_forbidden_reason.ShowErrorMessage();
 		return;
 	}
-	const Money build_cost = this->instance->ComputeBuildCost();
-	if (!BestErrorMessageReason::CheckActionAllowed(BestErrorMessageReason::ACT_BUILD, build_cost)) return;
+	if (!this->instance->BuildRide()) return;
 
 	const SmallRideInstance inst_number = static_cast<SmallRideInstance>(this->instance->GetIndex());
 	const RideTypeKind kind = this->instance->GetKind();
 
-	_rides_manager.NewInstanceAdded(inst_number);
-	AddRemovePathEdges(this->instance->vox_pos, PATH_EMPTY, this->instance->GetEntranceDirections(this->instance->vox_pos), PAS_QUEUE_PATH);
-	_finances_manager.PayRideConstruct(build_cost);
-	_window_manager.GetViewport()->AddFloatawayMoneyAmount(build_cost, this->instance->vox_pos);
-
 	this->instance = nullptr;  // Delete this window.
 	delete this;
 
@@ -16,6 +16,7 @@
 #include "viewport.h"
 #include "map.h"
 #include "coaster.h"
+#include "replay.h"
 
 #include "gui_sprites.h"
 
@@ -271,6 +272,7 @@ void RideSelectGui::OnClick(WidgetNumber wid_num, const Point16 &pos)
 				if (instance == INVALID_RIDE_INSTANCE) return;
 
 				RideInstance *ri = _rides_manager.CreateInstance(ride_type, instance);
+				RecordRideCreation(ri);
 				assert(this->current_kind == ride_type->kind);
 				switch (ride_type->kind) {
 					case RTK_SHOP:
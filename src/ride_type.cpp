@@ -683,6 +683,8 @@ void RidesManager::OnAnimate(int delay)
 	for (auto &pair : this->instances) {
 		if (pair.second->state == RIS_ALLOCATED) continue;
 		pair.second->OnAnimate(delay);
+		/* The timers of a ride change every tick. Changes by the player between two ticks are caught here as well. */
+		this->change_stamp++;
 	}
 }
 
@@ -750,6 +752,7 @@ void RidesManager::Load(Loader &ldr)
 		ldr.VersionMismatch(version, CURRENT_VERSION_RIDS);
 	}
 	ldr.ClosePattern();
+	this->change_stamp++;
 }
 
 void RidesManager::Save(Saver &svr)
@@ -924,6 +927,7 @@ void RidesManager::NewInstanceAdded(uint16 num)
 	const RideType *rt = ri->GetRideType();
 	assert(ri->state == RIS_ALLOCATED);
 	ri->InsertIntoWorld();
+	this->change_stamp++;
 
 	/* Find a new name for the instance. */
 	const StringID *names = rt->GetInstanceNames();
@@ -990,6 +994,7 @@ void RidesManager::DeleteInstance(uint16 num)
 
 	it->second->RemoveFromWorld();
 	this->instances.erase(it);  // Deletes the instance.
+	this->change_stamp++;
 }
 
 void RidesManager::DeleteAllRideInstances()
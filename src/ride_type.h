@@ -274,6 +274,16 @@ public:
 	void OnNewMonth();
 	void OnNewDay();
 
+	/**
+	 * Get the stamp of the latest change of the saved data of the rides.
+	 * Only rides that are not #RIS_ALLOCATED are saved, and those change with every tick.
+	 * @return Stamp of the latest change.
+	 */
+	inline uint32 GetChangeStamp() const
+	{
+		return this->change_stamp;
+	}
+
 	void Load(Loader &ldr);
 	void Save(Saver &svr);
 	void LoadDesigns();
@@ -298,6 +308,9 @@ public:
 	std::map<uint16, std::unique_ptr<RideInstance>> instances;           ///< Rides available in the park.
 	std::vector<std::unique_ptr<const RideEntranceExitType>> entrances;  ///< Available ride entrance types.
 	std::vector<std::unique_ptr<const RideEntranceExitType>> exits;      ///< Available ride exit types.
+
+private:
+	uint32 change_stamp = 0;  ///< Stamp of the latest change of the saved data. @see GetChangeStamp
 };
 
 RideInstance *RideExistsAtBottom(XYZPoint16 pos, TileEdge edge);
@@ -102,6 +102,7 @@ PathObjectInstance::~PathObjectInstance()
 /** Recompute at which of the path edges this item should exist. */
 void PathObjectInstance::RecomputeExistenceState()
 {
+	_scenery.MarkChanged();
 	const Voxel *voxel = _world.GetVoxel(this->vox_pos);
 	if (voxel == nullptr || !HasValidPath(voxel)) {
 		/* The path was deleted under the object. Delete it now. */
@@ -296,6 +297,7 @@ void PathObjectInstance::SetExistsOnTileEdge(TileEdge e, bool b)
 {
 	if (!b && this->type == &PathObjectType::BENCH) this->RemoveGuestsFromBench(e);
 	SB(this->state, e, 1, b ? 1 : 0);
+	_scenery.MarkChanged();
 }
 
 /**
@@ -317,6 +319,7 @@ void PathObjectInstance::SetDemolishedOnTileEdge(TileEdge e, bool d)
 {
 	if (d && this->type == &PathObjectType::BENCH) this->RemoveGuestsFromBench(e);
 	SB(this->state, e + 4, 1, d ? 1 : 0);
+	_scenery.MarkChanged();
 }
 
 /**
@@ -371,6 +374,7 @@ uint16 PathObjectInstance::GetRightGuest(TileEdge e) const
  */
 void PathObjectInstance::AddItemToBin(TileEdge e) {
 	this->data[e]++;
+	_scenery.MarkChanged();
 }
 
 /**
@@ -380,6 +384,7 @@ void PathObjectInstance::AddItemToBin(TileEdge e) {
  */
 void PathObjectInstance::EmptyBin(TileEdge e) {
 	this->data[e] = 0;
+	_scenery.MarkChanged();
 }
 
 /**
@@ -391,6 +396,7 @@ void PathObjectInstance::EmptyBin(TileEdge e) {
 void PathObjectInstance::SetLeftGuest(TileEdge e, uint16 id) {
 	this->data[e] &= 0xFFFF0000;
 	this->data[e] |= id;
+	_scenery.MarkChanged();
 }
 
 /**
@@ -402,6 +408,7 @@ void PathObjectInstance::SetLeftGuest(TileEdge e, uint16 id) {
 void PathObjectInstance::SetRightGuest(TileEdge e, uint16 id) {
 	this->data[e] &= 0x0000FFFF;
 	this->data[e] |= (id << 16);
+	_scenery.MarkChanged();
 }
 
 
@@ -507,6 +514,7 @@ SceneryInstance::SceneryInstance(const SceneryType *t)
 	vox_pos(XYZPoint16::invalid()),
 	orientation(0),
 	animtime(0),
+	anim_phase(NO_CLOCK_ANIMATION),
 	time_since_watered(0)
 {
 }
@@ -591,10 +599,12 @@ void SceneryInstance::InsertIntoWorld()
 				 */
 				voxel->SetInstanceData(h == 0 ? voxel_data : INVALID_VOXEL_DATA);
 			}
+			_world.MarkStackDirty(this->vox_pos.x + location.x, this->vox_pos.y + location.y);
 		}
 	}
 	this->time_since_watered = 0;
 	this->animtime = 0;
+	if (this->anim_phase != NO_CLOCK_ANIMATION) this->SetClockAnimation(0);
 }
 
 /** Remove this item from the voxels it currently occupies. */
@@ -619,6 +629,7 @@ void SceneryInstance::RemoveFromWorld()
 					voxel->ClearInstances();
 				}
 			}
+			_world.MarkStackDirty(this->vox_pos.x + unrotated_pos.x, this->vox_pos.y + unrotated_pos.y);
 		}
 	}
 }
@@ -642,11 +653,12 @@ void SceneryInstance::GetSprites(const XYZPoint16 &vox, const uint16 voxel_numbe
 	if (voxel_number == INVALID_VOXEL_DATA) return;
 	const XYZPoint16 unrotated_pos = UnorientatedOffset(this->orientation, vox.x - this->vox_pos.x, vox.y - this->vox_pos.y);
 	const TimedAnimation *anim = (this->IsDry() ? this->type->dry_animation : this->type->main_animation);
-	sprites[1] = anim->views[anim->GetFrame(this->animtime, true)]->GetSprite(unrotated_pos.x, unrotated_pos.y, (this->orientation + 4 - orient) & 3, zoom);
+	sprites[1] = anim->views[anim->GetFrame(this->GetAnimationTime(), true)]->GetSprite(unrotated_pos.x, unrotated_pos.y, (this->orientation + 4 - orient) & 3, zoom);
 }
 
 /**
  * Some time has passed, update this item's animation.
+ * Only called for items that do not follow the animation clock.
  * @param delay Number of milliseconds that passed.
  */
 void SceneryInstance::OnAnimate(const int delay)
@@ -657,6 +669,30 @@ void SceneryInstance::OnAnimate(const int delay)
 	this->animtime %= anim->GetTotalDuration();
 }
 
+/**
+ * Get the current time in the animation of this item.
+ * @return Time in the animation, in milliseconds.
+ */
+uint32 SceneryInstance::GetAnimationTime() const
+{
+	if (this->anim_phase == NO_CLOCK_ANIMATION) return this->animtime;
+
+	const uint32 duration = this->type->main_animation->GetTotalDuration();
+	return (_scenery.GetAnimationClock() % duration + duration - this->anim_phase) % duration;
+}
+
+/**
+ * Let the animation of this item follow the animation clock of the scenery manager, instead of updating it every frame.
+ * Only possible for items without a changing animation, that is items that do not need watering.
+ * @param time Current time in the animation, in milliseconds.
+ */
+void SceneryInstance::SetClockAnimation(uint32 time)
+{
+	assert(this->type->watering_interval == 0);
+	const uint32 duration = this->type->main_animation->GetTotalDuration();
+	this->anim_phase = (_scenery.GetAnimationClock() % duration + duration - time % duration) % duration;
+}
+
 /**
  * Whether this item is dried up for lack of watering.
  * @return The item is dry.
@@ -687,6 +723,7 @@ void SceneryInstance::Load(Loader &ldr)
 	this->vox_pos.z = ldr.GetWord();
 	this->orientation = ldr.GetByte();
 	this->animtime = ldr.GetLong();
+	this->anim_phase = NO_CLOCK_ANIMATION;
 	this->time_since_watered = ldr.GetLong();
 	ldr.ClosePattern();
 }
@@ -698,14 +735,15 @@ void SceneryInstance::Save(Saver &svr) const
 	svr.PutWord(this->vox_pos.y);
 	svr.PutWord(this->vox_pos.z);
 	svr.PutByte(this->orientation);
-	svr.PutLong(this->animtime);
+	svr.PutLong(this->GetAnimationTime());
 	svr.PutLong(this->time_since_watered);
 	svr.EndPattern();
 }
 
 /** Default constructor. */
-SceneryManager::SceneryManager() : temp_item(nullptr), temp_path_object(nullptr)
+SceneryManager::SceneryManager() : temp_item(nullptr), temp_path_object(nullptr), anim_clock(0), change_stamp(0)
 {
+	std::fill_n(this->litter_grid, lengthof(this->litter_grid), 0);
 }
 
 /**
@@ -778,10 +816,12 @@ void SceneryManager::Clear()
 {
 	this->temp_item = nullptr;
 	this->temp_path_object = nullptr;
-	while (!this->all_items.empty()) this->RemoveItem(this->all_items.begin()->first);
-	/* Do not use std::map::clear(), it may result in a heap-use-after-free. */
+	while (!this->all_items.empty()) this->RemoveItem(XYZPoint16(this->all_items.begin()->second->vox_pos));
+	/* Do not use std::unordered_map::clear(), it may result in a heap-use-after-free. */
 	while (!this->litter_and_vomit.empty()) this->litter_and_vomit.erase(this->litter_and_vomit.begin());
 	while (!this->all_path_objects.empty()) this->all_path_objects.erase(this->all_path_objects.begin());
+	std::fill_n(this->litter_grid, lengthof(this->litter_grid), 0);
+	this->MarkChanged();
 }
 
 /**
@@ -790,7 +830,24 @@ void SceneryManager::Clear()
  */
 void SceneryManager::OnAnimate(const int delay)
 {
-	for (auto &pair : this->all_items) pair.second->OnAnimate(delay);
+	/* Most items only have an animation, their frame is derived from the clock when drawing them. */
+	this->anim_clock += delay;
+	for (auto &pair : this->watered_items) pair.second->OnAnimate(delay);
+	/* The saved animation times of the items change with the clock. */
+	if (!this->all_items.empty()) this->MarkChanged();
+}
+
+/**
+ * Start updating the animation and timers of an item of #all_items.
+ * @param item Item to update.
+ */
+void SceneryManager::StartAnimating(SceneryInstance *item)
+{
+	if (item->type->watering_interval > 0) {
+		this->watered_items[GetVoxelKey(item->vox_pos)] = item;
+	} else {
+		item->SetClockAnimation(item->animtime);
+	}
 }
 
 /**
@@ -801,9 +858,12 @@ void SceneryManager::OnAnimate(const int delay)
  */
 void SceneryManager::AddItem(SceneryInstance *item)
 {
-	assert(this->all_items.count(item->vox_pos) == 0);
-	this->all_items[item->vox_pos] = std::unique_ptr<SceneryInstance>(item);
+	const uint32 key = GetVoxelKey(item->vox_pos);
+	assert(this->all_items.count(key) == 0);
+	this->all_items[key] = std::unique_ptr<SceneryInstance>(item);
 	item->InsertIntoWorld();
+	this->StartAnimating(item);
+	this->MarkChanged();
 }
 
 /**
@@ -812,9 +872,12 @@ void SceneryManager::AddItem(SceneryInstance *item)
  */
 void SceneryManager::RemoveItem(const XYZPoint16 &pos)
 {
-	auto it = this->all_items.find(pos);
+	const uint32 key = GetVoxelKey(pos);
+	auto it = this->all_items.find(key);
 	assert(it != this->all_items.end());
+	this->watered_items.erase(key);
 	this->all_items.erase(it);  // This deletes the instance.
+	this->MarkChanged();
 }
 
 /**
@@ -823,7 +886,28 @@ void SceneryManager::RemoveItem(const XYZPoint16 &pos)
  */
 uint SceneryManager::CountLitterAndVomit(const XYZPoint16 &pos) const
 {
-	return this->litter_and_vomit.count(pos);
+	const auto it = this->litter_and_vomit.find(GetVoxelKey(pos));
+	return it == this->litter_and_vomit.end() ? 0 : it->second.size();
+}
+
+/**
+ * Quickly check whether there may be litter or vomit near a voxel.
+ * @param pos Coordinate of the voxel.
+ * @param radius Maximal horizontal distance to the litter or vomit, in voxels.
+ * @return Whether litter or vomit exists near the voxel. It may also be a bit further away than \a radius.
+ */
+bool SceneryManager::HasLitterAndVomitNearby(const XYZPoint16 &pos, int radius) const
+{
+	const int first_x = std::max(0, pos.x - radius) / LITTER_GRID_CELL_SIZE;
+	const int last_x = std::min(WORLD_X_SIZE - 1, pos.x + radius) / LITTER_GRID_CELL_SIZE;
+	const int first_y = std::max(0, pos.y - radius) / LITTER_GRID_CELL_SIZE;
+	const int last_y = std::min(WORLD_Y_SIZE - 1, pos.y + radius) / LITTER_GRID_CELL_SIZE;
+	for (int x = first_x; x <= last_x; x++) {
+		for (int y = first_y; y <= last_y; y++) {
+			if (this->litter_grid[x * LITTER_GRID_Y_SIZE + y] > 0) return true;
+		}
+	}
+	return false;
 }
 
 /**
@@ -832,7 +916,7 @@ uint SceneryManager::CountLitterAndVomit(const XYZPoint16 &pos) const
  */
 uint8 SceneryManager::CountDemolishedItems(const XYZPoint16 &pos) const
 {
-	const auto it = this->all_path_objects.find(pos);
+	const auto it = this->all_path_objects.find(GetVoxelKey(pos));
 	if (it == this->all_path_objects.end()) return 0;
 
 	uint8 result = 0;
@@ -852,10 +936,11 @@ uint8 SceneryManager::CountDemolishedItems(const XYZPoint16 &pos) const
 void SceneryManager::SetPathObjectInstance(const XYZPoint16 &pos, const PathObjectType *type)
 {
 	if (type == nullptr) {
-		this->all_path_objects.erase(pos);
+		this->all_path_objects.erase(GetVoxelKey(pos));
 	} else {
-		this->all_path_objects[pos].reset(new PathObjectInstance(type, pos, XYZPoint16(/* Offset is ignored for user-placeable types. */)));
+		this->all_path_objects[GetVoxelKey(pos)].reset(new PathObjectInstance(type, pos, XYZPoint16(/* Offset is ignored for user-placeable types. */)));
 	}
+	this->MarkChanged();
 }
 
 /**
@@ -865,7 +950,7 @@ void SceneryManager::SetPathObjectInstance(const XYZPoint16 &pos, const PathObje
  */
 PathObjectInstance *SceneryManager::GetPathObject(const XYZPoint16 &pos)
 {
-	auto it = this->all_path_objects.find(pos);
+	auto it = this->all_path_objects.find(GetVoxelKey(pos));
 	return it == this->all_path_objects.end() ? nullptr : it->second.get();
 }
 
@@ -876,7 +961,9 @@ PathObjectInstance *SceneryManager::GetPathObject(const XYZPoint16 &pos)
  */
 void SceneryManager::AddLitter(const XYZPoint16 &pos, const XYZPoint16 &offset)
 {
-	this->litter_and_vomit.emplace(pos, std::unique_ptr<PathObjectInstance>(new PathObjectInstance(&PathObjectType::LITTER, pos, offset)));
+	this->litter_and_vomit[GetVoxelKey(pos)].emplace_back(new PathObjectInstance(&PathObjectType::LITTER, pos, offset));
+	this->GetLitterGridCell(pos)++;
+	this->MarkChanged();
 }
 
 /**
@@ -886,7 +973,9 @@ void SceneryManager::AddLitter(const XYZPoint16 &pos, const XYZPoint16 &offset)
  */
 void SceneryManager::AddVomit(const XYZPoint16 &pos, const XYZPoint16 &offset)
 {
-	this->litter_and_vomit.emplace(pos, std::unique_ptr<PathObjectInstance>(new PathObjectInstance(&PathObjectType::VOMIT, pos, offset)));
+	this->litter_and_vomit[GetVoxelKey(pos)].emplace_back(new PathObjectInstance(&PathObjectType::VOMIT, pos, offset));
+	this->GetLitterGridCell(pos)++;
+	this->MarkChanged();
 }
 
 /**
@@ -895,7 +984,12 @@ void SceneryManager::AddVomit(const XYZPoint16 &pos, const XYZPoint16 &offset)
  */
 void SceneryManager::RemoveLitterAndVomit(const XYZPoint16 &pos)
 {
-	this->litter_and_vomit.erase(pos);
+	auto it = this->litter_and_vomit.find(GetVoxelKey(pos));
+	if (it == this->litter_and_vomit.end()) return;
+
+	this->GetLitterGridCell(pos) -= it->second.size();
+	this->litter_and_vomit.erase(it);
+	this->MarkChanged();
 }
 
 /**
@@ -909,15 +1003,17 @@ std::vector<PathObjectInstance::PathObjectSprite> SceneryManager::DrawPathObject
 {
 	std::vector<PathObjectInstance::PathObjectSprite> result;
 
-	for (const auto &pair : this->litter_and_vomit) {
-		if (pair.first == pos) {
-			for (const PathObjectInstance::PathObjectSprite &image : pair.second->GetSprites(orientation, zoom)) {
+	const uint32 key = GetVoxelKey(pos);
+	const auto litter = this->litter_and_vomit.find(key);
+	if (litter != this->litter_and_vomit.end()) {
+		for (const auto &instance : litter->second) {
+			for (const PathObjectInstance::PathObjectSprite &image : instance->GetSprites(orientation, zoom)) {
 				result.push_back(image);
 			}
 		}
 	}
 
-	auto it = this->all_path_objects.find(pos);
+	auto it = this->all_path_objects.find(key);
 	if (it != this->all_path_objects.end()) {
 		for (const PathObjectInstance::PathObjectSprite &image : it->second->GetSprites(orientation, zoom)) {
 			result.push_back(image);
@@ -941,7 +1037,7 @@ std::vector<PathObjectInstance::PathObjectSprite> SceneryManager::DrawPathObject
  */
 SceneryInstance *SceneryManager::GetItem(const XYZPoint16 &pos)
 {
-	auto it = this->all_items.find(pos);
+	auto it = this->all_items.find(GetVoxelKey(pos));
 	if (it != this->all_items.end()) return it->second.get();
 	if (this->temp_item != nullptr && this->temp_item->vox_pos == pos) return this->temp_item;
 
@@ -955,7 +1051,7 @@ SceneryInstance *SceneryManager::GetItem(const XYZPoint16 &pos)
 	for (int x = -search_radius; x <= search_radius; x++) {
 		for (int y = -search_radius; y <= search_radius; y++) {
 			const XYZPoint16 p(pos.x + x, pos.y + y, pos.z);
-			it = this->all_items.find(p);
+			it = IsVoxelstackInsideWorld(p.x, p.y) ? this->all_items.find(GetVoxelKey(p)) : this->all_items.end();
 			SceneryInstance *candidate;
 			if (it == this->all_items.end()) {
 				if (this->temp_item != nullptr && this->temp_item->vox_pos == p) {
@@ -996,7 +1092,8 @@ void SceneryManager::Load(Loader &ldr)
 			for (long l = ldr.GetLong(); l > 0; l--) {
 				SceneryInstance *i = new SceneryInstance(version >= 3 ? this->GetType(ldr.GetText()) : this->scenery_item_types[ldr.GetWord()].get());
 				i->Load(ldr);
-				this->all_items[i->vox_pos] = std::unique_ptr<SceneryInstance>(i);
+				this->all_items[GetVoxelKey(i->vox_pos)] = std::unique_ptr<SceneryInstance>(i);
+				this->StartAnimating(i);
 			}
 			if (version > 1) {
 				for (long l = ldr.GetLong(); l > 0; l--) {
@@ -1006,7 +1103,7 @@ void SceneryManager::Load(Loader &ldr)
 					pos.z = ldr.GetWord();
 					PathObjectInstance *i = new PathObjectInstance(PathObjectType::Get(ldr.GetByte()), pos, pos /* will be overwritten by #Load() */);
 					i->Load(ldr);
-					this->all_path_objects[pos] = std::unique_ptr<PathObjectInstance>(i);
+					this->all_path_objects[GetVoxelKey(pos)] = std::unique_ptr<PathObjectInstance>(i);
 				}
 				for (long l = ldr.GetLong(); l > 0; l--) {
 					XYZPoint16 pos;
@@ -1015,7 +1112,8 @@ void SceneryManager::Load(Loader &ldr)
 					pos.z = ldr.GetWord();
 					PathObjectInstance *i = new PathObjectInstance(PathObjectType::Get(ldr.GetByte()), pos, pos);
 					i->Load(ldr);
-					this->litter_and_vomit.emplace(pos, std::unique_ptr<PathObjectInstance>(i));
+					this->litter_and_vomit[GetVoxelKey(pos)].emplace_back(i);
+					this->GetLitterGridCell(pos)++;
 				}
 			}
 			break;
@@ -1026,33 +1124,56 @@ void SceneryManager::Load(Loader &ldr)
 	ldr.ClosePattern();
 }
 
+/**
+ * Get the keys of a hashed voxel container in the order of their voxels, to save the container deterministically.
+ * @param items Container to sort.
+ * @return The sorted keys of the container.
+ */
+template <typename T>
+static std::vector<uint32> GetSortedKeys(const std::unordered_map<uint32, T> &items)
+{
+	std::vector<uint32> keys;
+	keys.reserve(items.size());
+	for (const auto &pair : items) keys.push_back(pair.first);
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+
+/**
+ * Save a path object with its position.
+ * @param svr Output stream to save to.
+ * @param instance Path object to save.
+ */
+static void SavePathObject(Saver &svr, const PathObjectInstance &instance)
+{
+	svr.PutWord(instance.vox_pos.x);
+	svr.PutWord(instance.vox_pos.y);
+	svr.PutWord(instance.vox_pos.z);
+	svr.PutByte(instance.type->type_id);
+	instance.Save(svr);
+}
+
 void SceneryManager::Save(Saver &svr) const
 {
 	svr.CheckNoOpenPattern();
 	svr.StartPattern("SCNY", CURRENT_VERSION_SceneryInstance_SCNY);
 
 	svr.PutLong(this->all_items.size());
-	for (const auto &pair : this->all_items) {
-		svr.PutText(pair.second->type->internal_name);
-		pair.second->Save(svr);
+	for (uint32 key : GetSortedKeys(this->all_items)) {
+		const SceneryInstance *instance = this->all_items.at(key).get();
+		svr.PutText(instance->type->internal_name);
+		instance->Save(svr);
 	}
 
 	svr.PutLong(this->all_path_objects.size());
-	for (const auto &pair : this->all_path_objects) {
-		svr.PutWord(pair.first.x);
-		svr.PutWord(pair.first.y);
-		svr.PutWord(pair.first.z);
-		svr.PutByte(pair.second->type->type_id);
-		pair.second->Save(svr);
-	}
-
-	svr.PutLong(this->litter_and_vomit.size());
-	for (const auto &pair : this->litter_and_vomit) {
-		svr.PutWord(pair.first.x);
-		svr.PutWord(pair.first.y);
-		svr.PutWord(pair.first.z);
-		svr.PutByte(pair.second->type->type_id);
-		pair.second->Save(svr);
+	for (uint32 key : GetSortedKeys(this->all_path_objects)) SavePathObject(svr, *this->all_path_objects.at(key));
+
+	const std::vector<uint32> litter_keys = GetSortedKeys(this->litter_and_vomit);
+	uint32 litter_count = 0;
+	for (uint32 key : litter_keys) litter_count += this->litter_and_vomit.at(key).size();
+	svr.PutLong(litter_count);
+	for (uint32 key : litter_keys) {
+		for (const auto &instance : this->litter_and_vomit.at(key)) SavePathObject(svr, *instance);
 	}
 
 	svr.EndPattern();
@@ -12,6 +12,7 @@
 
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "stdafx.h"
@@ -78,6 +79,8 @@ public:
 	StringID CanPlace() const;
 	void GetSprites(const XYZPoint16 &vox, uint16 voxel_number, uint8 orient, int zoom, const ImageData *sprites[4], uint8 *platform) const;
 	void OnAnimate(int delay);
+	uint32 GetAnimationTime() const;
+	void SetClockAnimation(uint32 time);
 	bool IsDry() const;
 	bool ShouldBeWatered() const;
 
@@ -90,8 +93,11 @@ public:
 	const SceneryType *type;   ///< Type of item.
 	XYZPoint16 vox_pos;        ///< Position of the item's base voxel.
 	uint8 orientation;         ///< Orientation of the item.
-	uint32 animtime;           ///< Time in the animation, in milliseconds.
+	uint32 animtime;           ///< Time in the animation, in milliseconds. Not used if the item follows the animation clock, see #anim_phase.
+	uint32 anim_phase;         ///< Animation clock of the scenery manager at the start of the animation, modulo the animation length. #NO_CLOCK_ANIMATION if the item does not follow the clock.
 	uint32 time_since_watered; ///< Time since the item was last watered, in milliseconds. Only valid if the #type needs watering.
+
+	static const uint32 NO_CLOCK_ANIMATION = UINT32_MAX; ///< Value of #anim_phase of items that update #animtime themselves.
 };
 
 /** A type of path object, e.g. benches, litter. */
@@ -188,6 +194,10 @@ private:
 	uint8 state;         ///< Presence and demolishing states.
 };
 
+static const int LITTER_GRID_CELL_SIZE = 8;  ///< Length of the sides of a cell of the litter grid, in voxels.
+static const int LITTER_GRID_X_SIZE = WORLD_X_SIZE / LITTER_GRID_CELL_SIZE;  ///< Number of cells of the litter grid in X direction.
+static const int LITTER_GRID_Y_SIZE = WORLD_Y_SIZE / LITTER_GRID_CELL_SIZE;  ///< Number of cells of the litter grid in Y direction.
+
 /** All the scenery items in the world. */
 class SceneryManager {
 public:
@@ -202,6 +212,33 @@ public:
 	void OnAnimate(int delay);
 	void Clear();
 
+	/**
+	 * Get the time of the animation clock, which scenery items without timers of their own follow.
+	 * @return Number of milliseconds the scenery has been animated.
+	 */
+	inline uint64 GetAnimationClock() const
+	{
+		return this->anim_clock;
+	}
+
+	/**
+	 * Record that the saved data of the scenery has changed.
+	 * @see GetChangeStamp
+	 */
+	inline void MarkChanged()
+	{
+		this->change_stamp++;
+	}
+
+	/**
+	 * Get the stamp of the latest change of the saved data of the scenery, see #MarkChanged.
+	 * @return Stamp of the latest change.
+	 */
+	inline uint32 GetChangeStamp() const
+	{
+		return this->change_stamp;
+	}
+
 	void AddItem(SceneryInstance* item);
 	void RemoveItem(const XYZPoint16 &pos);
 	SceneryInstance *GetItem(const XYZPoint16 &pos);
@@ -211,6 +248,7 @@ public:
 	void  AddVomit (const XYZPoint16 &pos, const XYZPoint16 &offset);
 	void  RemoveLitterAndVomit(const XYZPoint16 &pos);
 	uint  CountLitterAndVomit (const XYZPoint16 &pos) const;
+	bool  HasLitterAndVomitNearby(const XYZPoint16 &pos, int radius) const;
 	uint8 CountDemolishedItems(const XYZPoint16 &pos) const;
 	PathObjectInstance *GetPathObject(const XYZPoint16 &pos);
 
@@ -225,9 +263,26 @@ public:
 private:
 	std::vector<std::unique_ptr<SceneryType>> scenery_item_types;  ///< All available scenery types.
 
-	std::map     <XYZPoint16, std::unique_ptr<SceneryInstance   >> all_items       ;  ///< All scenery items                 in the world, with their base voxel as key.
-	std::map     <XYZPoint16, std::unique_ptr<PathObjectInstance>> all_path_objects;  ///< All     user-buyable path objects in the world, with their base voxel as key.
-	std::multimap<XYZPoint16, std::unique_ptr<PathObjectInstance>> litter_and_vomit;  ///< All non-user-buyable path objects in the world, with their base voxel as key.
+	/* The containers are indexed by the voxel key (see #GetVoxelKey) of the base voxel of the items. */
+	std::unordered_map<uint32, std::unique_ptr<SceneryInstance>> all_items;                             ///< All scenery items in the world.
+	std::unordered_map<uint32, SceneryInstance*> watered_items;                                          ///< Scenery items of #all_items that need watering, they are updated every frame.
+	std::unordered_map<uint32, std::unique_ptr<PathObjectInstance>> all_path_objects;                   ///< All user-buyable path objects in the world.
+	std::unordered_map<uint32, std::vector<std::unique_ptr<PathObjectInstance>>> litter_and_vomit;      ///< All non-user-buyable path objects in the world, in order of creation at each voxel.
+	uint32 litter_grid[LITTER_GRID_X_SIZE * LITTER_GRID_Y_SIZE];  ///< Amount of #litter_and_vomit in each cell of #LITTER_GRID_CELL_SIZE by #LITTER_GRID_CELL_SIZE voxel stacks.
+	uint64 anim_clock;  ///< Animation clock, in milliseconds. @see GetAnimationClock
+	uint32 change_stamp;  ///< Stamp of the latest change of the saved data. @see GetChangeStamp
+
+	void StartAnimating(SceneryInstance *item);
+
+	/**
+	 * Get the litter grid cell containing a voxel.
+	 * @param pos Voxel coordinate.
+	 * @return The number of litter and vomit objects in the cell.
+	 */
+	inline uint32 &GetLitterGridCell(const XYZPoint16 &pos)
+	{
+		return this->litter_grid[(pos.x / LITTER_GRID_CELL_SIZE) * LITTER_GRID_Y_SIZE + pos.y / LITTER_GRID_CELL_SIZE];
+	}
 };
 
 extern SceneryManager _scenery;
@@ -14,6 +14,7 @@
 #include "language.h"
 #include "finances.h"
 #include "gamecontrol.h"
+#include "replay.h"
 #include "gui_sprites.h"
 #include "sprite_data.h"
 
@@ -302,6 +303,11 @@ void SceneryGui::SelectorMouseButtonEvent(const MouseButtons state)
 						}
 						_finances_manager.PayLandscaping(cost);
 						_window_manager.GetViewport()->AddFloatawayMoneyAmount(cost, i->vox_pos);
+
+						ReplayCommand cmd(RCT_REMOVE_SCENERY);
+						cmd.pos = i->vox_pos;
+						cmd.value = cost;
+						_replay.Record(cmd);
 						_scenery.RemoveItem(i->vox_pos);
 					}
 				}
@@ -325,6 +331,13 @@ void SceneryGui::SelectorMouseButtonEvent(const MouseButtons state)
 	}
 
 	this->instance->RemoveFromWorld();  // The scenery manager will want to re-insert it, so we must unlink it first.
+
+	ReplayCommand cmd(RCT_PLACE_SCENERY);
+	cmd.name = this->selected_type->internal_name;
+	cmd.pos = this->instance->vox_pos;
+	cmd.data[0] = this->instance->orientation;
+	_replay.Record(cmd);
+
 	_finances_manager.PayLandscaping(cost);
 	_window_manager.GetViewport()->AddFloatawayMoneyAmount(cost, this->instance->vox_pos);
 	_scenery.AddItem(this->instance.release());
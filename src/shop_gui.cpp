@@ -17,6 +17,7 @@
 #include "entity_gui.h"
 #include "finances.h"
 #include "viewport.h"
+#include "replay.h"
 
 /** Window to prompt for removing a shop. */
 class ShopRemoveWindow : public EntityRemoveWindow  {
@@ -47,6 +48,7 @@ void ShopRemoveWindow::OnClick(WidgetNumber number, [[maybe_unused]] const Point
 
 		delete GetWindowByType(WC_SHOP_MANAGER, this->si->GetIndex());
 
+		RecordRideDeletion(this->si, cost);
 		_rides_manager.DeleteInstance(this->si->GetIndex());
 	}
 	delete this;
@@ -174,6 +176,7 @@ public:
 	void UpdateWidgetSize(WidgetNumber wid_num, BaseWidget *wid) override;
 	void SetWidgetStringParameters(WidgetNumber wid_num) const override;
 	void OnClick(WidgetNumber wid_num, const Point16 &pos) override;
+	void OnChange(ChangeCode code, uint32 parameter) override;
 
 private:
 	ShopInstance *shop; ///< Shop instance getting managed by this window.
@@ -187,6 +190,7 @@ private:
  */
 ShopManagerWindow::ShopManagerWindow(ShopInstance *ri) : GuiWindow(WC_SHOP_MANAGER, ri->GetIndex()), shop(ri)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The sales and the state of the shop change all the time.
 	this->SetRideType(this->shop->GetShopType());
 	this->SetupWidgetTree(_shop_manager_gui_parts, lengthof(_shop_manager_gui_parts));
 	this->SetShopToggleButtons();
@@ -270,6 +274,7 @@ void ShopManagerWindow::OnClick(WidgetNumber wid_num, [[maybe_unused]] const Poi
 		case SMW_OPEN_SHOP_PANEL:
 			if (this->shop->state != RIS_OPEN) {
 				this->shop->OpenRide();
+				RecordRideState(this->shop);
 				this->SetShopToggleButtons();
 			}
 			break;
@@ -278,6 +283,7 @@ void ShopManagerWindow::OnClick(WidgetNumber wid_num, [[maybe_unused]] const Poi
 		case SMW_CLOSE_SHOP_PANEL:
 			if (this->shop->state != RIS_CLOSED) {
 				this->shop->CloseRide();
+				RecordRideState(this->shop);
 				this->SetShopToggleButtons();
 			}
 			break;
@@ -297,6 +303,14 @@ void ShopManagerWindow::OnClick(WidgetNumber wid_num, [[maybe_unused]] const Poi
 	}
 }
 
+void ShopManagerWindow::OnChange(ChangeCode code, uint32 parameter)
+{
+	if (code != CHG_RECOLOUR_RESULT) return;
+
+	const int widget = (parameter >> 16) & 0xFF;
+	if (widget >= SMW_RECOLOUR1 && widget <= SMW_RECOLOUR3) RecordRecolour(this->shop, RRP_RIDE, widget - SMW_RECOLOUR1);
+}
+
 /**
  * Open a window to manage a given shop.
  * @param number Shop to manage.
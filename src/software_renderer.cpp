@@ -0,0 +1,401 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file software_renderer.cpp Drawing into memory without OpenGL. */
+
+#include "stdafx.h"
+#include "software_renderer.h"
+#include "palette.h"
+
+#include <cmath>
+#include <png.h>
+
+/**
+ * Multiply two colour components.
+ * @param a First component.
+ * @param b Second component.
+ * @return Product of both, scaled back to the \c 0..255 range.
+ */
+static inline uint32 MulComponent(uint32 a, uint32 b)
+{
+	return (a * b + 127) / 255;
+}
+
+/**
+ * Blend a pixel over a destination pixel, like \c GL_SRC_ALPHA, \c GL_ONE_MINUS_SRC_ALPHA does.
+ * The alpha channel accumulates coverage, so render targets end up with premultiplied colours.
+ * @param dst [inout] Destination pixel.
+ * @param r Red component of the source pixel.
+ * @param g Green component of the source pixel.
+ * @param b Blue component of the source pixel.
+ * @param a Alpha component of the source pixel.
+ */
+static inline void BlendPixel(uint8 *dst, uint32 r, uint32 g, uint32 b, uint32 a)
+{
+	if (a == 0) return;
+	if (a == OPAQUE) {
+		dst[0] = r;
+		dst[1] = g;
+		dst[2] = b;
+		dst[3] = OPAQUE;
+		return;
+	}
+	const uint32 inv = OPAQUE - a;
+	dst[0] = (r * a + dst[0] * inv + 127) / 255;
+	dst[1] = (g * a + dst[1] * inv + 127) / 255;
+	dst[2] = (b * a + dst[2] * inv + 127) / 255;
+	dst[3] = a + MulComponent(dst[3], inv);
+}
+
+/**
+ * Blend a pixel with premultiplied colours over a destination pixel, like \c GL_ONE, \c GL_ONE_MINUS_SRC_ALPHA does.
+ * @param dst [inout] Destination pixel.
+ * @param r Red component of the source pixel.
+ * @param g Green component of the source pixel.
+ * @param b Blue component of the source pixel.
+ * @param a Alpha component of the source pixel.
+ */
+static inline void BlendPremultipliedPixel(uint8 *dst, uint32 r, uint32 g, uint32 b, uint32 a)
+{
+	const uint32 inv = OPAQUE - a;
+	dst[0] = std::min<uint32>(OPAQUE, r + MulComponent(dst[0], inv));
+	dst[1] = std::min<uint32>(OPAQUE, g + MulComponent(dst[1], inv));
+	dst[2] = std::min<uint32>(OPAQUE, b + MulComponent(dst[2], inv));
+	dst[3] = std::min<uint32>(OPAQUE, a + MulComponent(dst[3], inv));
+}
+
+/**
+ * Convert a texture coordinate to a pixel index, repeating the texture outside the \c [0, 1) range.
+ * @param coord Texture coordinate.
+ * @param size Number of pixels in the texture.
+ * @return Index of the pixel.
+ */
+static inline uint32 WrapTextureCoordinate(float coord, uint32 size)
+{
+	int32 index = static_cast<int32>(std::floor(coord * size)) % static_cast<int32>(size);
+	if (index < 0) index += size;
+	return index;
+}
+
+/**
+ * Constructor of the software renderer.
+ * @param width Width of the screen in pixels.
+ * @param height Height of the screen in pixels.
+ */
+SoftwareRenderer::SoftwareRenderer(uint32 width, uint32 height) : target(0)
+{
+	this->Resize(width, height);
+}
+
+/**
+ * Change the size of the screen. Its contents are lost.
+ * @param width New width in pixels.
+ * @param height New height in pixels.
+ */
+void SoftwareRenderer::Resize(uint32 width, uint32 height)
+{
+	assert(this->target == 0);
+	this->screen.width = width;
+	this->screen.height = height;
+	this->screen.rgba.reset(new uint8[width * height * 4]());
+	this->scissor = Rectangle32(0, 0, width, height);
+	this->SetClip(0, 0, width, height);
+}
+
+/**
+ * Get a texture by its number.
+ * @param texture Number of the texture, \c 0 means the screen.
+ * @return The texture.
+ */
+SoftwareRenderer::Texture &SoftwareRenderer::GetTexture(uint32 texture)
+{
+	if (texture == 0) return this->screen;
+	assert(texture <= this->textures.size() && this->textures[texture - 1].rgba != nullptr);
+	return this->textures[texture - 1];
+}
+
+/**
+ * Create a new texture.
+ * @param width Width of the texture in pixels.
+ * @param height Height of the texture in pixels.
+ * @param rgba Pixels of the texture, or \c nullptr for a transparent texture.
+ * @return Number of the new texture, never \c 0.
+ */
+uint32 SoftwareRenderer::CreateTexture(uint32 width, uint32 height, std::unique_ptr<uint8[]> rgba)
+{
+	uint32 texture;
+	if (this->free_textures.empty()) {
+		this->textures.emplace_back();
+		texture = this->textures.size();
+	} else {
+		texture = this->free_textures.back();
+		this->free_textures.pop_back();
+	}
+
+	Texture &t = this->textures[texture - 1];
+	t.width = width;
+	t.height = height;
+	t.rgba = (rgba != nullptr) ? std::move(rgba) : std::unique_ptr<uint8[]>(new uint8[width * height * 4]());
+	return texture;
+}
+
+/**
+ * Replace a part of a texture.
+ * @param texture Texture to modify.
+ * @param rect Area of the texture to replace, in pixels.
+ * @param rgba RGBA pixel data of the entire texture, the part inside \a rect is copied.
+ * @param stride Number of pixels in one row of \a rgba.
+ */
+void SoftwareRenderer::UpdateTexture(uint32 texture, const Rectangle32 &rect, const uint8 *rgba, uint32 stride)
+{
+	Texture &t = this->GetTexture(texture);
+	assert(rect.base.x >= 0 && rect.base.y >= 0 && rect.base.x + rect.width <= t.width && rect.base.y + rect.height <= t.height);
+	for (uint32 y = rect.base.y; y < rect.base.y + rect.height; y++) {
+		memcpy(t.rgba.get() + (y * t.width + rect.base.x) * 4, rgba + (y * stride + rect.base.x) * 4, rect.width * 4);
+	}
+}
+
+/**
+ * Release a texture.
+ * @param texture Texture to delete.
+ */
+void SoftwareRenderer::DeleteTexture(uint32 texture)
+{
+	Texture &t = this->GetTexture(texture);
+	assert(texture != 0 && texture != this->target);
+	t.rgba.reset();
+	t.width = 0;
+	t.height = 0;
+	this->free_textures.push_back(texture);
+}
+
+/**
+ * Draw into a texture instead of the screen, until #EndTarget is called.
+ * @param texture Texture to draw into.
+ * @param area Area of the texture to redraw. It is made transparent, and nothing outside it is changed.
+ */
+void SoftwareRenderer::BeginTarget(uint32 texture, const Rectangle32 &area)
+{
+	assert(this->target == 0 && texture != 0);
+	this->target = texture;
+	this->scissor = area;
+	this->SetClip(area.base.x, area.base.y, area.width, area.height);
+
+	Texture &t = this->GetTexture(texture);
+	for (int32 y = this->clip_top; y < this->clip_bottom; y++) {
+		memset(t.rgba.get() + (y * t.width + this->clip_left) * 4, 0, (this->clip_right - this->clip_left) * 4);
+	}
+}
+
+/** Continue drawing at the screen. */
+void SoftwareRenderer::EndTarget()
+{
+	assert(this->target != 0);
+	this->target = 0;
+	this->scissor = Rectangle32(0, 0, this->screen.width, this->screen.height);
+	this->SetClip(0, 0, this->screen.width, this->screen.height);
+}
+
+/**
+ * Restrict drawing to an area of the buffer being drawn into.
+ * @param x Left edge of the area.
+ * @param y Top edge of the area.
+ * @param width Width of the area.
+ * @param height Height of the area.
+ */
+void SoftwareRenderer::SetClip(int32 x, int32 y, int32 width, int32 height)
+{
+	const Texture &t = this->GetTexture(this->target);
+	this->clip_left   = std::max<int32>({x, this->scissor.base.x, 0});
+	this->clip_top    = std::max<int32>({y, this->scissor.base.y, 0});
+	this->clip_right  = std::min<int32>({x + width,  this->scissor.base.x + static_cast<int32>(this->scissor.width),  static_cast<int32>(t.width)});
+	this->clip_bottom = std::min<int32>({y + height, this->scissor.base.y + static_cast<int32>(this->scissor.height), static_cast<int32>(t.height)});
+	if (this->clip_right < this->clip_left) this->clip_right = this->clip_left;
+	if (this->clip_bottom < this->clip_top) this->clip_bottom = this->clip_top;
+}
+
+/** Make the entire screen opaque black. */
+void SoftwareRenderer::Clear()
+{
+	uint8 *p = this->screen.rgba.get();
+	const uint8 *end = p + this->screen.width * this->screen.height * 4;
+	for (; p < end; p += 4) {
+		p[0] = 0;
+		p[1] = 0;
+		p[2] = 0;
+		p[3] = OPAQUE;
+	}
+}
+
+/**
+ * Draw a texture, stretched to fill a rectangle. Pixels are drawn when their centre is inside the rectangle.
+ * @param texture Texture to draw.
+ * @param x1 Left edge of the rectangle.
+ * @param y1 Top edge of the rectangle.
+ * @param x2 Right edge of the rectangle.
+ * @param y2 Bottom edge of the rectangle.
+ * @param col RGBA colour to multiply the texture with.
+ * @param tex Texture coordinates of the corners, in the same order as #VideoSystem::DoDrawImage.
+ * @param premultiplied The colours of the texture are premultiplied by its alpha.
+ */
+void SoftwareRenderer::DrawTexture(uint32 texture, float x1, float y1, float x2, float y2, uint32 col, const WXYZPointF &tex, bool premultiplied)
+{
+	const Texture &src = this->GetTexture(texture);
+	if (src.width == 0 || src.height == 0 || x2 <= x1 || y2 <= y1) return;
+
+	const int32 left   = std::max<int32>(this->clip_left,   std::ceil(x1 - 0.5f));
+	const int32 right  = std::min<int32>(this->clip_right,  std::ceil(x2 - 0.5f));
+	const int32 top    = std::max<int32>(this->clip_top,    std::ceil(y1 - 0.5f));
+	const int32 bottom = std::min<int32>(this->clip_bottom, std::ceil(y2 - 0.5f));
+	if (left >= right || top >= bottom) return;
+
+	/* Texture coordinates run from tex.x to tex.z horizontally, and from tex.w to tex.y vertically. */
+	this->columns.resize(right - left);
+	for (int32 x = left; x < right; x++) {
+		this->columns[x - left] = WrapTextureCoordinate(tex.x + (x + 0.5f - x1) / (x2 - x1) * (tex.z - tex.x), src.width) * 4;
+	}
+
+	const bool modulate = (col != 0xffffffff);
+	const uint32 mr = GetR(col);
+	const uint32 mg = GetG(col);
+	const uint32 mb = GetB(col);
+	const uint32 ma = GetA(col);
+	Texture &dst = this->GetTexture(this->target);
+	for (int32 y = top; y < bottom; y++) {
+		const uint32 row = WrapTextureCoordinate(tex.w + (y + 0.5f - y1) / (y2 - y1) * (tex.y - tex.w), src.height);
+		const uint8 *src_row = src.rgba.get() + row * src.width * 4;
+		uint8 *d = dst.rgba.get() + (y * dst.width + left) * 4;
+		for (const uint32 column : this->columns) {
+			const uint8 *s = src_row + column;
+			uint32 r = s[0];
+			uint32 g = s[1];
+			uint32 b = s[2];
+			uint32 a = s[3];
+			if (modulate) {
+				r = MulComponent(r, mr);
+				g = MulComponent(g, mg);
+				b = MulComponent(b, mb);
+				a = MulComponent(a, ma);
+			}
+			if (premultiplied) {
+				BlendPremultipliedPixel(d, r, g, b, a);
+			} else {
+				BlendPixel(d, r, g, b, a);
+			}
+			d += 4;
+		}
+	}
+}
+
+/**
+ * Fill a rectangle in a solid colour. Pixels are drawn when their centre is inside the rectangle.
+ * @param x1 Left edge of the rectangle.
+ * @param y1 Top edge of the rectangle.
+ * @param x2 Right edge of the rectangle.
+ * @param y2 Bottom edge of the rectangle.
+ * @param col RGBA colour to use.
+ */
+void SoftwareRenderer::FillRectangle(float x1, float y1, float x2, float y2, uint32 col)
+{
+	if (x2 < x1) std::swap(x1, x2);
+	if (y2 < y1) std::swap(y1, y2);
+	const int32 left   = std::max<int32>(this->clip_left,   std::ceil(x1 - 0.5f));
+	const int32 right  = std::min<int32>(this->clip_right,  std::ceil(x2 - 0.5f));
+	const int32 top    = std::max<int32>(this->clip_top,    std::ceil(y1 - 0.5f));
+	const int32 bottom = std::min<int32>(this->clip_bottom, std::ceil(y2 - 0.5f));
+	if (left >= right || top >= bottom || GetA(col) == TRANSPARENT) return;
+
+	Texture &dst = this->GetTexture(this->target);
+	for (int32 y = top; y < bottom; y++) {
+		uint8 *d = dst.rgba.get() + (y * dst.width + left) * 4;
+		for (int32 x = left; x < right; x++, d += 4) BlendPixel(d, GetR(col), GetG(col), GetB(col), GetA(col));
+	}
+}
+
+/**
+ * Draw a straight line of one pixel wide.
+ * @param x1 X coordinate of the starting point.
+ * @param y1 Y coordinate of the starting point.
+ * @param x2 X coordinate of the end point.
+ * @param y2 Y coordinate of the end point.
+ * @param col RGBA colour to use.
+ */
+void SoftwareRenderer::DrawLine(float x1, float y1, float x2, float y2, uint32 col)
+{
+	int32 x = std::floor(x1);
+	int32 y = std::floor(y1);
+	const int32 end_x = std::floor(x2);
+	const int32 end_y = std::floor(y2);
+	const int32 dx = abs(end_x - x);
+	const int32 dy = -abs(end_y - y);
+	const int32 step_x = (x < end_x) ? 1 : -1;
+	const int32 step_y = (y < end_y) ? 1 : -1;
+
+	/* Bresenham's line algorithm. */
+	Texture &dst = this->GetTexture(this->target);
+	int32 err = dx + dy;
+	for (;;) {
+		if (x >= this->clip_left && x < this->clip_right && y >= this->clip_top && y < this->clip_bottom) {
+			BlendPixel(dst.rgba.get() + (y * dst.width + x) * 4, GetR(col), GetG(col), GetB(col), GetA(col));
+		}
+		if (x == end_x && y == end_y) break;
+		const int32 err2 = 2 * err;
+		if (err2 >= dy) {
+			err += dy;
+			x += step_x;
+		}
+		if (err2 <= dx) {
+			err += dx;
+			y += step_y;
+		}
+	}
+}
+
+/**
+ * Save the screen as PNG file.
+ * @param fname Name of the file to write.
+ * @return Whether the file was written successfully.
+ */
+bool SoftwareRenderer::SavePng(const std::string &fname) const
+{
+	FILE *fp = fopen(fname.c_str(), "wb");
+	if (fp == nullptr) return false;
+
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	png_infop info_ptr = (png_ptr == nullptr) ? nullptr : png_create_info_struct(png_ptr);
+	if (info_ptr == nullptr) {
+		png_destroy_write_struct(&png_ptr, nullptr);
+		fclose(fp);
+		return false;
+	}
+
+	/* The screen is opaque, the alpha channel is not saved. */
+	std::unique_ptr<uint8[]> row(new uint8[this->screen.width * 3]);
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		fclose(fp);
+		return false;
+	}
+
+	png_init_io(png_ptr, fp);
+	png_set_IHDR(png_ptr, info_ptr, this->screen.width, this->screen.height, 8, PNG_COLOR_TYPE_RGB,
+			PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(png_ptr, info_ptr);
+	for (uint32 y = 0; y < this->screen.height; y++) {
+		const uint8 *src = this->screen.rgba.get() + y * this->screen.width * 4;
+		for (uint32 x = 0; x < this->screen.width; x++) {
+			row[x * 3 + 0] = src[x * 4 + 0];
+			row[x * 3 + 1] = src[x * 4 + 1];
+			row[x * 3 + 2] = src[x * 4 + 2];
+		}
+		png_write_row(png_ptr, row.get());
+	}
+	png_write_end(png_ptr, nullptr);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+	fclose(fp);
+	return true;
+}
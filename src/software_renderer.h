@@ -0,0 +1,70 @@
+/*
+ * This file is part of FreeRCT.
+ * FreeRCT is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * FreeRCT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with FreeRCT. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file software_renderer.h Drawing into memory without OpenGL. */
+
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include "stdafx.h"
+#include "geometry.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Renderer that draws into RGBA pixel buffers in memory, for use without a display.
+ * It mimics the OpenGL drawing of the #VideoSystem, with nearest-pixel texture sampling.
+ * All coordinates are pixel positions in the buffer being drawn into.
+ */
+class SoftwareRenderer {
+public:
+	SoftwareRenderer(uint32 width, uint32 height);
+
+	void Resize(uint32 width, uint32 height);
+
+	uint32 CreateTexture(uint32 width, uint32 height, std::unique_ptr<uint8[]> rgba = nullptr);
+	void UpdateTexture(uint32 texture, const Rectangle32 &rect, const uint8 *rgba, uint32 stride);
+	void DeleteTexture(uint32 texture);
+
+	void BeginTarget(uint32 texture, const Rectangle32 &area);
+	void EndTarget();
+	void SetClip(int32 x, int32 y, int32 width, int32 height);
+
+	void Clear();
+	void DrawTexture(uint32 texture, float x1, float y1, float x2, float y2, uint32 col, const WXYZPointF &tex, bool premultiplied = false);
+	void FillRectangle(float x1, float y1, float x2, float y2, uint32 col);
+	void DrawLine(float x1, float y1, float x2, float y2, uint32 col);
+
+	bool SavePng(const std::string &fname) const;
+
+private:
+	/** Pixel buffer that can be drawn, or drawn into. */
+	struct Texture {
+		uint32 width = 0;               ///< Width of the buffer in pixels.
+		uint32 height = 0;              ///< Height of the buffer in pixels.
+		std::unique_ptr<uint8[]> rgba;  ///< RGBA pixels, row by row from the top, \c nullptr if the texture is not in use.
+	};
+
+	Texture &GetTexture(uint32 texture);
+
+	Texture screen;                     ///< The screen.
+	std::vector<Texture> textures;      ///< Textures, indexed by their number minus one.
+	std::vector<uint32> free_textures;  ///< Numbers of deleted textures, available for reuse.
+	uint32 target;                      ///< Number of the texture being drawn into, \c 0 for the screen.
+
+	int32 clip_left;      ///< Left edge of the drawable area of #target.
+	int32 clip_top;       ///< Top edge of the drawable area of #target.
+	int32 clip_right;     ///< Right edge of the drawable area of #target (exclusive).
+	int32 clip_bottom;    ///< Bottom edge of the drawable area of #target (exclusive).
+	Rectangle32 scissor;  ///< Area of #target that may be changed at all.
+
+	std::vector<uint32> columns;  ///< Texture column of every drawn pixel column, kept to avoid allocations.
+};
+
+#endif
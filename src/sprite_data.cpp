@@ -12,7 +12,6 @@
 #include "sprite_data.h"
 #include "fileio.h"
 #include "bitmath.h"
-#include "video.h"
 
 #include <cmath>
 #include <vector>
@@ -144,63 +143,58 @@ void ImageData::Load8bpp(RcdFileReader *rcd_file, size_t length)
 
 	rcd_file->GetBlob(data.get(), length); // Load the image data.
 
-	/* Verify the image data. */
-	this->rgba.reset(new uint8[this->width * this->height * 4]);
-	this->recol.reset(new uint8[this->width * this->height]);
+	/*
+	 * Decode the image data. Transparent pixels are all zero, so the buffers start zeroed and only the
+	 * opaque runs are written. Every run is validated before it is expanded.
+	 */
+	this->rgba.reset(new uint8[this->width * this->height * 4]());
+	this->recol.reset(new uint8[this->width * this->height]());
 	uint8 *rgba_ptr = this->rgba.get();
 	uint8 *recol_ptr = this->recol.get();
 	for (uint i = 0; i < this->height; i++) {
 		uint32 offset = table[i];
 		if (offset == INVALID_JUMP) {
 			/* Whole line is transparent. */
-			for (int x = 0; x < this->width; ++x) {
-				*(rgba_ptr++) = 0;
-				*(rgba_ptr++) = 0;
-				*(rgba_ptr++) = 0;
-				*(rgba_ptr++) = 0;
-				*(recol_ptr++) = 0;
-			}
+			rgba_ptr += 4 * this->width;
+			recol_ptr += this->width;
 			continue;
 		}
 
 		uint32 xpos = 0;
 		for (;;) {
 			if (offset + 2 >= length) rcd_file->Error("Offset out of bounds");
-			uint8 rel_pos = data[offset];
-			uint8 count = data[offset + 1];
-			for (int g = 0; g < (rel_pos & 127); ++g) {
-				*(rgba_ptr++) = 0;
-				*(rgba_ptr++) = 0;
-				*(rgba_ptr++) = 0;
-				*(rgba_ptr++) = 0;
-				*(recol_ptr++) = 0;
-			}
-			xpos += (rel_pos & 127) + count;
-			for (int dx = 0; dx < count; ++dx) {
-				uint8 pixel = data[offset + 2 + dx];
-				*(recol_ptr++) = pixel;
-				uint32 rgba = _palette[pixel];
-				*(rgba_ptr++) = (rgba >> 24) & 0xff;
-				*(rgba_ptr++) = (rgba >> 16) & 0xff;
-				*(rgba_ptr++) = (rgba >>  8) & 0xff;
-				*(rgba_ptr++) = (rgba      ) & 0xff;
-			}
-			offset += 2 + count;
+			const uint8 rel_pos = data[offset];
+			const uint8 count = data[offset + 1];
+			const uint32 gap = rel_pos & 127;
+			xpos += gap + count;
+			const uint32 next_offset = offset + 2 + count;
 			if ((rel_pos & 128) == 0) {
-				if (xpos >= this->width || offset >= length) rcd_file->Error("X coordinate out of exclusive bounds");
+				if (xpos >= this->width || next_offset >= length) rcd_file->Error("X coordinate out of exclusive bounds");
 			} else {
-				if (xpos > this->width || offset > length) rcd_file->Error("X coordinate out of inclusive bounds");
-				break;
+				if (xpos > this->width || next_offset > length) rcd_file->Error("X coordinate out of inclusive bounds");
+			}
+
+			rgba_ptr += 4 * gap;
+			recol_ptr += gap;
+			const uint8 *pixels = &data[offset + 2];
+			memcpy(recol_ptr, pixels, count);
+			recol_ptr += count;
+			for (uint32 dx = 0; dx < count; ++dx) {
+				const uint32 rgba = _palette[pixels[dx]];
+				rgba_ptr[0] = GetR(rgba);
+				rgba_ptr[1] = GetG(rgba);
+				rgba_ptr[2] = GetB(rgba);
+				rgba_ptr[3] = GetA(rgba);
+				rgba_ptr += 4;
 			}
-		}
 
-		for (; xpos < this->width; ++xpos) {
-			*(rgba_ptr++) = 0;
-			*(rgba_ptr++) = 0;
-			*(rgba_ptr++) = 0;
-			*(rgba_ptr++) = 0;
-			*(recol_ptr++) = 0;
+			offset = next_offset;
+			if ((rel_pos & 128) != 0) break;
 		}
+
+		/* Rest of the line is transparent. */
+		rgba_ptr += 4 * (this->width - xpos);
+		recol_ptr += this->width - xpos;
 	}
 	assert(recol_ptr - this->recol.get() == 1L * this->width * this->height);
 	assert(rgba_ptr - this->rgba.get() == 4L * this->width * this->height);
@@ -230,19 +224,26 @@ void ImageData::Load32bpp(RcdFileReader *rcd_file, size_t length)
 	if (data == nullptr) rcd_file->Error("Out of memory");
 	rcd_file->GetBlob(data.get(), length);
 
-	/* Verify the data. */
-	this->rgba.reset(new uint8[this->width * this->height * 4]);
-	this->recol.reset(new uint8[this->width * this->height * 2]);
+	/*
+	 * Decode the data. Transparent pixels and pixels without recolouring have zeroes in the buffers, so the
+	 * buffers start zeroed and only the other pixels are written. Every run is validated before it is expanded.
+	 */
+	this->rgba.reset(new uint8[this->width * this->height * 4]());
+	this->recol.reset(new uint8[this->width * this->height * 2]());
 	uint8 *rgba_ptr = this->rgba.get();
 	uint8 *recol_ptr = this->recol.get();
-	uint8 *abs_end = data.get() + length;
+	static const uint8 HEADER_BYTES[] = {0, 1, 0, 2};  // Bytes before the pixel data of a run, for each kind of run.
+	static const uint8 PIXEL_BYTES[] = {3, 3, 0, 1};   // Bytes of data of each pixel, for each kind of run.
+	const uint8 *abs_end = data.get() + length;
 	int line_count = 0;
 	const uint8 *ptr = data.get();
 	bool finished = false;
 	while (ptr < abs_end && !finished) {
 		line_count++;
+		if (line_count > this->height) rcd_file->Error("Line count mismatch");
 
 		/* Find end of this line. */
+		if (abs_end - ptr < 2) rcd_file->Error("End out of bounds");
 		uint16 line_length = ptr[0] | (ptr[1] << 8);
 		const uint8 *end;
 		if (line_length == 0) {
@@ -257,76 +258,69 @@ void ImageData::Load32bpp(RcdFileReader *rcd_file, size_t length)
 		/* Read line. */
 		bool finished_line = false;
 		uint xpos = 0;
-		while (ptr < end && !finished_line) {
-			uint8 mode = *ptr++;
+		while (ptr < end) {
+			const uint8 mode = *ptr++;
 			if (mode == 0) {
-				for (; xpos < this->width; ++xpos) {
-					*(rgba_ptr++) = 0;
-					*(rgba_ptr++) = 0;
-					*(rgba_ptr++) = 0;
-					*(rgba_ptr++) = 0;
-					*(recol_ptr++) = 0;
-					*(recol_ptr++) = 0;
-				}
 				finished_line = true;
 				break;
 			}
-			xpos += mode & 0x3F;
+
+			const uint count = mode & 0x3F;
+			if (xpos + count > this->width) rcd_file->Error("X coordinate out of bounds");
+			if (static_cast<size_t>(end - ptr) < HEADER_BYTES[mode >> 6] + PIXEL_BYTES[mode >> 6] * count) rcd_file->Error("Pixel data out of bounds");
+			xpos += count;
+
 			switch (mode >> 6) {
 				case 0:  // Fully opaque colour.
-					for (int i = mode & 0x3F; i > 0; --i) {
-						*(rgba_ptr++) = *(ptr++);
-						*(rgba_ptr++) = *(ptr++);
-						*(rgba_ptr++) = *(ptr++);
-						*(rgba_ptr++) = 255;
-						*(recol_ptr++) = 0;
-						*(recol_ptr++) = 0;
+					for (uint i = 0; i < count; ++i) {
+						rgba_ptr[0] = ptr[0];
+						rgba_ptr[1] = ptr[1];
+						rgba_ptr[2] = ptr[2];
+						rgba_ptr[3] = 255;
+						rgba_ptr += 4;
+						ptr += 3;
 					}
 					break;
 				case 1: {  // Semi-transparent colour.
-					uint8 alpha = *(ptr++);
-					for (int i = mode & 0x3F; i > 0; --i) {
-						*(rgba_ptr++) = *(ptr++);
-						*(rgba_ptr++) = *(ptr++);
-						*(rgba_ptr++) = *(ptr++);
-						*(rgba_ptr++) = alpha;
-						*(recol_ptr++) = 0;
-						*(recol_ptr++) = 0;
+					const uint8 alpha = *(ptr++);
+					for (uint i = 0; i < count; ++i) {
+						rgba_ptr[0] = ptr[0];
+						rgba_ptr[1] = ptr[1];
+						rgba_ptr[2] = ptr[2];
+						rgba_ptr[3] = alpha;
+						rgba_ptr += 4;
+						ptr += 3;
 					}
 					break;
 				}
 				case 2:  // Fully transparent.
-					for (int i = mode & 0x3F; i > 0; --i) {
-						*(rgba_ptr++) = 0;
-						*(rgba_ptr++) = 0;
-						*(rgba_ptr++) = 0;
-						*(rgba_ptr++) = 0;
-						*(recol_ptr++) = 0;
-						*(recol_ptr++) = 0;
-					}
+					rgba_ptr += 4 * count;
 					break;
 				case 3: {  // Recolour layer.
-					uint8 layer = *(ptr++);
-					uint8 alpha = *(ptr++);
-					for (int i = mode & 0x3F; i > 0; --i) {
-						*(rgba_ptr++) = 0;
-						*(rgba_ptr++) = 0;
-						*(rgba_ptr++) = 0;
-						*(rgba_ptr++) = alpha;
-						*(recol_ptr++) = layer;
-						*(recol_ptr++) = *(ptr++);
+					const uint8 layer = *(ptr++);
+					const uint8 alpha = *(ptr++);
+					for (uint i = 0; i < count; ++i) {
+						rgba_ptr[3] = alpha;
+						rgba_ptr += 4;
+						recol_ptr[2 * i] = layer;
+						recol_ptr[2 * i + 1] = ptr[i];
 					}
+					ptr += count;
 					break;
 				}
 			}
+			recol_ptr += 2 * count;
 		}
-		if (xpos > this->width) rcd_file->Error("X coordinate out of bounds");
 		if (!finished_line) rcd_file->Error("Incomplete line");
 		if (ptr != end) rcd_file->Error("Trailing bytes at end of line");
+
+		/* Rest of the line is transparent. */
+		rgba_ptr += 4 * (this->width - xpos);
+		recol_ptr += 2 * (this->width - xpos);
 	}
+	if (line_count != this->height) rcd_file->Error("Line count mismatch");
 	assert(recol_ptr - this->recol.get() == 2L * this->width * this->height);
 	assert(rgba_ptr - this->rgba.get() == 4L * this->width * this->height);
-	if (line_count != this->height) rcd_file->Error("Line count mismatch");
 	if (ptr != abs_end) rcd_file->Error("Trailing bytes at end of file");
 }
 
@@ -369,41 +363,33 @@ uint32 ImageData::GetPixel(uint16 xoffset, uint16 yoffset, const Recolouring *re
  */
 std::unique_ptr<uint8[]> ImageData::GetRecoloured(GradientShift shift, const Recolouring &recolour) const
 {
-	ShiftFunc af = GetAlphaShiftFunc(shift);
-	std::unique_ptr<uint8[]> result(new uint8[this->width * this->height * 4]);
+	const RecolourTables &tables = recolour.GetRecolourTables(shift);
+	const uint32 pixels = this->width * this->height;
+	std::unique_ptr<uint8[]> result(new uint8[pixels * 4]);
 	uint8 *ptr = result.get();
 	const uint8 *recol_ptr = this->recol.get();
 
 	if (this->is_8bpp) {
-		for (int y = 0; y < this->height; ++y) {
-			for (int x = 0; x < this->width; ++x) {
-				uint32 pixel = _palette[recolour.GetPalette(shift)[*(recol_ptr++)]];
-				*(ptr++) = GetR(pixel);
-				*(ptr++) = GetG(pixel);
-				*(ptr++) = GetB(pixel);
-				*(ptr++) = af(GetA(pixel));
-			}
+		for (uint32 i = 0; i < pixels; ++i) {
+			memcpy(ptr, tables.palette[recol_ptr[i]], 4);
+			ptr += 4;
 		}
 	} else {
+		const uint8 *gradient_shift = GetGradientShiftTable(shift);
+		const uint8 *alpha_shift = GetAlphaShiftTable(shift);
 		const uint8 *rgba_ptr = this->rgba.get();
-		ShiftFunc sf = GetGradientShiftFunc(shift);
-		for (int y = 0; y < this->height; ++y) {
-			for (int x = 0; x < this->width; ++x) {
-				if (recol_ptr[0] == 0) {
-					*(ptr++) = sf(*(rgba_ptr++));
-					*(ptr++) = sf(*(rgba_ptr++));
-					*(ptr++) = sf(*(rgba_ptr++));
-					*(ptr++) = af(*(rgba_ptr++));
-				} else {
-					const uint32 recoloured = recolour.GetRecolourTable(recol_ptr[0] - 1)[recol_ptr[1]];
-					*(ptr++) = sf(GetR(recoloured));
-					*(ptr++) = sf(GetG(recoloured));
-					*(ptr++) = sf(GetB(recoloured));
-					*(ptr++) = af(rgba_ptr[3]);
-					rgba_ptr += 4;
-				}
-				recol_ptr += 2;
+		for (uint32 i = 0; i < pixels; ++i) {
+			if (recol_ptr[0] == 0) {
+				ptr[0] = gradient_shift[rgba_ptr[0]];
+				ptr[1] = gradient_shift[rgba_ptr[1]];
+				ptr[2] = gradient_shift[rgba_ptr[2]];
+			} else {
+				memcpy(ptr, tables.layers[std::min(recol_ptr[0] - 1, MAX_RECOLOUR)][recol_ptr[1]], 4);
 			}
+			ptr[3] = alpha_shift[rgba_ptr[3]];
+			ptr += 4;
+			rgba_ptr += 4;
+			recol_ptr += 2;
 		}
 	}
 
@@ -418,6 +404,9 @@ std::unique_ptr<uint8[]> ImageData::GetRecoloured(GradientShift shift, const Rec
 const ImageData *ImageData::Scale(uint16 desired_width) const
 {
 	if (desired_width == this->width) return this;
+	for (const ImageData *variant : this->zoom_variants) {
+		if (variant->width == desired_width) return variant;
+	}
 
 	ImageData *cached = _image_variants.GetScaled(this, desired_width);
 	if (cached != nullptr) return cached;
@@ -478,6 +467,21 @@ const ImageData *ImageData::Scale(uint16 desired_width) const
 	return img;
 }
 
+/**
+ * Add a downscaled copy of this image, to use instead of scaling the image at run time.
+ * @param variant Downscaled image, with the size and offset that scaling the image to its width would give.
+ */
+void ImageData::AddZoomVariant(const ImageData *variant)
+{
+	for (const ImageData *&known : this->zoom_variants) {
+		if (known->width == variant->width) {
+			known = variant;
+			return;
+		}
+	}
+	this->zoom_variants.push_back(variant);
+}
+
 /**
  * Load 8bpp or 32bpp sprite block from the \a rcd_file.
  * @param rcd_file File being loaded.
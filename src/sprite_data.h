@@ -12,6 +12,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 #include "palette.h"
 #include "time_func.h"
 
@@ -34,6 +35,7 @@ public:
 	std::unique_ptr<uint8[]> GetRecoloured(GradientShift shift, const Recolouring &recolour) const;
 
 	const ImageData *Scale(uint16 desired_width) const;
+	void AddZoomVariant(const ImageData *variant);
 
 	/**
 	 * Is the sprite just a single pixel?
@@ -52,6 +54,8 @@ public:
 
 	std::unique_ptr<uint8[]> rgba;   ///< All pixel values of the image in RGBA format.
 	std::unique_ptr<uint8[]> recol;  ///< The recolouring layer and table index of each pixel.
+
+	std::vector<const ImageData *> zoom_variants;  ///< Downscaled copies of the image for other zoom levels, made by rcdgen.
 };
 
 /** Keeps track of cached recolouring and scaling variants of images. */
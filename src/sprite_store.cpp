@@ -219,6 +219,32 @@ void LoadSpriteFromFile(RcdFileReader *rcd_file, const ImageMap &sprites, ImageD
 	*spr = iter->second;
 }
 
+/**
+ * Load the downscaled variants of a sprite from a SCAL block of the \a rcd_file.
+ * @param rcd_file File to load from.
+ * @param sprites Sprites already loaded from this file.
+ */
+static void LoadZoomVariants(RcdFileReader *rcd_file, const ImageMap &sprites)
+{
+	rcd_file->CheckVersion(1);
+	rcd_file->CheckMinLength(rcd_file->size, 4 + 2, "header");
+
+	ImageData *sprite;
+	LoadSpriteFromFile(rcd_file, sprites, &sprite);
+	uint16 count = rcd_file->GetUInt16();
+	rcd_file->CheckExactLength(rcd_file->size, 4 + 2 + 4 * count, "header");
+	if (sprite == nullptr) rcd_file->Error("Missing sprite");
+
+	for (uint16 i = 0; i < count; i++) {
+		ImageData *variant;
+		LoadSpriteFromFile(rcd_file, sprites, &variant);
+		if (variant == nullptr || variant->is_8bpp != sprite->is_8bpp || variant->width >= sprite->width) {
+			rcd_file->Error("Invalid scaled sprite");
+		}
+		sprite->AddZoomVariant(variant);
+	}
+}
+
 /**
  * Get a text reference from the \a rcd_file, retrieve the corresponding text data, and put it in the \a txt destination.
  * @param rcd_file File to load from.
@@ -1405,13 +1431,22 @@ void SpriteManager::Load(const char *filename)
 	TextMap  texts;   // Texts loaded from this file.
 	TrackPiecesMap track_pieces; // Track pieces loaded from this file.
 
+	/* Find the blocks with the table of contents if available, so blocks that are not read completely cannot derail loading. */
+	std::vector<RcdBlockEntry> toc;
+	const bool has_toc = rcd_file.ReadTableOfContents(&toc);
+
 	/* Load blocks. */
 	for (uint blk_num = 1;; blk_num++) {
-		if (!rcd_file.ReadBlockHeader()) return; // End reached.
+		if (has_toc) {
+			if (blk_num > toc.size()) return; // End reached.
+			if (!rcd_file.SeekBlock(toc[blk_num - 1])) throw LoadingError("Block %u does not match the table of contents.", blk_num);
+		} else if (!rcd_file.ReadBlockHeader()) {
+			return; // End reached.
+		}
 
 		/* Skip meta blocks. */
-		if (strcmp(rcd_file.name, "INFO") == 0) {
-			if (!rcd_file.SkipBytes(rcd_file.size)) throw LoadingError("Invalid INFO block.");
+		if (strcmp(rcd_file.name, "INFO") == 0 || strcmp(rcd_file.name, "RTOC") == 0) {
+			if (!rcd_file.SkipBytes(rcd_file.size)) throw LoadingError("Invalid %s block.", rcd_file.name);
 			continue;
 		}
 
@@ -1425,6 +1460,11 @@ void SpriteManager::Load(const char *filename)
 			continue;
 		}
 
+		if (strcmp(rcd_file.name, "SCAL") == 0) {
+			LoadZoomVariants(&rcd_file, sprites);
+			continue;
+		}
+
 		if (strcmp(rcd_file.name, "SURF") == 0) {
 			this->LoadSURF(&rcd_file, sprites);
 			continue;
@@ -12,6 +12,7 @@
 #include "person.h"
 #include "people.h"
 #include "sprite_data.h"
+#include "replay.h"
 
 /**
  * Widget numbers of the staff GUI.
@@ -79,6 +80,7 @@ public:
  */
 StaffManagementGui::StaffManagementGui() : GuiWindow(WC_STAFF, ALL_WINDOWS_OF_TYPE), selected(PERSON_MECHANIC)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The activities of the staff change all the time.
 	this->SetupWidgetTree(_staff_select_gui_parts, lengthof(_staff_select_gui_parts));
 	this->SetScrolledWidget(STAFF_GUI_LIST, STAFF_GUI_SCROLL_LIST);
 	this->SelectTab(PERSON_HANDYMAN);
@@ -135,6 +137,11 @@ void StaffManagementGui::OnClick(const WidgetNumber number, const Point16 &pos)
 				default:
 					NOT_REACHED();
 			}
+			{
+				ReplayCommand cmd(RCT_HIRE_STAFF);
+				cmd.data[0] = this->selected;
+				_replay.Record(cmd);
+			}
 			break;
 
 		case STAFF_CATEGORY_MECHANICS:    this->SelectTab(PERSON_MECHANIC);    break;
@@ -150,6 +157,7 @@ void StaffManagementGui::OnClick(const WidgetNumber number, const Point16 &pos)
 
 			StaffMember *m = _staff.Get(this->selected, index - first_index);
 			if (pos.x > this->GetWidget<BaseWidget>(STAFF_GUI_LIST)->pos.width * 4 / 5) {
+				RecordStaffDismissal(m);
 				_staff.Dismiss(m);
 			} else {
 				ShowPersonInfoGui(m);
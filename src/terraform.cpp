@@ -15,6 +15,7 @@
 #include "gamecontrol.h"
 #include "math_func.h"
 #include "memory.h"
+#include "replay.h"
 
 static const Money TERRAFORM_UNIT_COST(40);  ///< The cost for applying one elemental unit of terraforming modifications.
 
@@ -408,6 +409,8 @@ static void SetXFoundations(int xpos, int ypos)
 
 	SetFoundations(first,  first_south, first_west, second_east, second_north, 0x10, 0x20);
 	SetFoundations(second, second_north, second_east, first_west, first_south, 0x01, 0x02);
+	if (first != nullptr) _world.MarkStackDirty(xpos, ypos);
+	if (second != nullptr) _world.MarkStackDirty(xpos + 1, ypos);
 }
 
 /**
@@ -453,6 +456,8 @@ static void SetYFoundations(int xpos, int ypos)
 
 	SetFoundations(first,  first_south, first_east, second_west, second_north, 0x08, 0x04);
 	SetFoundations(second, second_north, second_west, first_east, first_south, 0x80, 0x40);
+	if (first != nullptr) _world.MarkStackDirty(xpos, ypos);
+	if (second != nullptr) _world.MarkStackDirty(xpos, ypos + 1);
 }
 
 /**
@@ -516,8 +521,11 @@ bool TerrainChanges::ModifyWorld(const int direction)
 		return true;
 	}
 	_finances_manager.PayLandscaping(total_cost);
-	_window_manager.GetViewport()->AddFloatawayMoneyAmount(total_cost, XYZPoint16(
-			this->changes.begin()->first.x, this->changes.begin()->first.y, this->changes.begin()->second.height));
+	Viewport *vp = _window_manager.GetViewport();
+	if (vp != nullptr) {  // There is no viewport while replaying.
+		vp->AddFloatawayMoneyAmount(total_cost, XYZPoint16(
+				this->changes.begin()->first.x, this->changes.begin()->first.y, this->changes.begin()->second.height));
+	}
 
 	/* Second iteration: Change the ground of the tiles. */
 	for (auto &iter : this->changes) {
@@ -578,6 +586,7 @@ bool TerrainChanges::ModifyWorld(const int direction)
 			v->SetFoundationSlope(0);
 		}
 		AddGroundFencesToMap(fences, vs, height); // Add fences last, as it assumes ground has been fully set.
+		_world.MarkStackDirty(pos.x, pos.y);
 	}
 
 	/* Third iteration: Add foundations to every changed tile edge.
@@ -626,6 +635,14 @@ bool TerrainChanges::ModifyWorld(const int direction)
  */
 void ChangeTileCursorMode(const Point16 &voxel_pos, CursorType ctype, bool levelling, int direction, bool dot_mode)
 {
+	ReplayCommand cmd(RCT_TERRAFORM_TILE);
+	cmd.pos = XYZPoint16(voxel_pos.x, voxel_pos.y, 0);
+	cmd.data[0] = ctype;
+	cmd.data[1] = levelling ? 1 : 0;
+	cmd.data[2] = dot_mode ? 1 : 0;
+	cmd.value = direction;
+	_replay.Record(cmd);
+
 	if (_game_mode_mgr.InPlayMode() && _world.GetTileOwner(voxel_pos.x, voxel_pos.y) != OWN_PARK) return;
 
 	Point16 p;
@@ -675,6 +692,13 @@ void ChangeTileCursorMode(const Point16 &voxel_pos, CursorType ctype, bool level
  */
 void ChangeAreaCursorMode(const Rectangle16 &orig_area, bool levelling, int direction)
 {
+	ReplayCommand cmd(RCT_TERRAFORM_AREA);
+	cmd.pos = XYZPoint16(orig_area.base.x, orig_area.base.y, 0);
+	cmd.size = Point16(orig_area.width, orig_area.height);
+	cmd.data[1] = levelling ? 1 : 0;
+	cmd.value = direction;
+	_replay.Record(cmd);
+
 	Point16 p;
 
 	Rectangle16 area(orig_area); // Restrict area to on-world.
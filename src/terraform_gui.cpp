@@ -16,6 +16,7 @@
 #include "sprite_data.h"
 #include "gui_sprites.h"
 #include "mouse_mode.h"
+#include "replay.h"
 
 static const int TERRAFORM_MAX_SIZE = 9;      ///< Maximum length of tiles for terraforming (both X and Y).
 static const int TERRAFORM_ELEMENT_SIZE = 16; ///< Horizontal size of a tile in the display (pixels).
@@ -162,6 +163,12 @@ void TerraformGui::DoChangeLandOwner()
 	if (this->change_owner.has_value()) {
 		_world.SetTileOwnerRect(this->tiles_selector.area.base.x, this->tiles_selector.area.base.y,
 				this->tiles_selector.area.width, this->tiles_selector.area.height, *this->change_owner);
+
+		ReplayCommand cmd(RCT_CHANGE_LAND_OWNER);
+		cmd.pos = XYZPoint16(this->tiles_selector.area.base.x, this->tiles_selector.area.base.y, 0);
+		cmd.size = Point16(this->tiles_selector.area.width, this->tiles_selector.area.height);
+		cmd.data[0] = *this->change_owner;
+		_replay.Record(cmd);
 	}
 }
 
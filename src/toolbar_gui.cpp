@@ -220,19 +220,19 @@ void ToolbarWindow::OnClick(WidgetNumber number, [[maybe_unused]] const Point16
 		}
 
 		case TB_SPEED_0:
-			_game_control.speed = GSP_PAUSE;
+			_game_control.SetSpeed(GSP_PAUSE);
 			break;
 		case TB_SPEED_1:
-			_game_control.speed = GSP_1;
+			_game_control.SetSpeed(GSP_1);
 			break;
 		case TB_SPEED_2:
-			_game_control.speed = GSP_2;
+			_game_control.SetSpeed(GSP_2);
 			break;
 		case TB_SPEED_4:
-			_game_control.speed = GSP_4;
+			_game_control.SetSpeed(GSP_4);
 			break;
 		case TB_SPEED_8:
-			_game_control.speed = GSP_8;
+			_game_control.SetSpeed(GSP_8);
 			break;
 
 		case TB_GUI_PATHS:
@@ -425,6 +425,7 @@ static const WidgetPart _bottom_toolbar_widgets[] = {
 
 BottomToolbarWindow::BottomToolbarWindow() : GuiWindow(WC_BOTTOM_TOOLBAR, ALL_WINDOWS_OF_TYPE)
 {
+	this->refresh_interval = LIVE_DATA_REFRESH_INTERVAL;  // The date, money, and guests of the park change all the time.
 	this->closeable = false;
 	this->SetupWidgetTree(_bottom_toolbar_widgets, lengthof(_bottom_toolbar_widgets));
 }
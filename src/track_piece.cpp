@@ -167,6 +167,7 @@ void TrackPiece::RemoveFromWorld([[maybe_unused]] const uint16 ride_index, const
 			assert(voxel->instance == ride_index);
 			voxel->ClearInstances();
 		}
+		_world.MarkStackDirty(base_voxel.x + subpiece->dxyz.x, base_voxel.y + subpiece->dxyz.y);
 	}
 }
 
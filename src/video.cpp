@@ -17,6 +17,7 @@
 #include "string_func.h"
 #include "window.h"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <sstream>
@@ -100,7 +101,8 @@ void TextRenderer::LoadFont(const FontSet *font)
 	FT_Select_Charmap(face, FT_ENCODING_UNICODE);
 
 	FT_Set_Pixel_Sizes(face, 0, font->font_size);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	const bool software = _video.IsSoftwareRendering();
+	if (!software) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	/* Load all characters we may need. */
 	for (uint32 codepoint = font->codepoint_ranges.front().first; codepoint <= MAX_CODEPOINT; codepoint = NextCodepointToLoad(font, codepoint)) {
@@ -113,23 +115,38 @@ void TextRenderer::LoadFont(const FontSet *font)
 		}
 
 		GLuint texture;
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glTexImage2D(
-				GL_TEXTURE_2D,
-				0,
-				GL_R8,
-				face->glyph->bitmap.width,
-				face->glyph->bitmap.rows,
-				0,
-				GL_RED,
-				GL_UNSIGNED_BYTE,
-				face->glyph->bitmap.buffer
-		);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		if (software) {
+			/* White pixels with the coverage of the glyph as opacity, the text colour is applied while drawing. */
+			const FT_Bitmap &bitmap = face->glyph->bitmap;
+			std::unique_ptr<uint8[]> rgba(new uint8[bitmap.width * bitmap.rows * 4]);
+			for (uint32 y = 0; y < bitmap.rows; y++) {
+				for (uint32 x = 0; x < bitmap.width; x++) {
+					uint8 *p = rgba.get() + (y * bitmap.width + x) * 4;
+					p[0] = p[1] = p[2] = OPAQUE;
+					p[3] = bitmap.buffer[y * bitmap.pitch + x];
+				}
+			}
+			texture = _video.CreateTexture(bitmap.width, bitmap.rows);
+			_video.UpdateTexture(texture, Rectangle32(0, 0, bitmap.width, bitmap.rows), rgba.get(), bitmap.width);
+		} else {
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexImage2D(
+					GL_TEXTURE_2D,
+					0,
+					GL_R8,
+					face->glyph->bitmap.width,
+					face->glyph->bitmap.rows,
+					0,
+					GL_RED,
+					GL_UNSIGNED_BYTE,
+					face->glyph->bitmap.buffer
+			);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
 
 		this->characters[codepoint] = {
 			texture,
@@ -140,7 +157,7 @@ void TextRenderer::LoadFont(const FontSet *font)
 		};
 	}
 
-	glBindTexture(GL_TEXTURE_2D, 0);
+	if (!software) glBindTexture(GL_TEXTURE_2D, 0);
 	FT_Done_Face(face);
 	FT_Done_FreeType(ft);
 
@@ -203,14 +220,17 @@ void TextRenderer::Draw(const std::string &text, float x, float y, float max_wid
 {
 	if (text.empty()) return;
 
-	glUseProgram(this->shader);
-	glUniform1f(glGetUniformLocation(this->shader, "text_colour_r"), FGetR(colour));
-	glUniform1f(glGetUniformLocation(this->shader, "text_colour_g"), FGetG(colour));
-	glUniform1f(glGetUniformLocation(this->shader, "text_colour_b"), FGetB(colour));
-	glUniform1f(glGetUniformLocation(this->shader, "text_colour_a"), FGetA(colour));
+	const bool software = _video.IsSoftwareRendering();
+	if (!software) {
+		glUseProgram(this->shader);
+		glUniform1f(glGetUniformLocation(this->shader, "text_colour_r"), FGetR(colour));
+		glUniform1f(glGetUniformLocation(this->shader, "text_colour_g"), FGetG(colour));
+		glUniform1f(glGetUniformLocation(this->shader, "text_colour_b"), FGetB(colour));
+		glUniform1f(glGetUniformLocation(this->shader, "text_colour_a"), FGetA(colour));
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(this->vao);
+		glActiveTexture(GL_TEXTURE0);
+		glBindVertexArray(this->vao);
+	}
 
 	/* Insert some padding around the text.
 	 * Horizontal spacing is distributed equally on both sides of the text,
@@ -235,6 +255,12 @@ void TextRenderer::Draw(const std::string &text, float x, float y, float max_wid
 		/* Prevent fuzzy rendering. */
 		x1 = round(x1); y1 = round(y1); x2 = round(x2); y2 = round(y2);
 
+		if (software) {
+			_video.BlitTexture(fg.texture_id, Rectangle32(x1, y1, x2 - x1, y2 - y1), colour);
+			x += (fg.advance >> 6) * scale;
+			continue;
+		}
+
 		_video.CoordsToGL(&x1, &y1);
 		_video.CoordsToGL(&x2, &y2);
 
@@ -254,6 +280,7 @@ void TextRenderer::Draw(const std::string &text, float x, float y, float max_wid
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 		x += (fg.advance >> 6) * scale;
 	}
+	if (software) return;
 	glBindVertexArray(0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -320,7 +347,19 @@ void VideoSystem::FramebufferSizeCallback([[maybe_unused]] GLFWwindow *window, i
 	_video.height = new_h;
 	_video.UpdateClip();
 
-	_window_manager.RepositionAllWindows(_video.width, _video.height);
+	/* The windows belong to the game state, which another thread may be changing while input is ignored. */
+	if (_video.ignore_input) {
+		_video.resize_pending = true;
+		return;
+	}
+	_video.RepositionWindows();
+}
+
+/** Fit the windows to the current size of the FreeRCT window. */
+void VideoSystem::RepositionWindows()
+{
+	this->resize_pending = false;
+	_window_manager.RepositionAllWindows(this->width, this->height);
 	NotifyChange(WC_BOTTOM_TOOLBAR, ALL_WINDOWS_OF_TYPE, CHG_RESOLUTION_CHANGED, 0);
 }
 
@@ -335,6 +374,7 @@ void VideoSystem::FramebufferSizeCallback([[maybe_unused]] GLFWwindow *window, i
 void VideoSystem::KeyCallback([[maybe_unused]] GLFWwindow *window, int key, [[maybe_unused]] int scancode, int action, int mods)
 {
 	assert(window == _video.window);
+	if (_video.ignore_input) return;
 	if (action != GLFW_PRESS && action != GLFW_REPEAT) return;
 
 	WmKeyMod mod_mask = WMKM_NONE;
@@ -458,6 +498,7 @@ void VideoSystem::KeyCallback([[maybe_unused]] GLFWwindow *window, int key, [[ma
 void VideoSystem::TextCallback([[maybe_unused]] GLFWwindow *window, uint32 codepoint)
 {
 	assert(window == _video.window);
+	if (_video.ignore_input) return;
 	char buffer[] = {0, 0, 0, 0, 0};
 	EncodeUtf8Char(codepoint, buffer);
 	_window_manager.KeyEvent(WMKC_SYMBOL, WMKM_NONE, buffer);
@@ -474,6 +515,7 @@ void VideoSystem::MouseMoveCallback([[maybe_unused]] GLFWwindow *window, double
 	assert(window == _video.window);
 	_video.mouse_x = std::max(0.0, std::min<double>(x, _video.width));
 	_video.mouse_y = std::max(0.0, std::min<double>(y, _video.height));
+	if (_video.ignore_input) return;
 	_window_manager.MouseMoveEvent();
 }
 
@@ -486,7 +528,7 @@ void VideoSystem::MouseMoveCallback([[maybe_unused]] GLFWwindow *window, double
 void VideoSystem::ScrollCallback([[maybe_unused]] GLFWwindow *window, [[maybe_unused]] double xdelta, double ydelta)
 {
 	assert(window == _video.window);
-	if (abs(ydelta) < 0.01) return;
+	if (_video.ignore_input || abs(ydelta) < 0.01) return;
 	_window_manager.MouseWheelEvent((ydelta > 0) ? 1 : -1);
 }
 
@@ -499,6 +541,7 @@ void VideoSystem::ScrollCallback([[maybe_unused]] GLFWwindow *window, [[maybe_un
  */
 void VideoSystem::MouseClickCallback([[maybe_unused]] GLFWwindow *window, int button, int action, [[maybe_unused]] int mods) {
 	assert(window == _video.window);
+	if (_video.ignore_input) return;
 
 	MouseButtons mouse_button;
 	switch (button) {
@@ -526,12 +569,16 @@ void VideoSystem::SetMouseDragging(MouseButtons button, bool dragging, bool hide
 	} else {
 		this->mouse_dragging &= ~button;
 	}
-	glfwSetInputMode(window, GLFW_CURSOR, hide_cursor ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+	if (this->window != nullptr) glfwSetInputMode(this->window, GLFW_CURSOR, hide_cursor ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
 }
 
 /** Shut down the video system. */
 void VideoSystem::Shutdown()
 {
+	if (this->software != nullptr) {
+		this->software.reset();
+		return;
+	}
 	glfwTerminate();
 }
 
@@ -554,6 +601,8 @@ void VideoSystem::Initialize(std::vector<const FontSet*> fonts)
 	this->mouse_x = this->width / 2;
 	this->mouse_y = this->height / 2;
 	this->mouse_dragging = MB_NONE;
+	this->render_target = nullptr;
+	this->render_origin = Point32(0, 0);
 
 	std::string caption = "FreeRCT ";
 	caption += _freerct_revision;
@@ -612,6 +661,33 @@ void VideoSystem::Initialize(std::vector<const FontSet*> fonts)
 	this->average_frametime = 1;
 }
 
+/**
+ * Initialize the graphics system to draw into memory with the software renderer, without opening a window.
+ * @param fonts Font files to load.
+ * @param width Width of the screen in pixels.
+ * @param height Height of the screen in pixels.
+ */
+void VideoSystem::InitializeSoftware(std::vector<const FontSet*> fonts, uint32 width, uint32 height)
+{
+	this->width = width;
+	this->height = height;
+	this->mouse_x = this->width / 2;
+	this->mouse_y = this->height / 2;
+	this->mouse_dragging = MB_NONE;
+	this->render_target = nullptr;
+	this->render_origin = Point32(0, 0);
+	this->window = nullptr;
+	this->software.reset(new SoftwareRenderer(width, height));
+	this->resolutions.emplace(width, height);
+	this->UpdateClip();
+
+	for (const FontSet *font : fonts) _text_renderer.LoadFont(font);
+
+	this->last_frame = std::chrono::high_resolution_clock::now();
+	this->cur_frame = this->last_frame;
+	this->average_frametime = 1;
+}
+
 /** Run the main loop. */
 void VideoSystem::MainLoop()
 {
@@ -630,7 +706,6 @@ void VideoSystem::MainLoop()
  */
 bool VideoSystem::MainLoopDoCycle()
 {
-	constexpr uint32 FRAME_DELAY = 30;        ///< Minimum number of milliseconds between two frames.
 	constexpr double AVERAGE_FPS_STEPS = 15;  ///< Number of frame iterations in the average framerate computation.
 	this->last_frame = this->cur_frame;
 	this->cur_frame = std::chrono::high_resolution_clock::now();
@@ -640,16 +715,21 @@ bool VideoSystem::MainLoopDoCycle()
 	this->SetResolution({GetEmscriptenCanvasWidth(), GetEmscriptenCanvasHeight()});
 #endif
 
-	/* Handle input events. */
-	glfwPollEvents();
-
-	/* Prepare for the next rendering step. */
-	glClear(GL_COLOR_BUFFER_BIT);
+	/* Handle input events, and prepare for the next rendering step. */
+	if (this->software != nullptr) {
+		this->software->Clear();
+	} else {
+		glfwPollEvents();
+		if (this->resize_pending) this->RepositionWindows();
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
 
 	/* Progress the game. */
 	OnNewFrame(FRAME_DELAY);
 	_game_control.DoNextAction();
-	if (!_game_control.running || glfwWindowShouldClose(this->window)) return false;
+	if (!_game_control.running) return false;
+	if (this->software != nullptr) return true;  // Without display, there is no window to close nor a need to wait.
+	if (glfwWindowShouldClose(this->window)) return false;
 
 	/* Cap the FPS rate. */
 	double time = Delta(this->cur_frame);
@@ -661,7 +741,67 @@ bool VideoSystem::MainLoopDoCycle()
 /** Finish repainting, perform the final steps. */
 void VideoSystem::FinishRepaint()
 {
-	glfwSwapBuffers(this->window);
+	if (this->window != nullptr) glfwSwapBuffers(this->window);
+}
+
+/**
+ * Show a progress bar on an otherwise empty screen, while the game state is being changed by another thread.
+ * Window events are handled to keep the window responsive, but input is not passed to the windows.
+ * @param fraction Part of the work that is done, between \c 0 and \c 1.
+ */
+void VideoSystem::ShowProgress(double fraction)
+{
+	if (this->window == nullptr) return;
+
+	const Realtime start = std::chrono::high_resolution_clock::now();
+	this->ignore_input = true;
+	glfwPollEvents();
+	this->ignore_input = false;
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	const int bar_width = std::min<int>(this->width / 2, 400);
+	const int bar_height = 20;
+	const Rectangle32 bar((static_cast<int>(this->width) - bar_width) / 2, (static_cast<int>(this->height) - bar_height) / 2, bar_width, bar_height);
+	const int done = std::clamp(fraction, 0.0, 1.0) * (bar_width - 4);
+	this->DrawRectangle(bar, 0xffffffff);
+	if (done > 0) this->FillRectangle(Rectangle32(bar.base.x + 2, bar.base.y + 2, done, bar_height - 4), 0xffffffff);
+	this->FinishRepaint();
+
+	double time = Delta(start);
+	if (time < FRAME_DELAY) std::this_thread::sleep_for(Duration(FRAME_DELAY - time));
+}
+
+/**
+ * Run the main loop with the software renderer, without saving the screen.
+ * @param frames Number of frames to draw.
+ * @return Number of drawn frames, less than \a frames if the game ended.
+ */
+int VideoSystem::RenderFrames(int frames)
+{
+	assert(this->software != nullptr);
+	int drawn = 0;
+	while (drawn < frames && this->MainLoopDoCycle()) drawn++;
+	return drawn;
+}
+
+/**
+ * Draw frames with the software renderer, and save the screen of the last frame as PNG file.
+ * @param fname Name of the file to write.
+ * @param frames Number of frames to draw.
+ * @return Whether the screenshot was saved successfully.
+ */
+bool VideoSystem::RenderScreenshot(const std::string &fname, int frames)
+{
+	const Realtime start = std::chrono::high_resolution_clock::now();
+	const int drawn = this->RenderFrames(frames);
+	const double time = Delta(start);
+	printf("Drew %d frames of %ux%u pixels in %.1f ms (%.3f ms per frame)\n", drawn, this->width, this->height, time, (drawn > 0) ? time / drawn : 0.0);
+
+	if (!this->software->SavePng(fname)) {
+		fprintf(stderr, "Cannot write screenshot '%s'\n", fname.c_str());
+		return false;
+	}
+	return true;
 }
 
 /**
@@ -689,7 +829,16 @@ double VideoSystem::AvgFPS() const
  */
 void VideoSystem::SetResolution(const Point32 &res)
 {
-	glfwSetWindowSize(this->window, res.x, res.y);
+	if (this->software == nullptr) {
+		glfwSetWindowSize(this->window, res.x, res.y);
+		return;
+	}
+
+	this->software->Resize(res.x, res.y);
+	this->width = res.x;
+	this->height = res.y;
+	this->UpdateClip();
+	this->RepositionWindows();
 }
 
 /**
@@ -718,17 +867,29 @@ void VideoSystem::PopClip()
 /** Update the current clipping area. */
 void VideoSystem::UpdateClip()
 {
+	if (this->software != nullptr) {
+		if (this->clip.empty()) {
+			this->software->SetClip(0, 0, this->render_target == nullptr ? this->width : this->render_target->width,
+					this->render_target == nullptr ? this->height : this->render_target->height);
+		} else {
+			const Rectangle32 &rect = this->clip.back();
+			this->software->SetClip(rect.base.x - this->render_origin.x, rect.base.y - this->render_origin.y, rect.width, rect.height);
+		}
+		return;
+	}
+
+	const float target_height = (this->render_target == nullptr) ? this->height : this->render_target->height;
 	float x, y, w, h;
 	if (this->clip.empty()) {
 		x = 0;
 		y = 0;
-		w = this->width;
-		h = this->height;
+		w = (this->render_target == nullptr) ? this->width : this->render_target->width;
+		h = target_height;
 	} else {
 		w = this->clip.back().width;
 		h = this->clip.back().height;
-		x = this->clip.back().base.x;
-		y = this->height - h - this->clip.back().base.y;
+		x = this->clip.back().base.x - this->render_origin.x;
+		y = target_height - h - (this->clip.back().base.y - this->render_origin.y);
 	}
 	glViewport(x, y, w, h);
 }
@@ -741,8 +902,15 @@ void VideoSystem::UpdateClip()
 void VideoSystem::CoordsToGL(float *x, float *y) const {
 	float w, h;
 	if (this->clip.empty()) {
-		w = this->width;
-		h = this->height;
+		if (this->render_target == nullptr) {
+			w = this->width;
+			h = this->height;
+		} else {
+			w = this->render_target->width;
+			h = this->render_target->height;
+			*x -= this->render_origin.x;
+			*y -= this->render_origin.y;
+		}
 	} else {
 		w = this->clip.back().width;
 		h = this->clip.back().height;
@@ -877,6 +1045,12 @@ GLuint VideoSystem::GetImageTexture(const ImageData *img, const Recolouring &rec
 	const auto it = this->image_textures.find(map_key);
 	if (it != this->image_textures.end()) return it->second;
 
+	if (this->software != nullptr) {
+		GLuint t = this->software->CreateTexture(img->width, img->height, img->GetRecoloured(shift, recolour));
+		this->image_textures.emplace(map_key, t);
+		return t;
+	}
+
 	GLuint t = 0;
 	glGenTextures(1, &t);
 	glBindTexture(GL_TEXTURE_2D, t);
@@ -927,6 +1101,197 @@ void VideoSystem::TileImage(const ImageData *img, const Rectangle32 &rect, bool
 				));
 }
 
+/**
+ * Create a texture whose contents are composed by the caller instead of being loaded from an image.
+ * The texture is not scaled smoothly, so each of its pixels can be drawn as a solid block.
+ * @param width Width of the texture in pixels.
+ * @param height Height of the texture in pixels.
+ * @return The new texture, with undefined contents. Release it with #DeleteTexture.
+ * @see UpdateTexture
+ */
+GLuint VideoSystem::CreateTexture(uint32 width, uint32 height)
+{
+	if (this->software != nullptr) return this->software->CreateTexture(width, height);
+
+	GLuint t = 0;
+	glGenTextures(1, &t);
+	glBindTexture(GL_TEXTURE_2D, t);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	return t;
+}
+
+/**
+ * Replace a part of a texture created with #CreateTexture.
+ * @param texture Texture to modify.
+ * @param rect Area of the texture to replace, in pixels.
+ * @param rgba RGBA pixel data of the entire texture, the part inside \a rect is copied.
+ * @param stride Number of pixels in one row of \a rgba.
+ */
+void VideoSystem::UpdateTexture(GLuint texture, const Rectangle32 &rect, const uint8 *rgba, uint32 stride)
+{
+	if (this->software != nullptr) {
+		this->software->UpdateTexture(texture, rect, rgba, stride);
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, rect.base.x);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, rect.base.y);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, rect.base.x, rect.base.y, rect.width, rect.height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+/**
+ * Release a texture created with #CreateTexture.
+ * @param texture Texture to delete.
+ */
+void VideoSystem::DeleteTexture(GLuint texture)
+{
+	if (this->software != nullptr) {
+		this->software->DeleteTexture(texture);
+		return;
+	}
+	glDeleteTextures(1, &texture);
+}
+
+/**
+ * Draw a texture created with #CreateTexture, stretched to fill an area.
+ * @param texture Texture to draw.
+ * @param rect Rectangle to fill.
+ * @param col RGBA colour to overlay over the texture.
+ */
+void VideoSystem::BlitTexture(GLuint texture, const Rectangle32 &rect, uint32 col)
+{
+	this->DoDrawImage(texture, rect.base.x, rect.base.y,
+			rect.base.x + static_cast<float>(rect.width), rect.base.y + static_cast<float>(rect.height), col);
+}
+
+/**
+ * (Re)create a render target with the given size. Its previous contents are lost.
+ * @param target [inout] Render target to resize.
+ * @param width New width in pixels.
+ * @param height New height in pixels.
+ * @return Whether the render target can be used. If not, draw at the screen directly instead.
+ */
+bool VideoSystem::ResizeRenderTarget(RenderTarget *target, uint32 width, uint32 height)
+{
+	this->DeleteRenderTarget(target);
+	target->width = width;
+	target->height = height;
+	if (width == 0 || height == 0) return false;
+
+	target->texture = this->CreateTexture(width, height);
+	if (this->software != nullptr) {
+		target->framebuffer = target->texture;  // The texture itself is drawn into.
+		return true;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &target->framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->texture, 0);
+	const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (!complete) this->DeleteRenderTarget(target);
+	return complete;
+}
+
+/**
+ * Release the OpenGL resources of a render target. Its size is kept.
+ * @param target [inout] Render target to clean up.
+ */
+void VideoSystem::DeleteRenderTarget(RenderTarget *target)
+{
+	if (this->software != nullptr) {
+		if (target->texture != 0) this->software->DeleteTexture(target->texture);
+	} else {
+		if (target->framebuffer != 0) glDeleteFramebuffers(1, &target->framebuffer);
+		if (target->texture != 0) glDeleteTextures(1, &target->texture);
+	}
+	target->framebuffer = 0;
+	target->texture = 0;
+}
+
+/**
+ * Redirect all drawing to a render target, until #EndRenderTarget is called.
+ * Drawing still happens in screen coordinates, as if the render target was put at the screen at \a origin.
+ * @param target Render target to draw into.
+ * @param origin Screen position of the top-left corner of the render target.
+ * @param area Screen area to redraw. It is made transparent, and nothing outside it is changed.
+ */
+void VideoSystem::BeginRenderTarget(const RenderTarget &target, const Point32 &origin, const Rectangle32 &area)
+{
+	assert(this->render_target == nullptr && target.framebuffer != 0);
+	this->render_target = &target;
+	this->render_origin = origin;
+	if (this->software != nullptr) {
+		this->software->BeginTarget(target.texture, Rectangle32(area.base.x - origin.x, area.base.y - origin.y, area.width, area.height));
+		this->UpdateClip();
+		return;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+	this->UpdateClip();
+
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(area.base.x - origin.x, static_cast<int>(target.height) - (area.base.y - origin.y) - static_cast<int>(area.height), area.width, area.height);
+	glClearColor(0.f, 0.f, 0.f, 0.f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glClearColor(0.f, 0.f, 0.f, 1.0f);
+
+	/* Accumulate coverage in the alpha channel, which leaves the colours premultiplied by it. */
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+/** Stop drawing into a render target, and continue drawing at the screen. */
+void VideoSystem::EndRenderTarget()
+{
+	assert(this->render_target != nullptr);
+	if (this->software != nullptr) {
+		this->software->EndTarget();
+	} else {
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glDisable(GL_SCISSOR_TEST);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	this->render_target = nullptr;
+	this->render_origin = Point32(0, 0);
+	this->UpdateClip();
+}
+
+/**
+ * Draw the contents of a render target at the screen.
+ * @param target Render target to draw.
+ * @param pos Screen position of the top-left corner.
+ */
+void VideoSystem::BlitRenderTarget(const RenderTarget &target, const Point32 &pos)
+{
+	if (target.framebuffer == 0) return;
+
+	if (this->software != nullptr) {
+		this->software->DrawTexture(target.texture, pos.x - this->render_origin.x, pos.y - this->render_origin.y,
+				pos.x - this->render_origin.x + static_cast<float>(target.width), pos.y - this->render_origin.y + static_cast<float>(target.height),
+				0xffffffff, WXYZPointF(0.0f, 0.0f, 1.0f, 1.0f), true);
+		return;
+	}
+
+	/* The colours are premultiplied by alpha, and framebuffer rows run from bottom to top. */
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	this->DoDrawImage(target.texture, pos.x, pos.y,
+			pos.x + static_cast<float>(target.width), pos.y + static_cast<float>(target.height),
+			0xffffffff, WXYZPointF(1.0f, 0.0f, 0.0f, 1.0f));
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
 /**
  * Get the text-size of a number between \a smallest and \a biggest.
  * @param smallest Smallest possible number to display.
@@ -1000,6 +1365,12 @@ void VideoSystem::BlitText(const std::string &text, uint32 colour, int xpos, int
  */
 void VideoSystem::DoDrawImage(GLuint texture, float x1, float y1, float x2, float y2, uint32 col, const WXYZPointF &tex)
 {
+	if (this->software != nullptr) {
+		this->software->DrawTexture(texture, x1 - this->render_origin.x, y1 - this->render_origin.y,
+				x2 - this->render_origin.x, y2 - this->render_origin.y, col, tex);
+		return;
+	}
+
 	this->CoordsToGL(&x1, &y1);
 	this->CoordsToGL(&x2, &y2);
 	float vertices[] = {
@@ -1037,6 +1408,15 @@ void VideoSystem::DoDrawImage(GLuint texture, float x1, float y1, float x2, floa
  * @param col RGBA colour to use.
  */
 void VideoSystem::DoDrawPlainColours(const std::vector<Point<float>> &points, uint32 col) {
+	if (this->software != nullptr) {
+		for (const auto &p : points) {
+			const float x = std::floor(p.x) - this->render_origin.x;
+			const float y = std::floor(p.y) - this->render_origin.y;
+			this->software->FillRectangle(x, y, x + 1.0f, y + 1.0f, col);
+		}
+		return;
+	}
+
 	struct PerVertexData {
 		float gl_x;
 		float gl_y;
@@ -1080,6 +1460,11 @@ void VideoSystem::DoDrawPlainColours(const std::vector<Point<float>> &points, ui
  * @param col RGBA colour to use.
  */
 void VideoSystem::DoDrawLine(float x1, float y1, float x2, float y2, uint32 col) {
+	if (this->software != nullptr) {
+		this->software->DrawLine(x1 - this->render_origin.x, y1 - this->render_origin.y, x2 - this->render_origin.x, y2 - this->render_origin.y, col);
+		return;
+	}
+
 	this->CoordsToGL(&x1, &y1);
 	this->CoordsToGL(&x2, &y2);
 	float vertices[] = {
@@ -1107,6 +1492,11 @@ void VideoSystem::DoDrawLine(float x1, float y1, float x2, float y2, uint32 col)
  * @param col RGBA colour to use.
  */
 void VideoSystem::DoFillPlainColour(float x1, float y1, float x2, float y2, uint32 col) {
+	if (this->software != nullptr) {
+		this->software->FillRectangle(x1 - this->render_origin.x, y1 - this->render_origin.y, x2 - this->render_origin.x, y2 - this->render_origin.y, col);
+		return;
+	}
+
 	this->CoordsToGL(&x1, &y1);
 	this->CoordsToGL(&x2, &y2);
 	float vertices[] = {
@@ -13,6 +13,7 @@
 #include "stdafx.h"
 #include "geometry.h"
 #include "palette.h"
+#include "software_renderer.h"
 #include "time_func.h"
 #include "window_constants.h"
 
@@ -68,10 +69,28 @@ enum Alignment {
 	ALG_RIGHT,   ///< Align to the right edge.
 };
 
+/** Offscreen image that can be drawn into, and put at the screen afterwards. */
+struct RenderTarget {
+	GLuint framebuffer = 0;  ///< OpenGL framebuffer object, \c 0 if the render target is not available.
+	GLuint texture = 0;      ///< Texture containing the drawn image.
+	uint32 width = 0;        ///< Width of the image in pixels.
+	uint32 height = 0;       ///< Height of the image in pixels.
+};
+
 /** Class providing the interface to the OpenGL rendering backend. */
 class VideoSystem {
 public:
 	void Initialize(std::vector<const FontSet*> fonts);
+	void InitializeSoftware(std::vector<const FontSet*> fonts, uint32 width, uint32 height);
+
+	/**
+	 * Whether drawing happens in memory by the software renderer, instead of at a window with OpenGL.
+	 * @return The software renderer is used.
+	 */
+	bool IsSoftwareRendering() const
+	{
+		return this->software != nullptr;
+	}
 
 	static void MainLoopCycle();
 	void MainLoop();
@@ -204,10 +223,24 @@ public:
 	void BlitImage(const Point32 &pos, const ImageData *img, const Recolouring &recolour = _no_recolour,
 			GradientShift shift = GS_NORMAL, uint32 col = 0xffffffff);
 
+	GLuint CreateTexture(uint32 width, uint32 height);
+	void UpdateTexture(GLuint texture, const Rectangle32 &rect, const uint8 *rgba, uint32 stride);
+	void DeleteTexture(GLuint texture);
+	void BlitTexture(GLuint texture, const Rectangle32 &rect, uint32 col = 0xffffffff);
+
+	bool ResizeRenderTarget(RenderTarget *target, uint32 width, uint32 height);
+	void DeleteRenderTarget(RenderTarget *target);
+	void BeginRenderTarget(const RenderTarget &target, const Point32 &origin, const Rectangle32 &area);
+	void EndRenderTarget();
+	void BlitRenderTarget(const RenderTarget &target, const Point32 &pos);
+
 	void PushClip(const Rectangle32 &rect);
 	void PopClip();
 
 	void FinishRepaint();
+	int RenderFrames(int frames);
+	bool RenderScreenshot(const std::string &fname, int frames);
+	void ShowProgress(double fraction);
 
 private:
 	bool MainLoopDoCycle();
@@ -223,6 +256,8 @@ private:
 	void DoDrawLine(float x1, float y1, float x2, float y2, uint32 colour);
 	void DoFillPlainColour(float x1, float y1, float x2, float y2, uint32 colour);
 
+	void RepositionWindows();
+
 	static void FramebufferSizeCallback(GLFWwindow *window, int new_w, int new_h);
 	static void MouseClickCallback(GLFWwindow *window, int button, int action, int mods);
 	static void MouseMoveCallback(GLFWwindow *window, double x, double y);
@@ -235,6 +270,8 @@ private:
 	double mouse_x;   ///< Current mouse X position.
 	double mouse_y;   ///< Current mouse Y position.
 	MouseButtons mouse_dragging;  ///< The mouse button being dragged, if any.
+	bool ignore_input = false;    ///< Whether input events are dropped instead of passed to the windows.
+	bool resize_pending = false;  ///< Whether the window size changed while input was ignored, and the windows must still be repositioned.
 
 	std::set<Point32> resolutions;  ///< Available window resolutions.
 
@@ -251,8 +288,11 @@ private:
 	GLuint ebo;            ///< The OpenGL element buffer.
 
 	std::vector<Rectangle32> clip;  ///< Current clipping area stack.
+	const RenderTarget *render_target;  ///< Render target being drawn into, \c nullptr while drawing at the screen.
+	Point32 render_origin;              ///< Screen position of the top-left corner of #render_target.
 
-	GLFWwindow *window;  ///< The GLFW window.
+	GLFWwindow *window;  ///< The GLFW window, \c nullptr when using the software renderer.
+	std::unique_ptr<SoftwareRenderer> software;  ///< Renderer drawing into memory, \c nullptr when drawing with OpenGL.
 };
 
 constexpr int WINDOW_ICON_WIDTH  = 32;  ///< Width of the window/taskbar icon.
@@ -702,8 +702,9 @@ void SpriteCollector::CollectVoxel(const Voxel *voxel, const XYZPoint16 &voxel_p
 			!IsImplodedSteepSlope(voxel->GetGroundSlope()) || IsImplodedSteepSlopeTop(voxel->GetGroundSlope())) ? voxel_pos.z : (voxel_pos.z + 1);
 	while (vo != nullptr) {
 		const Recolouring *recolour;
-		const ImageData *anim_spr = vo->GetSprite(this->orient, this->zoom, &recolour);
-		if (anim_spr != nullptr && (!this->vp->GetDisplayFlag(DF_HIDE_PEOPLE) || dynamic_cast<const Person*>(vo) == nullptr)) {
+		const bool hidden = vo->kind == VOK_PERSON && this->vp->GetDisplayFlag(DF_HIDE_PEOPLE);
+		const ImageData *anim_spr = hidden ? nullptr : vo->GetSprite(this->orient, this->zoom, &recolour);
+		if (anim_spr != nullptr) {
 			int x_off = ComputeX(vo->pix_pos.x, vo->pix_pos.y);
 			int y_off = ComputeY(vo->pix_pos.x, vo->pix_pos.y, vo->pix_pos.z);
 			Point32 pos(north_point.x + this->north_offsets[this->orient].x + x_off,
@@ -873,7 +874,7 @@ void PixelFinder::CollectVoxel(const Voxel *voxel, const XYZPoint16 &voxel_pos,
 	if ((this->allowed & CS_PERSON) != 0 && !this->vp->GetDisplayFlag(DF_HIDE_PEOPLE)) {
 		/* Looking for persons? */
 		for (const VoxelObject *vo = voxel->voxel_objects; vo != nullptr; vo = vo->next_object) {
-			const Person *pers = dynamic_cast<const Person *>(vo);
+			const Person *pers = GetPerson(vo);
 			if (pers == nullptr) continue;
 			assert(pers->walk != nullptr);
 			AnimationType anim_type = pers->walk->anim_type;
@@ -1080,7 +1081,7 @@ void Viewport::OnDraw(MouseModeSelector *selector)
 	if (this->GetDisplayFlag(DF_FPS)) {
 		constexpr const int SPACING = 4;
 		/* FPS is only interesting for developers, no need to make this translatable. */
-		_video.BlitText(Format("FPS: %2.1f (avg. %2.1f)", _video.FPS(), _video.AvgFPS()),
+		_video.BlitText(Format("FPS: %2.1f (avg. %2.1f), widgets drawn: %u", _video.FPS(), _video.AvgFPS(), _window_manager.last_widget_draw_count),
 				_palette[TEXT_WHITE], SPACING, SPACING, _video.Width() - 2 * SPACING, ALG_RIGHT);
 	}
 
@@ -1240,29 +1241,29 @@ bool Viewport::OnKeyEvent(WmKeyCode key_code, WmKeyMod mod, const std::string &s
 			return true;
 
 		case KS_INGAME_SPEED_PAUSE:
-			_game_control.speed = GSP_PAUSE;
+			_game_control.SetSpeed(GSP_PAUSE);
 			return true;
 		case KS_INGAME_SPEED_1:
-			_game_control.speed = GSP_1;
+			_game_control.SetSpeed(GSP_1);
 			return true;
 		case KS_INGAME_SPEED_2:
-			_game_control.speed = GSP_2;
+			_game_control.SetSpeed(GSP_2);
 			return true;
 		case KS_INGAME_SPEED_4:
-			_game_control.speed = GSP_4;
+			_game_control.SetSpeed(GSP_4);
 			return true;
 		case KS_INGAME_SPEED_8:
-			_game_control.speed = GSP_8;
+			_game_control.SetSpeed(GSP_8);
 			return true;
 		case KS_INGAME_SPEED_UP:
 			if (_game_control.speed + 1 < GSP_COUNT) {
-				_game_control.speed++;
+				_game_control.SetSpeed(static_cast<GameSpeed>(_game_control.speed + 1));
 				return true;
 			}
 			return false;
 		case KS_INGAME_SPEED_DOWN:
 			if (_game_control.speed > GSP_PAUSE) {
-				_game_control.speed--;
+				_game_control.SetSpeed(static_cast<GameSpeed>(_game_control.speed - 1));
 				return true;
 			}
 			return false;
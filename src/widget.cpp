@@ -45,6 +45,7 @@ BaseWidget::BaseWidget(WidgetType wtype)
 	resize_x(0),
 	resize_y(0),
 	receive_repeated_events(false),
+	dirty(true),
 	tooltip(STR_NULL)
 {
 	for (int i = 0; i < PAD_COUNT; i++) this->paddings[i] = 0;
@@ -222,7 +223,10 @@ void BaseWidget::DrawTooltip(Point32 p)
 void BaseWidget::Draw(const GuiWindow *w)
 {
 	this->cached_window_base = w->rect.base;
-	if (this->visible) this->DoDraw(w);  // Polymorphic function call.
+	if (!this->visible || !this->pos.Intersects(w->dirty_area)) return;
+
+	_window_manager.widget_draw_count++;
+	this->DoDraw(w);  // Polymorphic function call.
 }
 
 /**
@@ -236,12 +240,13 @@ void BaseWidget::DoDraw(const GuiWindow *w)
 }
 
 /**
- * Change this widget's visibility state and update its window.
+ * Change this widget's visibility state and update its window, if the state changes.
  * @param w The window this widget belongs to.
  * @param v The widget should be visible.
  */
 void BaseWidget::SetVisible(GuiWindow *w, const bool v)
 {
+	if (this->visible == v) return;  // Resizing repaints the whole window.
 	this->visible = v;
 	w->ResetSize();
 }
@@ -694,6 +699,7 @@ void TextInputWidget::SetCursorPos(const size_t pos)
 {
 	assert(pos <= this->buffer.size());
 	this->cursor_pos = pos;
+	this->MarkDirty();
 }
 
 /**
@@ -713,6 +719,7 @@ void TextInputWidget::SetText(const std::string &text)
 {
 	this->buffer = text;
 	this->cursor_pos = std::min(this->cursor_pos, this->buffer.size());
+	this->MarkDirty();
 	if (this->text_changed) this->text_changed();
 }
 
@@ -723,6 +730,7 @@ void TextInputWidget::SetText(const std::string &text)
 void TextInputWidget::SetFocus(bool focus)
 {
 	this->has_focus = focus;
+	this->MarkDirty();
 }
 
 bool TextInputWidget::OnClick([[maybe_unused]] const Point32 &base, const Point16 &pos)
@@ -1088,7 +1096,10 @@ void ScrollbarWidget::SetItemSize(uint size)
  */
 void ScrollbarWidget::SetItemCount(uint count)
 {
-	this->item_count = count;
+	if (count != this->item_count) {
+		this->item_count = count;
+		this->MarkDirty();
+	}
 	this->SetStart(this->start);
 }
 
@@ -1153,7 +1164,10 @@ void ScrollbarWidget::SetStart(uint offset)
 {
 	uint visible_count = this->GetVisibleCount();
 	uint max_start = (this->item_count > visible_count) ? this->item_count - visible_count : 0;
-	this->start = std::min(offset, max_start);
+	offset = std::min(offset, max_start);
+	if (offset == this->start) return;
+	this->start = offset;
+	this->MarkDirty();
 }
 
 /**
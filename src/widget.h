@@ -107,9 +107,16 @@ public:
 	uint16 resize_x;           ///< Horizontal resize step.
 	uint16 resize_y;           ///< Vertical resize step.
 	bool receive_repeated_events;  ///< Receive auto-repeat events when a mouse button is pressed and held.
+	bool dirty;                ///< The widget changed since its window was last repainted.
 	uint8 paddings[PAD_COUNT]; ///< Padding.
 	StringID tooltip;          ///< Tool-tip of the widget.
 
+	/** Request a repaint of the widget at the next screen update. */
+	void MarkDirty()
+	{
+		this->dirty = true;
+	}
+
 	virtual BaseWidget *FindTooltipWidget(Point16 pt);
 	void DrawTooltip(Point32 p);
 
@@ -177,7 +184,7 @@ public:
 	 */
 	void SetChecked(bool value)
 	{
-		this->flags = (value) ? (this->flags | LWF_CHECKED) : (this->flags & ~LWF_CHECKED);
+		this->SetFlag(LWF_CHECKED, value);
 	}
 
 	/**
@@ -186,7 +193,7 @@ public:
 	 */
 	void SetPressed(bool value)
 	{
-		this->flags = (value) ? (this->flags | LWF_PRESSED) : (this->flags & ~LWF_PRESSED);
+		this->SetFlag(LWF_PRESSED, value);
 	}
 
 	/**
@@ -195,12 +202,26 @@ public:
 	 */
 	void SetShaded(bool value)
 	{
-		this->flags = (value) ? (this->flags | LWF_SHADED) : (this->flags & ~LWF_SHADED);
+		this->SetFlag(LWF_SHADED, value);
 	}
 
 	uint8 flags;          ///< Flags of the leaf widget. @see LeafWidgetFlags
 	ColourRange colour;   ///< Colour of the widget.
 	GradientShift shift;  ///< Gradient shift for the widget colour.
+
+private:
+	/**
+	 * Change a flag of the widget, and request a repaint if it changed.
+	 * @param flag Flag to change.
+	 * @param value New value of the flag.
+	 */
+	void SetFlag(uint8 flag, bool value)
+	{
+		const uint8 new_flags = (value) ? (this->flags | flag) : (this->flags & ~flag);
+		if (new_flags == this->flags) return;
+		this->flags = new_flags;
+		this->MarkDirty();
+	}
 };
 
 /**
@@ -48,7 +48,7 @@ static uint GetWindowZPriority(WindowTypes wt);
  * @param wnumber Number of the window within the \a wtype.
  */
 Window::Window(WindowTypes wtype, WindowNumber wnumber)
-: rect(0, 0, 0, 0), wtype(wtype), wnumber(wnumber), timeout(0), flags(0), higher(nullptr), lower(nullptr)
+: rect(0, 0, 0, 0), wtype(wtype), wnumber(wnumber), timeout(0), flags(0), higher(nullptr), lower(nullptr), dirty_area(0, 0, 0, 0)
 {
 	_window_manager.AddToStack(this); // Add to window stack.
 }
@@ -89,6 +89,28 @@ void Window::SetPosition(Point32 pos)
 	this->rect.base = pos;
 }
 
+/** Mark the entire window as needing a repaint. */
+void Window::MarkDirty()
+{
+	this->dirty_area = Rectangle16(0, 0, this->rect.width, this->rect.height);
+}
+
+/**
+ * Mark a part of the window as needing a repaint.
+ * @param area Area to repaint, relative to the top-left corner of the window.
+ */
+void Window::MarkDirty(const Rectangle16 &area)
+{
+	if (area.width == 0 || area.height == 0) return;
+
+	if (this->dirty_area.width == 0 || this->dirty_area.height == 0) {
+		this->dirty_area = area;
+	} else {
+		this->dirty_area.MergeArea(area);
+	}
+	this->dirty_area.RestrictTo(0, 0, this->rect.width, this->rect.height);
+}
+
 /** Compute the initial position of a window. */
 class ComputeInitialPosition {
 public:
@@ -327,9 +349,11 @@ GuiWindow::GuiWindow(WindowTypes wtype, WindowNumber wnumber) : Window(wtype, wn
 	selector(nullptr),
 	ride_type(nullptr),
 	closeable(true),
+	refresh_interval(0),
 	tree(nullptr),
 	widgets(nullptr),
-	num_widgets(0)
+	num_widgets(0),
+	refresh_countdown(0)
 {
 	SetHighlight(true);
 }
@@ -338,6 +362,7 @@ GuiWindow::~GuiWindow()
 {
 	/* The derived window should have released the selector before arriving here. */
 	assert(this->selector == nullptr);
+	_video.DeleteRenderTarget(&this->contents);
 }
 
 /**
@@ -379,6 +404,7 @@ void GuiWindow::ResetSize()
 
 	Rectangle16 min_rect(0, 0, this->tree->min_x, this->tree->min_y);
 	this->tree->SetSmallestSizePosition(min_rect);
+	this->MarkDirty();
 }
 
 /**
@@ -452,9 +478,55 @@ void GuiWindow::DrawWidget([[maybe_unused]] WidgetNumber wid_num, [[maybe_unused
 	/* Do nothing by default. */
 }
 
+/** Add the widgets that changed since the previous repaint to the #dirty_area. */
+void GuiWindow::CollectDirtyWidgets()
+{
+	for (uint16 i = 0; i < this->num_widgets; i++) {
+		BaseWidget *wid = this->widgets[i];
+		if (wid == nullptr || !wid->dirty) continue;
+
+		this->MarkDirty(wid->pos);
+		wid->dirty = false;
+	}
+}
+
+/**
+ * Paint the window to the screen.
+ * The widgets are drawn into an offscreen copy of the window, which is only updated in the #dirty_area.
+ * @param selector Mouse mode selector to render.
+ */
 void GuiWindow::OnDraw([[maybe_unused]] MouseModeSelector *selector)
 {
-	this->tree->Draw(this);
+	this->CollectDirtyWidgets();
+	if (this->refresh_interval > 0) {
+		if (this->refresh_countdown > 0) this->refresh_countdown--;
+		if (this->refresh_countdown == 0) {
+			this->refresh_countdown = this->refresh_interval;
+			this->MarkDirty();
+		}
+	}
+
+	if (this->contents.width != this->rect.width || this->contents.height != this->rect.height) {
+		_video.ResizeRenderTarget(&this->contents, this->rect.width, this->rect.height);
+		this->MarkDirty();
+	}
+
+	if (this->contents.framebuffer == 0) {
+		/* No offscreen copy available, draw the window directly. */
+		this->MarkDirty();
+		this->tree->Draw(this);
+	} else {
+		if (this->dirty_area.width > 0 && this->dirty_area.height > 0) {
+			Rectangle32 area(this->rect.base.x + this->dirty_area.base.x, this->rect.base.y + this->dirty_area.base.y,
+					this->dirty_area.width, this->dirty_area.height);
+			_video.BeginRenderTarget(this->contents, this->rect.base, area);
+			this->tree->Draw(this);
+			_video.EndRenderTarget();
+		}
+		_video.BlitRenderTarget(this->contents, this->rect.base);
+	}
+	this->dirty_area = Rectangle16(0, 0, 0, 0);
+
 	if ((this->flags & WF_HIGHLIGHT) != 0) _video.DrawRectangle(this->rect, MakeRGBA(255, 255, 255, OPAQUE));
 }
 
@@ -653,6 +725,7 @@ WidgetNumber GuiWindow::GetSelectedRadioButton(const WidgetNumber *wids)
 
 void GuiWindow::TimeoutCallback()
 {
+	this->MarkDirty();
 	this->tree->AutoRaiseButtons(this->rect.base);
 	if ((this->flags & WF_HIGHLIGHT) != 0) this->SetHighlight(false);
 }
@@ -682,6 +755,8 @@ WindowManager::WindowManager()
 :
 	top(nullptr),
 	bottom(nullptr),
+	widget_draw_count(0),
+	last_widget_draw_count(0),
 	current_window(nullptr),
 	select_window(nullptr),
 	select_valid(true),
@@ -955,10 +1030,16 @@ void WindowManager::UpdateCurrentWindow()
 	if (w == this->current_window) return;
 
 	/* Windows are different, send mouse leave/enter events. */
-	if (this->current_window != nullptr && this->HasWindow(this->current_window)) this->current_window->OnMouseLeaveEvent();
+	if (this->current_window != nullptr && this->HasWindow(this->current_window)) {
+		this->current_window->MarkDirty();
+		this->current_window->OnMouseLeaveEvent();
+	}
 
 	this->current_window = w;
-	if (this->current_window != nullptr) this->current_window->OnMouseEnterEvent();
+	if (this->current_window != nullptr) {
+		this->current_window->MarkDirty();
+		this->current_window->OnMouseEnterEvent();
+	}
 }
 
 /**
@@ -993,6 +1074,7 @@ void WindowManager::MouseButtonEvent(MouseButtons button, WmMouseEventMode mode)
 	if ((_video.GetMouseDragging() & button) != MB_NONE) {
 		if (mode == WMEM_RELEASE) _video.SetMouseDragging(button, false, false);
 	} else if (this->current_window != nullptr) {
+		this->current_window->MarkDirty();
 		WmMouseEvent me = this->current_window->OnMouseButtonEvent(button, mode);
 		switch (me) {
 			case WMME_NONE:
@@ -1023,7 +1105,10 @@ void WindowManager::MouseButtonEvent(MouseButtons button, WmMouseEventMode mode)
 void WindowManager::MouseWheelEvent(int direction)
 {
 	this->UpdateCurrentWindow();
-	if (this->current_window != nullptr) this->current_window->OnMouseWheelEvent(direction);
+	if (this->current_window != nullptr) {
+		this->current_window->MarkDirty();
+		this->current_window->OnMouseWheelEvent(direction);
+	}
 }
 
 /**
@@ -1036,18 +1121,22 @@ void WindowManager::MouseWheelEvent(int direction)
 bool WindowManager::KeyEvent(WmKeyCode key_code, WmKeyMod mod, const std::string &symbol)
 {
 	for (Window *w = this->top; w != nullptr; w = w->lower) {
+		w->MarkDirty();  // Before handling the event, as the window may delete itself.
 		if (w->OnKeyEvent(key_code, mod, symbol)) return true;
 	}
 	return false;
 }
 
 /**
- * Redraw (parts of) the windows.
- * @todo [medium/difficult] Do this much less stupid.
+ * Redraw the windows. The screen is composed from all windows again, but a #GuiWindow only redraws
+ * the widgets in its #Window::dirty_area.
  * @ingroup window_group
  */
 void WindowManager::UpdateWindows()
 {
+	this->last_widget_draw_count = this->widget_draw_count;
+	this->widget_draw_count = 0;
+
 	BaseWidget *tooltip_widget = nullptr;
 	Window *tooltip_window = nullptr;
 	if (_video.GetMouseDragging() == MB_NONE && this->current_window != nullptr) {
@@ -1131,7 +1220,10 @@ Window *GetWindowByType(WindowTypes wtype, WindowNumber wnumber)
 void NotifyChange(WindowTypes wtype, WindowNumber wnumber, ChangeCode code, uint32 parameter)
 {
 	Window *w = GetWindowByType(wtype, wnumber);
-	if (w != nullptr) w->OnChange(code, parameter);
+	if (w != nullptr) {
+		w->MarkDirty();
+		w->OnChange(code, parameter);
+	}
 }
 
 /**
@@ -1143,6 +1235,7 @@ void NotifyChange(ChangeCode code, uint32 parameter)
 {
 	for (Window *w = _window_manager.top; w != nullptr;) {
 		Window *next = w->lower;  // Make a copy in case the window deletes itself.
+		w->MarkDirty();
 		w->OnChange(code, parameter);
 		w = next;
 	}
@@ -69,6 +69,7 @@ public:
 	uint8 flags;    ///< %Window flags. @see WindowFlags
 	Window *higher; ///< %Window above this window (managed by #WindowManager).
 	Window *lower;  ///< %Window below this window (managed by #WindowManager).
+	Rectangle16 dirty_area; ///< Part of the window (relative to its top-left corner) to repaint, empty if the drawn contents are up to date.
 
 	/**
 	 * Get the current mouse position relative to this window's top-left corner.
@@ -93,6 +94,9 @@ public:
 	void SetPosition(Point32 pos);
 	virtual Point32 OnInitialPosition();
 
+	void MarkDirty();
+	void MarkDirty(const Rectangle16 &area);
+
 	virtual void OnDraw(MouseModeSelector *selector);
 	virtual void OnMouseMoveEvent(const Point16 &pos);
 	virtual WmMouseEvent OnMouseButtonEvent(MouseButtons state, WmMouseEventMode mode);
@@ -110,6 +114,8 @@ public:
 	virtual void SetTooltipStringParameters(BaseWidget *tooltip_widget) const;
 };
 
+static const uint16 LIVE_DATA_REFRESH_INTERVAL = 10;  ///< Number of screen updates between two repaints of a #GuiWindow that shows data which changes unnoticed.
+
 /**
  * Base class for windows with a widget tree.
  * @ingroup window_group
@@ -198,11 +204,16 @@ protected:
 	void ShowRecolourDropdown(WidgetNumber widnum, RecolourEntry *entry, ColourRange colour = COL_RANGE_INVALID);
 
 	bool closeable;  ///< This window can be closed by the user.
+	uint16 refresh_interval;  ///< Number of screen updates after which the window is repainted, even if nothing was marked dirty. \c 0 means never.
 
 private:
 	std::unique_ptr<BaseWidget> tree;     ///< Tree of widgets.
 	std::unique_ptr<BaseWidget*[]>widgets; ///< Array of widgets with a non-negative index (use #GetWidget to get the widgets from this array).
 	uint16 num_widgets;   ///< Number of widgets in #widgets.
+	RenderTarget contents;     ///< Drawn contents of the window, composed onto the screen at every screen update.
+	uint16 refresh_countdown;  ///< Number of screen updates until the next periodic repaint.
+
+	void CollectDirtyWidgets();
 };
 
 /**
@@ -340,6 +351,9 @@ public:
 	Window *top;    ///< Top-most window in the window stack.
 	Window *bottom; ///< Lowest window in the window stack.
 
+	uint32 widget_draw_count;       ///< Number of widgets drawn so far in the current screen update.
+	uint32 last_widget_draw_count;  ///< Number of widgets drawn in the previous screen update.
+
 private:
 	Window *FindWindowByPosition(const Point16 &pos) const;
 	void UpdateCurrentWindow();
@@ -59,6 +59,7 @@ enum ChangeCode {
 	CHG_DROPDOWN_RESULT,     ///< The selection of a dropdown window.
 	CHG_RESOLUTION_CHANGED,  ///< The size of the FreeRCT window was changed.
 	CHG_PERSON_DELETED,      ///< A person has been deleted from the world.
+	CHG_RECOLOUR_RESULT,     ///< A new colour was chosen in a recolour dropdown window.
 };
 
 /** Various state flags of the %Window. */